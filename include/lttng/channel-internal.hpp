@@ -25,6 +25,23 @@ struct lttng_channel_extended {
 	uint8_t preallocation_policy;
 	/* Maximal age of subbuffers in microseconds (automatic reclamation policy). */
 	LTTNG_OPTIONAL_COMM(std::uint64_t) LTTNG_PACKED automatic_memory_reclamation_maximal_age_us;
+	/* enum lttng_channel_compression */
+	uint8_t compression;
+	/* Packet compression statistics, only set when listing channels. */
+	uint64_t compression_input_bytes;
+	uint64_t compression_output_bytes;
+	uint64_t compression_cpu_time_ns;
+	/* Consumption I/O statistics, only set when listing channels. */
+	uint64_t io_consumed_subbuffers;
+	uint64_t io_written_bytes;
+	uint64_t io_write_calls;
+	uint64_t io_relayd_send_time_ns;
+	uint64_t io_subbuffer_consumption_p99_ns;
+	uint64_t io_subbuffer_consumption_max_ns;
+	uint64_t io_write_p99_ns;
+	uint64_t io_write_max_ns;
+	/* The I/O statistics could be obtained from the consumer daemons. */
+	uint8_t has_io_stats;
 } LTTNG_PACKED;
 
 struct lttng_channel_comm {
@@ -56,6 +73,23 @@ struct lttng_channel_comm {
 	uint8_t preallocation_policy;
 	/* Maximal age of subbuffers in microseconds (automatic reclamation policy). */
 	LTTNG_OPTIONAL_COMM(std::uint64_t) LTTNG_PACKED automatic_memory_reclamation_maximal_age_us;
+	/* enum lttng_channel_compression */
+	uint8_t compression;
+	/* Packet compression statistics, only set when listing channels. */
+	uint64_t compression_input_bytes;
+	uint64_t compression_output_bytes;
+	uint64_t compression_cpu_time_ns;
+	/* Consumption I/O statistics, only set when listing channels. */
+	uint64_t io_consumed_subbuffers;
+	uint64_t io_written_bytes;
+	uint64_t io_write_calls;
+	uint64_t io_relayd_send_time_ns;
+	uint64_t io_subbuffer_consumption_p99_ns;
+	uint64_t io_subbuffer_consumption_max_ns;
+	uint64_t io_write_p99_ns;
+	uint64_t io_write_max_ns;
+	/* The I/O statistics could be obtained from the consumer daemons. */
+	uint8_t has_io_stats;
 } LTTNG_PACKED;
 
 struct lttng_channel *lttng_channel_create_internal();
@@ -50,6 +50,24 @@ enum lttng_channel_preallocation_policy {
 	LTTNG_CHANNEL_PREALLOCATION_POLICY_ON_DEMAND = 1,
 };
 
+/*!
+@brief
+    \ref api-channel-compression "Packet compression" codec
+    of a channel.
+
+@ingroup api_channel
+*/
+enum lttng_channel_compression {
+	/// Don't compress packets.
+	LTTNG_CHANNEL_COMPRESSION_NONE = 0,
+
+	/// Compress packets with zstd.
+	LTTNG_CHANNEL_COMPRESSION_ZSTD = 1,
+
+	/// Compress packets with LZ4.
+	LTTNG_CHANNEL_COMPRESSION_LZ4 = 2,
+};
+
 /*!
 @brief
     Status code for \lt_obj_channel property accessors.
@@ -1028,6 +1046,241 @@ LTTNG_EXPORT extern enum lttng_channel_status
 lttng_channel_set_automatic_memory_reclamation_policy(struct lttng_channel *channel,
 						      uint64_t older_than_us);
 
+/*!
+@brief
+    Sets \lt_p{*compression} to the
+    \ref api-channel-compression "packet compression" codec
+    of the \lt_obj_channel summary \lt_p{channel}.
+
+@ingroup api_channel
+
+This property only applies to \link #LTTNG_DOMAIN_UST user space\endlink
+channels.
+
+@param[in] channel
+    Summary of the channel of which to get the packet compression codec.
+@param[out] compression
+    <strong>On success</strong>, this function sets \lt_p{*compression}
+    to the packet compression codec of \lt_p{channel}.
+
+@retval #LTTNG_CHANNEL_STATUS_OK
+    Success.
+@retval #LTTNG_CHANNEL_STATUS_INVALID
+    Unsatisfied precondition.
+
+@pre
+    @lt_pre_not_null{channel}
+    - The \lt_obj_domain type of \lt_p{channel} is #LTTNG_DOMAIN_UST.
+    @lt_pre_not_null{compression}
+
+@sa lttng_channel_set_compression() --
+    Sets the packet compression codec of a channel summary.
+*/
+LTTNG_EXPORT extern enum lttng_channel_status
+lttng_channel_get_compression(const struct lttng_channel *channel,
+			      enum lttng_channel_compression *compression);
+
+/*!
+@brief
+    Sets the \ref api-channel-compression "packet compression" codec
+    of the channel summary \lt_p{channel} to \lt_p{compression}.
+
+@ingroup api_channel
+
+This property only applies to \link #LTTNG_DOMAIN_UST user space\endlink
+channels.
+
+@param[in] channel
+    Channel summary of which to set the packet compression codec to
+    \lt_p{compression}.
+@param[in] compression
+    Packet compression codec to set.
+
+@retval #LTTNG_CHANNEL_STATUS_OK
+    Success.
+@retval #LTTNG_CHANNEL_STATUS_INVALID
+    Unsatisfied precondition.
+
+@pre
+    @lt_pre_not_null{channel}
+    - The \lt_obj_domain type of \lt_p{channel} is #LTTNG_DOMAIN_UST.
+
+@sa lttng_channel_get_compression() --
+    Returns the packet compression codec of a channel summary.
+*/
+LTTNG_EXPORT extern enum lttng_channel_status
+lttng_channel_set_compression(struct lttng_channel *channel,
+			      enum lttng_channel_compression compression);
+
+/*!
+@brief
+    Sets \lt_p{*input_bytes}, \lt_p{*output_bytes}, and
+    \lt_p{*cpu_time_ns} to the
+    \ref api-channel-compression "packet compression" statistics of
+    the \lt_obj_channel summarized by \lt_p{channel}.
+
+@ingroup api_channel
+
+lttng_list_channels() sets a pointer to an array of all the
+channel summaries of a given \lt_obj_session and \lt_obj_domain.
+
+The compression ratio of the channel is
+<code>*input_bytes / *output_bytes</code>.
+
+@param[in] channel
+    Summary of the channel of which to get the packet compression
+    statistics.
+@param[out] input_bytes
+    <strong>On success</strong>, this function sets \lt_p{*input_bytes}
+    to the number of packet bytes which the consumer daemon compressed.
+@param[out] output_bytes
+    <strong>On success</strong>, this function sets
+    \lt_p{*output_bytes} to the number of bytes which the compression
+    of those packets produced.
+@param[out] cpu_time_ns
+    <strong>On success</strong>, this function sets \lt_p{*cpu_time_ns}
+    to the CPU time (ns) which the consumer daemon spent compressing
+    those packets.
+
+@retval #LTTNG_CHANNEL_STATUS_OK
+    Success.
+@retval #LTTNG_CHANNEL_STATUS_INVALID
+    Unsatisfied precondition.
+
+@pre
+    @lt_pre_not_null{channel}
+    - You obtained \lt_p{channel} with lttng_list_channels().
+    @lt_pre_not_null{input_bytes}
+    @lt_pre_not_null{output_bytes}
+    @lt_pre_not_null{cpu_time_ns}
+*/
+LTTNG_EXPORT extern enum lttng_channel_status
+lttng_channel_get_compression_statistics(const struct lttng_channel *channel,
+					 uint64_t *input_bytes,
+					 uint64_t *output_bytes,
+					 uint64_t *cpu_time_ns);
+
+/*!
+@brief
+    Sets \lt_p{*consumed_subbuffer_count}, \lt_p{*written_bytes},
+    \lt_p{*write_call_count}, and \lt_p{*relayd_send_time_ns} to the
+    \ref api-channel-io-stats "I/O statistics" of the
+    \lt_obj_channel summarized by \lt_p{channel}.
+
+@ingroup api_channel
+
+lttng_list_channels() sets a pointer to an array of all the
+channel summaries of a given \lt_obj_session and \lt_obj_domain.
+
+@param[in] channel
+    Summary of the channel of which to get the I/O statistics.
+@param[out] consumed_subbuffer_count
+    <strong>On success</strong>, this function sets
+    \lt_p{*consumed_subbuffer_count} to the number of sub-buffers which
+    the consumer daemon consumed.
+@param[out] written_bytes
+    <strong>On success</strong>, this function sets
+    \lt_p{*written_bytes} to the number of bytes which the consumer
+    daemon wrote to trace files or sent to a relay daemon.
+@param[out] write_call_count
+    <strong>On success</strong>, this function sets
+    \lt_p{*write_call_count} to the number of write operations
+    (<code>write()</code> calls or <code>splice()</code> iterations)
+    which the consumer daemon performed.
+@param[out] relayd_send_time_ns
+    <strong>On success</strong>, this function sets
+    \lt_p{*relayd_send_time_ns} to the time (ns) which the consumer
+    daemon spent sending packets to a relay daemon.
+
+@retval #LTTNG_CHANNEL_STATUS_OK
+    Success.
+@retval #LTTNG_CHANNEL_STATUS_UNSET
+    The I/O statistics of the channel are unavailable: the session
+    daemon couldn't get them from the consumer daemons.
+@retval #LTTNG_CHANNEL_STATUS_INVALID
+    Unsatisfied precondition.
+
+@pre
+    @lt_pre_not_null{channel}
+    - You obtained \lt_p{channel} with lttng_list_channels().
+    @lt_pre_not_null{consumed_subbuffer_count}
+    @lt_pre_not_null{written_bytes}
+    @lt_pre_not_null{write_call_count}
+    @lt_pre_not_null{relayd_send_time_ns}
+
+@sa lttng_channel_get_io_latency_statistics() --
+    Returns the I/O latency statistics of a channel summary.
+*/
+LTTNG_EXPORT extern enum lttng_channel_status
+lttng_channel_get_io_statistics(const struct lttng_channel *channel,
+				uint64_t *consumed_subbuffer_count,
+				uint64_t *written_bytes,
+				uint64_t *write_call_count,
+				uint64_t *relayd_send_time_ns);
+
+/*!
+@brief
+    Sets \lt_p{*subbuffer_consumption_p99_ns},
+    \lt_p{*subbuffer_consumption_max_ns}, \lt_p{*write_p99_ns}, and
+    \lt_p{*write_max_ns} to the
+    \ref api-channel-io-stats "I/O latency statistics" of the
+    \lt_obj_channel summarized by \lt_p{channel}.
+
+@ingroup api_channel
+
+lttng_list_channels() sets a pointer to an array of all the
+channel summaries of a given \lt_obj_session and \lt_obj_domain.
+
+Each value is the one of the data stream of the channel for which
+it's the highest. The 99th percentiles are approximations: they are the
+upper bounds of power-of-two ranges.
+
+@param[in] channel
+    Summary of the channel of which to get the I/O latency statistics.
+@param[out] subbuffer_consumption_p99_ns
+    <strong>On success</strong>, this function sets
+    \lt_p{*subbuffer_consumption_p99_ns} to the 99th percentile of the
+    time (ns) between the moment the consumer daemon acquires a
+    sub-buffer and the moment it releases it, once written.
+@param[out] subbuffer_consumption_max_ns
+    <strong>On success</strong>, this function sets
+    \lt_p{*subbuffer_consumption_max_ns} to the maximum of this time
+    (ns).
+@param[out] write_p99_ns
+    <strong>On success</strong>, this function sets
+    \lt_p{*write_p99_ns} to the 99th percentile of the duration (ns) of
+    the write operations of the consumer daemon.
+@param[out] write_max_ns
+    <strong>On success</strong>, this function sets
+    \lt_p{*write_max_ns} to the maximum duration (ns) of those write
+    operations.
+
+@retval #LTTNG_CHANNEL_STATUS_OK
+    Success.
+@retval #LTTNG_CHANNEL_STATUS_UNSET
+    The I/O latency statistics of the channel are unavailable: the
+    session daemon couldn't get them from the consumer daemons.
+@retval #LTTNG_CHANNEL_STATUS_INVALID
+    Unsatisfied precondition.
+
+@pre
+    @lt_pre_not_null{channel}
+    - You obtained \lt_p{channel} with lttng_list_channels().
+    @lt_pre_not_null{subbuffer_consumption_p99_ns}
+    @lt_pre_not_null{subbuffer_consumption_max_ns}
+    @lt_pre_not_null{write_p99_ns}
+    @lt_pre_not_null{write_max_ns}
+
+@sa lttng_channel_get_io_statistics() --
+    Returns the I/O statistics of a channel summary.
+*/
+LTTNG_EXPORT extern enum lttng_channel_status
+lttng_channel_get_io_latency_statistics(const struct lttng_channel *channel,
+					uint64_t *subbuffer_consumption_p99_ns,
+					uint64_t *subbuffer_consumption_max_ns,
+					uint64_t *write_p99_ns,
+					uint64_t *write_max_ns);
+
 #ifdef __cplusplus
 }
 #endif
@@ -191,6 +191,11 @@ lttng_load_session_attr_set_override_session_name(struct lttng_load_session_attr
  * The lttng_load_session_attr object must not be NULL. No ownership of the
  * object is kept by the function; it must be released by the caller.
  *
+ * The commands recreating the sessions are sent through the persistent
+ * session daemon connection of the calling thread, if any (see
+ * lttng_session_daemon_connection_set_current()), or through a new
+ * connection per command otherwise.
+ *
  * Returns 0 on success or a negative LTTNG_ERR value on error.
  */
 LTTNG_EXPORT extern int lttng_load_session(struct lttng_load_session_attr *attr);
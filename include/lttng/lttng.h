@@ -67,6 +67,7 @@
 #include <lttng/reclaim.h>
 #include <lttng/rotation.h>
 #include <lttng/save.h>
+#include <lttng/session-daemon-connection.h>
 #include <lttng/session-descriptor.h>
 #include <lttng/session.h>
 #include <lttng/snapshot.h>
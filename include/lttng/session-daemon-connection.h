@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+
+#ifndef LTTNG_SESSION_DAEMON_CONNECTION_H
+#define LTTNG_SESSION_DAEMON_CONNECTION_H
+
+#include <lttng/lttng-export.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+@addtogroup api_gen
+@{
+*/
+
+/*!
+@struct lttng_session_daemon_connection
+
+@brief
+    Persistent session daemon connection (opaque type).
+
+See \ref api-gen-sessiond-persistent-conn "Persistent session daemon connection".
+*/
+struct lttng_session_daemon_connection;
+
+/*!
+@brief
+    Return type of persistent session daemon connection functions.
+
+Error status enumerators have a negative value.
+*/
+enum lttng_session_daemon_connection_status {
+	/// Success.
+	LTTNG_SESSION_DAEMON_CONNECTION_STATUS_OK = 0,
+
+	/// Unsatisfied precondition.
+	LTTNG_SESSION_DAEMON_CONNECTION_STATUS_INVALID = -1,
+
+	/// liblttng-ctl isn't able to connect to a session daemon.
+	LTTNG_SESSION_DAEMON_CONNECTION_STATUS_NO_SESSION_DAEMON = -2,
+
+	/// The session daemon doesn't support persistent connections.
+	LTTNG_SESSION_DAEMON_CONNECTION_STATUS_UNSUPPORTED = -3,
+
+	/// Other error.
+	LTTNG_SESSION_DAEMON_CONNECTION_STATUS_ERROR = -4,
+};
+
+/*!
+@brief
+    Opens a persistent connection to the session daemon and sets
+    \lt_p{*connection} to it.
+
+liblttng-ctl connects to the same session daemon as its other functions
+(see \ref api-gen-sessiond-conn "Session daemon connection").
+
+Use the returned connection with lttng_session_daemon_connection_set_current().
+
+@param[out] connection
+    <strong>On success</strong>, this function sets \lt_p{*connection}
+    to the opened persistent session daemon connection.
+
+    Destroy \lt_p{*connection} with
+    lttng_session_daemon_connection_destroy().
+
+@retval #LTTNG_SESSION_DAEMON_CONNECTION_STATUS_OK
+    Success.
+@retval #LTTNG_SESSION_DAEMON_CONNECTION_STATUS_INVALID
+    Unsatisfied precondition.
+@retval #LTTNG_SESSION_DAEMON_CONNECTION_STATUS_NO_SESSION_DAEMON
+    liblttng-ctl isn't able to connect to a session daemon.
+@retval #LTTNG_SESSION_DAEMON_CONNECTION_STATUS_UNSUPPORTED
+    The session daemon doesn't support persistent connections.
+@retval #LTTNG_SESSION_DAEMON_CONNECTION_STATUS_ERROR
+    Other error.
+
+@pre
+    @lt_pre_not_null{connection}
+
+@sa lttng_session_daemon_connection_destroy() --
+    Destroys a persistent session daemon connection.
+*/
+LTTNG_EXPORT extern enum lttng_session_daemon_connection_status
+lttng_session_daemon_connection_create(struct lttng_session_daemon_connection **connection);
+
+/*!
+@brief
+    Makes the liblttng-ctl functions called by the current thread send
+    their commands through \lt_p{connection}.
+
+Pass \c NULL as \lt_p{connection} so that the liblttng-ctl functions
+which the current thread calls open a new session daemon connection for
+each command (the default).
+
+Many threads may share the same persistent connection: their commands
+are pipelined, that is, a thread doesn't wait for the reply to the
+command of another thread before sending its own command.
+
+@param[in] connection
+    @parblock
+    Persistent session daemon connection which the liblttng-ctl
+    functions called by the current thread use, or \c NULL to open a
+    new connection for each command.
+
+    \lt_p{connection} must remain valid until you call this function
+    again from the current thread.
+    @endparblock
+
+@retval #LTTNG_SESSION_DAEMON_CONNECTION_STATUS_OK
+    Success.
+*/
+LTTNG_EXPORT extern enum lttng_session_daemon_connection_status
+lttng_session_daemon_connection_set_current(struct lttng_session_daemon_connection *connection);
+
+/*!
+@brief
+    Destroys the persistent session daemon connection
+    \lt_p{connection}.
+
+@param[in] connection
+    @parblock
+    Persistent session daemon connection to destroy.
+
+    May be \c NULL.
+    @endparblock
+
+@pre
+    - No thread uses \lt_p{connection} (see
+      lttng_session_daemon_connection_set_current()).
+*/
+LTTNG_EXPORT extern void
+lttng_session_daemon_connection_destroy(struct lttng_session_daemon_connection *connection);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LTTNG_SESSION_DAEMON_CONNECTION_H */
@@ -447,6 +447,282 @@ lttng_process_attr_virtual_group_id_tracker_handle_remove_group_name(
 	const struct lttng_process_attr_tracker_handle *group_id_tracker,
 	const char *virtual_group_name);
 
+/*
+ * Add `count` numerical PIDs to the process ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was added, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS if it was already present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_process_id_tracker_handle_add_pids(
+	const struct lttng_process_attr_tracker_handle *process_id_tracker,
+	const pid_t *pids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Remove `count` numerical PIDs from the process ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was removed, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING if it was not present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_process_id_tracker_handle_remove_pids(
+	const struct lttng_process_attr_tracker_handle *process_id_tracker,
+	const pid_t *pids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Add `count` numerical PIDs to the virtual process ID process attribute
+ * tracker inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was added, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS if it was already present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_virtual_process_id_tracker_handle_add_pids(
+	const struct lttng_process_attr_tracker_handle *process_id_tracker,
+	const pid_t *vpids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Remove `count` numerical PIDs from the virtual process ID process attribute
+ * tracker inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was removed, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING if it was not present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_virtual_process_id_tracker_handle_remove_pids(
+	const struct lttng_process_attr_tracker_handle *process_id_tracker,
+	const pid_t *vpids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Add `count` numerical UIDs to the user ID process attribute tracker inclusion
+ * set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was added, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS if it was already present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_user_id_tracker_handle_add_uids(
+	const struct lttng_process_attr_tracker_handle *user_id_tracker,
+	const uid_t *uids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Remove `count` numerical UIDs from the user ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was removed, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING if it was not present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_user_id_tracker_handle_remove_uids(
+	const struct lttng_process_attr_tracker_handle *user_id_tracker,
+	const uid_t *uids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Add `count` numerical UIDs to the virtual user ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was added, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS if it was already present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_virtual_user_id_tracker_handle_add_uids(
+	const struct lttng_process_attr_tracker_handle *user_id_tracker,
+	const uid_t *vuids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Remove `count` numerical UIDs from the virtual user ID process attribute
+ * tracker inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was removed, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING if it was not present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_virtual_user_id_tracker_handle_remove_uids(
+	const struct lttng_process_attr_tracker_handle *user_id_tracker,
+	const uid_t *vuids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Add `count` numerical GIDs to the group ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was added, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS if it was already present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_group_id_tracker_handle_add_gids(
+	const struct lttng_process_attr_tracker_handle *group_id_tracker,
+	const gid_t *gids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Remove `count` numerical GIDs from the group ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was removed, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING if it was not present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_group_id_tracker_handle_remove_gids(
+	const struct lttng_process_attr_tracker_handle *group_id_tracker,
+	const gid_t *gids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Add `count` numerical GIDs to the virtual group ID process attribute tracker
+ * inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was added, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS if it was already present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_virtual_group_id_tracker_handle_add_gids(
+	const struct lttng_process_attr_tracker_handle *group_id_tracker,
+	const gid_t *vgids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
+/*
+ * Remove `count` numerical GIDs from the virtual group ID process attribute
+ * tracker inclusion set.
+ *
+ * The values are sent to the session daemon in a single command. The
+ * outcome of the operation for each value is stored, when `statuses` is not
+ * NULL, in the `count` entries of `statuses`:
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the value was removed, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING if it was not present in
+ * the inclusion set.
+ *
+ * Returns LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK if the command was
+ * processed by the session daemon, and
+ * LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID if an invalid tracker or
+ * array argument was provided.
+ */
+LTTNG_EXPORT extern enum lttng_process_attr_tracker_handle_status
+lttng_process_attr_virtual_group_id_tracker_handle_remove_gids(
+	const struct lttng_process_attr_tracker_handle *group_id_tracker,
+	const gid_t *vgids,
+	unsigned int count,
+	enum lttng_process_attr_tracker_handle_status *statuses);
+
 /*
  * Get the process attribute values that are part of a tracker's inclusion set.
  *
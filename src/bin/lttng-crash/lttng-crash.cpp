@@ -13,21 +13,29 @@
 
 #include <lttng/lttng.h>
 
+#include <algorithm>
+#include <atomic>
 #include <ctype.h>
 #include <dirent.h>
 #include <fcntl.h>
 #include <getopt.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/wait.h>
+#include <system_error>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 #include <version.hpp>
 
 #define COPY_BUFLEN	      4096
@@ -220,26 +228,48 @@ struct lttng_crash_layout {
 	uint32_t mode; /* Buffer mode: 0: overwrite, 1: discard */
 	uint32_t extra_reader_subbuf; /* Has an extra reader subbuffer ? (true/false) */
 };
+
+/*
+ * Buffer file to extract. Jobs are gathered while walking the input
+ * directory tree (which creates the output directories and copies the
+ * metadata files) and run afterwards by a pool of extraction threads.
+ */
+struct extraction_job {
+	std::string output_path;
+	std::string input_path;
+};
 } /* namespace */
 
 /* Variables */
 static const char *progname;
 static char *opt_viewer_path = nullptr;
 static char *opt_output_path = nullptr;
+static unsigned int opt_jobs;
+static uint64_t opt_begin_timestamp;
+static uint64_t opt_end_timestamp = UINT64_MAX;
 
 static char *the_input_path;
+static std::vector<extraction_job> the_extraction_jobs;
 
 int lttng_opt_quiet, lttng_opt_verbose, lttng_opt_mi;
 
 enum {
 	OPT_DUMP_OPTIONS,
+	OPT_BEGIN,
+	OPT_END,
 };
 
 /* Getopt options. No first level command. */
 static struct option long_options[] = {
-	{ "version", 0, nullptr, 'V' }, { "help", 0, nullptr, 'h' },
-	{ "verbose", 0, nullptr, 'v' }, { "viewer", 1, nullptr, 'e' },
-	{ "extract", 1, nullptr, 'x' }, { "list-options", 0, nullptr, OPT_DUMP_OPTIONS },
+	{ "version", 0, nullptr, 'V' },
+	{ "help", 0, nullptr, 'h' },
+	{ "verbose", 0, nullptr, 'v' },
+	{ "viewer", 1, nullptr, 'e' },
+	{ "extract", 1, nullptr, 'x' },
+	{ "jobs", 1, nullptr, 'j' },
+	{ "begin", 1, nullptr, OPT_BEGIN },
+	{ "end", 1, nullptr, OPT_END },
+	{ "list-options", 0, nullptr, OPT_DUMP_OPTIONS },
 	{ nullptr, 0, nullptr, 0 },
 };
 
@@ -300,7 +330,7 @@ static int parse_args(int argc, char **argv)
 		return -1;
 	}
 
-	while ((opt = getopt_long(argc, argv, "+Vhve:x:", long_options, nullptr)) != -1) {
+	while ((opt = getopt_long(argc, argv, "+Vhve:x:j:", long_options, nullptr)) != -1) {
 		switch (opt) {
 		case 'V':
 			version(stdout);
@@ -324,6 +354,37 @@ static int parse_args(int argc, char **argv)
 			free(opt_output_path);
 			opt_output_path = strdup(optarg);
 			break;
+		case 'j':
+		{
+			unsigned long long jobs;
+
+			if (utils_parse_unsigned_long_long(optarg, &jobs) || jobs == 0 ||
+			    jobs > UINT_MAX) {
+				ERR("Invalid number of jobs: `%s`", optarg);
+				goto error;
+			}
+
+			opt_jobs = (unsigned int) jobs;
+			break;
+		}
+		case OPT_BEGIN:
+		case OPT_END:
+		{
+			unsigned long long timestamp;
+
+			if (utils_parse_unsigned_long_long(optarg, &timestamp)) {
+				ERR("Invalid timestamp: `%s`", optarg);
+				goto error;
+			}
+
+			if (opt == OPT_BEGIN) {
+				opt_begin_timestamp = timestamp;
+			} else {
+				opt_end_timestamp = timestamp;
+			}
+
+			break;
+		}
 		case OPT_DUMP_OPTIONS:
 			list_options(stdout);
 			ret = 1;
@@ -340,6 +401,12 @@ static int parse_args(int argc, char **argv)
 		goto error;
 	}
 
+	if (opt_begin_timestamp > opt_end_timestamp) {
+		ERR("Command-line error: The --begin timestamp is greater than the --end "
+		    "timestamp");
+		goto error;
+	}
+
 	the_input_path = argv[optind];
 end:
 	return ret;
@@ -348,6 +415,44 @@ error:
 	return -1;
 }
 
+/*
+ * Copy the whole content of fd_src into fd_dest without bouncing it through
+ * user space.
+ *
+ * Return 0 on success, 1 if the file systems don't support in-kernel copies
+ * (nothing was copied), or -1 on error.
+ */
+static int copy_file_in_kernel([[maybe_unused]] int fd_dest, [[maybe_unused]] int fd_src)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+	for (;;) {
+		const ssize_t copied_len =
+			copy_file_range(fd_src, nullptr, fd_dest, nullptr, SSIZE_MAX, 0);
+
+		if (copied_len == 0) {
+			return 0;
+		} else if (copied_len > 0) {
+			continue;
+		}
+
+		switch (errno) {
+		case EINTR:
+			continue;
+		case ENOSYS:
+		case EXDEV:
+		case EINVAL:
+		case EOPNOTSUPP:
+			DBG("copy_file_range() is not supported, falling back to read/write");
+			return 1;
+		default:
+			return -1;
+		}
+	}
+#else
+	return 1;
+#endif /* HAVE_COPY_FILE_RANGE */
+}
+
 static int copy_file(const char *file_dest, const char *file_src)
 {
 	int fd_src = -1, fd_dest = -1;
@@ -370,6 +475,15 @@ static int copy_file(const char *file_dest, const char *file_src)
 		goto error;
 	}
 
+	ret = copy_file_in_kernel(fd_dest, fd_src);
+	if (ret <= 0) {
+		if (ret < 0) {
+			PERROR("Error copying '%s' into '%s'", file_src, file_dest);
+		}
+
+		goto error;
+	}
+
 	for (;;) {
 		readlen = lttng_read(fd_src, buf, COPY_BUFLEN);
 		if (readlen < 0) {
@@ -721,13 +835,62 @@ subbuffer_id_get_index(uint32_t extra_reader_subbuf, uint64_t id, unsigned int w
 		return id;
 }
 
-static int
-copy_crash_subbuf(const struct lttng_crash_layout *layout, int fd_dest, char *buf, uint64_t offset)
+/*
+ * Check whether a sub-buffer overlaps the [--begin, --end] timestamp window.
+ *
+ * The crash ABI only describes the location of the content and packet sizes.
+ * In the lttng-ust packet context, they are immediately preceded by the
+ * 64-bit timestamp_begin and timestamp_end fields. The end timestamp of a
+ * sub-buffer which is not fully committed is not written yet: such a
+ * sub-buffer is considered to extend indefinitely.
+ */
+static bool subbuf_in_timestamp_range(const struct lttng_crash_layout *layout,
+				      const char *subbuf_ptr,
+				      bool fully_committed)
+{
+	const int timestamp_len = sizeof(uint64_t);
+	uint64_t timestamp_begin, timestamp_end = UINT64_MAX;
+
+	if (opt_begin_timestamp == 0 && opt_end_timestamp == UINT64_MAX) {
+		return true;
+	}
+
+	if (layout->length.content_size != timestamp_len ||
+	    layout->offset.content_size < 2 * timestamp_len) {
+		/* Unknown packet context layout: keep everything. */
+		return true;
+	}
+
+	timestamp_begin = _crash_get_field(layout,
+					   subbuf_ptr + layout->offset.content_size -
+						   2 * timestamp_len,
+					   timestamp_len);
+	if (fully_committed) {
+		timestamp_end = _crash_get_field(layout,
+						 subbuf_ptr + layout->offset.content_size -
+							 timestamp_len,
+						 timestamp_len);
+	}
+
+	return timestamp_begin <= opt_end_timestamp && timestamp_end >= opt_begin_timestamp;
+}
+
+/*
+ * Locate the packet of the sub-buffer at `offset` within the mapped source
+ * file `buf`, patching its header in place if it is not fully committed.
+ *
+ * Return 0 and set `packet` to the data to copy to the output file, 1 if the
+ * sub-buffer is outside of the timestamp range, -ENODATA if there is no more
+ * data to copy from the buffer, or another negative value on error.
+ */
+static int copy_crash_subbuf(const struct lttng_crash_layout *layout,
+			     char *buf,
+			     uint64_t offset,
+			     struct iovec *packet)
 {
 	uint64_t buf_size, subbuf_size, num_subbuf, sbidx, id, sb_bindex, rpages_offset, p_offset,
 		seq_cc, committed, commit_count_mask, consumed_cur, packet_size;
 	char *subbuf_ptr;
-	ssize_t writelen;
 
 	/*
 	 * Get the current subbuffer by applying the proper mask to
@@ -795,6 +958,11 @@ copy_crash_subbuf(const struct lttng_crash_layout *layout, int fd_dest, char *bu
 	p_offset = crash_get_field(layout, buf + rpages_offset, sb_backend_p_offset);
 	subbuf_ptr = buf + p_offset;
 
+	if (!subbuf_in_timestamp_range(layout, subbuf_ptr, committed == subbuf_size)) {
+		DBG("Skipping sub-buffer outside of the timestamp range");
+		return 1;
+	}
+
 	if (committed == subbuf_size) {
 		/*
 		 * Packet header can be used.
@@ -835,45 +1003,102 @@ copy_crash_subbuf(const struct lttng_crash_layout *layout, int fd_dest, char *bu
 		packet_size = committed;
 	}
 
-	/*
-	 * Copy packet into fd_dest.
-	 */
-	writelen = lttng_write(fd_dest, subbuf_ptr, packet_size);
-	if (writelen < packet_size) {
-		PERROR("Error writing to output file");
-		return -1;
-	}
-	DBG("Copied %" PRIu64 " bytes of data", packet_size);
+	packet->iov_base = subbuf_ptr;
+	packet->iov_len = packet_size;
+	DBG("Found %" PRIu64 " bytes of data", packet_size);
 	return 0;
 
 nodata:
 	return -ENODATA;
 }
 
+/*
+ * Write all packets to fd_dest, IOV_MAX packets per system call.
+ */
+static int write_packets(int fd_dest, std::vector<struct iovec>& packets)
+{
+	size_t first = 0;
+
+	while (first < packets.size()) {
+		const int iov_count = (int) std::min<size_t>(packets.size() - first, IOV_MAX);
+		ssize_t written_len = writev(fd_dest, &packets[first], iov_count);
+
+		if (written_len < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			PERROR("Error writing to output file");
+			return -1;
+		}
+
+		/* Skip the packets that were completely written. */
+		while (first < packets.size() && (size_t) written_len >= packets[first].iov_len) {
+			written_len -= packets[first].iov_len;
+			first++;
+		}
+
+		/* Resume a short write from the middle of a packet. */
+		if (written_len > 0) {
+			packets[first].iov_base = (char *) packets[first].iov_base + written_len;
+			packets[first].iov_len -= written_len;
+		}
+	}
+
+	return 0;
+}
+
 static int copy_crash_data(const struct lttng_crash_layout *layout, int fd_dest, int fd_src)
 {
 	char *buf;
-	int ret = 0, has_data = 0;
+	int ret = 0;
 	struct stat statbuf;
 	size_t src_file_len;
 	uint64_t prod_offset, consumed_offset;
 	uint64_t offset, subbuf_size;
-	ssize_t readlen;
+	std::vector<struct iovec> packets;
 
 	ret = fstat(fd_src, &statbuf);
 	if (ret) {
 		return ret;
 	}
 	src_file_len = layout->mmap_length;
-	buf = calloc<char>(src_file_len);
-	if (!buf) {
-		return -1;
-	}
-	readlen = lttng_read(fd_src, buf, src_file_len);
-	if (readlen < 0) {
-		PERROR("Error reading input file");
-		ret = -1;
-		goto end;
+
+	/*
+	 * Map the source file privately: the headers of partially committed
+	 * sub-buffers are patched in place without modifying the file. A
+	 * truncated file is read into a zeroed anonymous mapping instead, as
+	 * accessing a file mapping past its end raises SIGBUS.
+	 */
+	if (statbuf.st_size >= (off_t) src_file_len) {
+		buf = (char *) mmap(
+			nullptr, src_file_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_src, 0);
+		if (buf == MAP_FAILED) {
+			PERROR("Error mapping input file");
+			return -1;
+		}
+
+		(void) madvise(buf, src_file_len, MADV_SEQUENTIAL);
+	} else {
+		ssize_t readlen;
+
+		buf = (char *) mmap(nullptr,
+				    src_file_len,
+				    PROT_READ | PROT_WRITE,
+				    MAP_PRIVATE | MAP_ANONYMOUS,
+				    -1,
+				    0);
+		if (buf == MAP_FAILED) {
+			PERROR("Error allocating input buffer");
+			return -1;
+		}
+
+		readlen = lttng_read(fd_src, buf, src_file_len);
+		if (readlen < 0) {
+			PERROR("Error reading input file");
+			ret = -1;
+			goto end;
+		}
 	}
 
 	prod_offset = crash_get_field(layout, buf, prod_offset);
@@ -883,28 +1108,44 @@ static int copy_crash_data(const struct lttng_crash_layout *layout, int fd_dest,
 	subbuf_size = layout->subbuf_size;
 
 	for (offset = consumed_offset; offset < prod_offset; offset += subbuf_size) {
-		ret = copy_crash_subbuf(layout, fd_dest, buf, offset);
-		if (!ret) {
-			has_data = 1;
+		struct iovec packet;
+
+		ret = copy_crash_subbuf(layout, buf, offset, &packet);
+		if (ret == -ENODATA) {
+			break;
+		} else if (ret < 0) {
+			goto end;
+		} else if (ret > 0) {
+			continue;
 		}
-		if (ret) {
+
+		/* Coalesce packets which are contiguous in the source file. */
+		if (!packets.empty() &&
+		    (char *) packets.back().iov_base + packets.back().iov_len ==
+			    packet.iov_base) {
+			packets.back().iov_len += packet.iov_len;
+			continue;
+		}
+
+		try {
+			packets.push_back(packet);
+		} catch (const std::bad_alloc&) {
+			ERR("Failed to allocate packet list");
+			ret = -1;
 			goto end;
 		}
 	}
+
+	ret = packets.empty() ? -ENODATA : write_packets(fd_dest, packets);
 end:
-	free(buf);
-	if (ret && ret != -ENODATA) {
-		return ret;
-	}
-	if (has_data) {
-		return 0;
-	} else {
-		return -ENODATA;
+	if (munmap(buf, src_file_len)) {
+		PERROR("munmap");
 	}
+
+	return ret;
 }
 
-static int
-extract_file(int output_dir_fd, const char *output_file, int input_dir_fd, const char *input_file)
+static int extract_file(const char *output_file, const char *input_file)
 {
 	int fd_dest, fd_src, ret = 0, closeret;
 	struct lttng_crash_layout layout;
@@ -912,7 +1153,7 @@ extract_file(int output_dir_fd, const char *output_file, int input_dir_fd, const
 	layout.reverse_byte_order = 0; /* For reading magic number */
 
 	DBG("Extract file '%s'", input_file);
-	fd_src = openat(input_dir_fd, input_file, O_RDONLY);
+	fd_src = open(input_file, O_RDONLY);
 	if (fd_src < 0) {
 		PERROR("Error opening '%s' for reading", input_file);
 		ret = -1;
@@ -925,10 +1166,8 @@ extract_file(int output_dir_fd, const char *output_file, int input_dir_fd, const
 		goto close_src;
 	}
 
-	fd_dest = openat(output_dir_fd,
-			 output_file,
-			 O_RDWR | O_CREAT | O_EXCL,
-			 S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+	fd_dest = open(
+		output_file, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
 	if (fd_dest < 0) {
 		PERROR("Error opening '%s' for writing", output_file);
 		ret = -1;
@@ -946,9 +1185,9 @@ close_dest:
 		PERROR("close");
 	}
 	if (ret == -ENODATA) {
-		closeret = unlinkat(output_dir_fd, output_file, 0);
+		closeret = unlink(output_file);
 		if (closeret) {
-			PERROR("unlinkat");
+			PERROR("unlink");
 		}
 	}
 close_src:
@@ -960,10 +1199,14 @@ end:
 	return ret;
 }
 
-static int extract_all_files(const char *output_path, const char *input_path)
+/*
+ * Queue the extraction of every file of a trace directory. The files are
+ * extracted later on by run_extraction_jobs().
+ */
+static int queue_all_files(const char *output_path, const char *input_path)
 {
-	DIR *input_dir, *output_dir;
-	int input_dir_fd, output_dir_fd, ret = 0, closeret;
+	DIR *input_dir;
+	int ret = 0, closeret;
 	struct dirent *entry; /* input */
 
 	/* Open input directory */
@@ -972,44 +1215,24 @@ static int extract_all_files(const char *output_path, const char *input_path)
 		PERROR("Cannot open '%s' path", input_path);
 		return -1;
 	}
-	input_dir_fd = dirfd(input_dir);
-	if (input_dir_fd < 0) {
-		PERROR("dirfd");
-		return -1;
-	}
-
-	/* Open output directory */
-	output_dir = opendir(output_path);
-	if (!output_dir) {
-		PERROR("Cannot open '%s' path", output_path);
-		return -1;
-	}
-	output_dir_fd = dirfd(output_dir);
-	if (output_dir_fd < 0) {
-		PERROR("dirfd");
-		return -1;
-	}
 
 	while ((entry = readdir(input_dir))) {
-		if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+		if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..") ||
+		    !strcmp(entry->d_name, "metadata")) {
 			continue;
-		ret = extract_file(output_dir_fd, entry->d_name, input_dir_fd, entry->d_name);
-		if (ret == -ENODATA) {
-			DBG("No data in file '%s', skipping", entry->d_name);
-			ret = 0;
-			continue;
-		} else if (ret < 0) {
+		}
+
+		try {
+			the_extraction_jobs.push_back(
+				{ std::string(output_path) + "/" + entry->d_name,
+				  std::string(input_path) + "/" + entry->d_name });
+		} catch (const std::bad_alloc&) {
+			ERR("Failed to queue the extraction of '%s/%s'", input_path, entry->d_name);
+			ret = -1;
 			break;
-		} else if (ret > 0) {
-			DBG("Skipping file '%s'", entry->d_name);
-			ret = 0;
-			continue;
 		}
 	}
-	closeret = closedir(output_dir);
-	if (closeret) {
-		PERROR("closedir");
-	}
+
 	closeret = closedir(input_dir);
 	if (closeret) {
 		PERROR("closedir");
@@ -1017,6 +1240,80 @@ static int extract_all_files(const char *output_path, const char *input_path)
 	return ret;
 }
 
+static int run_extraction_job(const extraction_job& job)
+{
+	const int ret = extract_file(job.output_path.c_str(), job.input_path.c_str());
+
+	if (ret == -ENODATA) {
+		DBG("No data in file '%s', skipping", job.input_path.c_str());
+		return 0;
+	} else if (ret > 0) {
+		DBG("Skipping file '%s'", job.input_path.c_str());
+		return 0;
+	} else if (ret < 0) {
+		WARN("Error extracting '%s', continuing anyway.", job.input_path.c_str());
+	}
+
+	return ret;
+}
+
+/*
+ * Extract the queued files using up to `--jobs` threads (the number of
+ * online CPUs by default). The files are independent: each thread takes the
+ * next pending job until none are left.
+ *
+ * Return the number of files that could not be extracted.
+ */
+static unsigned int run_extraction_jobs()
+{
+	std::atomic<size_t> next_job_index(0);
+	std::atomic<unsigned int> failed_job_count(0);
+	std::vector<std::thread> threads;
+	unsigned int thread_count = opt_jobs;
+
+	if (thread_count == 0) {
+		const long online_cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+		thread_count = online_cpu_count > 0 ? (unsigned int) online_cpu_count : 1;
+	}
+
+	thread_count = std::min<size_t>(thread_count, the_extraction_jobs.size());
+	DBG("Extracting %zu files using %u threads", the_extraction_jobs.size(), thread_count);
+
+	const auto extract = [&next_job_index, &failed_job_count]() {
+		for (;;) {
+			const auto job_index = next_job_index.fetch_add(1);
+
+			if (job_index >= the_extraction_jobs.size()) {
+				break;
+			}
+
+			if (run_extraction_job(the_extraction_jobs[job_index])) {
+				failed_job_count++;
+			}
+		}
+	};
+
+	/* The calling thread is part of the pool. */
+	for (unsigned int i = 1; i < thread_count; i++) {
+		try {
+			threads.emplace_back(extract);
+		} catch (const std::exception& ex) {
+			WARN("Failed to launch extraction thread, continuing with %zu threads: %s",
+			     threads.size() + 1,
+			     ex.what());
+			break;
+		}
+	}
+
+	extract();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	return failed_job_count;
+}
+
 static int extract_one_trace(const char *output_path, const char *input_path)
 {
 	char dest[PATH_MAX], src[PATH_MAX];
@@ -1039,7 +1336,7 @@ static int extract_one_trace(const char *output_path, const char *input_path)
 	}
 
 	/* Extract each other file that has expected header */
-	return extract_all_files(output_path, input_path);
+	return queue_all_files(output_path, input_path);
 }
 
 static int extract_trace_recursive(const char *output_path, const char *input_path)
@@ -1319,6 +1616,11 @@ int main(int argc, char *argv[])
 		/* extract_trace_recursive reported a warning. */
 		has_warning = true;
 	}
+
+	if (run_extraction_jobs()) {
+		has_warning = true;
+	}
+
 	if (!opt_output_path) {
 		/* View trace */
 		ret = view_trace(output_path, opt_viewer_path);
@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#define _LGPL_SOURCE
+#include "cmd-2-11.hpp"
+#include "cmd-2-16.hpp"
+
+#include <common/common.hpp>
+#include <common/sessiond-comm/relayd.hpp>
+
+#include <inttypes.h>
+
+/*
+ * cmd_recv_stream_2_16 allocates path_name and channel_name.
+ */
+int cmd_recv_stream_2_16(const struct lttng_buffer_view *payload,
+			 char **ret_path_name,
+			 char **ret_channel_name,
+			 uint64_t *tracefile_size,
+			 uint64_t *tracefile_count,
+			 uint64_t *trace_archive_id,
+			 uint8_t *compression_codec)
+{
+	int ret;
+	const size_t codec_len = member_sizeof(struct lttcomm_relayd_add_stream_2_16,
+					       compression_codec);
+	struct lttng_buffer_view stream_2_11_view;
+
+	if (payload->size < sizeof(struct lttcomm_relayd_add_stream_2_16)) {
+		ERR("Unexpected payload size in \"cmd_recv_stream_2_16\": expected >= %zu bytes, got %zu bytes",
+		    sizeof(struct lttcomm_relayd_add_stream_2_16),
+		    payload->size);
+		ret = -1;
+		goto error;
+	}
+
+	/* The rest of the message is a 2.11 message. */
+	stream_2_11_view = lttng_buffer_view_from_view(payload, codec_len, -1);
+	ret = cmd_recv_stream_2_11(&stream_2_11_view,
+				   ret_path_name,
+				   ret_channel_name,
+				   tracefile_size,
+				   tracefile_count,
+				   trace_archive_id);
+	if (ret) {
+		goto error;
+	}
+
+	memcpy(compression_codec,
+	       payload->data + offsetof(struct lttcomm_relayd_add_stream_2_16, compression_codec),
+	       codec_len);
+error:
+	return ret;
+}
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef RELAYD_CMD_2_16_H
+#define RELAYD_CMD_2_16_H
+
+#include <common/buffer-view.hpp>
+
+#include <inttypes.h>
+
+int cmd_recv_stream_2_16(const struct lttng_buffer_view *payload,
+			 char **ret_path_name,
+			 char **ret_channel_name,
+			 uint64_t *tracefile_size,
+			 uint64_t *tracefile_count,
+			 uint64_t *trace_archive_id,
+			 uint8_t *compression_codec);
+
+#endif /* RELAYD_CMD_2_16_H */
@@ -9,6 +9,7 @@
 
 #define _LGPL_SOURCE
 #include "connection.hpp"
+#include "metrics-relayd.hpp"
 #include "stream.hpp"
 #include "viewer-session.hpp"
 
@@ -90,6 +91,12 @@ struct relay_connection *connection_create(struct lttcomm_sock *sock, enum conne
 		PERROR("zmalloc relay connection");
 		goto end;
 	}
+	conn->metrics = relay_metrics_register_connection(type, sock->fd);
+	if (!conn->metrics) {
+		free(conn);
+		conn = nullptr;
+		goto end;
+	}
 	urcu_ref_init(&conn->ref);
 	conn->type = type;
 	conn->sock = sock;
@@ -115,6 +122,7 @@ static void rcu_free_connection(struct rcu_head *head)
 	if (conn->type == RELAY_CONTROL) {
 		lttng_dynamic_buffer_reset(&conn->protocol.ctrl.reception_buffer);
 	}
+	relay_metrics_unregister_connection(conn->metrics);
 	free(conn);
 }
 
@@ -173,6 +181,7 @@ int connection_set_session(struct relay_connection *conn, struct relay_session *
 	if (connection_get(conn)) {
 		if (session_get(session)) {
 			conn->session = session;
+			conn->metrics->session_id.store(session->id, std::memory_order_relaxed);
 		} else {
 			ERR("Failed to get session reference in connection_set_session()");
 			ret = -1;
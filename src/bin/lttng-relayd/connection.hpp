@@ -24,6 +24,8 @@
 #include <urcu/list.h>
 #include <urcu/wfcqueue.h>
 
+struct relay_connection_metrics;
+
 enum connection_type {
 	RELAY_CONNECTION_UNKNOWN = 0,
 	RELAY_DATA = 1,
@@ -102,6 +104,12 @@ struct relay_connection {
 
 	bool version_check_done;
 
+	/*
+	 * Performance counters of the connection, owned by the connection
+	 * registry of the metrics thread.
+	 */
+	struct relay_connection_metrics *metrics;
+
 	/*
 	 * Node member of connection within global socket hash table.
 	 */
@@ -423,5 +423,9 @@ int relay_index_set_control_data(struct relay_index *index,
 		index->index_data.packet_seq_num = htobe64(unset_value);
 	}
 
+	/* Packets are written verbatim: the stored size is the received data size. */
+	index->index_data.stored_size = htobe64(data->stored_size);
+	index->index_data.compression_codec = data->compression_codec;
+
 	return relay_index_set_data(index, &index_data);
 }
@@ -14,6 +14,7 @@
 #include "health-relayd.hpp"
 #include "live.hpp"
 #include "lttng-relayd.hpp"
+#include "metrics-relayd.hpp"
 #include "session.hpp"
 #include "stream.hpp"
 #include "testpoint.hpp"
@@ -46,6 +47,7 @@
 
 #include <vendor/optional.hpp>
 
+#include <chrono>
 #include <fcntl.h>
 #include <getopt.h>
 #include <grp.h>
@@ -1172,6 +1174,8 @@ static int viewer_connect(struct relay_connection *conn)
 		goto end;
 	}
 
+	conn->metrics->type.store(conn->type, std::memory_order_relaxed);
+
 	reply.major = htobe32(reply.major);
 	reply.minor = htobe32(reply.minor);
 	if (conn->type == RELAY_VIEWER_COMMAND) {
@@ -2214,6 +2218,10 @@ send_reply:
 		viewer_index.flags |= LTTNG_VIEWER_FLAG_NEW_STREAM;
 	}
 
+	if (viewer_index.status == LTTNG_VIEWER_INDEX_RETRY) {
+		conn->metrics->viewer_index_retries.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	viewer_index.flags = htobe32(viewer_index.flags);
 	viewer_index.status = htobe32(viewer_index.status);
 	health_code_update();
@@ -2355,6 +2363,7 @@ send_reply_nolock:
 	}
 
 	DBG("Sent %u bytes for stream %" PRIu64, reply_size, stream_id);
+	conn->metrics->sent_bytes.fetch_add(reply_size, std::memory_order_relaxed);
 
 end_free:
 	free(reply);
@@ -2775,6 +2784,7 @@ static int process_control(struct lttng_viewer_cmd *recv_hdr, struct relay_conne
 {
 	int ret = 0;
 	const lttng_viewer_command cmd = (lttng_viewer_command) be32toh(recv_hdr->cmd);
+	const auto command_begin_time = std::chrono::steady_clock::now();
 
 	/*
 	 * Make sure we've done the version check before any command other then
@@ -2827,6 +2837,8 @@ static int process_control(struct lttng_viewer_cmd *recv_hdr, struct relay_conne
 		goto end;
 	}
 
+	conn->metrics->command_time.record(std::chrono::steady_clock::now() - command_begin_time);
+	conn->metrics->processed_messages.fetch_add(1, std::memory_order_relaxed);
 end:
 	return ret;
 }
@@ -2964,6 +2976,10 @@ restart:
 				if (revents & LPOLLIN) {
 					ret = conn->sock->ops->recvmsg(
 						conn->sock, &recv_hdr, sizeof(recv_hdr), 0);
+					if (ret > 0) {
+						conn->metrics->received_bytes.fetch_add(
+							ret, std::memory_order_relaxed);
+					}
 					if (ret <= 0) {
 						/* Connection closed. */
 						cleanup_connection_pollfd(&events, pollfd);
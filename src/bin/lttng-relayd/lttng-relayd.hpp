@@ -50,6 +50,7 @@ extern char *opt_output_path;
 extern const char *tracing_group_name;
 extern const char *const config_section_name;
 extern enum relay_group_output_by opt_group_output_by;
+extern int opt_disable_metrics;
 
 extern struct fd_tracker *the_fd_tracker;
 
@@ -14,6 +14,7 @@
 #include "connection.hpp"
 #include "ctf-trace.hpp"
 #include "health-relayd.hpp"
+#include "metrics-relayd.hpp"
 #include "index.hpp"
 #include "live.hpp"
 #include "lttng-relayd.hpp"
@@ -57,6 +58,7 @@
 #include <lttng/lttng.h>
 
 #include <algorithm>
+#include <chrono>
 #include <ctype.h>
 #include <fcntl.h>
 #include <getopt.h>
@@ -101,6 +103,7 @@ enum relay_connection_status {
 char *opt_output_path, *opt_working_directory, *opt_pid_file = nullptr;
 static int opt_daemon, opt_background, opt_print_version,
 	opt_allow_clear = 1, opt_dynamic_port_allocation = 0, opt_sig_parent = 0;
+int opt_disable_metrics;
 enum relay_group_output_by opt_group_output_by = RELAYD_GROUP_OUTPUT_BY_UNKNOWN;
 
 /* Argument variables */
@@ -110,9 +113,9 @@ int lttng_opt_mi; /* not static in error.h */
 
 /*
  * We need to wait for listener and live listener threads, as well as
- * health check thread, before being ready to signal readiness.
+ * health check and metrics threads, before being ready to signal readiness.
  */
-#define NR_LTTNG_RELAY_READY 3
+#define NR_LTTNG_RELAY_READY 4
 static int lttng_relay_ready = NR_LTTNG_RELAY_READY;
 
 /* Size of receive buffer. */
@@ -145,6 +148,7 @@ static pthread_t listener_thread;
 static pthread_t dispatcher_thread;
 static pthread_t worker_thread;
 static pthread_t health_thread;
+static pthread_t metrics_thread;
 
 /*
  * last_relay_stream_id_lock protects last_relay_stream_id increment
@@ -268,6 +272,7 @@ static struct option long_options[] = {
 	},
 	{ "disallow-clear", 0, nullptr, 'x' },
 	{ "dynamic-port-allocation", 0, nullptr, '\0' },
+	{ "disable-metrics", 0, nullptr, '\0' },
 	{ "sig-parent", 0, nullptr, 'S' },
 	{
 		nullptr,
@@ -328,6 +333,8 @@ static int set_option(int opt, const char *arg, const char *optname)
 			lttng_opt_fd_pool_size = (unsigned int) v;
 		} else if (!strcmp(optname, "dynamic-port-allocation")) {
 			opt_dynamic_port_allocation = 1;
+		} else if (!strcmp(optname, "disable-metrics")) {
+			opt_disable_metrics = 1;
 		} else {
 			fprintf(stderr, "unknown option %s", optname);
 			if (arg) {
@@ -815,6 +822,9 @@ static void relayd_cleanup()
 	if (health_quit_pipe[0] != -1) {
 		(void) fd_tracker_util_pipe_close(the_fd_tracker, health_quit_pipe);
 	}
+	if (metrics_quit_pipe[0] != -1) {
+		(void) fd_tracker_util_pipe_close(the_fd_tracker, metrics_quit_pipe);
+	}
 	relayd_close_thread_quit_pipe();
 	if (sessiond_trace_chunk_registry) {
 		sessiond_trace_chunk_registry_destroy(sessiond_trace_chunk_registry);
@@ -876,6 +886,10 @@ int lttng_relay_stop_threads()
 		ERR("write error on health quit pipe");
 	}
 
+	if (notify_health_quit_pipe(metrics_quit_pipe)) {
+		ERR("write error on metrics quit pipe");
+	}
+
 	/* Dispatch thread */
 	CMM_STORE_SHARED(dispatch_thread_exit, 1);
 	futex_nto1_wake(&relay_conn_queue.futex);
@@ -1002,6 +1016,17 @@ static int init_health_quit_pipe()
 		the_fd_tracker, "Health quit pipe", health_quit_pipe);
 }
 
+/*
+ * Init metrics quit pipe.
+ *
+ * Return -1 on error or 0 if all pipes are created.
+ */
+static int init_metrics_quit_pipe()
+{
+	return fd_tracker_util_pipe_open_cloexec(
+		the_fd_tracker, "Metrics quit pipe", metrics_quit_pipe);
+}
+
 static int create_sock(void *data, int *out_fd)
 {
 	int ret;
@@ -1788,6 +1813,7 @@ static int relay_add_stream(const struct lttcomm_relayd_hdr *recv_hdr __attribut
 	char *path_name = nullptr, *channel_name = nullptr;
 	uint64_t tracefile_size = 0, tracefile_count = 0;
 	LTTNG_OPTIONAL(uint64_t) stream_chunk_id = {};
+	uint8_t compression_codec = 0;
 
 	if (!session || !conn->version_check_done) {
 		ERR("Trying to add a stream before version check");
@@ -1802,8 +1828,8 @@ static int relay_add_stream(const struct lttcomm_relayd_hdr *recv_hdr __attribut
 		/* From 2.2 to 2.10 */
 		ret = cmd_recv_stream_2_2(
 			payload, &path_name, &channel_name, &tracefile_size, &tracefile_count);
-	} else {
-		/* From 2.11 to ... */
+	} else if (session->minor < 16) {
+		/* From 2.11 to 2.15 */
 		ret = cmd_recv_stream_2_11(payload,
 					   &path_name,
 					   &channel_name,
@@ -1811,6 +1837,16 @@ static int relay_add_stream(const struct lttcomm_relayd_hdr *recv_hdr __attribut
 					   &tracefile_count,
 					   &stream_chunk_id.value);
 		stream_chunk_id.is_set = true;
+	} else {
+		/* From 2.16 to ... */
+		ret = cmd_recv_stream_2_16(payload,
+					   &path_name,
+					   &channel_name,
+					   &tracefile_size,
+					   &tracefile_count,
+					   &stream_chunk_id.value,
+					   &compression_codec);
+		stream_chunk_id.is_set = true;
 	}
 
 	if (ret < 0) {
@@ -1877,8 +1913,13 @@ static int relay_add_stream(const struct lttcomm_relayd_hdr *recv_hdr __attribut
 	pthread_mutex_unlock(&last_relay_stream_id_lock);
 
 	/* We pass ownership of path_name and channel_name. */
-	stream = stream_create(
-		trace, stream_handle, path_name, channel_name, tracefile_size, tracefile_count);
+	stream = stream_create(trace,
+			       stream_handle,
+			       path_name,
+			       channel_name,
+			       tracefile_size,
+			       tracefile_count,
+			       compression_codec != 0);
 	path_name = nullptr;
 	channel_name = nullptr;
 
@@ -2594,8 +2635,7 @@ static int relay_recv_index(const struct lttcomm_relayd_hdr *recv_hdr __attribut
 		goto end_no_session;
 	}
 
-	msg_len = lttcomm_relayd_index_len(lttng_to_index_major(conn->major, conn->minor),
-					   lttng_to_index_minor(conn->major, conn->minor));
+	msg_len = lttcomm_relayd_index_msg_len(conn->major, conn->minor);
 	if (payload->size < msg_len) {
 		ERR("Unexpected payload size in \"relay_recv_index\": expected >= %zu bytes, got %zu bytes",
 		    msg_len,
@@ -2621,6 +2661,14 @@ static int relay_recv_index(const struct lttcomm_relayd_hdr *recv_hdr __attribut
 		index_info.packet_seq_num = -1ULL;
 	}
 
+	if (conn->minor >= 16) {
+		index_info.stored_size = be64toh(index_info.stored_size);
+	} else {
+		/* Packets are never compressed before 2.16. */
+		index_info.stored_size = index_info.packet_size / CHAR_BIT;
+		index_info.compression_codec = 0;
+	}
+
 	stream = stream_get_by_id(index_info.relay_stream_id);
 	if (!stream) {
 		ERR("stream_get_by_id not found");
@@ -3578,6 +3626,7 @@ relay_process_control_receive_payload(struct relay_connection *conn)
 	struct ctrl_connection_state_receive_payload *state =
 		&conn->protocol.ctrl.state.receive_payload;
 	struct lttng_buffer_view payload_view;
+	std::chrono::steady_clock::time_point command_begin_time;
 
 	if (state->left_to_receive == 0) {
 		/* Short-circuit for payload-less commands. */
@@ -3608,6 +3657,7 @@ relay_process_control_receive_payload(struct relay_connection *conn)
 
 	state->left_to_receive -= ret;
 	state->received += ret;
+	conn->metrics->received_bytes.fetch_add(ret, std::memory_order_relaxed);
 
 	if (state->left_to_receive > 0) {
 		/*
@@ -3634,7 +3684,10 @@ reception_complete:
 	 * Commands are responsible for sending their reply to the peer.
 	 */
 	payload_view = lttng_buffer_view_from_dynamic_buffer(reception_buffer, 0, -1);
+	command_begin_time = std::chrono::steady_clock::now();
 	ret = relay_process_control_command(conn, &state->header, &payload_view);
+	conn->metrics->command_time.record(std::chrono::steady_clock::now() - command_begin_time);
+	conn->metrics->processed_messages.fetch_add(1, std::memory_order_relaxed);
 	if (ret < 0) {
 		status = RELAY_CONNECTION_STATUS_ERROR;
 		goto end;
@@ -3685,6 +3738,7 @@ relay_process_control_receive_header(struct relay_connection *conn)
 
 	state->left_to_receive -= ret;
 	state->received += ret;
+	conn->metrics->received_bytes.fetch_add(ret, std::memory_order_relaxed);
 
 	if (state->left_to_receive > 0) {
 		/*
@@ -3800,6 +3854,7 @@ static enum relay_connection_status relay_process_data_receive_header(struct rel
 
 	state->left_to_receive -= ret;
 	state->received += ret;
+	conn->metrics->received_bytes.fetch_add(ret, std::memory_order_relaxed);
 
 	if (state->left_to_receive > 0) {
 		/*
@@ -3941,6 +3996,7 @@ relay_process_data_receive_payload(struct relay_connection *conn)
 			recv_size = ret;
 		}
 
+		conn->metrics->received_bytes.fetch_add(recv_size, std::memory_order_relaxed);
 		packet_chunk = lttng_buffer_view_init(data_buffer, 0, recv_size);
 		LTTNG_ASSERT(packet_chunk.data);
 
@@ -4004,6 +4060,7 @@ relay_process_data_receive_payload(struct relay_connection *conn)
 		status = RELAY_CONNECTION_STATUS_ERROR;
 		goto end_stream_unlock;
 	}
+	conn->metrics->processed_messages.fetch_add(1, std::memory_order_relaxed);
 
 	/*
 	 * Resetting the protocol state (to RECEIVE_HEADER) will trash the
@@ -4639,6 +4696,12 @@ int main(int argc, char **argv)
 		goto exit_options;
 	}
 
+	ret = init_metrics_quit_pipe();
+	if (ret) {
+		retval = -1;
+		goto exit_options;
+	}
+
 	/* Create thread to manage the client socket */
 	ret = pthread_create(&health_thread,
 			     default_pthread_attr(),
@@ -4651,6 +4714,18 @@ int main(int argc, char **argv)
 		goto exit_options;
 	}
 
+	/* Create thread to manage the metrics socket */
+	ret = pthread_create(&metrics_thread,
+			     default_pthread_attr(),
+			     thread_manage_metrics_relayd,
+			     (void *) nullptr);
+	if (ret) {
+		errno = ret;
+		PERROR("pthread_create metrics");
+		retval = -1;
+		goto exit_metrics_thread;
+	}
+
 	/* Setup the dispatcher thread */
 	ret = pthread_create(&dispatcher_thread,
 			     default_pthread_attr(),
@@ -4724,6 +4799,14 @@ exit_worker_thread:
 	}
 exit_dispatcher_thread:
 
+	ret = pthread_join(metrics_thread, &status);
+	if (ret) {
+		errno = ret;
+		PERROR("pthread_join metrics_thread");
+		retval = -1;
+	}
+exit_metrics_thread:
+
 	ret = pthread_join(health_thread, &status);
 	if (ret) {
 		errno = ret;
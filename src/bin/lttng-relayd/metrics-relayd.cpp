@@ -0,0 +1,712 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#define _LGPL_SOURCE
+#include "ctf-trace.hpp"
+#include "lttng-relayd.hpp"
+#include "metrics-relayd.hpp"
+#include "session.hpp"
+#include "stream.hpp"
+#include "unix-socket-server.hpp"
+#include "utils.hpp"
+
+#include <common/common.hpp>
+#include <common/compat/getenv.hpp>
+#include <common/defaults.hpp>
+#include <common/exception.hpp>
+#include <common/fd-tracker/fd-tracker.hpp>
+#include <common/format.hpp>
+#include <common/make-unique-wrapper.hpp>
+#include <common/make-unique.hpp>
+#include <common/sessiond-comm/sessiond-comm.hpp>
+#include <common/urcu.hpp>
+#include <common/utils.hpp>
+
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+int metrics_quit_pipe[2] = { -1, -1 };
+
+namespace {
+/* Global metrics unix path */
+char metrics_unix_sock_path[PATH_MAX];
+
+/*
+ * Registry of the performance counters of the live connections of the
+ * relay daemon, indexed by connection ID.
+ *
+ * Connections are owned by the thread that accepted them and kept in
+ * per-thread hash tables; this registry allows the metrics thread to
+ * walk all of them.
+ */
+std::mutex connection_registry_lock;
+std::map<uint64_t, std::unique_ptr<relay_connection_metrics>> connection_registry;
+uint64_t next_connection_id;
+
+/*
+ * Held while streams leave the stream hash table, and while the metrics
+ * thread walks it. Also protects the totals of the retired streams of the
+ * sessions.
+ */
+std::mutex stream_retirement_lock;
+
+using duration_snapshot = lttng::log2_duration_histogram::snapshot;
+
+struct session_sample {
+	std::string labels;
+	uint64_t stream_count = 0;
+	uint64_t written_bytes = 0;
+	uint64_t received_packets = 0;
+	uint64_t received_indexes = 0;
+};
+
+struct stream_sample {
+	std::string labels;
+	uint64_t written_bytes;
+	uint64_t received_packets;
+	uint64_t received_indexes;
+	uint64_t received_beacons;
+	duration_snapshot write_time;
+};
+
+struct connection_sample {
+	std::string labels;
+	uint64_t received_bytes;
+	uint64_t sent_bytes;
+	uint64_t processed_messages;
+	uint64_t viewer_index_retries;
+	duration_snapshot command_time;
+};
+
+const char *connection_type_str(enum connection_type type)
+{
+	switch (type) {
+	case RELAY_DATA:
+		return "data";
+	case RELAY_CONTROL:
+		return "control";
+	case RELAY_VIEWER_COMMAND:
+		return "viewer_command";
+	case RELAY_VIEWER_NOTIFICATION:
+		return "viewer_notification";
+	case RELAY_CONNECTION_UNKNOWN:
+	default:
+		return "unknown";
+	}
+}
+
+/* Format the address of the peer of a connected socket, empty if unknown. */
+std::string peer_address(int sock_fd)
+{
+	struct sockaddr_storage addr = {};
+	socklen_t addr_len = sizeof(addr);
+	char address_str[INET6_ADDRSTRLEN];
+
+	if (getpeername(sock_fd, (struct sockaddr *) &addr, &addr_len) < 0) {
+		return "";
+	}
+
+	switch (addr.ss_family) {
+	case AF_INET:
+	{
+		const auto *addr_in = (const struct sockaddr_in *) &addr;
+
+		if (!inet_ntop(AF_INET, &addr_in->sin_addr, address_str, sizeof(address_str))) {
+			return "";
+		}
+
+		return fmt::format("{}:{}", address_str, ntohs(addr_in->sin_port));
+	}
+	case AF_INET6:
+	{
+		const auto *addr_in6 = (const struct sockaddr_in6 *) &addr;
+
+		if (!inet_ntop(AF_INET6, &addr_in6->sin6_addr, address_str, sizeof(address_str))) {
+			return "";
+		}
+
+		return fmt::format("[{}]:{}", address_str, ntohs(addr_in6->sin6_port));
+	}
+	default:
+		return "";
+	}
+}
+
+/* Escape a label value as per the Prometheus text exposition format. */
+std::string escape_label_value(const char *value)
+{
+	std::string escaped;
+
+	for (const char *c = value; *c; c++) {
+		switch (*c) {
+		case '\\':
+			escaped += "\\\\";
+			break;
+		case '"':
+			escaped += "\\\"";
+			break;
+		case '\n':
+			escaped += "\\n";
+			break;
+		default:
+			escaped += *c;
+			break;
+		}
+	}
+
+	return escaped;
+}
+
+void append_family_header(std::string& document,
+			  const char *name,
+			  const char *type,
+			  const char *help)
+{
+	fmt::format_to(std::back_inserter(document),
+		       "# HELP {0} {1}\n# TYPE {0} {2}\n",
+		       name,
+		       help,
+		       type);
+}
+
+void append_sample(std::string& document,
+		   const char *name,
+		   const std::string& labels,
+		   uint64_t value)
+{
+	fmt::format_to(std::back_inserter(document), "{}{{{}}} {}\n", name, labels, value);
+}
+
+void append_sample(std::string& document, const char *name, uint64_t value)
+{
+	fmt::format_to(std::back_inserter(document), "{} {}\n", name, value);
+}
+
+/*
+ * Append a family of counters (or gauges), one sample per entry of
+ * `samples`, the value of which is returned by `get_value`.
+ */
+template <typename SampleType, typename GetValueType>
+void append_family(std::string& document,
+		   const char *name,
+		   const char *type,
+		   const char *help,
+		   const std::vector<SampleType>& samples,
+		   GetValueType get_value)
+{
+	append_family_header(document, name, type, help);
+	for (const auto& sample : samples) {
+		append_sample(document, name, sample.labels, get_value(sample));
+	}
+}
+
+/*
+ * Append a summary family of durations (nanoseconds), exposing the median,
+ * the 99th percentile, and the maximum of each sample.
+ */
+template <typename SampleType, typename GetSnapshotType>
+void append_duration_family(std::string& document,
+			    const char *name,
+			    const char *help,
+			    const std::vector<SampleType>& samples,
+			    GetSnapshotType get_snapshot)
+{
+	append_family_header(document, name, "summary", help);
+	for (const auto& sample : samples) {
+		const duration_snapshot& snapshot = get_snapshot(sample);
+		const auto separator = sample.labels.empty() ? "" : ",";
+
+		fmt::format_to(std::back_inserter(document),
+			       "{0}{{{1}{2}quantile=\"0.5\"}} {3}\n"
+			       "{0}{{{1}{2}quantile=\"0.99\"}} {4}\n"
+			       "{0}{{{1}{2}quantile=\"1\"}} {5}\n"
+			       "{0}_sum{{{1}}} {6}\n"
+			       "{0}_count{{{1}}} {7}\n",
+			       name,
+			       sample.labels,
+			       separator,
+			       snapshot.quantile_upper_bound(0.5),
+			       snapshot.quantile_upper_bound(0.99),
+			       snapshot.max(),
+			       snapshot.sum(),
+			       snapshot.count());
+	}
+}
+
+void append_fd_tracker_metrics(std::string& document)
+{
+	struct fd_tracker_stats stats;
+
+	fd_tracker_get_stats(the_fd_tracker, &stats);
+
+	append_family_header(document,
+			     "lttng_relayd_fd_tracker_uses_total",
+			     "counter",
+			     "Uses of suspendable file system handles.");
+	append_sample(document, "lttng_relayd_fd_tracker_uses_total", stats.uses);
+	append_family_header(document,
+			     "lttng_relayd_fd_tracker_misses_total",
+			     "counter",
+			     "Uses of file system handles which required their file to be reopened.");
+	append_sample(document, "lttng_relayd_fd_tracker_misses_total", stats.misses);
+	append_family_header(document,
+			     "lttng_relayd_fd_tracker_errors_total",
+			     "counter",
+			     "Failures to suspend or restore file system handles.");
+	append_sample(document, "lttng_relayd_fd_tracker_errors_total", stats.errors);
+	append_family_header(document,
+			     "lttng_relayd_fd_tracker_fds",
+			     "gauge",
+			     "File descriptors tracked by the file descriptor tracker.");
+	append_sample(document,
+		      "lttng_relayd_fd_tracker_fds",
+		      "state=\"active_suspendable\"",
+		      stats.active_suspendable);
+	append_sample(
+		document, "lttng_relayd_fd_tracker_fds", "state=\"suspended\"", stats.suspended);
+	append_sample(document,
+		      "lttng_relayd_fd_tracker_fds",
+		      "state=\"unsuspendable\"",
+		      stats.unsuspendable);
+	append_family_header(document,
+			     "lttng_relayd_fd_tracker_capacity",
+			     "gauge",
+			     "Maximal number of file descriptors open simultaneously.");
+	append_sample(document, "lttng_relayd_fd_tracker_capacity", stats.capacity);
+}
+
+void append_object_count_metrics(std::string& document)
+{
+	const lttng::urcu::read_lock_guard read_lock;
+
+	append_family_header(
+		document, "lttng_relayd_objects", "gauge", "Objects known to the relay daemon.");
+	append_sample(document,
+		      "lttng_relayd_objects",
+		      "type=\"session\"",
+		      lttng_ht_get_count(sessions_ht));
+	append_sample(document,
+		      "lttng_relayd_objects",
+		      "type=\"stream\"",
+		      lttng_ht_get_count(relay_streams_ht));
+	append_sample(document,
+		      "lttng_relayd_objects",
+		      "type=\"viewer_session\"",
+		      lttng_ht_get_count(viewer_sessions_ht));
+	append_sample(document,
+		      "lttng_relayd_objects",
+		      "type=\"viewer_stream\"",
+		      lttng_ht_get_count(viewer_streams_ht));
+}
+
+/* Get the sample of a session, creating it from the session's retired streams. */
+session_sample& get_session_sample(std::map<uint64_t, session_sample>& sessions,
+				   const relay_session& session)
+{
+	auto& sample = sessions[session.id];
+
+	if (sample.labels.empty()) {
+		sample.labels =
+			fmt::format("session_id=\"{}\",session_name=\"{}\",hostname=\"{}\"",
+				    session.id,
+				    escape_label_value(session.session_name),
+				    escape_label_value(session.hostname));
+		sample.written_bytes = session.retired_streams_metrics.written_bytes;
+		sample.received_packets = session.retired_streams_metrics.received_packets;
+		sample.received_indexes = session.retired_streams_metrics.received_indexes;
+	}
+
+	return sample;
+}
+
+/* Sample the counters of the sessions and of their open streams. */
+void sample_streams(std::map<uint64_t, session_sample>& sessions,
+		    std::vector<stream_sample>& streams)
+{
+	const std::lock_guard<std::mutex> retirement_lock(stream_retirement_lock);
+	const lttng::urcu::read_lock_guard read_lock;
+
+	for (const auto *session :
+	     lttng::urcu::lfht_iteration_adapter<relay_session,
+						 decltype(relay_session::session_n),
+						 &relay_session::session_n>(*sessions_ht->ht)) {
+		get_session_sample(sessions, *session);
+	}
+
+	/*
+	 * No reference is taken on the streams: holding the retirement lock
+	 * guarantees that the streams found in the hash table still hold their
+	 * trace, and thus their session, even when they are being released.
+	 */
+	for (const auto *stream :
+	     lttng::urcu::lfht_iteration_adapter<relay_stream,
+						 decltype(relay_stream::node),
+						 &relay_stream::node>(*relay_streams_ht->ht)) {
+		const auto *session = stream->trace->session;
+		const auto& metrics = *stream->metrics;
+		const auto order = std::memory_order_relaxed;
+		auto& session_entry = get_session_sample(sessions, *session);
+
+		stream_sample sample = {
+			.labels = fmt::format("session_id=\"{}\",stream_id=\"{}\",channel=\"{}\"",
+					      session->id,
+					      stream->stream_handle,
+					      escape_label_value(stream->channel_name)),
+			.written_bytes = metrics.written_bytes.load(order),
+			.received_packets = metrics.received_packets.load(order),
+			.received_indexes = metrics.received_indexes.load(order),
+			.received_beacons = metrics.received_beacons.load(order),
+			.write_time = metrics.write_time.get_snapshot(),
+		};
+
+		session_entry.stream_count++;
+		session_entry.written_bytes += sample.written_bytes;
+		session_entry.received_packets += sample.received_packets;
+		session_entry.received_indexes += sample.received_indexes;
+		streams.emplace_back(std::move(sample));
+	}
+}
+
+void append_stream_metrics(std::string& document)
+{
+	std::map<uint64_t, session_sample> sessions;
+	std::vector<stream_sample> streams;
+
+	sample_streams(sessions, streams);
+
+	std::vector<session_sample> session_samples;
+	for (auto& session_entry : sessions) {
+		session_samples.emplace_back(std::move(session_entry.second));
+	}
+
+	append_family(document,
+		      "lttng_relayd_session_streams",
+		      "gauge",
+		      "Open streams of a relay session.",
+		      session_samples,
+		      [](const session_sample& sample) { return sample.stream_count; });
+	append_family(document,
+		      "lttng_relayd_session_written_bytes_total",
+		      "counter",
+		      "Bytes written to the trace files of a relay session, closed streams included.",
+		      session_samples,
+		      [](const session_sample& sample) { return sample.written_bytes; });
+	append_family(document,
+		      "lttng_relayd_session_received_packets_total",
+		      "counter",
+		      "Packets received for the streams of a relay session, closed streams included.",
+		      session_samples,
+		      [](const session_sample& sample) { return sample.received_packets; });
+	append_family(document,
+		      "lttng_relayd_session_received_indexes_total",
+		      "counter",
+		      "Indexes received for the streams of a relay session, closed streams included.",
+		      session_samples,
+		      [](const session_sample& sample) { return sample.received_indexes; });
+
+	append_family(document,
+		      "lttng_relayd_stream_written_bytes_total",
+		      "counter",
+		      "Bytes written to the trace files of a stream.",
+		      streams,
+		      [](const stream_sample& sample) { return sample.written_bytes; });
+	append_family(document,
+		      "lttng_relayd_stream_received_packets_total",
+		      "counter",
+		      "Packets received for a stream.",
+		      streams,
+		      [](const stream_sample& sample) { return sample.received_packets; });
+	append_family(document,
+		      "lttng_relayd_stream_received_indexes_total",
+		      "counter",
+		      "Indexes received for a stream.",
+		      streams,
+		      [](const stream_sample& sample) { return sample.received_indexes; });
+	append_family(document,
+		      "lttng_relayd_stream_received_beacons_total",
+		      "counter",
+		      "Live beacons received for a stream.",
+		      streams,
+		      [](const stream_sample& sample) { return sample.received_beacons; });
+	append_duration_family(document,
+			       "lttng_relayd_stream_write_duration_nanoseconds",
+			       "Duration of the writes of received data to the trace files of a stream.",
+			       streams,
+			       [](const stream_sample& sample) -> const duration_snapshot& {
+				       return sample.write_time;
+			       });
+}
+
+void append_connection_metrics(std::string& document)
+{
+	std::map<enum connection_type, uint64_t> connection_counts;
+	std::vector<connection_sample> connections;
+
+	{
+		const std::lock_guard<std::mutex> lock(connection_registry_lock);
+
+		for (const auto& entry : connection_registry) {
+			const auto& metrics = *entry.second;
+			const auto order = std::memory_order_relaxed;
+			const auto type = metrics.type.load(order);
+			const auto session_id = metrics.session_id.load(order);
+			auto labels = fmt::format("connection_id=\"{}\",type=\"{}\",peer=\"{}\"",
+						  metrics.id,
+						  connection_type_str(type),
+						  escape_label_value(metrics.peer.c_str()));
+
+			if (session_id != -1ULL) {
+				labels += fmt::format(",session_id=\"{}\"", session_id);
+			}
+
+			connection_counts[type]++;
+			connections.emplace_back(connection_sample{
+				.labels = std::move(labels),
+				.received_bytes = metrics.received_bytes.load(order),
+				.sent_bytes = metrics.sent_bytes.load(order),
+				.processed_messages = metrics.processed_messages.load(order),
+				.viewer_index_retries = metrics.viewer_index_retries.load(order),
+				.command_time = metrics.command_time.get_snapshot(),
+			});
+		}
+	}
+
+	append_family_header(document,
+			     "lttng_relayd_connections",
+			     "gauge",
+			     "Open connections of the relay daemon.");
+	for (const auto& count : connection_counts) {
+		append_sample(document,
+			      "lttng_relayd_connections",
+			      fmt::format("type=\"{}\"", connection_type_str(count.first)),
+			      count.second);
+	}
+
+	append_family(document,
+		      "lttng_relayd_connection_received_bytes_total",
+		      "counter",
+		      "Bytes received on a connection.",
+		      connections,
+		      [](const connection_sample& sample) { return sample.received_bytes; });
+	append_family(document,
+		      "lttng_relayd_connection_sent_bytes_total",
+		      "counter",
+		      "Bytes of packet replies sent to the live viewer of a connection.",
+		      connections,
+		      [](const connection_sample& sample) { return sample.sent_bytes; });
+	append_family(document,
+		      "lttng_relayd_connection_processed_messages_total",
+		      "counter",
+		      "Commands (control and viewer connections) or packets (data connections) processed.",
+		      connections,
+		      [](const connection_sample& sample) { return sample.processed_messages; });
+	append_family(document,
+		      "lttng_relayd_connection_viewer_index_retries_total",
+		      "counter",
+		      "Next index requests of a live viewer which had to be retried.",
+		      connections,
+		      [](const connection_sample& sample) { return sample.viewer_index_retries; });
+	append_duration_family(document,
+			       "lttng_relayd_connection_command_duration_nanoseconds",
+			       "Duration of the processing of the commands of a connection.",
+			       connections,
+			       [](const connection_sample& sample) -> const duration_snapshot& {
+				       return sample.command_time;
+			       });
+}
+
+/* Format the current performance counters of the relay daemon. */
+std::string format_metrics_document()
+{
+	std::string document;
+
+	append_object_count_metrics(document);
+	append_fd_tracker_metrics(document);
+	append_stream_metrics(document);
+	append_connection_metrics(document);
+	return document;
+}
+
+void parse_metrics_env()
+{
+	const char *metrics_path;
+
+	metrics_path = lttng_secure_getenv(LTTNG_RELAYD_METRICS_ENV);
+	if (metrics_path) {
+		strncpy(metrics_unix_sock_path, metrics_path, PATH_MAX);
+		metrics_unix_sock_path[PATH_MAX - 1] = '\0';
+	}
+}
+
+void setup_metrics_path()
+{
+	parse_metrics_env();
+
+	const auto rundir_path =
+		lttng::make_unique_wrapper<char, lttng::memory::free>(utils_get_rundir(0));
+	if (!rundir_path) {
+		LTTNG_THROW_ALLOCATION_FAILURE_ERROR(
+			"Failed to determine RUNDIR for metrics socket creation");
+	}
+
+	auto relayd_rundir_path = [&rundir_path]() {
+		char *raw_relayd_path = nullptr;
+		const auto fmt_ret =
+			asprintf(&raw_relayd_path, DEFAULT_RELAYD_PATH, rundir_path.get());
+		if (fmt_ret < 0) {
+			LTTNG_THROW_POSIX("Failed to format relayd rundir path", errno);
+		}
+
+		return lttng::make_unique_wrapper<char, lttng::memory::free>(raw_relayd_path);
+	}();
+
+	create_lttng_rundir_with_perm(rundir_path.get());
+	create_lttng_rundir_with_perm(relayd_rundir_path.get());
+
+	if (strlen(metrics_unix_sock_path) != 0) {
+		return;
+	}
+
+	snprintf(metrics_unix_sock_path,
+		 sizeof(metrics_unix_sock_path),
+		 DEFAULT_RELAY_METRICS_UNIX_SOCK,
+		 rundir_path.get(),
+		 (int) getpid());
+}
+
+/* Send the current performance counters of the relay daemon to a client. */
+void serve_metrics_client(int client_sock)
+{
+	std::string document;
+
+	/* A client which doesn't receive the document must not stall the thread. */
+	if (lttcomm_setsockopt_snd_timeout(client_sock, DEFAULT_RELAY_METRICS_SEND_TIMEOUT)) {
+		return;
+	}
+
+	try {
+		document = format_metrics_document();
+	} catch (const std::exception& ex) {
+		ERR_FMT("Failed to format the metrics of the relay daemon: {}", ex.what());
+		return;
+	}
+
+	DBG2("Sending %zu bytes of metrics to client", document.size());
+	if (!document.empty()) {
+		const auto ret = lttcomm_send_unix_sock(
+			client_sock, document.data(), document.size(), true);
+
+		if (ret < 0) {
+			DBG("Failed to send metrics to client");
+		}
+	}
+}
+} /* namespace */
+
+struct relay_connection_metrics *relay_metrics_register_connection(enum connection_type type,
+								   int sock_fd)
+{
+	try {
+		auto peer = peer_address(sock_fd);
+		const std::lock_guard<std::mutex> lock(connection_registry_lock);
+		const auto id = next_connection_id++;
+		auto metrics =
+			lttng::make_unique<relay_connection_metrics>(id, type, std::move(peer));
+		auto *raw_metrics = metrics.get();
+
+		connection_registry.emplace(id, std::move(metrics));
+		return raw_metrics;
+	} catch (const std::bad_alloc&) {
+		ERR("Failed to allocate the performance counters of a relay connection");
+		return nullptr;
+	}
+}
+
+void relay_metrics_unregister_connection(struct relay_connection_metrics *metrics)
+{
+	if (!metrics) {
+		return;
+	}
+
+	const std::lock_guard<std::mutex> lock(connection_registry_lock);
+	connection_registry.erase(metrics->id);
+}
+
+std::unique_lock<std::mutex> relay_metrics_retire_stream(const struct relay_stream& stream)
+{
+	std::unique_lock<std::mutex> lock(stream_retirement_lock);
+	auto& totals = stream.trace->session->retired_streams_metrics;
+	const auto order = std::memory_order_relaxed;
+
+	totals.written_bytes += stream.metrics->written_bytes.load(order);
+	totals.received_packets += stream.metrics->received_packets.load(order);
+	totals.received_indexes += stream.metrics->received_indexes.load(order);
+	return lock;
+}
+
+/*
+ * Thread managing the metrics socket.
+ *
+ * A client connecting to the metrics socket receives the current
+ * performance counters of the relay daemon in the Prometheus text
+ * exposition format, after which the connection is closed.
+ *
+ * The metrics are not essential to the relay daemon: an error of this
+ * thread only makes them unavailable.
+ */
+void *thread_manage_metrics_relayd(void *data __attribute__((unused)))
+{
+	int err = -1;
+	bool ready_notified = false;
+
+	DBG("[thread] Manage metrics started");
+
+	if (opt_disable_metrics) {
+		DBG("Metrics socket disabled");
+		err = 0;
+		goto end;
+	}
+
+	try {
+		setup_metrics_path();
+	} catch (const lttng::runtime_error& ex) {
+		ERR_FMT("Failed to setup metrics socket path of relay daemon: {}", ex.what());
+		goto end;
+	}
+
+	rcu_register_thread();
+	err = relayd_serve_unix_socket(metrics_unix_sock_path,
+				       "Metrics",
+				       metrics_quit_pipe[0],
+				       serve_metrics_client,
+				       &ready_notified);
+	rcu_unregister_thread();
+end:
+	if (err) {
+		ERR("Metrics error occurred in %s, metrics are unavailable", __func__);
+	}
+
+	/* The readiness of the relay daemon doesn't depend on its metrics. */
+	if (!ready_notified) {
+		lttng_relay_notify_ready();
+	}
+
+	DBG("Metrics thread dying");
+	return nullptr;
+}
@@ -0,0 +1,107 @@
+#ifndef METRICS_RELAYD_H
+#define METRICS_RELAYD_H
+
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "connection.hpp"
+
+#include <common/histogram.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <utility>
+
+#define LTTNG_RELAYD_METRICS_ENV "LTTNG_RELAYD_METRICS"
+
+/*
+ * Performance counters of a relay stream.
+ *
+ * The counters are updated, with the stream lock held, by the thread
+ * receiving the stream's data and indexes. The metrics thread reads them
+ * without holding the stream lock.
+ */
+struct relay_stream_metrics {
+	/* Data and padding bytes written to the stream's files. */
+	std::atomic<uint64_t> written_bytes{ 0 };
+	std::atomic<uint64_t> received_packets{ 0 };
+	/* Indexes received on the control connection, live beacons excluded. */
+	std::atomic<uint64_t> received_indexes{ 0 };
+	std::atomic<uint64_t> received_beacons{ 0 };
+	/* Duration of the writes of a received data chunk to the stream's files. */
+	lttng::log2_duration_histogram write_time;
+};
+
+/*
+ * Performance counters of a relay connection.
+ *
+ * Owned by the connection registry of the metrics module: the counters
+ * remain valid from the registration of the connection until its
+ * unregistration.
+ */
+struct relay_connection_metrics {
+	relay_connection_metrics(uint64_t id_, enum connection_type type_, std::string peer_) :
+		id(id_), type(type_), peer(std::move(peer_))
+	{
+	}
+
+	/* Deactivate copy and assignment. */
+	relay_connection_metrics(const relay_connection_metrics&) = delete;
+	relay_connection_metrics(relay_connection_metrics&&) = delete;
+	relay_connection_metrics& operator=(const relay_connection_metrics&) = delete;
+	relay_connection_metrics& operator=(relay_connection_metrics&&) = delete;
+	~relay_connection_metrics() = default;
+
+	const uint64_t id;
+	/* Live connections only learn their type on the viewer's connect command. */
+	std::atomic<enum connection_type> type;
+	/* Address of the peer, empty when unknown. */
+	const std::string peer;
+	/* Relay session of a control or data connection, -1ULL when unset. */
+	std::atomic<uint64_t> session_id{ -1ULL };
+	std::atomic<uint64_t> received_bytes{ 0 };
+	/* Viewer connections only: bytes of packet replies sent to the viewer. */
+	std::atomic<uint64_t> sent_bytes{ 0 };
+	/* Commands (control and viewer connections) or packets (data connections). */
+	std::atomic<uint64_t> processed_messages{ 0 };
+	/* Viewer connections only: GET_NEXT_INDEX commands answered with "retry". */
+	std::atomic<uint64_t> viewer_index_retries{ 0 };
+	/* Duration of the processing of the commands of the connection. */
+	lttng::log2_duration_histogram command_time;
+};
+
+extern int metrics_quit_pipe[2];
+
+struct relay_stream;
+
+/*
+ * Add the performance counters of a stream about to leave the stream hash
+ * table to the totals of its session.
+ *
+ * The returned lock must be held until the stream is removed from the hash
+ * table so that the metrics thread accounts for the stream either on its own
+ * or through its session's totals, but never both.
+ */
+std::unique_lock<std::mutex> relay_metrics_retire_stream(const struct relay_stream& stream);
+
+/*
+ * Create the performance counters of a new connection and register them
+ * in the registry walked by the metrics thread.
+ *
+ * Returns nullptr on allocation failure.
+ */
+struct relay_connection_metrics *relay_metrics_register_connection(enum connection_type type,
+								   int sock_fd);
+
+/* Unregister and destroy the performance counters of a connection. */
+void relay_metrics_unregister_connection(struct relay_connection_metrics *metrics);
+
+void *thread_manage_metrics_relayd(void *data);
+
+#endif /* METRICS_RELAYD_H */
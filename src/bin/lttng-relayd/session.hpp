@@ -137,6 +137,17 @@ struct relay_session {
 	 */
 	bool ongoing_rotation;
 	struct lttng_directory_handle *output_directory;
+	/*
+	 * Totals of the performance counters of the session's streams which
+	 * left the stream hash table, keeping the session's counters monotonic
+	 * as its streams are closed. Protected by the stream retirement lock of
+	 * the metrics module.
+	 */
+	struct {
+		uint64_t written_bytes;
+		uint64_t received_packets;
+		uint64_t received_indexes;
+	} retired_streams_metrics;
 	struct rcu_head rcu_node; /* For call_rcu teardown. */
 };
 
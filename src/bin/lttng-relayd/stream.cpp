@@ -11,6 +11,7 @@
 #define _LGPL_SOURCE
 #include "index.hpp"
 #include "lttng-relayd.hpp"
+#include "metrics-relayd.hpp"
 #include "stream.hpp"
 #include "viewer-stream.hpp"
 
@@ -22,6 +23,7 @@
 #include <common/utils.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -416,7 +418,7 @@ end:
 static int create_index_file(struct relay_stream *stream, struct lttng_trace_chunk *chunk)
 {
 	int ret;
-	uint32_t major, minor;
+	uint32_t major, minor, index_minor;
 	char *index_subpath = nullptr;
 	enum lttng_trace_chunk_status status;
 
@@ -429,6 +431,9 @@ static int create_index_file(struct relay_stream *stream, struct lttng_trace_chu
 	}
 	major = stream->trace->session->major;
 	minor = stream->trace->session->minor;
+	/* Only the streams of compressed channels use the 1.2 index. */
+	index_minor = stream->compressed ? CTF_INDEX_COMPRESSED_MINOR :
+					   lttng_to_index_minor(major, minor);
 
 	if (!chunk) {
 		ret = 0;
@@ -451,7 +456,7 @@ static int create_index_file(struct relay_stream *stream, struct lttng_trace_chu
 							  stream->tracefile_size,
 							  stream->tracefile_current_index,
 							  lttng_to_index_major(major, minor),
-							  lttng_to_index_minor(major, minor),
+							  index_minor,
 							  true,
 							  &stream->index_file);
 	if (status != LTTNG_TRACE_CHUNK_STATUS_OK) {
@@ -571,7 +576,8 @@ struct relay_stream *stream_create(struct ctf_trace *trace,
 				   char *path_name,
 				   char *channel_name,
 				   uint64_t tracefile_size,
-				   uint64_t tracefile_count)
+				   uint64_t tracefile_count,
+				   bool compressed)
 {
 	int ret;
 	struct relay_stream *stream = nullptr;
@@ -592,6 +598,7 @@ struct relay_stream *stream_create(struct ctf_trace *trace,
 	stream->ctf_stream_id = -1ULL;
 	stream->tracefile_size = tracefile_size;
 	stream->tracefile_count = tracefile_count;
+	stream->compressed = compressed;
 	stream->path_name = path_name;
 	stream->channel_name = channel_name;
 	stream->beacon_ts_end = -1ULL;
@@ -601,6 +608,15 @@ struct relay_stream *stream_create(struct ctf_trace *trace,
 	ctf_trace_get(trace);
 	stream->trace = trace;
 
+	try {
+		stream->metrics = new relay_stream_metrics;
+	} catch (const std::bad_alloc&) {
+		ERR("Failed to allocate the performance counters of stream of channel \"%s\"",
+		    channel_name);
+		ret = -1;
+		goto end;
+	}
+
 	pthread_mutex_lock(&trace->session->lock);
 	current_trace_chunk = trace->session->current_trace_chunk;
 	if (current_trace_chunk) {
@@ -724,6 +740,7 @@ static void stream_unpublish(struct relay_stream *stream)
 	if (stream->in_stream_ht) {
 		struct lttng_ht_iter iter;
 		int ret;
+		const auto retire_lock = relay_metrics_retire_stream(*stream);
 
 		iter.iter.node = &stream->node.node;
 		ret = lttng_ht_del(relay_streams_ht, &iter);
@@ -751,6 +768,7 @@ static void stream_destroy(struct relay_stream *stream)
 	if (stream->tfa) {
 		tracefile_array_destroy(stream->tfa);
 	}
+	delete stream->metrics;
 	free(stream->path_name);
 	free(stream->channel_name);
 	free(stream);
@@ -1064,6 +1082,7 @@ int stream_write(struct relay_stream *stream,
 	ssize_t write_ret;
 	size_t padding_to_write = padding_len;
 	char padding_buffer[FILE_IO_STACK_BUFFER_SIZE];
+	std::chrono::steady_clock::time_point write_begin_time;
 
 	ASSERT_LOCKED(stream->lock);
 	memset(padding_buffer, 0, std::min(sizeof(padding_buffer), padding_to_write));
@@ -1076,6 +1095,7 @@ int stream_write(struct relay_stream *stream,
 		ret = -1;
 		goto end;
 	}
+	write_begin_time = std::chrono::steady_clock::now();
 	if (packet) {
 		write_ret = fs_handle_write(stream->file, packet->data, packet->size);
 		if (write_ret != packet->size) {
@@ -1103,6 +1123,13 @@ int stream_write(struct relay_stream *stream,
 		padding_to_write -= padding_to_write_this_pass;
 	}
 
+	if (packet || padding_len > 0) {
+		stream->metrics->write_time.record(std::chrono::steady_clock::now() -
+						   write_begin_time);
+		stream->metrics->written_bytes.fetch_add((packet ? packet->size : 0) + padding_len,
+							 std::memory_order_relaxed);
+	}
+
 	if (stream->is_metadata) {
 		size_t recv_len;
 
@@ -1225,6 +1252,7 @@ int stream_complete_packet(struct relay_stream *stream,
 	}
 
 	stream->prev_data_seq = sequence_number;
+	stream->metrics->received_packets.fetch_add(1, std::memory_order_relaxed);
 	ret = try_rotate_stream_data(stream);
 
 end:
@@ -1256,10 +1284,12 @@ int stream_add_index(struct relay_stream *stream, const struct lttcomm_relayd_in
 		if (stream->indexes_in_flight == 0) {
 			stream->beacon_ts_end = index_info->timestamp_end;
 		}
+		stream->metrics->received_beacons.fetch_add(1, std::memory_order_relaxed);
 		ret = 0;
 		goto end;
 	} else {
 		stream->beacon_ts_end = -1ULL;
+		stream->metrics->received_indexes.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	index = relay_index_get_by_id_or_create(stream, index_info->net_seq_num);
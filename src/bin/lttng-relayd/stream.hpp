@@ -24,6 +24,7 @@
 #include <urcu/list.h>
 
 struct lttcomm_relayd_index;
+struct relay_stream_metrics;
 
 struct relay_stream_rotation {
 	/*
@@ -89,6 +90,11 @@ struct relay_stream {
 	 * files shall be unlinked before being opened after this has occurred.
 	 */
 	bool tracefile_wrapped_around;
+	/*
+	 * The packets of the stream are compressed; its index files record
+	 * the stored size and codec of each packet (CTF index 1.2).
+	 */
+	bool compressed;
 
 	/*
 	 * Position in the tracefile where we have the full index also on disk.
@@ -180,6 +186,8 @@ struct relay_stream {
 	struct lttng_trace_chunk *trace_chunk;
 	LTTNG_OPTIONAL(struct relay_stream_rotation) ongoing_rotation;
 	uint64_t completed_rotation_count;
+	/* Performance counters of the stream, reported by the metrics thread. */
+	struct relay_stream_metrics *metrics;
 };
 
 struct relay_stream *stream_create(struct ctf_trace *trace,
@@ -187,7 +195,8 @@ struct relay_stream *stream_create(struct ctf_trace *trace,
 				   char *path_name,
 				   char *channel_name,
 				   uint64_t tracefile_size,
-				   uint64_t tracefile_count);
+				   uint64_t tracefile_count,
+				   bool compressed);
 
 struct relay_stream *stream_get_by_id(uint64_t stream_id);
 bool stream_get(struct relay_stream *stream);
@@ -0,0 +1,245 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#define _LGPL_SOURCE
+#include "lttng-relayd.hpp"
+#include "unix-socket-server.hpp"
+
+#include <common/common.hpp>
+#include <common/compat/poll.hpp>
+#include <common/fd-tracker/utils.hpp>
+#include <common/format.hpp>
+#include <common/sessiond-comm/sessiond-comm.hpp>
+#include <common/utils.hpp>
+
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace {
+int accept_unix_socket(void *data, int *out_fd)
+{
+	int ret;
+	const int accepting_sock = *((int *) data);
+
+	ret = lttcomm_accept_unix_sock(accepting_sock);
+	if (ret < 0) {
+		goto end;
+	}
+
+	*out_fd = ret;
+	ret = 0;
+end:
+	return ret;
+}
+
+int open_unix_socket(void *data, int *out_fd)
+{
+	int ret;
+	const char *path = (const char *) data;
+
+	ret = lttcomm_create_unix_sock(path);
+	if (ret < 0) {
+		goto end;
+	}
+
+	*out_fd = ret;
+	ret = 0;
+end:
+	return ret;
+}
+
+/* Give the tracing group access to the socket when running as root. */
+int set_socket_permissions(const char *path)
+{
+	int ret;
+	gid_t gid;
+
+	if (getuid()) {
+		return 0;
+	}
+
+	ret = utils_get_group_id(tracing_group_name, true, &gid);
+	if (ret) {
+		/* Default to root group. */
+		gid = 0;
+	}
+
+	ret = chown(path, 0, gid);
+	if (ret < 0) {
+		ERR("Unable to set group on %s", path);
+		PERROR("chown");
+		return -1;
+	}
+
+	ret = chmod(path, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+	if (ret < 0) {
+		ERR("Unable to set permissions on %s", path);
+		PERROR("chmod");
+		return -1;
+	}
+
+	return 0;
+}
+} /* namespace */
+
+int relayd_serve_unix_socket(const char *path,
+			     const char *name,
+			     int quit_pipe_fd,
+			     const std::function<void(int client_sock)>& serve_client,
+			     bool *ready_notified)
+{
+	int sock = -1, new_sock = -1, ret, err = -1;
+	uint32_t nb_fd, i;
+	struct lttng_poll_event events;
+	const std::string sock_name = fmt::format("Unix socket @ {}", path);
+	const std::string accepted_sock_name =
+		fmt::format("Socket accepted from unix socket @ {}", path);
+	const std::string epoll_name = fmt::format("{} management thread epoll", name);
+	const char *sock_name_str = sock_name.c_str();
+	const char *accepted_sock_name_str = accepted_sock_name.c_str();
+
+	*ready_notified = false;
+
+	/* We might hit an error path before this is created. */
+	lttng_poll_init(&events);
+
+	ret = fd_tracker_open_unsuspendable_fd(
+		the_fd_tracker, &sock, &sock_name_str, 1, open_unix_socket, (void *) path);
+	if (ret < 0) {
+		ERR_FMT("Unable to create {} Unix socket: path=`{}`", name, path);
+		goto end;
+	}
+
+	ret = set_socket_permissions(path);
+	if (ret) {
+		goto end;
+	}
+
+	/*
+	 * Set the CLOEXEC flag. Return code is useless because either way, the
+	 * show must go on.
+	 */
+	(void) utils_set_fd_cloexec(sock);
+
+	ret = lttcomm_listen_unix_sock(sock);
+	if (ret < 0) {
+		goto end;
+	}
+
+	/* Size is set to 2 for the unix socket and quit pipe. */
+	ret = fd_tracker_util_poll_create(
+		the_fd_tracker, epoll_name.c_str(), &events, 2, LTTNG_CLOEXEC);
+	if (ret < 0) {
+		ERR("Poll set creation failed");
+		goto end;
+	}
+
+	ret = lttng_poll_add(&events, quit_pipe_fd, LPOLLIN);
+	if (ret < 0) {
+		goto end;
+	}
+
+	ret = lttng_poll_add(&events, sock, LPOLLIN | LPOLLPRI);
+	if (ret < 0) {
+		goto end;
+	}
+
+	lttng_relay_notify_ready();
+	*ready_notified = true;
+
+	while (true) {
+		DBG_FMT("{} socket ready", name);
+
+		/* Infinite blocking call, waiting for transmission */
+	restart:
+		ret = lttng_poll_wait(&events, -1);
+		if (ret < 0) {
+			/*
+			 * Restart interrupted system call.
+			 */
+			if (errno == EINTR) {
+				goto restart;
+			}
+			goto end;
+		}
+
+		nb_fd = ret;
+
+		for (i = 0; i < nb_fd; i++) {
+			/* Fetch once the poll data */
+			const auto revents = LTTNG_POLL_GETEV(&events, i);
+			const auto pollfd = LTTNG_POLL_GETFD(&events, i);
+
+			/* Activity on thread quit pipe, exiting. */
+			if (pollfd == quit_pipe_fd) {
+				DBG("Activity on thread quit pipe");
+				err = 0;
+				goto end;
+			}
+
+			if (pollfd == sock) {
+				if (revents & LPOLLIN) {
+					continue;
+				} else if (revents & (LPOLLERR | LPOLLHUP | LPOLLRDHUP)) {
+					ERR_FMT("{} socket poll error", name);
+					goto end;
+				} else {
+					ERR("Unexpected poll events %u for sock %d",
+					    revents,
+					    pollfd);
+					goto end;
+				}
+			}
+		}
+
+		ret = fd_tracker_open_unsuspendable_fd(the_fd_tracker,
+						       &new_sock,
+						       &accepted_sock_name_str,
+						       1,
+						       accept_unix_socket,
+						       &sock);
+		if (ret < 0) {
+			goto end;
+		}
+
+		/*
+		 * Set the CLOEXEC flag. Return code is useless because either way, the
+		 * show must go on.
+		 */
+		(void) utils_set_fd_cloexec(new_sock);
+
+		serve_client(new_sock);
+
+		/* End of transmission */
+		ret = fd_tracker_close_unsuspendable_fd(
+			the_fd_tracker, &new_sock, 1, fd_tracker_util_close_fd, nullptr);
+		if (ret) {
+			PERROR("close");
+		}
+		new_sock = -1;
+	}
+
+end:
+	unlink(path);
+	if (sock >= 0) {
+		ret = fd_tracker_close_unsuspendable_fd(
+			the_fd_tracker, &sock, 1, fd_tracker_util_close_fd, nullptr);
+		if (ret) {
+			PERROR("close");
+		}
+	}
+
+	/*
+	 * We do NOT rmdir rundir nor the relayd path because there are
+	 * other processes using them.
+	 */
+
+	(void) fd_tracker_util_poll_clean(the_fd_tracker, &events);
+	return err;
+}
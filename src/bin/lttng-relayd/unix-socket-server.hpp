@@ -0,0 +1,35 @@
+#ifndef RELAYD_UNIX_SOCKET_SERVER_H
+#define RELAYD_UNIX_SOCKET_SERVER_H
+
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <functional>
+
+/*
+ * Serve the clients of a unix socket, one at a time, until activity on
+ * `quit_pipe_fd`.
+ *
+ * The socket is created at `path` and, when the relay daemon runs as root,
+ * made accessible to the tracing group. `name` identifies the socket in the
+ * logs and in the file descriptor tracker.
+ *
+ * `serve_client` is called with the socket of each accepted client, which is
+ * closed once it returns.
+ *
+ * lttng_relay_notify_ready() is called once the socket accepts clients, after
+ * which `*ready_notified` is set.
+ *
+ * Returns 0 on activity on `quit_pipe_fd`, -1 on error.
+ */
+int relayd_serve_unix_socket(const char *path,
+			     const char *name,
+			     int quit_pipe_fd,
+			     const std::function<void(int client_sock)>& serve_client,
+			     bool *ready_notified);
+
+#endif /* RELAYD_UNIX_SOCKET_SERVER_H */
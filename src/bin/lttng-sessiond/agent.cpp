@@ -14,6 +14,7 @@
 
 #include <common/common.hpp>
 #include <common/compat/endian.hpp>
+#include <common/dynamic-buffer.hpp>
 #include <common/sessiond-comm/agent.hpp>
 #include <common/urcu.hpp>
 
@@ -30,6 +31,7 @@
 
 #include <urcu/rculist.h>
 #include <urcu/uatomic.h>
+#include <vector>
 
 using event_rule_logging_get_name_pattern =
 	enum lttng_event_rule_status (*)(const struct lttng_event_rule *, const char **);
@@ -385,100 +387,131 @@ error:
 }
 
 /*
- * Internal enable agent event on a agent application. This function
- * communicates with the agent to enable a given event.
+ * Append the payload of an enable event command to `buffer`. The payload is the
+ * fixed-size struct followed by the variable-length filter expression (+1 for
+ * the ending \0).
  *
  * Return LTTNG_OK on success or else a LTTNG_ERR* code.
  */
-static int enable_event(const struct agent_app *app, struct agent_event *event)
+static int serialize_enable_event(const struct agent_event *event,
+				  struct lttng_dynamic_buffer *buffer)
 {
-	int ret;
-	char *bytes_to_send;
-	uint64_t data_size;
 	size_t filter_expression_length;
-	uint32_t reply_ret_code;
 	struct lttcomm_agent_enable_event msg;
-	struct lttcomm_agent_generic_reply reply;
-
-	LTTNG_ASSERT(app);
-	LTTNG_ASSERT(app->sock);
-	LTTNG_ASSERT(event);
-
-	DBG2("Agent enabling event %s for app pid: %d and socket %d",
-	     event->name,
-	     app->pid,
-	     app->sock->fd);
 
-	/*
-	 * Calculate the payload's size, which is the fixed-size struct followed
-	 * by the variable-length filter expression (+1 for the ending \0).
-	 */
 	if (!event->filter_expression) {
 		filter_expression_length = 0;
 	} else {
 		filter_expression_length = strlen(event->filter_expression) + 1;
 	}
-	data_size = sizeof(msg) + filter_expression_length;
 
 	memset(&msg, 0, sizeof(msg));
 	msg.loglevel_value = htobe32(event->loglevel_value);
 	msg.loglevel_type = htobe32(event->loglevel_type);
 	if (lttng_strncpy(msg.name, event->name, sizeof(msg.name))) {
-		ret = LTTNG_ERR_INVALID;
-		goto error;
+		return LTTNG_ERR_INVALID;
 	}
 	msg.filter_expression_length = htobe32(filter_expression_length);
 
-	ret = send_header(app->sock, data_size, AGENT_CMD_ENABLE, 0);
-	if (ret < 0) {
-		goto error_io;
-	}
-
-	bytes_to_send = calloc<char>(data_size);
-	if (!bytes_to_send) {
-		ret = LTTNG_ERR_NOMEM;
-		goto error;
-	}
-
-	memcpy(bytes_to_send, &msg, sizeof(msg));
-	if (filter_expression_length > 0) {
-		memcpy(bytes_to_send + sizeof(msg),
-		       event->filter_expression,
-		       filter_expression_length);
-	}
-
-	ret = send_payload(app->sock, bytes_to_send, data_size);
-	free(bytes_to_send);
-	if (ret < 0) {
-		goto error_io;
+	if (lttng_dynamic_buffer_append(buffer, &msg, sizeof(msg)) ||
+	    lttng_dynamic_buffer_append(
+		    buffer, event->filter_expression, filter_expression_length)) {
+		return LTTNG_ERR_NOMEM;
 	}
 
-	ret = recv_reply(app->sock, &reply, sizeof(reply));
-	if (ret < 0) {
-		goto error_io;
-	}
+	return LTTNG_OK;
+}
 
-	reply_ret_code = be32toh(reply.ret_code);
+/*
+ * Translate the return code of an agent to an enable event request.
+ *
+ * Return LTTNG_OK on success or else a LTTNG_ERR* code.
+ */
+static int enable_event_reply_ret_code(uint32_t reply_ret_code)
+{
 	log_reply_code(reply_ret_code);
 	switch (reply_ret_code) {
 	case AGENT_RET_CODE_SUCCESS:
-		break;
+		return LTTNG_OK;
 	case AGENT_RET_CODE_UNKNOWN_NAME:
-		ret = LTTNG_ERR_UST_EVENT_NOT_FOUND;
-		goto error;
+		return LTTNG_ERR_UST_EVENT_NOT_FOUND;
 	default:
-		ret = LTTNG_ERR_UNK;
-		goto error;
+		return LTTNG_ERR_UNK;
 	}
+}
 
-	return LTTNG_OK;
+/*
+ * Send an enable event command to an agent application without waiting for
+ * its reply, which must be received with recv_enable_event_reply().
+ *
+ * Return LTTNG_OK on success or else a LTTNG_ERR* code.
+ */
+static int send_enable_event(const struct agent_app *app, const struct agent_event *event)
+{
+	int ret;
+	struct lttng_dynamic_buffer payload;
 
-error_io:
-	ret = LTTNG_ERR_UST_ENABLE_FAIL;
-error:
+	LTTNG_ASSERT(app);
+	LTTNG_ASSERT(app->sock);
+	LTTNG_ASSERT(event);
+
+	DBG2("Agent enabling event %s for app pid: %d and socket %d",
+	     event->name,
+	     app->pid,
+	     app->sock->fd);
+
+	lttng_dynamic_buffer_init(&payload);
+	ret = serialize_enable_event(event, &payload);
+	if (ret != LTTNG_OK) {
+		goto end;
+	}
+
+	if (send_header(app->sock, payload.size, AGENT_CMD_ENABLE, 0) < 0 ||
+	    send_payload(app->sock, payload.data, payload.size) < 0) {
+		ret = LTTNG_ERR_UST_ENABLE_FAIL;
+		goto end;
+	}
+
+	ret = LTTNG_OK;
+end:
+	lttng_dynamic_buffer_reset(&payload);
 	return ret;
 }
 
+/*
+ * Receive the reply of an agent application to an enable event command sent
+ * with send_enable_event().
+ *
+ * Return LTTNG_OK on success or else a LTTNG_ERR* code.
+ */
+static int recv_enable_event_reply(const struct agent_app *app)
+{
+	struct lttcomm_agent_generic_reply reply;
+
+	if (recv_reply(app->sock, &reply, sizeof(reply)) < 0) {
+		return LTTNG_ERR_UST_ENABLE_FAIL;
+	}
+
+	return enable_event_reply_ret_code(be32toh(reply.ret_code));
+}
+
+/*
+ * Internal enable agent event on a agent application. This function
+ * communicates with the agent to enable a given event.
+ *
+ * Return LTTNG_OK on success or else a LTTNG_ERR* code.
+ */
+static int enable_event(const struct agent_app *app, const struct agent_event *event)
+{
+	const int ret = send_enable_event(app, event);
+
+	if (ret != LTTNG_OK) {
+		return ret;
+	}
+
+	return recv_enable_event_reply(app);
+}
+
 /*
  * Send Pascal-style string. Size is sent as a 32-bit big endian integer.
  */
@@ -668,14 +701,25 @@ int agent_send_registration_done(struct agent_app *app)
  * Enable agent event on every agent applications registered with the session
  * daemon.
  *
+ * The command is sent to all the applications before any reply is awaited so
+ * that the applications process it concurrently.
+ *
  * Return LTTNG_OK on success or else a LTTNG_ERR* code.
  */
 int agent_enable_event(struct agent_event *event, enum lttng_domain_type domain)
 {
-	int ret;
+	int ret = LTTNG_OK;
+	std::vector<const agent_app *> pending_apps;
 
 	LTTNG_ASSERT(event);
 
+	/*
+	 * The applications awaiting a reply must not be reclaimed before their
+	 * reply is received: remain in the same RCU read-side critical section
+	 * across both loops.
+	 */
+	const lttng::urcu::read_lock_guard read_lock;
+
 	for (auto *app : lttng::urcu::
 		     lfht_iteration_adapter<agent_app, decltype(agent_app::node), &agent_app::node>(
 			     *the_agent_apps_ht_by_sock->ht)) {
@@ -684,14 +728,28 @@ int agent_enable_event(struct agent_event *event, enum lttng_domain_type domain)
 		}
 
 		/* Enable event on agent application through TCP socket. */
-		ret = enable_event(app, event);
+		ret = send_enable_event(app, event);
 		if (ret != LTTNG_OK) {
-			goto error;
+			break;
 		}
+
+		pending_apps.push_back(app);
+	}
+
+	/* Replies of the applications that received the command must be consumed. */
+	for (const auto *app : pending_apps) {
+		const int reply_ret = recv_enable_event_reply(app);
+
+		if (ret == LTTNG_OK) {
+			ret = reply_ret;
+		}
+	}
+
+	if (ret != LTTNG_OK) {
+		goto error;
 	}
 
 	event->enabled_count++;
-	ret = LTTNG_OK;
 
 error:
 	return ret;
@@ -935,8 +993,10 @@ error:
  *
  * Return newly allocated object or else NULL on error.
  */
-struct agent_app *
-agent_create_app(pid_t pid, enum lttng_domain_type domain, struct lttcomm_sock *sock)
+struct agent_app *agent_create_app(pid_t pid,
+				   enum lttng_domain_type domain,
+				   uint32_t minor_version,
+				   struct lttcomm_sock *sock)
 {
 	struct agent_app *app;
 
@@ -950,6 +1010,7 @@ agent_create_app(pid_t pid, enum lttng_domain_type domain, struct lttcomm_sock *
 
 	app->pid = pid;
 	app->domain = domain;
+	app->minor_version = minor_version;
 	app->sock = sock;
 	lttng_ht_node_init_ulong(&app->node, (unsigned long) app->sock->fd);
 
@@ -1476,6 +1537,157 @@ void agent_app_ht_clean()
 	lttng_ht_destroy(the_agent_apps_ht_by_sock);
 }
 
+/*
+ * Append a Pascal-style string to `buffer`. Size is a 32-bit big endian integer.
+ *
+ * Return 0 on success or else a negative value.
+ */
+static int serialize_pstring(struct lttng_dynamic_buffer *buffer, const char *str, uint32_t len)
+{
+	const uint32_t len_be = htobe32(len);
+
+	if (lttng_dynamic_buffer_append(buffer, &len_be, sizeof(len_be))) {
+		return -1;
+	}
+
+	return lttng_dynamic_buffer_append(buffer, str, len);
+}
+
+/*
+ * Enable every enabled event and every application context of an agent on an
+ * agent application using a single command, rather than one command per rule.
+ * The application must implement the agent protocol 2.1 or later.
+ *
+ * As with the per-rule commands, the failure to apply a rule is only logged.
+ *
+ * Return LTTNG_OK on success or else a LTTNG_ERR* code.
+ */
+static int apply_rule_set(const struct agent_app *app, const struct agent *agt)
+{
+	int ret;
+	uint32_t reply_ret_code;
+	struct agent_app_ctx *ctx;
+	struct lttcomm_agent_apply_rule_set msg;
+	struct lttcomm_agent_generic_reply reply;
+	struct lttng_dynamic_buffer payload;
+	std::vector<const agent_event *> events;
+	std::vector<const agent_app_ctx *> app_ctxs;
+	std::vector<uint32_t> rule_ret_codes;
+
+	LTTNG_ASSERT(app);
+	LTTNG_ASSERT(app->sock);
+	LTTNG_ASSERT(agt);
+
+	lttng_dynamic_buffer_init(&payload);
+
+	/* The header is set once the rules are counted. */
+	ret = lttng_dynamic_buffer_set_size(&payload, sizeof(msg));
+	if (ret) {
+		ret = LTTNG_ERR_NOMEM;
+		goto end;
+	}
+
+	for (auto *event :
+	     lttng::urcu::lfht_iteration_adapter<agent_event,
+						 decltype(agent_event::node),
+						 &agent_event::node>(*agt->events->ht)) {
+		if (!AGENT_EVENT_IS_ENABLED(event)) {
+			continue;
+		}
+
+		ret = serialize_enable_event(event, &payload);
+		if (ret != LTTNG_OK) {
+			goto end;
+		}
+
+		events.push_back(event);
+	}
+
+	cds_list_for_each_entry_rcu(ctx, &agt->app_ctx_list, list_node)
+	{
+		const size_t provider_name_len = strlen(ctx->provider_name) + 1;
+		const size_t ctx_name_len = strlen(ctx->ctx_name) + 1;
+
+		if (provider_name_len > UINT32_MAX || ctx_name_len > UINT32_MAX) {
+			ERR("Application context name > MAX_UINT32");
+			ret = LTTNG_ERR_INVALID;
+			goto end;
+		}
+
+		if (serialize_pstring(&payload, ctx->provider_name, (uint32_t) provider_name_len) ||
+		    serialize_pstring(&payload, ctx->ctx_name, (uint32_t) ctx_name_len)) {
+			ret = LTTNG_ERR_NOMEM;
+			goto end;
+		}
+
+		app_ctxs.push_back(ctx);
+	}
+
+	if (events.empty() && app_ctxs.empty()) {
+		ret = LTTNG_OK;
+		goto end;
+	}
+
+	DBG2("Agent applying %zu event(s) and %zu application context(s) on app pid: %d and socket %d",
+	     events.size(),
+	     app_ctxs.size(),
+	     app->pid,
+	     app->sock->fd);
+
+	msg.event_count = htobe32((uint32_t) events.size());
+	msg.app_ctx_count = htobe32((uint32_t) app_ctxs.size());
+	memcpy(payload.data, &msg, sizeof(msg));
+
+	if (send_header(app->sock, payload.size, AGENT_CMD_APPLY_RULE_SET, 0) < 0 ||
+	    send_payload(app->sock, payload.data, payload.size) < 0 ||
+	    recv_reply(app->sock, &reply, sizeof(reply)) < 0) {
+		ret = LTTNG_ERR_UST_ENABLE_FAIL;
+		goto end;
+	}
+
+	reply_ret_code = be32toh(reply.ret_code);
+	log_reply_code(reply_ret_code);
+	if (reply_ret_code != AGENT_RET_CODE_SUCCESS) {
+		ret = LTTNG_ERR_UNK;
+		goto end;
+	}
+
+	rule_ret_codes.resize(events.size() + app_ctxs.size());
+	if (recv_reply(app->sock,
+		       rule_ret_codes.data(),
+		       rule_ret_codes.size() * sizeof(rule_ret_codes[0])) < 0) {
+		ret = LTTNG_ERR_UST_ENABLE_FAIL;
+		goto end;
+	}
+
+	for (size_t i = 0; i < events.size(); i++) {
+		if (enable_event_reply_ret_code(be32toh(rule_ret_codes[i])) != LTTNG_OK) {
+			DBG2("Agent update unable to enable event %s on app pid: %d sock %d",
+			     events[i]->name,
+			     app->pid,
+			     app->sock->fd);
+		}
+	}
+
+	for (size_t i = 0; i < app_ctxs.size(); i++) {
+		const uint32_t ctx_ret_code = be32toh(rule_ret_codes[events.size() + i]);
+
+		log_reply_code(ctx_ret_code);
+		if (ctx_ret_code != AGENT_RET_CODE_SUCCESS) {
+			DBG2("Agent update unable to add application context %s:%s on app pid: %d sock %d",
+			     app_ctxs[i]->provider_name,
+			     app_ctxs[i]->ctx_name,
+			     app->pid,
+			     app->sock->fd);
+		}
+	}
+
+	ret = LTTNG_OK;
+end:
+	lttng_dynamic_buffer_reset(&payload);
+	return ret;
+}
+
 /*
  * Update a agent application (given socket) using the given agent.
  *
@@ -1492,6 +1704,19 @@ void agent_update(const struct agent *agt, const struct agent_app *app)
 
 	DBG("Agent updating app: pid = %ld", (long) app->pid);
 
+	/* AGENT_CMD_APPLY_RULE_SET was introduced by the protocol 2.1. */
+	if (app->minor_version >= 1) {
+		ret = apply_rule_set(app, agt);
+		if (ret != LTTNG_OK) {
+			DBG2("Agent update unable to apply the rule set on app pid: %d sock %d",
+			     app->pid,
+			     app->sock->fd);
+		}
+
+		return;
+	}
+
+	/* Agents implementing the protocol 2.0 are updated one rule at a time. */
 	/*
 	 * We are in the registration path thus if the application is gone,
 	 * there is a serious code flow error.
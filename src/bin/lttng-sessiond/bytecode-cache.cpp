@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "bytecode-cache.hpp"
+
+#include <common/error.hpp>
+#include <common/macros.hpp>
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+namespace ls = lttng::sessiond;
+
+namespace {
+/* FNV-1a hash of the fields of `bytecode` which are sent to the tracers. */
+std::size_t hash_bytecode(const struct lttng_bytecode& bytecode)
+{
+	const uint32_t len = bytecode.len;
+	const uint32_t reloc_table_offset = bytecode.reloc_table_offset;
+	const uint64_t seqnum = bytecode.seqnum;
+	std::size_t hash = 14695981039346656037ULL;
+
+	const auto hash_bytes = [&hash](const void *data, std::size_t size) {
+		for (std::size_t i = 0; i < size; i++) {
+			hash ^= static_cast<const unsigned char *>(data)[i];
+			hash *= 1099511628211ULL;
+		}
+	};
+
+	hash_bytes(&len, sizeof(len));
+	hash_bytes(&reloc_table_offset, sizeof(reloc_table_offset));
+	hash_bytes(&seqnum, sizeof(seqnum));
+	hash_bytes(bytecode.data, len);
+	return hash;
+}
+
+bool bytecodes_equal(const struct lttng_bytecode& a, const struct lttng_bytecode& b)
+{
+	return a.len == b.len && a.reloc_table_offset == b.reloc_table_offset &&
+		a.seqnum == b.seqnum && memcmp(a.data, b.data, a.len) == 0;
+}
+} /* namespace */
+
+ls::bytecode_cache::~bytecode_cache()
+{
+	for (const auto& entry : _entries) {
+		free(entry.second.bytecode);
+	}
+}
+
+const struct lttng_bytecode *ls::bytecode_cache::get(const struct lttng_bytecode& bytecode)
+{
+	const auto hash = hash_bytecode(bytecode);
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto candidates = _bytecodes_by_hash.equal_range(hash);
+
+	for (auto it = candidates.first; it != candidates.second; ++it) {
+		if (bytecodes_equal(*it->second, bytecode)) {
+			_entries.at(it->second).reference_count++;
+			return it->second;
+		}
+	}
+
+	auto *shared_bytecode = zmalloc<lttng_bytecode>(sizeof(bytecode) + bytecode.len);
+	if (!shared_bytecode) {
+		throw std::bad_alloc();
+	}
+
+	shared_bytecode->len = bytecode.len;
+	shared_bytecode->reloc_table_offset = bytecode.reloc_table_offset;
+	shared_bytecode->seqnum = bytecode.seqnum;
+	memcpy(shared_bytecode->data, bytecode.data, bytecode.len);
+
+	try {
+		_entries.emplace(shared_bytecode, entry{ shared_bytecode, hash, 1 });
+		_bytecodes_by_hash.emplace(hash, shared_bytecode);
+	} catch (...) {
+		_entries.erase(shared_bytecode);
+		free(shared_bytecode);
+		throw;
+	}
+
+	DBG_FMT("Added bytecode to the cache: len={}, distinct_bytecode_count={}",
+		bytecode.len,
+		_entries.size());
+	return shared_bytecode;
+}
+
+const struct lttng_bytecode *
+ls::bytecode_cache::get_reference(const struct lttng_bytecode *shared_bytecode)
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+
+	_entries.at(shared_bytecode).reference_count++;
+	return shared_bytecode;
+}
+
+void ls::bytecode_cache::put(const struct lttng_bytecode *shared_bytecode) noexcept
+{
+	if (!shared_bytecode) {
+		return;
+	}
+
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto entry_it = _entries.find(shared_bytecode);
+
+	LTTNG_ASSERT(entry_it != _entries.end());
+	LTTNG_ASSERT(entry_it->second.reference_count > 0);
+	if (--entry_it->second.reference_count > 0) {
+		return;
+	}
+
+	const auto candidates = _bytecodes_by_hash.equal_range(entry_it->second.hash);
+	for (auto it = candidates.first; it != candidates.second; ++it) {
+		if (it->second == shared_bytecode) {
+			_bytecodes_by_hash.erase(it);
+			break;
+		}
+	}
+
+	free(entry_it->second.bytecode);
+	_entries.erase(entry_it);
+}
+
+std::size_t ls::bytecode_cache::size() const
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+
+	return _entries.size();
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef LTTNG_SESSIOND_BYTECODE_CACHE_HPP
+#define LTTNG_SESSIOND_BYTECODE_CACHE_HPP
+
+#include <common/sessiond-comm/sessiond-comm.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace lttng {
+namespace sessiond {
+
+/*
+ * Reference-counted set of the filter bytecodes used by the events and
+ * event rules of the session daemon.
+ *
+ * The identical bytecodes of the events of all the recording sessions and
+ * of the triggers (the same filter expression is typically used for many
+ * events) share a single immutable copy. That copy has the layout expected by
+ * the tracers and is sent as is to every application, without per-application
+ * allocations.
+ *
+ * Thread-safe: all operations are protected by an internal mutex.
+ */
+class bytecode_cache final {
+public:
+	bytecode_cache() = default;
+
+	/* Deactivate copy and assignment. */
+	bytecode_cache(const bytecode_cache&) = delete;
+	bytecode_cache(bytecode_cache&&) = delete;
+	bytecode_cache& operator=(const bytecode_cache&) = delete;
+	bytecode_cache& operator=(bytecode_cache&&) = delete;
+	~bytecode_cache();
+
+	/*
+	 * Get a reference to the shared copy of `bytecode`, creating it if
+	 * needed. The reference must be released with put().
+	 *
+	 * Throws std::bad_alloc.
+	 */
+	const struct lttng_bytecode *get(const struct lttng_bytecode& bytecode);
+
+	/* Get another reference to a shared copy returned by get(). */
+	const struct lttng_bytecode *get_reference(const struct lttng_bytecode *shared_bytecode);
+
+	/* Release a reference returned by get() or get_reference(). */
+	void put(const struct lttng_bytecode *shared_bytecode) noexcept;
+
+	/* Number of distinct bytecodes in the cache. */
+	std::size_t size() const;
+
+private:
+	struct entry {
+		struct lttng_bytecode *bytecode;
+		std::size_t hash;
+		unsigned int reference_count;
+	};
+
+	mutable std::mutex _lock;
+	/* Entries indexed by the address of their shared copy. */
+	std::unordered_map<const struct lttng_bytecode *, entry> _entries;
+	/* Shared copies indexed by the hash of their contents. */
+	std::unordered_multimap<std::size_t, const struct lttng_bytecode *> _bytecodes_by_hash;
+};
+
+} /* namespace sessiond */
+} /* namespace lttng */
+
+#endif /* LTTNG_SESSIOND_BYTECODE_CACHE_HPP */
@@ -629,6 +629,14 @@ struct lttng_channel *trace_ust_channel_to_lttng_channel(const struct ltt_ust_ch
 		goto end;
 	}
 
+	if (lttng_channel_set_compression(
+		    channel, static_cast<enum lttng_channel_compression>(uchan->compression)) !=
+	    LTTNG_CHANNEL_STATUS_OK) {
+		ERR("Failed to set channel compression "
+		    "during conversion from ltt_ust_channel to lttng_channel");
+		goto end;
+	}
+
 	if (uchan->automatic_memory_reclamation_maximal_age) {
 		if (lttng_channel_set_automatic_memory_reclamation_policy(
 			    channel, uchan->automatic_memory_reclamation_maximal_age->count()) !=
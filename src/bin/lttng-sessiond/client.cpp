@@ -52,15 +52,21 @@
 #include <lttng/userspace-probe-internal.hpp>
 
 #include <array>
+#include <condition_variable>
+#include <deque>
 #include <fcntl.h>
 #include <grp.h>
+#include <mutex>
 #include <pthread.h>
 #include <pwd.h>
 #include <signal.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/stat.h>
+#include <system_error>
+#include <thread>
 #include <unistd.h>
+#include <unordered_set>
 #include <vector>
 
 namespace ls = lttng::sessiond;
@@ -74,6 +80,41 @@ struct thread_state {
 	int client_sock;
 } thread_state;
 
+struct client_connection {
+	int sock;
+	/*
+	 * A persistent connection is handed back to the client management thread
+	 * after each command, until the client closes it.
+	 */
+	bool is_persistent;
+};
+
+/*
+ * Connections accepted (or, for persistent connections, found readable) by the
+ * client management thread, waiting to be handled by one of the client worker
+ * threads.
+ */
+struct client_worker_pool {
+	std::mutex lock;
+	std::condition_variable connection_available;
+	std::deque<client_connection> pending_connections;
+	/*
+	 * Persistent connections handed back by the workers, to be monitored by the
+	 * client management thread. The workers write to `idle_connection_pipe` to
+	 * wake it up.
+	 */
+	std::vector<int> idle_persistent_socks;
+	struct lttng_pipe *idle_connection_pipe;
+	bool quit;
+	std::vector<std::thread> workers;
+} client_worker_pool;
+
+/*
+ * Serializes the processing of the commands that can't run concurrently with
+ * other commands (see process_client_msg()).
+ */
+std::mutex exclusive_command_lock;
+
 /*
  * Maximum number of retries for group list resizing.
  * 5 retries is chosen as a reasonable upper bound to avoid infinite loops in case
@@ -748,7 +789,8 @@ lttng::ctl::trigger receive_lttng_trigger(struct command_ctx *cmd_ctx, int sock,
 		LTTNG_THROW_CTL("Failed to allocate buffer for trigger receptio", LTTNG_ERR_NOMEM);
 	}
 
-	sock_recv_len = lttcomm_recv_unix_sock(sock, trigger_payload.buffer.data, trigger_len);
+	sock_recv_len =
+		client_recv_command_data(cmd_ctx, sock, trigger_payload.buffer.data, trigger_len);
 	if (sock_recv_len < 0 || sock_recv_len != trigger_len) {
 		*sock_error = 1;
 		LTTNG_THROW_PROTOCOL_ERROR("Failed to receive trigger in command payload");
@@ -756,8 +798,8 @@ lttng::ctl::trigger receive_lttng_trigger(struct command_ctx *cmd_ctx, int sock,
 
 	/* Receive fds, if any. */
 	if (cmd_ctx->lsm.fd_count > 0) {
-		sock_recv_len = lttcomm_recv_payload_fds_unix_sock(
-			sock, cmd_ctx->lsm.fd_count, &trigger_payload);
+		sock_recv_len = client_recv_command_fds(
+			cmd_ctx, sock, cmd_ctx->lsm.fd_count, &trigger_payload);
 		if (sock_recv_len > 0 && sock_recv_len != cmd_ctx->lsm.fd_count * sizeof(int)) {
 			*sock_error = 1;
 			LTTNG_THROW_PROTOCOL_ERROR(fmt::format(
@@ -814,7 +856,8 @@ enum lttng_error_code receive_lttng_error_query(struct command_ctx *cmd_ctx,
 		goto end;
 	}
 
-	sock_recv_len = lttcomm_recv_unix_sock(sock, query_payload.buffer.data, query_len);
+	sock_recv_len =
+		client_recv_command_data(cmd_ctx, sock, query_payload.buffer.data, query_len);
 	if (sock_recv_len < 0 || sock_recv_len != query_len) {
 		ERR("Failed to receive error query in command payload");
 		*sock_error = 1;
@@ -824,8 +867,8 @@ enum lttng_error_code receive_lttng_error_query(struct command_ctx *cmd_ctx,
 
 	/* Receive fds, if any. */
 	if (cmd_ctx->lsm.fd_count > 0) {
-		sock_recv_len = lttcomm_recv_payload_fds_unix_sock(
-			sock, cmd_ctx->lsm.fd_count, &query_payload);
+		sock_recv_len = client_recv_command_fds(
+			cmd_ctx, sock, cmd_ctx->lsm.fd_count, &query_payload);
 		if (sock_recv_len > 0 && sock_recv_len != cmd_ctx->lsm.fd_count * sizeof(int)) {
 			ERR("Failed to receive all file descriptors for error query in command payload: expected fd count = %u, ret = %d",
 			    cmd_ctx->lsm.fd_count,
@@ -897,7 +940,8 @@ enum lttng_error_code receive_lttng_event(struct command_ctx *cmd_ctx,
 		goto end;
 	}
 
-	sock_recv_len = lttcomm_recv_unix_sock(sock, event_payload.buffer.data, event_len);
+	sock_recv_len =
+		client_recv_command_data(cmd_ctx, sock, event_payload.buffer.data, event_len);
 	if (sock_recv_len < 0 || sock_recv_len != event_len) {
 		ERR("Failed to receive event in command payload");
 		*sock_error = 1;
@@ -907,8 +951,8 @@ enum lttng_error_code receive_lttng_event(struct command_ctx *cmd_ctx,
 
 	/* Receive fds, if any. */
 	if (cmd_ctx->lsm.fd_count > 0) {
-		sock_recv_len = lttcomm_recv_payload_fds_unix_sock(
-			sock, cmd_ctx->lsm.fd_count, &event_payload);
+		sock_recv_len = client_recv_command_fds(
+			cmd_ctx, sock, cmd_ctx->lsm.fd_count, &event_payload);
 		if (sock_recv_len > 0 && sock_recv_len != cmd_ctx->lsm.fd_count * sizeof(int)) {
 			ERR("Failed to receive all file descriptors for event in command payload: expected fd count = %u, ret = %d",
 			    cmd_ctx->lsm.fd_count,
@@ -990,7 +1034,7 @@ end:
 	return ret_code;
 }
 
-enum lttng_error_code receive_lttng_event_context(const struct command_ctx *cmd_ctx,
+enum lttng_error_code receive_lttng_event_context(struct command_ctx *cmd_ctx,
 						  int sock,
 						  int *sock_error,
 						  struct lttng_event_context **out_event_context)
@@ -1010,8 +1054,8 @@ enum lttng_error_code receive_lttng_event_context(const struct command_ctx *cmd_
 		goto end;
 	}
 
-	sock_recv_len =
-		lttcomm_recv_unix_sock(sock, event_context_payload.buffer.data, event_context_len);
+	sock_recv_len = client_recv_command_data(
+		cmd_ctx, sock, event_context_payload.buffer.data, event_context_len);
 	if (sock_recv_len < 0 || sock_recv_len != event_context_len) {
 		ERR("Failed to receive event context in command payload");
 		*sock_error = 1;
@@ -1177,6 +1221,106 @@ lttng_data_stream_info_sets lttng_data_stream_info_sets_create_from_memory_usage
 	return sets;
 }
 
+/*
+ * Return true if a command only reads the state of the session daemon and can run concurrently
+ * with other commands.
+ */
+bool command_runs_concurrently(lttcomm_sessiond_command command_type)
+{
+	switch (command_type) {
+	case LTTCOMM_SESSIOND_COMMAND_LIST_SESSIONS:
+	case LTTCOMM_SESSIOND_COMMAND_LIST_DOMAINS:
+	case LTTCOMM_SESSIOND_COMMAND_LIST_CHANNELS:
+	case LTTCOMM_SESSIOND_COMMAND_LIST_EVENTS:
+	case LTTCOMM_SESSIOND_COMMAND_LIST_TRACEPOINTS:
+	case LTTCOMM_SESSIOND_COMMAND_LIST_TRACEPOINT_FIELDS:
+	case LTTCOMM_SESSIOND_COMMAND_LIST_SYSCALLS:
+	case LTTCOMM_SESSIOND_COMMAND_SNAPSHOT_LIST_OUTPUT:
+	case LTTCOMM_SESSIOND_COMMAND_SESSION_LIST_ROTATION_SCHEDULES:
+	case LTTCOMM_SESSIOND_COMMAND_ROTATION_GET_INFO:
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_GET_POLICY:
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_GET_INCLUSION_SET:
+	case LTTCOMM_SESSIOND_COMMAND_GET_CHANNEL_DATA_STREAM_INFO_SETS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Return true if the consumer daemon described by `data` would be launched, or if its
+ * socket would be added to `output`, by the "pre-action" of a command's domain.
+ */
+bool consumer_pre_action_creates_objects(consumer_data& data,
+					 const consumer_output *output,
+					 bool can_launch_consumerd)
+{
+	const lttng::pthread::lock_guard pid_lock(data.pid_mutex);
+
+	if (can_launch_consumerd && data.pid == 0) {
+		return true;
+	}
+
+	if (output == nullptr || data.cmd_sock < 0) {
+		return false;
+	}
+
+	const lttng::urcu::read_lock_guard read_lock;
+	return consumer_find_socket(data.cmd_sock, output) == nullptr;
+}
+
+/*
+ * Return true if the "pre-action" of a command's domain (see process_client_msg()) would
+ * initialize the kernel tracer, create the domain session of `session`, launch a consumer
+ * daemon or add a consumer socket to the consumer output of `session`.
+ *
+ * `session` is null for commands that don't have a target session. Otherwise, it must be
+ * locked.
+ */
+bool domain_pre_action_creates_objects(lttng_domain_type domain_type, const ltt_session *session)
+{
+	switch (domain_type) {
+	case LTTNG_DOMAIN_KERNEL:
+		if (!kernel_tracer_is_initialized()) {
+			return true;
+		}
+
+		if (!session) {
+			return false;
+		}
+
+		if (!session->kernel_session) {
+			return true;
+		}
+
+		return consumer_pre_action_creates_objects(
+			the_kconsumer_data, session->kernel_session->consumer, true);
+	case LTTNG_DOMAIN_JUL:
+	case LTTNG_DOMAIN_LOG4J:
+	case LTTNG_DOMAIN_LOG4J2:
+	case LTTNG_DOMAIN_PYTHON:
+	case LTTNG_DOMAIN_UST:
+		if (!session) {
+			return false;
+		}
+
+		if (!session->ust_session) {
+			return true;
+		}
+
+		return consumer_pre_action_creates_objects(
+			       the_ustconsumer64_data,
+			       session->ust_session->consumer,
+			       the_config.consumerd64_bin_path.value != nullptr) ||
+			consumer_pre_action_creates_objects(
+				the_ustconsumer32_data,
+				session->ust_session->consumer,
+				the_config.consumerd32_bin_path.value != nullptr);
+	default:
+		return false;
+	}
+}
+
 /*
  * Process the command requested by the lttng client within the command
  * context structure. This function make sure that the return structure (llm)
@@ -1291,6 +1435,8 @@ int process_client_msg(struct command_ctx *cmd_ctx, int *sock, int *sock_error)
 	case LTTCOMM_SESSIOND_COMMAND_SESSION_LIST_ROTATION_SCHEDULES:
 	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_GET_POLICY:
 	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_GET_INCLUSION_SET:
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_ADD_INCLUDE_VALUES:
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_REMOVE_INCLUDE_VALUES:
 	case LTTCOMM_SESSIOND_COMMAND_DATA_PENDING:
 	case LTTCOMM_SESSIOND_COMMAND_ROTATE_SESSION:
 	case LTTCOMM_SESSIOND_COMMAND_ROTATION_GET_INFO:
@@ -1305,6 +1451,29 @@ int process_client_msg(struct command_ctx *cmd_ctx, int *sock, int *sock_error)
 		setup_lttng_msg_no_cmd_header(cmd_ctx, nullptr, 0);
 	}
 
+	/*
+	 * Commands are processed by a pool of client worker threads. Those which only read
+	 * the state of a session run concurrently, serialized only by the lock of their
+	 * target session.
+	 *
+	 * The other commands acquire the exclusive command lock until their domain's
+	 * "pre-action" is completed, as the latter may launch a consumer daemon, which
+	 * assumes no other command is in progress. Those which have a target session then
+	 * release it: they are serialized by the lock of their target session and by the
+	 * session list lock (see below).
+	 *
+	 * The pre-action may also create the domain's session: a concurrent command only
+	 * acquires the exclusive command lock when its pre-action creates something.
+	 *
+	 * The exclusive command lock is always acquired before the session list lock.
+	 */
+	const bool runs_concurrently = command_runs_concurrently(
+		(lttcomm_sessiond_command) cmd_ctx->lsm.cmd_type);
+	std::unique_lock<std::mutex> exclusive_lock;
+	if (!runs_concurrently) {
+		exclusive_lock = std::unique_lock<std::mutex>(exclusive_command_lock);
+	}
+
 	/*
 	 * The list lock is only acquired when processing a command that is applied
 	 * against a session. As such, a unique_lock that holds the list lock is move()'d to
@@ -1325,6 +1494,30 @@ int process_client_msg(struct command_ctx *cmd_ctx, int *sock, int *sock_error)
 	 */
 	nonstd::optional<ltt_session::locked_ref> target_session;
 
+	/*
+	 * A concurrent command releases the session list lock once its target session is
+	 * found. Releasing the last reference to the session requires the session list lock,
+	 * which can't be acquired while holding the session's lock (the locking order is the
+	 * opposite): unlock the session before re-acquiring the session list lock to release
+	 * the reference.
+	 */
+	const auto release_target_session = lttng::make_scope_exit([&]() noexcept {
+		if (!target_session || list_lock.owns_lock()) {
+			return;
+		}
+
+		auto& session = target_session->get();
+
+		/* Release ownership of the locked reference. */
+		target_session->release();
+		target_session.reset();
+
+		session_unlock(&session);
+		list_lock = lttng::sessiond::lock_session_list();
+		session_put(&session);
+	});
+
+lookup_target_session:
 	/* Commands that DO NOT need a session. */
 	switch (cmd_ctx->lsm.cmd_type) {
 	case LTTCOMM_SESSIOND_COMMAND_CREATE_SESSION_EXT:
@@ -1349,9 +1542,14 @@ int process_client_msg(struct command_ctx *cmd_ctx, int *sock, int *sock_error)
 
 		DBG("Getting session %s by name", cmd_ctx->lsm.session.name);
 		/*
-		 * We keep the session list lock across _all_ commands
-		 * for now, because the per-session lock does not
-		 * handle teardown properly.
+		 * The session list lock is held while looking up the target
+		 * session. Concurrent commands release it once their domain's
+		 * "pre-action" is completed.
+		 *
+		 * The other commands keep it until they complete: the functions
+		 * they call look sessions up by id and release the references
+		 * they acquire, which requires the session list lock since
+		 * sessions are not reclaimed after an RCU grace period.
 		 */
 		list_lock = lttng::sessiond::lock_session_list();
 		try {
@@ -1411,6 +1609,23 @@ int process_client_msg(struct command_ctx *cmd_ctx, int *sock, int *sock_error)
 		goto skip_domain;
 	}
 
+	/*
+	 * The exclusive command lock must be acquired before the session list lock: a
+	 * concurrent command whose pre-action creates something releases its target session
+	 * and looks it up again once it holds the exclusive command lock.
+	 */
+	if (!exclusive_lock.owns_lock() &&
+	    domain_pre_action_creates_objects(cmd_ctx->lsm.domain.type,
+					      target_session ? &target_session->get() : nullptr)) {
+		target_session.reset();
+		if (list_lock.owns_lock()) {
+			list_lock.unlock();
+		}
+
+		exclusive_lock = std::unique_lock<std::mutex>(exclusive_command_lock);
+		goto lookup_target_session;
+	}
+
 	/*
 	 * Check domain type for specific "pre-action".
 	 */
@@ -1574,6 +1789,22 @@ int process_client_msg(struct command_ctx *cmd_ctx, int *sock, int *sock_error)
 		break;
 	}
 skip_domain:
+	if (runs_concurrently) {
+		/* From here on, only the lock of the target session (if any) is held. */
+		if (list_lock.owns_lock()) {
+			list_lock.unlock();
+		}
+
+		if (exclusive_lock.owns_lock()) {
+			exclusive_lock.unlock();
+		}
+	} else if (target_session) {
+		/*
+		 * From here on, the command is serialized by the lock of its target
+		 * session and by the session list lock.
+		 */
+		exclusive_lock.unlock();
+	}
 
 	/* Validate consumer daemon state when start/stop trace command */
 	if (cmd_ctx->lsm.cmd_type == LTTCOMM_SESSIOND_COMMAND_START_TRACE ||
@@ -1731,7 +1962,7 @@ skip_domain:
 				goto error_add_remove_tracker_value;
 			}
 
-			ret = lttcomm_recv_unix_sock(*sock, payload.data, name_len);
+			ret = client_recv_command_data(cmd_ctx, *sock, payload.data, name_len);
 			if (ret <= 0) {
 				ERR("Failed to receive payload of %s process attribute tracker value argument",
 				    add_value ? "add" : "remove");
@@ -1776,6 +2007,96 @@ skip_domain:
 		lttng_dynamic_buffer_reset(&payload);
 		break;
 	}
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_ADD_INCLUDE_VALUES:
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_REMOVE_INCLUDE_VALUES:
+	{
+		struct lttng_dynamic_buffer payload;
+		struct lttng_buffer_view payload_view;
+		struct lttng_process_attr_values *values = nullptr;
+		std::vector<lttng_error_code> value_ret_codes;
+		std::vector<int32_t> reply;
+		const bool add_values = cmd_ctx->lsm.cmd_type ==
+			LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_ADD_INCLUDE_VALUES;
+		const size_t payload_len =
+			cmd_ctx->lsm.u.process_attr_tracker_add_remove_include_values.length;
+		const enum lttng_domain_type domain_type =
+			(enum lttng_domain_type) cmd_ctx->lsm.domain.type;
+		const enum lttng_process_attr process_attr =
+			(enum lttng_process_attr) cmd_ctx->lsm.u
+				.process_attr_tracker_add_remove_include_values.process_attr;
+		ssize_t values_ret;
+
+		if (payload_len > LTTNG_PROCESS_ATTR_VALUES_MAX_LEN) {
+			ERR("Rejecting process attribute tracker values %s as the payload exceeds the maximal allowed length: payload length = %zu, maximal length = %d",
+			    add_values ? "addition" : "removal",
+			    payload_len,
+			    LTTNG_PROCESS_ATTR_VALUES_MAX_LEN);
+			ret = LTTNG_ERR_INVALID;
+			goto error;
+		}
+
+		lttng_dynamic_buffer_init(&payload);
+		ret = lttng_dynamic_buffer_set_size(&payload, payload_len);
+		if (ret) {
+			ERR("Failed to allocate buffer to receive payload of %s process attribute tracker values argument",
+			    add_values ? "add" : "remove");
+			ret = LTTNG_ERR_NOMEM;
+			goto error_add_remove_tracker_values;
+		}
+
+		ret = client_recv_command_data(cmd_ctx, *sock, payload.data, payload_len);
+		if (ret <= 0) {
+			ERR("Failed to receive payload of %s process attribute tracker values argument",
+			    add_values ? "add" : "remove");
+			*sock_error = 1;
+			ret = LTTNG_ERR_INVALID_PROTOCOL;
+			goto error_add_remove_tracker_values;
+		}
+
+		/*
+		 * Validate the value types and domains are legal for the
+		 * process attribute tracker that is specified and convert the
+		 * values to the internal sessiond representation.
+		 */
+		payload_view = lttng_buffer_view_from_dynamic_buffer(&payload, 0, payload_len);
+		values_ret = lttng_process_attr_values_create_from_buffer(
+			domain_type, process_attr, &payload_view, &values);
+		if (values_ret != (ssize_t) payload_len) {
+			ret = LTTNG_ERR_INVALID_PROTOCOL;
+			goto error_add_remove_tracker_values;
+		}
+
+		value_ret_codes.resize(_lttng_process_attr_values_get_count(values), LTTNG_OK);
+		if (add_values) {
+			ret = cmd_process_attr_tracker_inclusion_set_add_values(
+				*target_session,
+				domain_type,
+				process_attr,
+				values,
+				value_ret_codes.data());
+		} else {
+			ret = cmd_process_attr_tracker_inclusion_set_remove_values(
+				*target_session,
+				domain_type,
+				process_attr,
+				values,
+				value_ret_codes.data());
+		}
+
+		if (ret != LTTNG_OK) {
+			goto error_add_remove_tracker_values;
+		}
+
+		/* Reply with the outcome of the addition/removal of each value. */
+		reply.assign(value_ret_codes.begin(), value_ret_codes.end());
+		setup_lttng_msg_no_cmd_header(
+			cmd_ctx, reply.data(), reply.size() * sizeof(decltype(reply)::value_type));
+
+	error_add_remove_tracker_values:
+		lttng_process_attr_values_destroy(values);
+		lttng_dynamic_buffer_reset(&payload);
+		break;
+	}
 	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_GET_POLICY:
 	{
 		enum lttng_tracking_policy tracking_policy;
@@ -1987,7 +2308,7 @@ skip_domain:
 
 		/* Receive variable len data */
 		DBG("Receiving %zu URI(s) from client ...", nb_uri);
-		ret = lttcomm_recv_unix_sock(*sock, uris, len);
+		ret = client_recv_command_data(cmd_ctx, *sock, uris, len);
 		if (ret <= 0) {
 			DBG("No URIs received from client... continuing");
 			*sock_error = 1;
@@ -2676,24 +2997,448 @@ void log_nested_exceptions(const ExceptionType& ex,
 }
 
 /*
- * This thread manage all clients request using the unix client socket for
- * communication.
+ * Receive a command sent on a persistent connection: its frame (along with the
+ * client's credentials), its lttcomm_session_msg, and its variable length data
+ * and fds, which the command consumes from `cmd_ctx`.
+ *
+ * Receiving the whole command before processing it keeps the connection in a
+ * consistent state whatever the outcome of the command: a command may fail
+ * before it consumes its variable length data.
+ *
+ * Returns true on success. Otherwise, the connection must be closed.
+ */
+bool receive_framed_command(struct command_ctx& cmd_ctx, int sock)
+{
+	struct lttcomm_session_msg_frame frame;
+	ssize_t ret;
+
+	ret = lttcomm_recv_creds_unix_sock(sock, &frame, sizeof(frame), &cmd_ctx.creds);
+	if (ret != sizeof(frame)) {
+		if (ret == 0) {
+			DBG_FMT("Persistent client connection closed by peer: socket={}", sock);
+		} else {
+			DBG("Incomplete recv() from client... continuing");
+		}
+
+		return false;
+	}
+
+	/* Packed fields can't be bound to references; copy to locals. */
+	const uint64_t data_size = frame.data_size;
+	const uint32_t fd_count = frame.fd_count;
+
+	if (data_size > LTTNG_SESSION_MSG_DATA_MAX_LEN || fd_count > LTTCOMM_MAX_SEND_FDS) {
+		ERR_FMT("Invalid command frame received on persistent client connection: socket={}, data_size={}, fd_count={}",
+			sock,
+			data_size,
+			fd_count);
+		return false;
+	}
+
+	ret = lttcomm_recv_unix_sock(sock, &cmd_ctx.lsm, sizeof(cmd_ctx.lsm));
+	if (ret != sizeof(cmd_ctx.lsm)) {
+		DBG("Incomplete recv() from client... continuing");
+		return false;
+	}
+
+	if (lttng_dynamic_buffer_set_size(&cmd_ctx.received_data.buffer, data_size)) {
+		ERR_FMT("Failed to allocate the command's variable length data buffer: socket={}, data_size={}",
+			sock,
+			data_size);
+		return false;
+	}
+
+	if (data_size > 0) {
+		ret = lttcomm_recv_unix_sock(sock, cmd_ctx.received_data.buffer.data, data_size);
+		if (ret != (ssize_t) data_size) {
+			DBG("Incomplete recv() from client... continuing");
+			return false;
+		}
+	}
+
+	if (fd_count > 0) {
+		ret = lttcomm_recv_payload_fds_unix_sock(sock, fd_count, &cmd_ctx.received_data);
+		if (ret != (ssize_t) (fd_count * sizeof(int))) {
+			ERR_FMT("Failed to receive the command's file descriptors: socket={}, fd_count={}, ret={}",
+				sock,
+				fd_count,
+				ret);
+			return false;
+		}
+	}
+
+	cmd_ctx.is_data_received = true;
+	return true;
+}
+
+/*
+ * Receive a command from a client connection, process it, and send the reply
+ * back to the client.
+ *
+ * Returns true if the connection is persistent and must be kept open to receive
+ * the next command. Otherwise, the connection is closed (unless a command took
+ * ownership of the socket) before returning.
+ */
+bool handle_client_connection(struct command_ctx& cmd_ctx, client_connection& connection)
+{
+	int ret, sock_error;
+	bool keep_connection = false;
+	const struct cmd_completion_handler *cmd_completion_handler;
+	int& sock = connection.sock;
+	const auto close_sock = lttng::make_scope_exit([&sock, &keep_connection]() noexcept {
+		/* The command may have taken ownership of the socket. */
+		if (!keep_connection && sock >= 0 && close(sock)) {
+			PERROR("close");
+		}
+	});
+
+	cmd_ctx.creds.uid = UINT32_MAX;
+	cmd_ctx.creds.gid = UINT32_MAX;
+	cmd_ctx.creds.pid = 0;
+	lttng_payload_clear(&cmd_ctx.reply_payload);
+	cmd_ctx.lttng_msg_size = 0;
+	cmd_ctx.is_data_received = false;
+	lttng_payload_clear(&cmd_ctx.received_data);
+	cmd_ctx.received_data_position = 0;
+	cmd_ctx.received_fd_handles_position = 0;
+
+	health_code_update();
+
+	/*
+	 * Data is received from the lttng client. The struct
+	 * lttcomm_session_msg (lsm) contains the command and data request of
+	 * the client.
+	 */
+	DBG("Receiving data from client ...");
+	if (connection.is_persistent) {
+		if (!receive_framed_command(cmd_ctx, sock)) {
+			return false;
+		}
+	} else {
+		ret = lttcomm_recv_creds_unix_sock(
+			sock, &cmd_ctx.lsm, sizeof(struct lttcomm_session_msg), &cmd_ctx.creds);
+		if (ret != sizeof(struct lttcomm_session_msg)) {
+			DBG("Incomplete recv() from client... continuing");
+			return false;
+		}
+	}
+
+	health_code_update();
+
+	rcu_thread_online();
+
+	/*
+	 * This function dispatch the work to the kernel or userspace tracer
+	 * libs and fill the lttcomm_lttng_msg data structure of all the needed
+	 * informations for the client. The command context struct contains
+	 * everything this function may needs.
+	 */
+	try {
+		/*
+		 * Check if the client has the right to execute this command.
+		 * If the client is root, it can do anything. If the client is not
+		 * root, it must be in the tracing group or have the same UID as the
+		 * sessiond's UID.
+		 */
+		if (!((is_root &&
+		       is_user_in_tracing_group(cmd_ctx.creds.uid, cmd_ctx.creds.gid)) ||
+		      (getuid() == cmd_ctx.creds.uid) || cmd_ctx.creds.uid == 0)) {
+			WARN_FMT(
+				"Client doesn't have permission to interact with this instance: uid={}",
+				cmd_ctx.creds.uid);
+			ret = LTTNG_ERR_EPERM;
+		} else if (cmd_ctx.lsm.cmd_type ==
+			   LTTCOMM_SESSIOND_COMMAND_ENABLE_PERSISTENT_CONNECTION) {
+			DBG_FMT("Enabling persistent client connection: socket={}", sock);
+			setup_empty_lttng_msg(&cmd_ctx);
+			connection.is_persistent = true;
+			ret = LTTNG_OK;
+		} else {
+			ret = process_client_msg(&cmd_ctx, &sock, &sock_error);
+		}
+	} catch (const std::bad_alloc& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_NOMEM;
+	} catch (const lttng::ctl::error& ex) {
+		log_nested_exceptions(ex);
+		ret = ex.code();
+	} catch (const lttng::invalid_argument_error& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_INVALID;
+	} catch (const lttng::unsupported_error& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_NOT_SUPPORTED;
+	} catch (const lttng::sessiond::exceptions::session_not_found_error& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_SESS_NOT_FOUND;
+	} catch (const lttng::sessiond::exceptions::channel_not_found_error& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_CHAN_NOT_FOUND;
+	} catch (const lttng::runtime_error& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_UNK;
+	} catch (const std::exception& ex) {
+		log_nested_exceptions(ex);
+		ret = LTTNG_ERR_UNK;
+	}
+
+	rcu_thread_offline();
+
+	if (ret < LTTNG_OK || ret >= LTTNG_ERR_NR) {
+		WARN("Command returned an invalid status code, returning unknown error: "
+		     "command type = %s (%d), ret = %d",
+		     lttcomm_sessiond_command_str((lttcomm_sessiond_command) cmd_ctx.lsm.cmd_type),
+		     cmd_ctx.lsm.cmd_type,
+		     ret);
+		ret = LTTNG_ERR_UNK;
+	}
+
+	if (ret != LTTNG_OK) {
+		/*
+		 * Reset the payload contents as the command may have left them in
+		 * an inconsistent state.
+		 */
+		setup_empty_lttng_msg(&cmd_ctx);
+	}
+
+	command_ctx_set_status_code(cmd_ctx, static_cast<lttng_error_code>(ret));
+
+	cmd_completion_handler = cmd_pop_completion_handler();
+	if (cmd_completion_handler) {
+		enum lttng_error_code completion_code;
+
+		completion_code = cmd_completion_handler->run(cmd_completion_handler->data);
+		if (completion_code != LTTNG_OK) {
+			return false;
+		}
+	}
+
+	health_code_update();
+
+	if (sock >= 0) {
+		struct lttng_payload_view view =
+			lttng_payload_view_from_payload(&cmd_ctx.reply_payload, 0, -1);
+		struct lttcomm_lttng_msg *llm = (typeof(llm)) cmd_ctx.reply_payload.buffer.data;
+
+		LTTNG_ASSERT(cmd_ctx.reply_payload.buffer.size >= sizeof(*llm));
+		LTTNG_ASSERT(cmd_ctx.lttng_msg_size == cmd_ctx.reply_payload.buffer.size);
+
+		llm->fd_count = lttng_payload_view_get_fd_handle_count(&view);
+
+		DBG("Sending response (size: %d, retcode: %s (%d))",
+		    cmd_ctx.lttng_msg_size,
+		    lttng_strerror(-llm->ret_code),
+		    llm->ret_code);
+		ret = send_unix_sock(sock, &view);
+		if (ret < 0) {
+			ERR("Failed to send data back to client");
+		} else {
+			/*
+			 * A command that takes ownership of the socket ends the
+			 * connection. The whole command was received, even if it
+			 * failed, so a persistent connection is ready to receive
+			 * the next one.
+			 */
+			keep_connection = connection.is_persistent;
+		}
+	}
+
+	health_code_update();
+	return keep_connection;
+}
+
+/*
+ * Hand a persistent connection back to the client management thread which
+ * monitors it until the client sends its next command.
+ */
+void return_idle_persistent_connection(int sock)
+{
+	const char wake_up = 'c';
+
+	{
+		const std::lock_guard<std::mutex> pool_lock(client_worker_pool.lock);
+
+		client_worker_pool.idle_persistent_socks.push_back(sock);
+	}
+
+	if (lttng_pipe_write(client_worker_pool.idle_connection_pipe, &wake_up, 1) != 1) {
+		PERROR("Failed to wake up the client management thread: socket=%d", sock);
+	}
+}
+
+/*
+ * Client worker thread: handles the client connections accepted by the client
+ * management thread until the pool is stopped.
+ */
+void client_worker(unsigned int worker_index)
+{
+	struct command_ctx cmd_ctx = {};
+
+	DBG_FMT("[thread] Client worker started: worker_index={}", worker_index);
+
+	lttng_payload_init(&cmd_ctx.reply_payload);
+	lttng_payload_init(&cmd_ctx.received_data);
+	rcu_register_thread();
+	rcu_thread_offline();
+	health_register(the_health_sessiond, HEALTH_SESSIOND_TYPE_CMD);
+
+	while (true) {
+		client_connection connection;
+
+		health_code_update();
+
+		{
+			std::unique_lock<std::mutex> pool_lock(client_worker_pool.lock);
+
+			health_poll_entry();
+			client_worker_pool.connection_available.wait(pool_lock, []() {
+				return client_worker_pool.quit ||
+					!client_worker_pool.pending_connections.empty();
+			});
+			health_poll_exit();
+
+			if (client_worker_pool.quit) {
+				break;
+			}
+
+			connection = client_worker_pool.pending_connections.front();
+			client_worker_pool.pending_connections.pop_front();
+		}
+
+		if (handle_client_connection(cmd_ctx, connection)) {
+			return_idle_persistent_connection(connection.sock);
+		}
+	}
+
+	health_unregister(the_health_sessiond);
+	lttng_payload_reset(&cmd_ctx.reply_payload);
+	lttng_payload_reset(&cmd_ctx.received_data);
+	rcu_unregister_thread();
+	DBG_FMT("[thread] Client worker dying: worker_index={}", worker_index);
+}
+
+bool start_client_workers(unsigned int worker_count)
+{
+	DBG_FMT("Starting client workers: worker_count={}", worker_count);
+
+	client_worker_pool.quit = false;
+	try {
+		for (unsigned int i = 0; i < worker_count; i++) {
+			client_worker_pool.workers.emplace_back(client_worker, i);
+		}
+	} catch (const std::system_error& ex) {
+		ERR_FMT("Failed to launch client worker thread: {}", ex.what());
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Stop the client worker threads once their current command is completed and
+ * close the connections that were not handled yet, including the idle
+ * persistent connections not yet monitored by the client management thread.
+ */
+void stop_client_workers()
+{
+	{
+		const std::lock_guard<std::mutex> pool_lock(client_worker_pool.lock);
+
+		client_worker_pool.quit = true;
+	}
+
+	client_worker_pool.connection_available.notify_all();
+	for (auto& worker : client_worker_pool.workers) {
+		worker.join();
+	}
+
+	client_worker_pool.workers.clear();
+
+	for (const auto& connection : client_worker_pool.pending_connections) {
+		if (close(connection.sock)) {
+			PERROR("close");
+		}
+	}
+
+	client_worker_pool.pending_connections.clear();
+
+	for (const auto sock : client_worker_pool.idle_persistent_socks) {
+		if (close(sock)) {
+			PERROR("close");
+		}
+	}
+
+	client_worker_pool.idle_persistent_socks.clear();
+}
+
+void queue_client_connection(client_connection connection)
+{
+	{
+		const std::lock_guard<std::mutex> pool_lock(client_worker_pool.lock);
+
+		client_worker_pool.pending_connections.push_back(connection);
+	}
+
+	client_worker_pool.connection_available.notify_one();
+}
+
+/*
+ * Add the idle persistent connections handed back by the client worker threads
+ * to the poll set of the client management thread.
+ */
+int monitor_idle_persistent_connections(struct lttng_poll_event *events,
+					std::unordered_set<int>& monitored_socks)
+{
+	char wake_up;
+	std::vector<int> idle_socks;
+
+	if (lttng_pipe_read(client_worker_pool.idle_connection_pipe, &wake_up, 1) != 1) {
+		PERROR("Failed to read from the idle client connection pipe");
+		return -1;
+	}
+
+	{
+		const std::lock_guard<std::mutex> pool_lock(client_worker_pool.lock);
+
+		idle_socks.swap(client_worker_pool.idle_persistent_socks);
+	}
+
+	for (const auto sock : idle_socks) {
+		if (lttng_poll_add(events, sock, LPOLLIN) < 0) {
+			ERR_FMT("Failed to monitor persistent client connection: socket={}", sock);
+			if (close(sock)) {
+				PERROR("close");
+			}
+
+			continue;
+		}
+
+		monitored_socks.insert(sock);
+	}
+
+	return 0;
+}
+
+/*
+ * This thread accepts the client connections on the unix client socket and
+ * hands them over to the client worker threads which process the commands.
+ *
+ * It also monitors the idle persistent connections and hands them over to the
+ * workers as the clients send their next command.
  */
 void *thread_manage_clients(void *data)
 {
 	int sock = -1, ret, i, err = -1;
-	int sock_error;
 	uint32_t nb_fd;
 	struct lttng_poll_event events;
 	const int client_sock = thread_state.client_sock;
 	struct lttng_pipe *quit_pipe = (lttng_pipe *) data;
 	const int thread_quit_pipe_fd = lttng_pipe_get_readfd(quit_pipe);
-	struct command_ctx cmd_ctx = {};
+	int idle_connection_pipe_fd;
+	std::unordered_set<int> monitored_socks;
 
 	DBG("[thread] Manage client started");
 
-	lttng_payload_init(&cmd_ctx.reply_payload);
-
 	is_root = (getuid() == 0);
 
 	pthread_cleanup_push(thread_init_cleanup, nullptr);
@@ -2710,10 +3455,11 @@ void *thread_manage_clients(void *data)
 	}
 
 	/*
-	 * Pass 2 as size here for the thread quit pipe and client_sock. Nothing
-	 * more will be added to this poll set.
+	 * Pass 3 as size here for the thread quit pipe, the idle connection pipe,
+	 * and client_sock. The poll set grows as idle persistent connections are
+	 * added to it.
 	 */
-	ret = lttng_poll_create(&events, 2, LTTNG_CLOEXEC);
+	ret = lttng_poll_create(&events, 3, LTTNG_CLOEXEC);
 	if (ret < 0) {
 		goto error_create_poll;
 	}
@@ -2730,6 +3476,21 @@ void *thread_manage_clients(void *data)
 		goto error;
 	}
 
+	client_worker_pool.idle_connection_pipe = lttng_pipe_open(FD_CLOEXEC);
+	if (!client_worker_pool.idle_connection_pipe) {
+		goto error;
+	}
+
+	idle_connection_pipe_fd = lttng_pipe_get_readfd(client_worker_pool.idle_connection_pipe);
+	ret = lttng_poll_add(&events, idle_connection_pipe_fd, LPOLLIN);
+	if (ret < 0) {
+		goto error;
+	}
+
+	if (!start_client_workers(the_config.client_worker_count)) {
+		goto error;
+	}
+
 	/* Set state as running. */
 	set_thread_status(true);
 	pthread_cleanup_pop(0);
@@ -2746,13 +3507,7 @@ void *thread_manage_clients(void *data)
 	health_code_update();
 
 	while (true) {
-		const struct cmd_completion_handler *cmd_completion_handler;
-
-		cmd_ctx.creds.uid = UINT32_MAX;
-		cmd_ctx.creds.gid = UINT32_MAX;
-		cmd_ctx.creds.pid = 0;
-		lttng_payload_clear(&cmd_ctx.reply_payload);
-		cmd_ctx.lttng_msg_size = 0;
+		bool accept_connection = false;
 
 		DBG("Accepting client command ...");
 
@@ -2787,18 +3542,54 @@ void *thread_manage_clients(void *data)
 				goto exit;
 			}
 
-			/* Event on the registration socket */
-			if (revents & LPOLLIN) {
+			if (pollfd == idle_connection_pipe_fd) {
+				if (monitor_idle_persistent_connections(&events, monitored_socks)) {
+					goto error;
+				}
+
 				continue;
-			} else if (revents & (LPOLLERR | LPOLLHUP | LPOLLRDHUP)) {
-				ERR("Client socket poll error");
+			}
+
+			if (pollfd == client_sock) {
+				/* Event on the registration socket */
+				if (revents & LPOLLIN) {
+					accept_connection = true;
+					continue;
+				} else if (revents & (LPOLLERR | LPOLLHUP | LPOLLRDHUP)) {
+					ERR("Client socket poll error");
+					goto error;
+				} else {
+					ERR("Unexpected poll events %u for sock %d",
+					    revents,
+					    pollfd);
+					goto error;
+				}
+			}
+
+			/*
+			 * Activity on an idle persistent connection: stop monitoring it
+			 * while its next command is processed.
+			 */
+			ret = lttng_poll_del(&events, pollfd);
+			if (ret < 0) {
 				goto error;
+			}
+
+			monitored_socks.erase(pollfd);
+			if (revents & LPOLLIN) {
+				queue_client_connection({ pollfd, true });
 			} else {
-				ERR("Unexpected poll events %u for sock %d", revents, pollfd);
-				goto error;
+				DBG_FMT("Persistent client connection hung up: socket={}", pollfd);
+				if (close(pollfd)) {
+					PERROR("close");
+				}
 			}
 		}
 
+		if (!accept_connection) {
+			continue;
+		}
+
 		DBG("Wait for client response");
 
 		health_code_update();
@@ -2822,137 +3613,8 @@ void *thread_manage_clients(void *data)
 
 		health_code_update();
 
-		/*
-		 * Data is received from the lttng client. The struct
-		 * lttcomm_session_msg (lsm) contains the command and data request of
-		 * the client.
-		 */
-		DBG("Receiving data from client ...");
-		ret = lttcomm_recv_creds_unix_sock(
-			sock, &cmd_ctx.lsm, sizeof(struct lttcomm_session_msg), &cmd_ctx.creds);
-		if (ret != sizeof(struct lttcomm_session_msg)) {
-			DBG("Incomplete recv() from client... continuing");
-			ret = close(sock);
-			if (ret) {
-				PERROR("close");
-			}
-			sock = -1;
-			continue;
-		}
-
-		health_code_update();
-
-		rcu_thread_online();
-
-		/*
-		 * This function dispatch the work to the kernel or userspace tracer
-		 * libs and fill the lttcomm_lttng_msg data structure of all the needed
-		 * informations for the client. The command context struct contains
-		 * everything this function may needs.
-		 */
-		try {
-			/*
-			 * Check if the client has the right to execute this command.
-			 * If the client is root, it can do anything. If the client is not
-			 * root, it must be in the tracing group or have the same UID as the
-			 * sessiond's UID.
-			 */
-			if ((is_root &&
-			     is_user_in_tracing_group(cmd_ctx.creds.uid, cmd_ctx.creds.gid)) ||
-			    (getuid() == cmd_ctx.creds.uid) || cmd_ctx.creds.uid == 0) {
-				ret = process_client_msg(&cmd_ctx, &sock, &sock_error);
-			} else {
-				WARN_FMT(
-					"Client doesn't have permission to interact with this instance: uid={}",
-					cmd_ctx.creds.uid);
-				ret = LTTNG_ERR_EPERM;
-			}
-		} catch (const std::bad_alloc& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_NOMEM;
-		} catch (const lttng::ctl::error& ex) {
-			log_nested_exceptions(ex);
-			ret = ex.code();
-		} catch (const lttng::invalid_argument_error& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_INVALID;
-		} catch (const lttng::unsupported_error& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_NOT_SUPPORTED;
-		} catch (const lttng::sessiond::exceptions::session_not_found_error& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_SESS_NOT_FOUND;
-		} catch (const lttng::sessiond::exceptions::channel_not_found_error& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_CHAN_NOT_FOUND;
-		} catch (const lttng::runtime_error& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_UNK;
-		} catch (const std::exception& ex) {
-			log_nested_exceptions(ex);
-			ret = LTTNG_ERR_UNK;
-		}
-
-		rcu_thread_offline();
-
-		if (ret < LTTNG_OK || ret >= LTTNG_ERR_NR) {
-			WARN("Command returned an invalid status code, returning unknown error: "
-			     "command type = %s (%d), ret = %d",
-			     lttcomm_sessiond_command_str(
-				     (lttcomm_sessiond_command) cmd_ctx.lsm.cmd_type),
-			     cmd_ctx.lsm.cmd_type,
-			     ret);
-			ret = LTTNG_ERR_UNK;
-		}
-
-		if (ret != LTTNG_OK) {
-			/*
-			 * Reset the payload contents as the command may have left them in
-			 * an inconsistent state.
-			 */
-			setup_empty_lttng_msg(&cmd_ctx);
-		}
-
-		command_ctx_set_status_code(cmd_ctx, static_cast<lttng_error_code>(ret));
-
-		cmd_completion_handler = cmd_pop_completion_handler();
-		if (cmd_completion_handler) {
-			enum lttng_error_code completion_code;
-
-			completion_code = cmd_completion_handler->run(cmd_completion_handler->data);
-			if (completion_code != LTTNG_OK) {
-				continue;
-			}
-		}
-
-		health_code_update();
-
-		if (sock >= 0) {
-			struct lttng_payload_view view =
-				lttng_payload_view_from_payload(&cmd_ctx.reply_payload, 0, -1);
-			struct lttcomm_lttng_msg *llm =
-				(typeof(llm)) cmd_ctx.reply_payload.buffer.data;
-
-			LTTNG_ASSERT(cmd_ctx.reply_payload.buffer.size >= sizeof(*llm));
-			LTTNG_ASSERT(cmd_ctx.lttng_msg_size == cmd_ctx.reply_payload.buffer.size);
-
-			llm->fd_count = lttng_payload_view_get_fd_handle_count(&view);
-
-			DBG("Sending response (size: %d, retcode: %s (%d))",
-			    cmd_ctx.lttng_msg_size,
-			    lttng_strerror(-llm->ret_code),
-			    llm->ret_code);
-			ret = send_unix_sock(sock, &view);
-			if (ret < 0) {
-				ERR("Failed to send data back to client");
-			}
-
-			/* End of transmission */
-			ret = close(sock);
-			if (ret) {
-				PERROR("close");
-			}
-		}
+		/* The command is received and processed by a client worker thread. */
+		queue_client_connection({ sock, false });
 		sock = -1;
 
 		health_code_update();
@@ -2960,6 +3622,17 @@ void *thread_manage_clients(void *data)
 
 exit:
 error:
+	stop_client_workers();
+
+	for (const auto monitored_sock : monitored_socks) {
+		if (close(monitored_sock)) {
+			PERROR("close");
+		}
+	}
+
+	lttng_pipe_destroy(client_worker_pool.idle_connection_pipe);
+	client_worker_pool.idle_connection_pipe = nullptr;
+
 	if (sock >= 0) {
 		ret = close(sock);
 		if (ret) {
@@ -2985,7 +3658,6 @@ error_create_poll:
 	health_unregister(the_health_sessiond);
 
 	DBG("Client thread dying");
-	lttng_payload_reset(&cmd_ctx.reply_payload);
 	rcu_unregister_thread();
 	return nullptr;
 }
@@ -3049,3 +3721,67 @@ error:
 	cleanup_client_thread(client_quit_pipe);
 	return nullptr;
 }
+
+ssize_t client_recv_command_data(struct command_ctx *cmd_ctx, int sock, void *buf, size_t size)
+{
+	LTTNG_ASSERT(cmd_ctx);
+
+	if (!cmd_ctx->is_data_received) {
+		return lttcomm_recv_unix_sock(sock, buf, size);
+	}
+
+	const auto remaining_size =
+		cmd_ctx->received_data.buffer.size - cmd_ctx->received_data_position;
+	if (size > remaining_size) {
+		ERR_FMT("Command variable length data is shorter than expected: command={}, expected_size={}, remaining_size={}",
+			lttcomm_sessiond_command_str(
+				(lttcomm_sessiond_command) cmd_ctx->lsm.cmd_type),
+			size,
+			remaining_size);
+		return -1;
+	}
+
+	memcpy(buf, cmd_ctx->received_data.buffer.data + cmd_ctx->received_data_position, size);
+	cmd_ctx->received_data_position += size;
+	return size;
+}
+
+ssize_t client_recv_command_fds(struct command_ctx *cmd_ctx,
+				int sock,
+				size_t fd_count,
+				struct lttng_payload *payload)
+{
+	LTTNG_ASSERT(cmd_ctx);
+	LTTNG_ASSERT(payload);
+
+	if (!cmd_ctx->is_data_received) {
+		return lttcomm_recv_payload_fds_unix_sock(sock, fd_count, payload);
+	}
+
+	const auto remaining_fd_count =
+		lttng_dynamic_pointer_array_get_count(&cmd_ctx->received_data._fd_handles) -
+		cmd_ctx->received_fd_handles_position;
+	if (fd_count > remaining_fd_count) {
+		ERR_FMT("Command received fewer file descriptors than expected: command={}, expected_fd_count={}, remaining_fd_count={}",
+			lttcomm_sessiond_command_str(
+				(lttcomm_sessiond_command) cmd_ctx->lsm.cmd_type),
+			fd_count,
+			remaining_fd_count);
+		return -1;
+	}
+
+	for (size_t i = 0; i < fd_count; i++) {
+		auto *handle = static_cast<struct fd_handle *>(
+			lttng_dynamic_pointer_array_get_pointer(&cmd_ctx->received_data._fd_handles,
+								cmd_ctx->received_fd_handles_position));
+
+		/* The payload acquires its own reference to the handle. */
+		if (lttng_payload_push_fd_handle(payload, handle)) {
+			return -LTTNG_ERR_NOMEM;
+		}
+
+		cmd_ctx->received_fd_handles_position++;
+	}
+
+	return fd_count * sizeof(int);
+}
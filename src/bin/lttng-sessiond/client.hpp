@@ -10,8 +10,36 @@
 #ifndef CLIENT_SESSIOND_H
 #define CLIENT_SESSIOND_H
 
+#include "lttng-sessiond.hpp"
 #include "thread.hpp"
 
+#include <common/payload.hpp>
+
+#include <sys/types.h>
+
 struct lttng_thread *launch_client_thread();
 
+/*
+ * Receive `size` bytes of the variable length data of the command being
+ * processed, from the client's socket or, when they were received ahead of
+ * the processing of the command, from `cmd_ctx`.
+ *
+ * Returns the received size on success, 0 if the client closed the
+ * connection, or a negative value on error.
+ */
+ssize_t client_recv_command_data(struct command_ctx *cmd_ctx, int sock, void *buf, size_t size);
+
+/*
+ * Receive `fd_count` fds of the command being processed and add them to
+ * `payload`, from the client's socket or, when they were received ahead of
+ * the processing of the command, from `cmd_ctx`.
+ *
+ * Returns a positive value on success, 0 if the client closed the
+ * connection, or a negative value on error.
+ */
+ssize_t client_recv_command_fds(struct command_ctx *cmd_ctx,
+				int sock,
+				size_t fd_count,
+				struct lttng_payload *payload);
+
 #endif /* CLIENT_SESSIOND_H */
@@ -11,6 +11,7 @@
 #include "agent.hpp"
 #include "buffer-registry.hpp"
 #include "channel.hpp"
+#include "client.hpp"
 #include "cmd.hpp"
 #include "commands/get-channel-memory-usage.hpp"
 #include "commands/reclaim-channel-memory.hpp"
@@ -36,6 +37,7 @@
 #include <common/buffer-view.hpp>
 #include <common/common.hpp>
 #include <common/compat/string.hpp>
+#include <common/compression/codec.hpp>
 #include <common/ctl/format.hpp>
 #include <common/defaults.hpp>
 #include <common/dynamic-buffer.hpp>
@@ -93,6 +95,7 @@
 
 namespace ls = lttng::sessiond;
 namespace lsu = lttng::sessiond::ust;
+namespace lsc = lttng::sessiond::consumer;
 
 static enum lttng_error_code wait_on_path(void *path);
 
@@ -112,8 +115,11 @@ struct cmd_destroy_session_reply_context {
  * when a session that has a non-default shm_path is being destroyed.
  *
  * See comment in cmd_destroy_session() for the rationale.
+ *
+ * Client commands are processed by a pool of threads: the handler, like the
+ * current completion handler, is per-thread.
  */
-struct destroy_completion_handler {
+thread_local struct destroy_completion_handler {
 	struct cmd_completion_handler handler;
 	char shm_path[member_sizeof(struct ltt_session, shm_path)];
 } destroy_completion_handler = {
@@ -131,7 +137,7 @@ pthread_mutex_t relayd_net_seq_idx_lock = PTHREAD_MUTEX_INITIALIZER;
 uint64_t relayd_net_seq_idx;
 } /* namespace */
 
-static struct cmd_completion_handler *current_completion_handler;
+static thread_local struct cmd_completion_handler *current_completion_handler;
 static int validate_ust_event_name(const char *);
 static int cmd_enable_event_internal(ltt_session::locked_ref& session,
 				     const struct lttng_domain *domain,
@@ -230,96 +236,146 @@ error:
 }
 
 /*
- * Get run-time attributes if the session has been started (discarded events,
- * lost packets).
+ * Get the runtime statistics of a consumer channel from the runtime statistics
+ * of all the channels of its session.
  */
-static int get_kernel_runtime_stats(const ltt_session::locked_ref& session,
-				    struct ltt_kernel_channel *kchan,
-				    uint64_t *discarded_events,
-				    uint64_t *lost_packets)
+static lsc::channel_runtime_stats
+find_channel_runtime_stats(const lsc::channel_runtime_stats_map& session_channels_stats,
+			   uint64_t consumer_channel_key)
 {
-	int ret;
+	const auto stats_it = session_channels_stats.find(consumer_channel_key);
 
-	if (!session->has_been_started) {
-		ret = 0;
-		*discarded_events = 0;
-		*lost_packets = 0;
-		goto end;
+	/* The consumer daemons don't know channels which have no streams yet. */
+	return stats_it != session_channels_stats.end() ? stats_it->second :
+							  lsc::channel_runtime_stats();
+}
+
+/*
+ * Get the runtime statistics (discarded events, lost packets, and packet
+ * compression statistics) of a UST channel from the runtime statistics of all
+ * the channels of its session.
+ */
+static lsc::channel_runtime_stats
+get_ust_runtime_stats(ltt_ust_session& usess,
+		      const ltt_ust_channel& uchan,
+		      const lsc::channel_runtime_stats_map& session_channels_stats)
+{
+	lsc::channel_runtime_stats stats;
+
+	switch (usess.buffer_type) {
+	case LTTNG_BUFFER_PER_UID:
+	{
+		uint64_t consumer_chan_key;
+
+		if (buffer_reg_uid_consumer_channel_key(
+			    &usess.buffer_reg_uid_list, uchan.id, &consumer_chan_key) == 0) {
+			stats = find_channel_runtime_stats(session_channels_stats,
+							   consumer_chan_key);
+		}
+
+		break;
 	}
+	case LTTNG_BUFFER_PER_PID:
+		/* Sum the counters of the channels of all the applications. */
+		for (const auto consumer_chan_key :
+		     ust_app_pid_get_channel_consumer_keys(&usess, &uchan)) {
+			const auto app_stats = find_channel_runtime_stats(session_channels_stats,
+									  consumer_chan_key);
 
-	ret = consumer_get_discarded_events(
-		session->id, kchan->key, session->kernel_session->consumer, discarded_events);
-	if (ret < 0) {
-		goto end;
+			stats.discarded_events += app_stats.discarded_events;
+			stats.lost_packets += app_stats.lost_packets;
+			stats.compression.input_bytes += app_stats.compression.input_bytes;
+			stats.compression.output_bytes += app_stats.compression.output_bytes;
+			stats.compression.cpu_time_ns += app_stats.compression.cpu_time_ns;
+			stats.io.add(app_stats.io);
+		}
+
+		break;
+	default:
+		ERR("Unsupported buffer ownership");
+		abort();
 	}
 
-	ret = consumer_get_lost_packets(
-		session->id, kchan->key, session->kernel_session->consumer, lost_packets);
-	if (ret < 0) {
-		goto end;
+	/* Only the counter matching the channel's mode is meaningful. */
+	if (uchan.attr.overwrite) {
+		stats.discarded_events = 0;
+	} else {
+		stats.lost_packets = 0;
 	}
 
-end:
-	return ret;
+	if (usess.buffer_type == LTTNG_BUFFER_PER_PID) {
+		stats.discarded_events += uchan.per_pid_closed_app_discarded;
+		stats.lost_packets += uchan.per_pid_closed_app_lost;
+		stats.compression.input_bytes += uchan.per_pid_closed_app_compression.input_bytes;
+		stats.compression.output_bytes += uchan.per_pid_closed_app_compression.output_bytes;
+		stats.compression.cpu_time_ns += uchan.per_pid_closed_app_compression.cpu_time_ns;
+	}
+
+	return stats;
 }
 
 /*
- * Get run-time attributes if the session has been started (discarded events,
- * lost packets).
+ * Get the runtime and I/O statistics of all the channels of a session's domain
+ * from its consumer daemons if the session has been started.
+ *
+ * The I/O statistics are optional: `has_io_stats` is set to false, rather than
+ * failing, when they can't be obtained.
+ *
+ * Return 0 on success or else a negative value.
  */
-static int get_ust_runtime_stats(const ltt_session::locked_ref& session,
-				 struct ltt_ust_channel *uchan,
-				 uint64_t *discarded_events,
-				 uint64_t *lost_packets)
+static int
+get_session_channels_runtime_stats(const ltt_session::locked_ref& session,
+				   consumer_output *consumer,
+				   lsc::channel_runtime_stats_map& session_channels_stats,
+				   bool& has_io_stats)
 {
-	int ret;
-	struct ltt_ust_session *usess;
+	has_io_stats = true;
 
-	if (!discarded_events || !lost_packets) {
-		ret = -1;
-		goto end;
+	if (!session->has_been_started || !consumer) {
+		return 0;
 	}
 
-	usess = session->ust_session;
-	LTTNG_ASSERT(discarded_events);
-	LTTNG_ASSERT(lost_packets);
-
-	if (!usess || !session->has_been_started) {
-		*discarded_events = 0;
-		*lost_packets = 0;
-		ret = 0;
-		goto end;
+	try {
+		session_channels_stats =
+			lsc::get_session_channels_runtime_stats(session->id, *consumer);
+	} catch (const std::exception& ex) {
+		ERR_FMT("Failed to get the runtime statistics of the channels of session: session_name=`{}`, error=`{}`",
+			session->name,
+			ex.what());
+		return -1;
 	}
 
-	if (usess->buffer_type == LTTNG_BUFFER_PER_UID) {
-		ret = ust_app_uid_get_channel_runtime_stats(usess->id,
-							    &usess->buffer_reg_uid_list,
-							    usess->consumer,
-							    uchan->id,
-							    uchan->attr.overwrite,
-							    discarded_events,
-							    lost_packets);
-	} else if (usess->buffer_type == LTTNG_BUFFER_PER_PID) {
-		ret = ust_app_pid_get_channel_runtime_stats(usess,
-							    uchan,
-							    usess->consumer,
-							    uchan->attr.overwrite,
-							    discarded_events,
-							    lost_packets);
-		if (ret < 0) {
-			goto end;
+	try {
+		for (const auto& channel_io_stats :
+		     lsc::get_session_channels_io_stats(session->id, *consumer)) {
+			session_channels_stats[channel_io_stats.first].io = channel_io_stats.second;
 		}
-		*discarded_events += uchan->per_pid_closed_app_discarded;
-		*lost_packets += uchan->per_pid_closed_app_lost;
-	} else {
-		ERR("Unsupported buffer ownership");
-		abort();
-		ret = -1;
-		goto end;
+	} catch (const std::exception& ex) {
+		WARN_FMT("Failed to get the I/O statistics of the channels of session, reporting them as unavailable: session_name=`{}`, error=`{}`",
+			 session->name,
+			 ex.what());
+		has_io_stats = false;
 	}
 
-end:
-	return ret;
+	return 0;
+}
+
+/*
+ * Set the I/O statistics of the summary of a channel which is being listed.
+ */
+static void set_channel_extended_io_stats(lttng_channel_extended& extended,
+					  const lsc::channel_io_stats& stats,
+					  bool has_io_stats)
+{
+	extended.has_io_stats = has_io_stats;
+	extended.io_consumed_subbuffers = stats.consumed_subbuffers;
+	extended.io_written_bytes = stats.written_bytes;
+	extended.io_write_calls = stats.write_calls;
+	extended.io_relayd_send_time_ns = stats.relayd_send_time_ns;
+	extended.io_subbuffer_consumption_p99_ns = stats.subbuffer_consumption_p99_ns;
+	extended.io_subbuffer_consumption_max_ns = stats.subbuffer_consumption_max_ns;
+	extended.io_write_p99_ns = stats.write_p99_ns;
+	extended.io_write_max_ns = stats.write_max_ns;
 }
 
 /*
@@ -1333,7 +1389,8 @@ int cmd_enable_channel(command_ctx *cmd_ctx, ltt_session::locked_ref& session, i
 		return LTTNG_ERR_NOMEM;
 	}
 
-	const auto sock_recv_len = lttcomm_recv_unix_sock(sock, channel_buffer.data, channel_len);
+	const auto sock_recv_len =
+		client_recv_command_data(cmd_ctx, sock, channel_buffer.data, channel_len);
 	if (sock_recv_len < 0 || sock_recv_len != channel_len) {
 		ERR("Failed to receive \"enable channel\" command payload");
 		return LTTNG_ERR_INVALID;
@@ -1489,6 +1546,46 @@ static enum lttng_error_code cmd_enable_channel_internal(ltt_session::locked_ref
 		}
 	}
 
+	if (extended->compression != LTTNG_CHANNEL_COMPRESSION_NONE) {
+		const auto codec_type =
+			static_cast<lttng::compression::codec_type>(extended->compression);
+
+		if (!the_config.experimental_packet_compression) {
+			WARN_FMT("Packet compression is experimental and must be enabled with the `{}` environment variable: "
+				 "session_name=`{}` channel_name=`{}`",
+				 DEFAULT_SESSIOND_EXPERIMENTAL_PACKET_COMPRESSION_ENV,
+				 session->name,
+				 new_channel_attr->name);
+			return LTTNG_ERR_NOT_SUPPORTED;
+		}
+
+		if (domain->type == LTTNG_DOMAIN_KERNEL) {
+			WARN_FMT("Packet compression is only supported by UST domains: "
+				 "session_name=`{}` channel_name=`{}` domain_type={}",
+				 session->name,
+				 new_channel_attr->name,
+				 domain->type);
+			return LTTNG_ERR_UNSUPPORTED_DOMAIN;
+		}
+
+		if (session->live_timer > 0) {
+			WARN_FMT("Packet compression is not supported by live sessions: "
+				 "session_name=`{}` channel_name=`{}`",
+				 session->name,
+				 new_channel_attr->name);
+			return LTTNG_ERR_NOT_SUPPORTED;
+		}
+
+		if (!lttng::compression::is_codec_supported(codec_type)) {
+			WARN_FMT("Packet compression codec is not supported by this build: "
+				 "session_name=`{}` channel_name=`{}` codec=`{}`",
+				 session->name,
+				 new_channel_attr->name,
+				 lttng::compression::codec_type_name(codec_type));
+			return LTTNG_ERR_NOT_SUPPORTED;
+		}
+	}
+
 	switch (domain->type) {
 	case LTTNG_DOMAIN_KERNEL:
 	{
@@ -1999,11 +2096,19 @@ end:
 	return ret_code;
 }
 
+/*
+ * Add a value to a process attribute tracker's inclusion set.
+ *
+ * When `should_update_ust_apps` is not NULL, the user space applications are
+ * not updated to reflect the change: `*should_update_ust_apps` is set when the
+ * caller must update them with trace_ust_update_apps().
+ */
 enum lttng_error_code
 cmd_process_attr_tracker_inclusion_set_add_value(const ltt_session::locked_ref& session,
 						 enum lttng_domain_type domain,
 						 enum lttng_process_attr process_attr,
-						 const struct process_attr_value *value)
+						 const struct process_attr_value *value,
+						 bool *should_update_ust_apps)
 {
 	enum lttng_error_code ret_code = LTTNG_OK;
 
@@ -2022,7 +2127,7 @@ cmd_process_attr_tracker_inclusion_set_add_value(const ltt_session::locked_ref&
 			goto end;
 		}
 		ret_code = trace_ust_process_attr_tracker_inclusion_set_add_value(
-			session->ust_session, process_attr, value);
+			session->ust_session, process_attr, value, should_update_ust_apps);
 		break;
 	default:
 		ret_code = LTTNG_ERR_UNSUPPORTED_DOMAIN;
@@ -2032,11 +2137,18 @@ end:
 	return ret_code;
 }
 
+/*
+ * Remove a value from a process attribute tracker's inclusion set.
+ *
+ * `should_update_ust_apps` is used as by
+ * cmd_process_attr_tracker_inclusion_set_add_value().
+ */
 enum lttng_error_code
 cmd_process_attr_tracker_inclusion_set_remove_value(const ltt_session::locked_ref& session,
 						    enum lttng_domain_type domain,
 						    enum lttng_process_attr process_attr,
-						    const struct process_attr_value *value)
+						    const struct process_attr_value *value,
+						    bool *should_update_ust_apps)
 {
 	enum lttng_error_code ret_code = LTTNG_OK;
 
@@ -2055,7 +2167,7 @@ cmd_process_attr_tracker_inclusion_set_remove_value(const ltt_session::locked_re
 			goto end;
 		}
 		ret_code = trace_ust_process_attr_tracker_inclusion_set_remove_value(
-			session->ust_session, process_attr, value);
+			session->ust_session, process_attr, value, should_update_ust_apps);
 		break;
 	default:
 		ret_code = LTTNG_ERR_UNSUPPORTED_DOMAIN;
@@ -2065,6 +2177,90 @@ end:
 	return ret_code;
 }
 
+/*
+ * Add or remove a set of values by applying the single-value command to each
+ * value. The user space applications are updated once, after all the values
+ * are applied, rather than once per value.
+ *
+ * The outcome of the command for each value is stored in `value_ret_codes`,
+ * which holds one entry per value.
+ */
+static enum lttng_error_code
+process_attr_tracker_inclusion_set_apply_values(const ltt_session::locked_ref& session,
+						enum lttng_domain_type domain,
+						enum lttng_process_attr process_attr,
+						const struct lttng_process_attr_values *values,
+						bool add,
+						enum lttng_error_code *value_ret_codes)
+{
+	bool should_update_ust_apps = false;
+
+	switch (domain) {
+	case LTTNG_DOMAIN_KERNEL:
+		if (!session->kernel_session) {
+			return LTTNG_ERR_INVALID;
+		}
+		break;
+	case LTTNG_DOMAIN_UST:
+		if (!session->ust_session) {
+			return LTTNG_ERR_INVALID;
+		}
+		break;
+	default:
+		return LTTNG_ERR_UNSUPPORTED_DOMAIN;
+	}
+
+	for (unsigned int i = 0; i < _lttng_process_attr_values_get_count(values); i++) {
+		const auto *value = lttng_process_attr_tracker_values_get_at_index(values, i);
+
+		value_ret_codes[i] = add ?
+			cmd_process_attr_tracker_inclusion_set_add_value(
+				session, domain, process_attr, value, &should_update_ust_apps) :
+			cmd_process_attr_tracker_inclusion_set_remove_value(
+				session, domain, process_attr, value, &should_update_ust_apps);
+	}
+
+	if (should_update_ust_apps) {
+		trace_ust_update_apps(session->ust_session);
+	}
+
+	return LTTNG_OK;
+}
+
+/*
+ * Add a set of values to a process attribute tracker's inclusion set.
+ *
+ * The outcome of the addition of each value is stored in `value_ret_codes`,
+ * which holds one entry per value.
+ */
+enum lttng_error_code
+cmd_process_attr_tracker_inclusion_set_add_values(const ltt_session::locked_ref& session,
+						  enum lttng_domain_type domain,
+						  enum lttng_process_attr process_attr,
+						  const struct lttng_process_attr_values *values,
+						  enum lttng_error_code *value_ret_codes)
+{
+	return process_attr_tracker_inclusion_set_apply_values(
+		session, domain, process_attr, values, true, value_ret_codes);
+}
+
+/*
+ * Remove a set of values from a process attribute tracker's inclusion set.
+ *
+ * The outcome of the removal of each value is stored in `value_ret_codes`,
+ * which holds one entry per value.
+ */
+enum lttng_error_code
+cmd_process_attr_tracker_inclusion_set_remove_values(const ltt_session::locked_ref& session,
+						     enum lttng_domain_type domain,
+						     enum lttng_process_attr process_attr,
+						     const struct lttng_process_attr_values *values,
+						     enum lttng_error_code *value_ret_codes)
+{
+	return process_attr_tracker_inclusion_set_apply_values(
+		session, domain, process_attr, values, false, value_ret_codes);
+}
+
 enum lttng_error_code
 cmd_process_attr_tracker_get_inclusion_set(const ltt_session::locked_ref& session,
 					   enum lttng_domain_type domain,
@@ -3818,7 +4014,7 @@ enum lttng_error_code cmd_create_session(struct command_ctx *cmd_ctx,
 		goto error;
 	}
 
-	ret = lttcomm_recv_unix_sock(sock, payload.data, payload.size);
+	ret = client_recv_command_data(cmd_ctx, sock, payload.data, payload.size);
 	if (ret <= 0) {
 		ERR("Reception of session descriptor failed, aborting.");
 		ret_code = LTTNG_ERR_SESSION_FAIL;
@@ -4312,29 +4508,37 @@ enum lttng_error_code cmd_list_channels(enum lttng_domain_type domain,
 	{
 		/* Kernel channels */
 		if (session->kernel_session != nullptr) {
+			lsc::channel_runtime_stats_map session_channels_stats;
+			bool has_io_stats;
+
+			ret = get_session_channels_runtime_stats(session,
+								 session->kernel_session->consumer,
+								 session_channels_stats,
+								 has_io_stats);
+			if (ret < 0) {
+				ret_code = LTTNG_ERR_UNK;
+				goto end;
+			}
+
 			for (auto kchan :
 			     lttng::urcu::list_iteration_adapter<ltt_kernel_channel,
 								 &ltt_kernel_channel::list>(
 				     session->kernel_session->channel_list.head)) {
-				uint64_t discarded_events, lost_packets;
 				struct lttng_channel_extended *extended;
 
 				extended = (struct lttng_channel_extended *)
 						   kchan->channel->attr.extended.ptr;
 
-				ret = get_kernel_runtime_stats(
-					session, kchan, &discarded_events, &lost_packets);
-				if (ret < 0) {
-					ret_code = LTTNG_ERR_UNK;
-					goto end;
-				}
+				const auto stats = find_channel_runtime_stats(
+					session_channels_stats, kchan->key);
 
 				/*
 				 * Update the discarded_events and lost_packets
 				 * count for the channel
 				 */
-				extended->discarded_events = discarded_events;
-				extended->lost_packets = lost_packets;
+				extended->discarded_events = stats.discarded_events;
+				extended->lost_packets = stats.lost_packets;
+				set_channel_extended_io_stats(*extended, stats.io, has_io_stats);
 
 				ret = lttng_channel_serialize(kchan->channel, &payload->buffer);
 				if (ret) {
@@ -4351,12 +4555,23 @@ enum lttng_error_code cmd_list_channels(enum lttng_domain_type domain,
 	}
 	case LTTNG_DOMAIN_UST:
 	{
+		lsc::channel_runtime_stats_map session_channels_stats;
+		bool has_io_stats;
+
+		ret = get_session_channels_runtime_stats(session,
+							 session->ust_session->consumer,
+							 session_channels_stats,
+							 has_io_stats);
+		if (ret < 0) {
+			ret_code = LTTNG_ERR_UNK;
+			goto end;
+		}
+
 		for (auto *uchan :
 		     lttng::urcu::lfht_iteration_adapter<ltt_ust_channel,
 							 decltype(ltt_ust_channel::node),
 							 &ltt_ust_channel::node>(
 			     *session->ust_session->domain_global.channels->ht)) {
-			uint64_t discarded_events = 0, lost_packets = 0;
 			struct lttng_channel *channel = nullptr;
 			struct lttng_channel_extended *extended;
 
@@ -4368,16 +4583,15 @@ enum lttng_error_code cmd_list_channels(enum lttng_domain_type domain,
 
 			extended = (struct lttng_channel_extended *) channel->attr.extended.ptr;
 
-			ret = get_ust_runtime_stats(
-				session, uchan, &discarded_events, &lost_packets);
-			if (ret < 0) {
-				lttng_channel_destroy(channel);
-				ret_code = LTTNG_ERR_UNK;
-				goto end;
-			}
+			const auto stats = get_ust_runtime_stats(
+				*session->ust_session, *uchan, session_channels_stats);
 
-			extended->discarded_events = discarded_events;
-			extended->lost_packets = lost_packets;
+			extended->discarded_events = stats.discarded_events;
+			extended->lost_packets = stats.lost_packets;
+			extended->compression_input_bytes = stats.compression.input_bytes;
+			extended->compression_output_bytes = stats.compression.output_bytes;
+			extended->compression_cpu_time_ns = stats.compression.cpu_time_ns;
+			set_channel_extended_io_stats(*extended, stats.io, has_io_stats);
 
 			ret = lttng_channel_serialize(channel, &payload->buffer);
 			if (ret) {
@@ -74,12 +74,26 @@ enum lttng_error_code
 cmd_process_attr_tracker_inclusion_set_add_value(const ltt_session::locked_ref& session,
 						 enum lttng_domain_type domain,
 						 enum lttng_process_attr process_attr,
-						 const struct process_attr_value *value);
+						 const struct process_attr_value *value,
+						 bool *should_update_ust_apps = nullptr);
 enum lttng_error_code
 cmd_process_attr_tracker_inclusion_set_remove_value(const ltt_session::locked_ref& session,
 						    enum lttng_domain_type domain,
 						    enum lttng_process_attr process_attr,
-						    const struct process_attr_value *value);
+						    const struct process_attr_value *value,
+						    bool *should_update_ust_apps = nullptr);
+enum lttng_error_code
+cmd_process_attr_tracker_inclusion_set_add_values(const ltt_session::locked_ref& session,
+						  enum lttng_domain_type domain,
+						  enum lttng_process_attr process_attr,
+						  const struct lttng_process_attr_values *values,
+						  enum lttng_error_code *value_ret_codes);
+enum lttng_error_code
+cmd_process_attr_tracker_inclusion_set_remove_values(const ltt_session::locked_ref& session,
+						     enum lttng_domain_type domain,
+						     enum lttng_process_attr process_attr,
+						     const struct lttng_process_attr_values *values,
+						     enum lttng_error_code *value_ret_codes);
 enum lttng_error_code
 cmd_process_attr_tracker_get_inclusion_set(const ltt_session::locked_ref& session,
 					   enum lttng_domain_type domain,
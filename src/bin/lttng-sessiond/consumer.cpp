@@ -981,6 +981,7 @@ void consumer_init_ask_channel_comm_msg(
 	int64_t blocking_timeout,
 	lttng::sessiond::recording_channel_configuration::buffer_preallocation_policy_t
 		preallocation_policy,
+	lttng::compression::codec_type compression_codec,
 	const nonstd::optional<std::chrono::microseconds>& automatic_memory_reclamation_maximal_age,
 	const char *root_shm_path,
 	const char *shm_path,
@@ -1037,6 +1038,7 @@ void consumer_init_ask_channel_comm_msg(
 	msg->u.ask_channel.preallocate_backing = preallocation_policy ==
 		lttng::sessiond::recording_channel_configuration::buffer_preallocation_policy_t::
 			PREALLOCATE;
+	msg->u.ask_channel.compression_codec = static_cast<uint8_t>(compression_codec);
 
 	if (automatic_memory_reclamation_maximal_age) {
 		LTTNG_OPTIONAL_SET(
@@ -1754,6 +1756,70 @@ end:
 	return ret;
 }
 
+/*
+ * Ask the consumer the packet compression statistics of a channel.
+ */
+int consumer_get_channel_compression_stats(
+	uint64_t session_id,
+	uint64_t channel_key,
+	struct consumer_output *consumer,
+	struct lttcomm_consumer_channel_compression_stats *stats)
+{
+	int ret;
+	struct lttcomm_consumer_msg msg;
+
+	LTTNG_ASSERT(consumer);
+	LTTNG_ASSERT(stats);
+
+	DBG3("Consumer channel compression statistics id %" PRIu64, session_id);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.cmd_type = LTTNG_CONSUMER_GET_CHANNEL_COMPRESSION_STATS;
+	msg.u.channel_compression_stats.session_id = session_id;
+	msg.u.channel_compression_stats.channel_key = channel_key;
+
+	*stats = {};
+
+	/* Send command for each consumer. */
+	for (auto *socket :
+	     lttng::urcu::lfht_iteration_adapter<consumer_socket,
+						 decltype(consumer_socket::node),
+						 &consumer_socket::node>(*consumer->socks->ht)) {
+		struct lttcomm_consumer_channel_compression_stats consumer_stats = {};
+
+		pthread_mutex_lock(socket->lock);
+		ret = consumer_socket_send(socket, &msg, sizeof(msg));
+		if (ret < 0) {
+			pthread_mutex_unlock(socket->lock);
+			goto end;
+		}
+
+		/*
+		 * No need for a recv reply status because the answer to the
+		 * command is the reply status message.
+		 */
+		ret = consumer_socket_recv(socket, &consumer_stats, sizeof(consumer_stats));
+		if (ret < 0) {
+			ERR("get channel compression statistics");
+			pthread_mutex_unlock(socket->lock);
+			goto end;
+		}
+		pthread_mutex_unlock(socket->lock);
+		stats->input_bytes += consumer_stats.input_bytes;
+		stats->output_bytes += consumer_stats.output_bytes;
+		stats->cpu_time_ns += consumer_stats.cpu_time_ns;
+	}
+
+	ret = 0;
+	DBG("Consumer compressed %" PRIu64 " bytes to %" PRIu64 " bytes in session id %" PRIu64,
+	    stats->input_bytes,
+	    stats->output_bytes,
+	    session_id);
+
+end:
+	return ret;
+}
+
 /*
  * Ask the consumer to rotate a channel.
  *
@@ -2058,6 +2124,178 @@ std::vector<lsc::stream_memory_reclamation_result_group> lsc::reclaim_channels_m
 	return result;
 }
 
+lsc::channel_runtime_stats_map lsc::get_session_channels_runtime_stats(std::uint64_t session_id,
+								     consumer_output& consumer)
+{
+	using reply_header = lttcomm_consumer_session_channels_runtime_stats_reply_header;
+	lsc::channel_runtime_stats_map result;
+
+	lttcomm_consumer_msg header = {
+		.cmd_type = LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS,
+		.u = {},
+	};
+
+	header.u.get_session_channels_runtime_stats.session_id = session_id;
+
+	const auto *header_begin = reinterpret_cast<const std::uint8_t *>(&header);
+
+	/* Send the command to each consumer daemon. */
+	for (auto *socket :
+	     lttng::urcu::lfht_iteration_adapter<consumer_socket,
+						 decltype(consumer_socket::node),
+						 &consumer_socket::node>(*consumer.socks->ht)) {
+		health_code_update();
+
+		std::vector<std::uint8_t> request_payload(header_begin,
+							  header_begin + sizeof(header));
+		std::vector<std::uint8_t> reply;
+		{
+			const lttng::pthread::lock_guard socket_lock(*socket->lock);
+
+			reply = consumer_request(*socket,
+						 LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS,
+						 std::move(request_payload));
+		}
+
+		health_code_update();
+
+		/*
+		 * The expected reply format is:
+		 *   [lttcomm_consumer_session_channels_runtime_stats_reply_header] (announces the
+		 *                                                                   channel count)
+		 *   [lttcomm_channel_runtime_stats]
+		 *   [lttcomm_channel_runtime_stats]
+		 *   [...]
+		 */
+		if (reply.size() < sizeof(reply_header)) {
+			LTTNG_THROW_PROTOCOL_ERROR(
+				fmt::format("Consumer reply is too short: command={}",
+					    LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS));
+		}
+
+		const auto channel_count = [&reply]() {
+			const auto& stats_header =
+				*reinterpret_cast<const reply_header *>(reply.data());
+
+			return stats_header.count;
+		}();
+
+		const lttng::binary_view<lttcomm_channel_runtime_stats> channels_stats(
+			reply.data() + sizeof(reply_header),
+			reply.size() - sizeof(reply_header),
+			channel_count);
+
+		/*
+		 * The entries are potentially unaligned (since they are packed), access them
+		 * by value.
+		 */
+		for (const auto channel_stats : channels_stats) {
+			auto& stats = result[channel_stats.channel_key];
+
+			stats.discarded_events += channel_stats.discarded_events;
+			stats.lost_packets += channel_stats.lost_packets;
+			stats.compression.input_bytes += channel_stats.compression.input_bytes;
+			stats.compression.output_bytes += channel_stats.compression.output_bytes;
+			stats.compression.cpu_time_ns += channel_stats.compression.cpu_time_ns;
+		}
+	}
+
+	DBG_FMT("Received runtime statistics of session channels from consumer daemons: session_id={}, channel_count={}",
+		session_id,
+		result.size());
+
+	return result;
+}
+
+lsc::channel_io_stats_map lsc::get_session_channels_io_stats(std::uint64_t session_id,
+							   consumer_output& consumer)
+{
+	using reply_header = lttcomm_consumer_session_streams_io_stats_reply_header;
+	lsc::channel_io_stats_map result;
+
+	lttcomm_consumer_msg header = {
+		.cmd_type = LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS,
+		.u = {},
+	};
+
+	header.u.get_session_streams_io_stats.session_id = session_id;
+
+	const auto *header_begin = reinterpret_cast<const std::uint8_t *>(&header);
+
+	/* Send the command to each consumer daemon. */
+	for (auto *socket :
+	     lttng::urcu::lfht_iteration_adapter<consumer_socket,
+						 decltype(consumer_socket::node),
+						 &consumer_socket::node>(*consumer.socks->ht)) {
+		health_code_update();
+
+		std::vector<std::uint8_t> request_payload(header_begin,
+							  header_begin + sizeof(header));
+		std::vector<std::uint8_t> reply;
+		{
+			const lttng::pthread::lock_guard socket_lock(*socket->lock);
+
+			reply = consumer_request(*socket,
+						 LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS,
+						 std::move(request_payload));
+		}
+
+		health_code_update();
+
+		/*
+		 * The expected reply format is:
+		 *   [lttcomm_consumer_session_streams_io_stats_reply_header] (announces the
+		 *                                                             stream count)
+		 *   [lttcomm_stream_io_stats]
+		 *   [lttcomm_stream_io_stats]
+		 *   [...]
+		 */
+		if (reply.size() < sizeof(reply_header)) {
+			LTTNG_THROW_PROTOCOL_ERROR(
+				fmt::format("Consumer reply is too short: command={}",
+					    LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS));
+		}
+
+		const auto stream_count = [&reply]() {
+			const auto& stats_header =
+				*reinterpret_cast<const reply_header *>(reply.data());
+
+			return stats_header.count;
+		}();
+
+		const lttng::binary_view<lttcomm_stream_io_stats> streams_stats(
+			reply.data() + sizeof(reply_header),
+			reply.size() - sizeof(reply_header),
+			stream_count);
+
+		/*
+		 * The entries are potentially unaligned (since they are packed), access them
+		 * by value.
+		 */
+		for (const auto stream_stats : streams_stats) {
+			const auto subbuffer_consumption = stream_stats.subbuffer_consumption;
+			lsc::channel_io_stats stats;
+
+			stats.consumed_subbuffers = subbuffer_consumption.count;
+			stats.written_bytes = stream_stats.written_bytes;
+			stats.write_calls = stream_stats.write.count;
+			stats.relayd_send_time_ns = stream_stats.relayd_send.total_ns;
+			stats.subbuffer_consumption_p99_ns = subbuffer_consumption.p99_ns;
+			stats.subbuffer_consumption_max_ns = subbuffer_consumption.max_ns;
+			stats.write_p99_ns = stream_stats.write.p99_ns;
+			stats.write_max_ns = stream_stats.write.max_ns;
+
+			result[stream_stats.channel_key].add(stats);
+		}
+	}
+
+	DBG_FMT("Received I/O statistics of session streams from consumer daemons: session_id={}, channel_count={}",
+		session_id,
+		result.size());
+
+	return result;
+}
+
 int consumer_init(struct consumer_socket *socket, const lttng_uuid& sessiond_uuid)
 {
 	int ret;
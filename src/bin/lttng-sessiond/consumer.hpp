@@ -13,6 +13,7 @@
 #include "snapshot.hpp"
 #include "ust-app.hpp"
 
+#include <common/compression/codec.hpp>
 #include <common/consumer/consumer-type.hpp>
 #include <common/hashtable/hashtable.hpp>
 
@@ -20,7 +21,9 @@
 
 #include <vendor/optional.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <unordered_map>
 #include <urcu/ref.h>
 
 struct snapshot;
@@ -269,6 +272,7 @@ void consumer_init_ask_channel_comm_msg(
 	int64_t blocking_timeout,
 	lttng::sessiond::recording_channel_configuration::buffer_preallocation_policy_t
 		preallocation_policy,
+	lttng::compression::codec_type compression_codec,
 	const nonstd::optional<std::chrono::microseconds>& automatic_memory_reclamation_maximal_age,
 	const char *root_shm_path,
 	const char *shm_path,
@@ -320,6 +324,11 @@ int consumer_get_lost_packets(uint64_t session_id,
 			      uint64_t channel_key,
 			      struct consumer_output *consumer,
 			      uint64_t *lost);
+int consumer_get_channel_compression_stats(
+	uint64_t session_id,
+	uint64_t channel_key,
+	struct consumer_output *consumer,
+	struct lttcomm_consumer_channel_compression_stats *stats);
 
 /* Snapshot command. */
 enum lttng_error_code consumer_snapshot_channel(struct consumer_socket *socket,
@@ -419,6 +428,63 @@ reclaim_channels_memory(consumer_socket& socket,
 			bool require_consumed,
 			std::uint64_t memory_reclaim_request_token);
 
+/*
+ * I/O statistics of the data streams of a channel. Counters are summed over the
+ * streams while the percentiles and maxima (ns) are those of the slowest stream.
+ */
+struct channel_io_stats {
+	std::uint64_t consumed_subbuffers = 0;
+	std::uint64_t written_bytes = 0;
+	std::uint64_t write_calls = 0;
+	std::uint64_t relayd_send_time_ns = 0;
+	std::uint64_t subbuffer_consumption_p99_ns = 0;
+	std::uint64_t subbuffer_consumption_max_ns = 0;
+	std::uint64_t write_p99_ns = 0;
+	std::uint64_t write_max_ns = 0;
+
+	void add(const channel_io_stats& other) noexcept
+	{
+		consumed_subbuffers += other.consumed_subbuffers;
+		written_bytes += other.written_bytes;
+		write_calls += other.write_calls;
+		relayd_send_time_ns += other.relayd_send_time_ns;
+		subbuffer_consumption_p99_ns =
+			std::max(subbuffer_consumption_p99_ns, other.subbuffer_consumption_p99_ns);
+		subbuffer_consumption_max_ns =
+			std::max(subbuffer_consumption_max_ns, other.subbuffer_consumption_max_ns);
+		write_p99_ns = std::max(write_p99_ns, other.write_p99_ns);
+		write_max_ns = std::max(write_max_ns, other.write_max_ns);
+	}
+};
+
+struct channel_runtime_stats {
+	std::uint64_t discarded_events = 0;
+	std::uint64_t lost_packets = 0;
+	lttcomm_consumer_channel_compression_stats compression = {};
+	channel_io_stats io;
+};
+
+/* Runtime statistics of channels, indexed by consumer channel key. */
+using channel_runtime_stats_map = std::unordered_map<std::uint64_t, channel_runtime_stats>;
+
+/*
+ * Get the runtime statistics of all the channels of a session with a single
+ * command per consumer daemon of `consumer`. The statistics reported by many
+ * consumer daemons for the same channel key are summed.
+ */
+channel_runtime_stats_map get_session_channels_runtime_stats(std::uint64_t session_id,
+							     consumer_output& consumer);
+
+/* I/O statistics of channels, indexed by consumer channel key. */
+using channel_io_stats_map = std::unordered_map<std::uint64_t, channel_io_stats>;
+
+/*
+ * Get the I/O statistics of the data streams of a session with a single
+ * command per consumer daemon of `consumer`, aggregated per channel.
+ */
+channel_io_stats_map get_session_channels_io_stats(std::uint64_t session_id,
+						   consumer_output& consumer);
+
 } /* namespace consumer */
 } /* namespace sessiond */
 } /* namespace lttng */
@@ -40,6 +40,8 @@ consumer_data the_kconsumer_data(LTTNG_CONSUMER_KERNEL);
 consumer_data the_ustconsumer64_data(LTTNG_CONSUMER64_UST);
 consumer_data the_ustconsumer32_data(LTTNG_CONSUMER32_UST);
 
+lttng::sessiond::bytecode_cache the_bytecode_cache;
+
 enum consumerd_state the_ust_consumerd_state;
 enum consumerd_state the_kernel_consumerd_state;
 
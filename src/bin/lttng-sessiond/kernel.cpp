@@ -42,13 +42,18 @@
 #include <lttng/userspace-probe-internal.hpp>
 #include <lttng/userspace-probe.h>
 
+#include <algorithm>
 #include <fcntl.h>
+#include <functional>
 #include <inttypes.h>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
 namespace {
 /*
@@ -66,6 +71,23 @@ int kernel_tracer_event_notifier_group_notification_fd = -1;
 bool kernel_tracer_event_notifier_group_notification_fd_registered = false;
 struct cds_lfht *kernel_token_to_event_notifier_rule_ht;
 
+const char *proc_modules_path = "/proc/modules";
+
+/*
+ * Catalog of the kernel tracepoints, as listed by the kernel tracer.
+ *
+ * Listing the tracepoints requires the kernel tracer to walk all of its
+ * registered probes. The catalog is kept until the set of loaded kernel
+ * modules changes.
+ */
+struct kernel_event_catalog {
+	std::mutex lock;
+	bool valid = false;
+	/* Fingerprint of the loaded kernel modules at the time of the listing. */
+	std::size_t modules_fingerprint = 0;
+	std::vector<struct lttng_event> events;
+} the_kernel_event_catalog;
+
 const char *kernel_tracer_status_to_str(lttng_kernel_tracer_status status)
 {
 	switch (status) {
@@ -115,6 +137,45 @@ inline uint64_t sanitize_uprobe_offset(uint64_t raw_offset)
 	return raw_offset;
 }
 #endif
+
+/*
+ * Compute a fingerprint of the set of loaded kernel modules.
+ *
+ * Kernel modules (lttng-modules probes included) can be loaded and unloaded
+ * without the involvement of the session daemon. Only the name and size of
+ * the modules are considered as their reference count changes constantly.
+ *
+ * Returns nullopt if the loaded modules can't be listed.
+ */
+nonstd::optional<std::size_t> loaded_kernel_modules_fingerprint()
+{
+	FILE *fp;
+	char *line = nullptr;
+	size_t line_len = 0;
+	std::string modules;
+
+	fp = fopen(proc_modules_path, "r");
+	if (!fp) {
+		DBG("Failed to open %s: %s", proc_modules_path, strerror(errno));
+		return nonstd::nullopt;
+	}
+
+	/* Each line is: name size refcount dependencies state address. */
+	while (getline(&line, &line_len, fp) != -1) {
+		const char *name_end = strchrnul(line, ' ');
+		const char *size_end = *name_end ? strchrnul(name_end + 1, ' ') : name_end;
+
+		modules.append(line, size_end - line);
+		modules.push_back('\n');
+	}
+
+	free(line);
+	if (fclose(fp)) {
+		PERROR("Failed to close %s", proc_modules_path);
+	}
+
+	return std::hash<std::string>()(modules);
+}
 } /* namespace */
 
 /*
@@ -1471,7 +1532,7 @@ error:
 /*
  * Get the event list from the kernel tracer and return the number of elements.
  */
-ssize_t kernel_list_events(struct lttng_event **events)
+static ssize_t list_kernel_tracepoints(struct lttng_event **events)
 {
 	int fd, ret;
 	char *event;
@@ -1553,6 +1614,71 @@ error:
 	return -1;
 }
 
+/*
+ * Get the kernel event catalog and return the number of elements.
+ *
+ * The tracepoints are only listed from the kernel tracer when the catalog was
+ * invalidated or when the set of loaded kernel modules changed since the last
+ * listing. The caller owns the returned array.
+ */
+ssize_t kernel_list_events(struct lttng_event **events)
+{
+	LTTNG_ASSERT(events);
+
+	const std::lock_guard<std::mutex> lock(the_kernel_event_catalog.lock);
+	const auto modules_fingerprint = loaded_kernel_modules_fingerprint();
+	auto& catalog = the_kernel_event_catalog;
+
+	if (!catalog.valid || !modules_fingerprint ||
+	    *modules_fingerprint != catalog.modules_fingerprint) {
+		struct lttng_event *listed_events;
+		const auto count = list_kernel_tracepoints(&listed_events);
+
+		if (count < 0) {
+			return count;
+		}
+
+		try {
+			catalog.events.assign(listed_events, listed_events + count);
+		} catch (const std::bad_alloc&) {
+			ERR("Failed to allocate kernel event catalog");
+			free(listed_events);
+			catalog.valid = false;
+			return -ENOMEM;
+		}
+
+		free(listed_events);
+
+		/* Without a fingerprint, changes to the loaded modules can't be detected. */
+		catalog.valid = modules_fingerprint.has_value();
+		catalog.modules_fingerprint = modules_fingerprint.value_or(0);
+		DBG("Kernel event catalog updated (%zu events)", catalog.events.size());
+	} else {
+		DBG("Using cached kernel event catalog (%zu events)", catalog.events.size());
+	}
+
+	/* Always allocate, even for an empty catalog, as the callers expect an array. */
+	*events = calloc<lttng_event>(std::max<std::size_t>(catalog.events.size(), 1));
+	if (!*events) {
+		PERROR("alloc list events");
+		return -ENOMEM;
+	}
+
+	std::copy(catalog.events.begin(), catalog.events.end(), *events);
+	return catalog.events.size();
+}
+
+/*
+ * Invalidate the kernel event catalog, forcing the next listing to query the
+ * kernel tracer.
+ */
+void kernel_invalidate_event_catalog()
+{
+	const std::lock_guard<std::mutex> lock(the_kernel_event_catalog.lock);
+
+	the_kernel_event_catalog.valid = false;
+}
+
 /*
  * Get kernel version and validate it.
  */
@@ -57,6 +57,7 @@ int kernel_metadata_flush_buffer(int fd);
 int kernel_start_session(struct ltt_kernel_session *session);
 int kernel_stop_session(struct ltt_kernel_session *session);
 ssize_t kernel_list_events(struct lttng_event **event_list);
+void kernel_invalidate_event_catalog();
 void kernel_wait_quiescent();
 int kernel_validate_version(struct lttng_kernel_abi_tracer_version *kernel_tracer_version,
 			    struct lttng_kernel_abi_tracer_abi_version *kernel_tracer_abi_version);
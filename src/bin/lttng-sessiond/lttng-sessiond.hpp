@@ -9,6 +9,7 @@
 #ifndef _LTT_SESSIOND_H
 #define _LTT_SESSIOND_H
 
+#include "bytecode-cache.hpp"
 #include "notification-thread.hpp"
 #include "rotation-thread.hpp"
 #include "session.hpp"
@@ -82,6 +83,15 @@ struct command_ctx {
 	/* Reply content, starts with an lttcomm_lttng_msg header. */
 	struct lttng_payload reply_payload;
 	lttng_sock_cred creds;
+	/*
+	 * On persistent connections, the variable length data and fds of the
+	 * command are received before it is processed and are consumed from
+	 * this payload (see client_recv_command_data()).
+	 */
+	bool is_data_received;
+	struct lttng_payload received_data;
+	size_t received_data_position;
+	size_t received_fd_handles_position;
 };
 
 struct ust_command {
@@ -143,6 +153,9 @@ extern struct consumer_data the_ustconsumer32_data;
 extern struct consumer_data the_ustconsumer64_data;
 extern struct consumer_data the_kconsumer_data;
 
+/* Filter bytecodes shared by the events of all sessions. */
+extern lttng::sessiond::bytecode_cache the_bytecode_cache;
+
 int sessiond_init_main_quit_pipe();
 int sessiond_wait_for_main_quit_pipe(int timeout_ms);
 int sessiond_notify_main_quit_pipe();
@@ -15,11 +15,24 @@
 #include <common/kernel-ctl/kernel-ctl.hpp>
 #include <common/urcu.hpp>
 
+#include <algorithm>
+#include <mutex>
 #include <stdbool.h>
+#include <vector>
 
 /* Global syscall table. */
 std::vector<struct syscall> syscall_table;
 
+namespace {
+/*
+ * Deduplicated listing of the system calls of the syscall table, built on
+ * the first listing since the table is only populated once.
+ */
+std::mutex syscall_catalog_lock;
+bool syscall_catalog_valid;
+std::vector<struct lttng_event> syscall_catalog;
+} /* namespace */
+
 /*
  * Populate the system call table using the kernel tracer.
  *
@@ -41,6 +54,12 @@ int syscall_init_table(int tracer_fd)
 
 	DBG3("Syscall init system call table");
 
+	{
+		const std::lock_guard<std::mutex> lock(syscall_catalog_lock);
+
+		syscall_catalog_valid = false;
+	}
+
 	fd = kernctl_syscall_list(tracer_fd);
 	if (fd < 0) {
 		ret = fd;
@@ -223,7 +242,7 @@ error:
  *
  * Return the number of entries in the array else a negative value.
  */
-ssize_t syscall_table_list(struct lttng_event **_events)
+static ssize_t list_syscalls(struct lttng_event **_events)
 {
 	int i, index = 0;
 	ssize_t ret;
@@ -292,3 +311,47 @@ error:
 	free(events);
 	return ret;
 }
+
+/*
+ * Get the deduplicated list of the system calls of the syscall table,
+ * listing them on the first call.
+ *
+ * Return the number of entries in the array else a negative value. The
+ * caller owns the returned array.
+ */
+ssize_t syscall_table_list(struct lttng_event **events)
+{
+	LTTNG_ASSERT(events);
+
+	const std::lock_guard<std::mutex> lock(syscall_catalog_lock);
+
+	if (!syscall_catalog_valid) {
+		struct lttng_event *listed_events;
+		const auto count = list_syscalls(&listed_events);
+
+		if (count < 0) {
+			return count;
+		}
+
+		try {
+			syscall_catalog.assign(listed_events, listed_events + count);
+		} catch (const std::bad_alloc&) {
+			ERR("Failed to allocate syscall catalog");
+			free(listed_events);
+			return -LTTNG_ERR_NOMEM;
+		}
+
+		free(listed_events);
+		syscall_catalog_valid = true;
+	}
+
+	/* Always allocate, even for an empty catalog, as the callers expect an array. */
+	*events = calloc<lttng_event>(std::max<std::size_t>(syscall_catalog.size(), 1));
+	if (!*events) {
+		PERROR("syscall table list zmalloc");
+		return -LTTNG_ERR_NOMEM;
+	}
+
+	std::copy(syscall_catalog.begin(), syscall_catalog.end(), *events);
+	return syscall_catalog.size();
+}
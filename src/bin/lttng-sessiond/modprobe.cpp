@@ -15,6 +15,7 @@
 
 #define _LGPL_SOURCE
 #include "kern-modules.hpp"
+#include "kernel.hpp"
 #include "lttng-sessiond.hpp"
 #include "modprobe.hpp"
 
@@ -640,6 +641,7 @@ static void modprobe_remove_lttng(const struct kern_modules_param *modules, int
 void modprobe_remove_lttng_control()
 {
 	modprobe_remove_lttng(kern_modules_control_core, ARRAY_SIZE(kern_modules_control_core));
+	kernel_invalidate_event_catalog();
 }
 
 static void free_probes()
@@ -668,6 +670,7 @@ void modprobe_remove_lttng_data()
 
 	modprobe_remove_lttng(probes, nr_probes);
 	free_probes();
+	kernel_invalidate_event_catalog();
 }
 
 /*
@@ -684,7 +687,11 @@ void modprobe_remove_lttng_all()
  */
 int modprobe_lttng_control()
 {
-	return modprobe_lttng(kern_modules_control_core, ARRAY_SIZE(kern_modules_control_core));
+	const auto ret =
+		modprobe_lttng(kern_modules_control_core, ARRAY_SIZE(kern_modules_control_core));
+
+	kernel_invalidate_event_catalog();
+	return ret;
 }
 
 /*
@@ -861,6 +868,7 @@ int modprobe_lttng_data()
 	 * Load probes modules now.
 	 */
 	ret = modprobe_lttng(probes, nr_probes);
+	kernel_invalidate_event_catalog();
 	if (ret) {
 		goto error;
 	}
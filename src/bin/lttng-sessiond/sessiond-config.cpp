@@ -28,6 +28,7 @@ static struct sessiond_config sessiond_config_build_defaults = {
 	.event_notifier_buffer_size_kernel = DEFAULT_EVENT_NOTIFIER_ERROR_COUNT_MAP_SIZE,
 	.event_notifier_buffer_size_userspace = DEFAULT_EVENT_NOTIFIER_ERROR_COUNT_MAP_SIZE,
 	.app_socket_timeout = DEFAULT_APP_SOCKET_RW_TIMEOUT,
+	.client_worker_count = DEFAULT_SESSIOND_CLIENT_WORKER_COUNT,
 
 	.quiet = false,
 
@@ -35,6 +36,7 @@ static struct sessiond_config sessiond_config_build_defaults = {
 	.background = false,
 	.daemonize = false,
 	.sig_parent = false,
+	.experimental_packet_compression = false,
 
 	.default_trace_format = LTTNG_TRACE_FORMAT_CTF_2,
 
@@ -119,6 +121,24 @@ int sessiond_config_apply_env_config(struct sessiond_config *config)
 		config->app_socket_timeout = int_val;
 	}
 
+	env_value = getenv(DEFAULT_SESSIOND_CLIENT_WORKER_COUNT_ENV);
+	if (env_value) {
+		char *endptr;
+		unsigned long worker_count;
+
+		errno = 0;
+		worker_count = strtoul(env_value, &endptr, 0);
+		if (errno != 0 || *endptr != '\0' || worker_count == 0 || worker_count > UINT_MAX) {
+			ERR("Invalid value \"%s\" used for \"%s\" environment variable",
+			    env_value,
+			    DEFAULT_SESSIOND_CLIENT_WORKER_COUNT_ENV);
+			ret = -1;
+			goto end;
+		}
+
+		config->client_worker_count = worker_count;
+	}
+
 	env_value = lttng_secure_getenv("LTTNG_CONSUMERD32_BIN");
 	if (env_value) {
 		config_string_set_static(&config->consumerd32_bin_path, env_value);
@@ -171,6 +191,21 @@ int sessiond_config_apply_env_config(struct sessiond_config *config)
 			goto end;
 		}
 	}
+
+	env_value = getenv(DEFAULT_SESSIOND_EXPERIMENTAL_PACKET_COMPRESSION_ENV);
+	if (env_value) {
+		if (strcmp(env_value, "1") == 0) {
+			config->experimental_packet_compression = true;
+		} else if (strcmp(env_value, "0") == 0) {
+			config->experimental_packet_compression = false;
+		} else {
+			ERR_FMT("Invalid value `{}` for `{}` environment variable: expecting `0` or `1`",
+				env_value,
+				DEFAULT_SESSIOND_EXPERIMENTAL_PACKET_COMPRESSION_ENV);
+			ret = -1;
+			goto end;
+		}
+	}
 end:
 	return ret;
 }
@@ -540,6 +575,7 @@ void sessiond_config_log(struct sessiond_config *config)
 			   config->agent_tcp_port.end);
 	}
 	DBG_NO_LOC("\tapplication socket timeout:    %i", config->app_socket_timeout);
+	DBG_NO_LOC("\tclient worker count:           %u", config->client_worker_count);
 	DBG_NO_LOC("\tno-kernel:                     %s", config->no_kernel ? "True" : "False");
 	DBG_NO_LOC("\tbackground:                    %s", config->background ? "True" : "False");
 	DBG_NO_LOC("\tdaemonize:                     %s", config->daemonize ? "True" : "False");
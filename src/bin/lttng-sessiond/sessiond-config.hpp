@@ -36,12 +36,16 @@ struct sessiond_config {
 	int event_notifier_buffer_size_userspace;
 	/* Socket timeout for receiving and sending (in seconds). */
 	int app_socket_timeout;
+	/* Number of threads processing client commands. */
+	unsigned int client_worker_count;
 
 	bool quiet;
 	bool no_kernel;
 	bool background;
 	bool daemonize;
 	bool sig_parent;
+	/* Allow channels to compress their packets (experimental). */
+	bool experimental_packet_compression;
 
 	enum lttng_trace_format default_trace_format;
 
@@ -9,6 +9,7 @@
 #define _LGPL_SOURCE
 #include "agent.hpp"
 #include "buffer-registry.hpp"
+#include "lttng-sessiond.hpp"
 #include "trace-ust.hpp"
 #include "ust-app.hpp"
 #include "utils.hpp"
@@ -425,6 +426,8 @@ struct ltt_ust_channel *trace_ust_create_channel(struct lttng_channel *chan,
 		}
 	}(static_cast<enum lttng_channel_preallocation_policy>(extended->preallocation_policy));
 
+	luc->compression = static_cast<lttng::compression::codec_type>(extended->compression);
+
 	/* Translate to UST output enum */
 	switch (luc->attr.output) {
 	default:
@@ -575,9 +578,20 @@ enum lttng_error_code trace_ust_create_event(struct lttng_event *ev,
 		goto error;
 	}
 
-	/* Same layout. */
+	if (filter) {
+		try {
+			local_ust_event->filter = the_bytecode_cache.get(*filter);
+		} catch (const std::bad_alloc&) {
+			ERR_FMT("Failed to cache UST event filter bytecode: event_name=`{}`",
+				local_ust_event->attr.name);
+			ret = LTTNG_ERR_NOMEM;
+			goto error;
+		}
+
+		free(filter);
+	}
+
 	local_ust_event->filter_expression = filter_expression;
-	local_ust_event->filter = filter;
 	local_ust_event->exclusion = exclusion;
 
 	/* Init node */
@@ -1027,14 +1041,20 @@ end:
 	return ret_code;
 }
 
-/* Called with the session lock held. */
-enum lttng_error_code
-trace_ust_process_attr_tracker_inclusion_set_add_value(struct ltt_ust_session *session,
-						       enum lttng_process_attr process_attr,
-						       const struct process_attr_value *value)
+/*
+ * Add a value to a process attribute tracker's inclusion set without updating
+ * the applications. `should_update_apps` is set when the applications of an
+ * active session must be updated to reflect the change.
+ *
+ * Called with the session lock held.
+ */
+static enum lttng_error_code
+_trace_ust_process_attr_tracker_inclusion_set_add_value(struct ltt_ust_session *session,
+							enum lttng_process_attr process_attr,
+							const struct process_attr_value *value,
+							bool *should_update_apps)
 {
 	enum lttng_error_code ret_code = LTTNG_OK;
-	bool should_update_apps = false;
 	struct ust_id_tracker *id_tracker = get_id_tracker(session, process_attr);
 	struct process_attr_tracker *tracker;
 	int integral_value;
@@ -1118,28 +1138,31 @@ trace_ust_process_attr_tracker_inclusion_set_add_value(struct ltt_ust_session *s
 	switch (process_attr) {
 	case LTTNG_PROCESS_ATTR_VIRTUAL_PROCESS_ID:
 		if (ust_app_find_by_pid(integral_value)) {
-			should_update_apps = true;
+			*should_update_apps = true;
 		}
 		break;
 	default:
-		should_update_apps = true;
+		*should_update_apps = true;
 		break;
 	}
-	if (should_update_apps && session->active) {
-		ust_app_global_update_all(session);
-	}
 end:
 	return ret_code;
 }
 
-/* Called with the session lock held. */
-enum lttng_error_code
-trace_ust_process_attr_tracker_inclusion_set_remove_value(struct ltt_ust_session *session,
-							  enum lttng_process_attr process_attr,
-							  const struct process_attr_value *value)
+/*
+ * Remove a value from a process attribute tracker's inclusion set without
+ * updating the applications. `should_update_apps` is set when the applications
+ * of an active session must be updated to reflect the change.
+ *
+ * Called with the session lock held.
+ */
+static enum lttng_error_code
+_trace_ust_process_attr_tracker_inclusion_set_remove_value(struct ltt_ust_session *session,
+							   enum lttng_process_attr process_attr,
+							   const struct process_attr_value *value,
+							   bool *should_update_apps)
 {
 	enum lttng_error_code ret_code = LTTNG_OK;
-	bool should_update_apps = false;
 	struct ust_id_tracker *id_tracker = get_id_tracker(session, process_attr);
 	struct process_attr_tracker *tracker;
 	int integral_value;
@@ -1223,20 +1246,71 @@ trace_ust_process_attr_tracker_inclusion_set_remove_value(struct ltt_ust_session
 	switch (process_attr) {
 	case LTTNG_PROCESS_ATTR_VIRTUAL_PROCESS_ID:
 		if (ust_app_find_by_pid(integral_value)) {
-			should_update_apps = true;
+			*should_update_apps = true;
 		}
 		break;
 	default:
-		should_update_apps = true;
+		*should_update_apps = true;
 		break;
 	}
-	if (should_update_apps && session->active) {
-		ust_app_global_update_all(session);
-	}
 end:
 	return ret_code;
 }
 
+/*
+ * Update the applications after a change of a process attribute tracker's
+ * inclusion set, unless `should_update_apps` is not NULL: it is then set when
+ * the caller must update them with trace_ust_update_apps().
+ */
+static void update_apps_after_tracker_change(struct ltt_ust_session *session,
+					     bool change_affects_apps,
+					     bool *should_update_apps)
+{
+	if (should_update_apps) {
+		*should_update_apps |= change_affects_apps;
+	} else if (change_affects_apps) {
+		trace_ust_update_apps(session);
+	}
+}
+
+/* Called with the session lock held. */
+enum lttng_error_code
+trace_ust_process_attr_tracker_inclusion_set_add_value(struct ltt_ust_session *session,
+						       enum lttng_process_attr process_attr,
+						       const struct process_attr_value *value,
+						       bool *should_update_apps)
+{
+	bool change_affects_apps = false;
+	const auto ret_code = _trace_ust_process_attr_tracker_inclusion_set_add_value(
+		session, process_attr, value, &change_affects_apps);
+
+	update_apps_after_tracker_change(session, change_affects_apps, should_update_apps);
+	return ret_code;
+}
+
+/* Called with the session lock held. */
+enum lttng_error_code
+trace_ust_process_attr_tracker_inclusion_set_remove_value(struct ltt_ust_session *session,
+							  enum lttng_process_attr process_attr,
+							  const struct process_attr_value *value,
+							  bool *should_update_apps)
+{
+	bool change_affects_apps = false;
+	const auto ret_code = _trace_ust_process_attr_tracker_inclusion_set_remove_value(
+		session, process_attr, value, &change_affects_apps);
+
+	update_apps_after_tracker_change(session, change_affects_apps, should_update_apps);
+	return ret_code;
+}
+
+/* Called with the session lock held. */
+void trace_ust_update_apps(struct ltt_ust_session *session)
+{
+	if (session->active) {
+		ust_app_global_update_all(session);
+	}
+}
+
 /*
  * RCU safe free context structure.
  */
@@ -1280,7 +1354,7 @@ void trace_ust_destroy_event(struct ltt_ust_event *event)
 
 	DBG2("Trace destroy UST event %s", event->attr.name);
 	free(event->filter_expression);
-	free(event->filter);
+	the_bytecode_cache.put(event->filter);
 	free(event->exclusion);
 	delete event;
 }
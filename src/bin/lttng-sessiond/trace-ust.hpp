@@ -13,10 +13,12 @@
 #include "lttng-ust-ctl.hpp"
 #include "recording-channel-configuration.hpp"
 
+#include <common/compression/codec.hpp>
 #include <common/defaults.hpp>
 #include <common/fs-utils.hpp>
 #include <common/hashtable/hashtable.hpp>
 #include <common/optional.hpp>
+#include <common/sessiond-comm/sessiond-comm.hpp>
 #include <common/tracker.hpp>
 
 #include <lttng/lttng.h>
@@ -47,7 +49,8 @@ struct ltt_ust_event {
 	struct lttng_ust_abi_event attr = {};
 	struct lttng_ht_node_str node = {};
 	char *filter_expression = nullptr;
-	struct lttng_bytecode *filter = nullptr;
+	/* Reference to the shared copy held by the_bytecode_cache. */
+	const struct lttng_bytecode *filter = nullptr;
 	struct lttng_event_exclusion *exclusion = nullptr;
 	/*
 	 * An internal event is an event which was created by the session daemon
@@ -77,12 +80,14 @@ struct ltt_ust_channel {
 	uint64_t tracefile_count = 0;
 	uint64_t per_pid_closed_app_discarded = 0;
 	uint64_t per_pid_closed_app_lost = 0;
+	struct lttcomm_consumer_channel_compression_stats per_pid_closed_app_compression = {};
 	uint64_t monitor_timer_interval = 0;
 	LTTNG_OPTIONAL(uint64_t) watchdog_timer_interval = {};
 
 	lttng::sessiond::recording_channel_configuration::buffer_preallocation_policy_t
 		preallocation_policy = lttng::sessiond::recording_channel_configuration::
 			buffer_preallocation_policy_t::PREALLOCATE;
+	lttng::compression::codec_type compression = lttng::compression::codec_type::NONE;
 	nonstd::optional<std::chrono::microseconds> automatic_memory_reclamation_maximal_age;
 };
 
@@ -246,14 +251,22 @@ enum lttng_error_code
 trace_ust_process_attr_tracker_set_tracking_policy(struct ltt_ust_session *session,
 						   enum lttng_process_attr process_attr,
 						   enum lttng_tracking_policy policy);
+/*
+ * When `should_update_apps` is not NULL, the applications are not updated to
+ * reflect the change: `*should_update_apps` is set when the caller must update
+ * them with trace_ust_update_apps().
+ */
 enum lttng_error_code
 trace_ust_process_attr_tracker_inclusion_set_add_value(struct ltt_ust_session *session,
 						       enum lttng_process_attr process_attr,
-						       const struct process_attr_value *value);
+						       const struct process_attr_value *value,
+						       bool *should_update_apps);
 enum lttng_error_code
 trace_ust_process_attr_tracker_inclusion_set_remove_value(struct ltt_ust_session *session,
 							  enum lttng_process_attr process_attr,
-							  const struct process_attr_value *value);
+							  const struct process_attr_value *value,
+							  bool *should_update_apps);
+void trace_ust_update_apps(struct ltt_ust_session *session);
 const struct process_attr_tracker *
 trace_ust_get_process_attr_tracker(struct ltt_ust_session *session,
 				   enum lttng_process_attr process_attr);
@@ -390,7 +403,8 @@ static inline enum lttng_error_code trace_ust_process_attr_tracker_set_tracking_
 static inline enum lttng_error_code trace_ust_process_attr_tracker_inclusion_set_add_value(
 	struct ltt_ust_session *session __attribute__((unused)),
 	enum lttng_process_attr process_attr __attribute__((unused)),
-	const struct process_attr_value *value __attribute__((unused)))
+	const struct process_attr_value *value __attribute__((unused)),
+	bool *should_update_apps __attribute__((unused)))
 {
 	return LTTNG_OK;
 }
@@ -398,11 +412,16 @@ static inline enum lttng_error_code trace_ust_process_attr_tracker_inclusion_set
 static inline enum lttng_error_code trace_ust_process_attr_tracker_inclusion_set_remove_value(
 	struct ltt_ust_session *session __attribute__((unused)),
 	enum lttng_process_attr process_attr __attribute__((unused)),
-	const struct process_attr_value *value __attribute__((unused)))
+	const struct process_attr_value *value __attribute__((unused)),
+	bool *should_update_apps __attribute__((unused)))
 {
 	return LTTNG_OK;
 }
 
+static inline void trace_ust_update_apps(struct ltt_ust_session *session __attribute__((unused)))
+{
+}
+
 static inline const struct process_attr_tracker *
 trace_ust_get_process_attr_tracker(struct ltt_ust_session *session __attribute__((unused)),
 				   enum lttng_process_attr process_attr __attribute__((unused)))
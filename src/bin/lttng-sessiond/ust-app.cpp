@@ -22,6 +22,7 @@
 #include "ust-app.hpp"
 #include "ust-consumer.hpp"
 #include "ust-field-quirks.hpp"
+#include "ust-tracepoint-catalog.hpp"
 #include "utils.hpp"
 
 #include <common/bytecode/bytecode.hpp>
@@ -144,6 +145,58 @@ error:
 }
 
 namespace {
+/*
+ * Bounds how long tracepoint providers loaded by an application after its
+ * provider set was listed remain unlisted.
+ */
+constexpr std::chrono::seconds tracepoint_catalog_max_list_age(10);
+
+lsu::tracepoint_catalog the_tracepoint_catalog(tracepoint_catalog_max_list_age);
+
+using catalog_tracepoint_list = lsu::tracepoint_catalog::tracepoint_list;
+using catalog_field_list = lsu::tracepoint_catalog::field_list;
+
+lsu::tracepoint_catalog::provider_set_key get_provider_set_key(const ust_app& app)
+{
+	return { app.name,
+		 app.uid,
+		 app.abi.bits_per_long,
+		 app.v_major,
+		 app.v_minor,
+		 app.exe_identity.dev,
+		 app.exe_identity.ino,
+		 app.exe_identity.mtime,
+		 app.exe_identity.is_known ? 0 : app.pid };
+}
+
+/*
+ * Examine the executable of an application so that the applications running
+ * the same executable share their tracepoint listings.
+ */
+void set_exe_identity(ust_app& app)
+{
+	char exe_path[32];
+	struct stat exe_stat;
+	int ret;
+
+	ret = snprintf(exe_path, sizeof(exe_path), "/proc/%d/exe", (int) app.pid);
+	LTTNG_ASSERT(ret > 0 && ret < (int) sizeof(exe_path));
+
+	ret = stat(exe_path, &exe_stat);
+	if (ret) {
+		DBG_FMT("Failed to examine the executable of application, its tracepoint listings will not be shared: pid={}, name=`{}`, error=`{}`",
+			app.pid,
+			app.name,
+			strerror(errno));
+		return;
+	}
+
+	app.exe_identity.is_known = true;
+	app.exe_identity.dev = exe_stat.st_dev;
+	app.exe_identity.ino = exe_stat.st_ino;
+	app.exe_identity.mtime = exe_stat.st_mtime;
+}
+
 lsu::registry_session::locked_ref
 get_locked_session_registry(const ust_app_session::identifier& identifier)
 {
@@ -536,7 +589,7 @@ static void delete_ust_app_event(int sock, struct ust_app_event *ua_event, struc
 	LTTNG_ASSERT(ua_event);
 	ASSERT_RCU_READ_LOCKED();
 
-	free(ua_event->filter);
+	the_bytecode_cache.put(ua_event->filter);
 	if (ua_event->exclusion != nullptr)
 		free(ua_event->exclusion);
 	if (ua_event->obj != nullptr) {
@@ -689,6 +742,7 @@ static void delete_ust_app_channel_rcu(struct rcu_head *head)
 static void save_per_pid_lost_discarded_counters(struct ust_app_channel *ua_chan)
 {
 	uint64_t discarded = 0, lost = 0;
+	struct lttcomm_consumer_channel_compression_stats compression_stats = {};
 	struct ltt_ust_channel *uchan;
 
 	/* Metadata channels do not have discarded counters. */
@@ -734,6 +788,12 @@ static void save_per_pid_lost_discarded_counters(struct ust_app_channel *ua_chan
 						      session->ust_session->consumer,
 						      &discarded);
 		}
+		if (ua_chan->compression != lttng::compression::codec_type::NONE) {
+			consumer_get_channel_compression_stats(ua_chan->session->tracing_id,
+							       ua_chan->key,
+							       session->ust_session->consumer,
+							       &compression_stats);
+		}
 		uchan = trace_ust_find_channel_by_name(session->ust_session->domain_global.channels,
 						       ua_chan->name);
 		if (!uchan) {
@@ -749,6 +809,9 @@ static void save_per_pid_lost_discarded_counters(struct ust_app_channel *ua_chan
 
 	uchan->per_pid_closed_app_discarded += discarded;
 	uchan->per_pid_closed_app_lost += lost;
+	uchan->per_pid_closed_app_compression.input_bytes += compression_stats.input_bytes;
+	uchan->per_pid_closed_app_compression.output_bytes += compression_stats.output_bytes;
+	uchan->per_pid_closed_app_compression.cpu_time_ns += compression_stats.cpu_time_ns;
 }
 
 /*
@@ -1595,31 +1658,6 @@ error:
 	return nullptr;
 }
 
-/*
- * Create a liblttng-ust filter bytecode from given bytecode.
- *
- * Return allocated filter or NULL on error.
- */
-static struct lttng_ust_abi_filter_bytecode *
-create_ust_filter_bytecode_from_bytecode(const struct lttng_bytecode *orig_f)
-{
-	struct lttng_ust_abi_filter_bytecode *filter = nullptr;
-
-	/* Copy filter bytecode. */
-	filter = zmalloc<lttng_ust_abi_filter_bytecode>(sizeof(*filter) + orig_f->len);
-	if (!filter) {
-		PERROR("Failed to allocate lttng_ust_filter_bytecode: bytecode len = %" PRIu32
-		       " bytes",
-		       orig_f->len);
-		goto error;
-	}
-
-	LTTNG_ASSERT(sizeof(struct lttng_bytecode) == sizeof(struct lttng_ust_abi_filter_bytecode));
-	memcpy(filter, orig_f, sizeof(*filter) + orig_f->len);
-error:
-	return filter;
-}
-
 /*
  * Create a liblttng-ust capture bytecode from given bytecode.
  *
@@ -1820,15 +1858,20 @@ static int set_ust_object_filter(struct ust_app *app,
 				 struct lttng_ust_abi_object_data *ust_object)
 {
 	int ret;
-	struct lttng_ust_abi_filter_bytecode *ust_bytecode = nullptr;
+
+	static_assert(sizeof(struct lttng_bytecode) ==
+			      sizeof(struct lttng_ust_abi_filter_bytecode),
+		      "Filter bytecode layouts must match");
+
+	/*
+	 * Same layout: the bytecode is sent as is, without copying it for
+	 * every application. The tracer control library doesn't modify it.
+	 */
+	auto *ust_bytecode = reinterpret_cast<struct lttng_ust_abi_filter_bytecode *>(
+		const_cast<struct lttng_bytecode *>(bytecode));
 
 	health_code_update();
 
-	ust_bytecode = create_ust_filter_bytecode_from_bytecode(bytecode);
-	if (!ust_bytecode) {
-		ret = -LTTNG_ERR_NOMEM;
-		goto error;
-	}
 	pthread_mutex_lock(&app->sock_lock);
 	ret = lttng_ust_ctl_set_filter(app->sock, ust_bytecode, ust_object);
 	pthread_mutex_unlock(&app->sock_lock);
@@ -1857,7 +1900,6 @@ static int set_ust_object_filter(struct ust_app *app,
 
 error:
 	health_code_update();
-	free(ust_bytecode);
 	return ret;
 }
 
@@ -2565,10 +2607,9 @@ static void shadow_copy_event(struct ust_app_event *ua_event, struct ltt_ust_eve
 	/* Copy event attributes */
 	memcpy(&ua_event->attr, &uevent->attr, sizeof(ua_event->attr));
 
-	/* Copy filter bytecode */
+	/* Share the filter bytecode of the session's event. */
 	if (uevent->filter) {
-		ua_event->filter = lttng_bytecode_copy(uevent->filter);
-		/* Filter might be NULL here in case of ENONEM. */
+		ua_event->filter = the_bytecode_cache.get_reference(uevent->filter);
 	}
 
 	/* Copy exclusion data */
@@ -2615,6 +2656,7 @@ static void shadow_copy_channel(struct ust_app_channel *ua_chan, struct ltt_ust_
 	}
 
 	ua_chan->preallocation_policy = uchan->preallocation_policy;
+	ua_chan->compression = uchan->compression;
 	ua_chan->automatic_memory_reclamation_maximal_age =
 		uchan->automatic_memory_reclamation_maximal_age;
 	ua_chan->attr.output = (lttng_ust_abi_output) uchan->attr.output;
@@ -3352,6 +3394,127 @@ error:
 	return ret;
 }
 
+/*
+ * Ask the consumer to create the channels of `ua_chans` and get them. Unlike
+ * calling do_consumer_create_channel() for each channel, this takes two round
+ * trips with the consumer daemon whatever the number of channels.
+ *
+ * On error, the channels which were entirely received from the consumer, if
+ * any, are still set; the caller must delete all the channels.
+ *
+ * Called with UST app session lock held.
+ *
+ * Return 0 on success or else a negative value.
+ */
+static int do_consumer_create_channels(struct ltt_ust_session *usess,
+				       struct ust_app_session *ua_sess,
+				       const std::vector<struct ust_app_channel *>& ua_chans,
+				       int bitness,
+				       lsu::registry_session *registry,
+				       enum lttng_trace_format trace_format)
+{
+	int ret;
+	unsigned int nb_fd = 0;
+	std::size_t received_count = 0;
+	struct consumer_socket *socket;
+
+	LTTNG_ASSERT(usess);
+	LTTNG_ASSERT(ua_sess);
+	LTTNG_ASSERT(!ua_chans.empty());
+	LTTNG_ASSERT(registry);
+
+	const lttng::urcu::read_lock_guard read_lock;
+	health_code_update();
+
+	/* Get the right consumer socket for the application. */
+	socket = consumer_find_socket_by_bitness(bitness, usess->consumer);
+	if (!socket) {
+		ret = -EINVAL;
+		goto error;
+	}
+
+	health_code_update();
+
+	/* Need one fd per channel. */
+	ret = lttng_fd_get(LTTNG_FD_APPS, ua_chans.size());
+	if (ret < 0) {
+		ERR("Exhausted number of available FD upon create channel");
+		goto error;
+	}
+
+	/*
+	 * Ask consumer to create the channels. The consumer will return the
+	 * number of stream we have to expect for each of them.
+	 */
+	ret = ust_consumer_ask_channels(ua_sess,
+					ua_chans,
+					usess->consumer,
+					socket,
+					registry,
+					usess->current_trace_chunk,
+					trace_format);
+	if (ret < 0) {
+		goto error_ask;
+	}
+
+	/*
+	 * Compute the number of fd needed before receiving them. It must be 2 per
+	 * stream (2 being the default value here).
+	 */
+	for (const auto *ua_chan : ua_chans) {
+		nb_fd += DEFAULT_UST_STREAM_FD_NUM * ua_chan->expected_stream_count;
+	}
+
+	/* Reserve the amount of file descriptor we need. */
+	ret = lttng_fd_get(LTTNG_FD_APPS, nb_fd);
+	if (ret < 0) {
+		ERR("Exhausted number of available FD upon create channel");
+		goto error_fd_get_stream;
+	}
+
+	health_code_update();
+
+	/*
+	 * Now get the channels from the consumer. This call will populate the
+	 * stream list of the channels and set the ust objects.
+	 */
+	if (usess->consumer->enabled) {
+		ret = ust_consumer_get_channels(socket, ua_chans, &received_count);
+		if (ret < 0) {
+			goto error_get;
+		}
+	}
+
+	return 0;
+
+error_get:
+	/*
+	 * The file descriptors of the channels which were received are released
+	 * with their objects. Destroy the other channels on the consumer side.
+	 */
+	for (auto i = received_count; i < ua_chans.size(); i++) {
+		lttng_fd_put(LTTNG_FD_APPS,
+			     DEFAULT_UST_STREAM_FD_NUM * ua_chans[i]->expected_stream_count + 1);
+		(void) ust_consumer_destroy_channel(socket, ua_chans[i]);
+	}
+	goto error;
+error_fd_get_stream:
+	/*
+	 * Initiate a destroy channel on the consumer since we had an error
+	 * handling it on our side. The return value is of no importance since we
+	 * already have a ret value set by the previous error that we need to
+	 * return.
+	 */
+	for (auto *ua_chan : ua_chans) {
+		(void) ust_consumer_destroy_channel(socket, ua_chan);
+	}
+error_ask:
+	lttng_fd_put(LTTNG_FD_APPS, ua_chans.size());
+error:
+	health_code_update();
+	return ret;
+}
+
 /*
  * Duplicate the ust data object of the ust app stream and save it in the
  * buffer registry stream.
@@ -3816,28 +3979,36 @@ static int create_channel_per_pid(struct ust_app *app,
 	ASSERT_LOCKED(session->_lock);
 	ASSERT_SESSION_LIST_LOCKED();
 
-	/* Create and add a new channel registry to session. */
-	try {
-		registry->add_channel(ua_chan->key,
-				      ust_channel_type_to_allocation_policy(ua_chan->attr.type));
-	} catch (const std::exception& ex) {
-		ERR("Error creating the UST channel \"%s\" registry instance: %s",
-		    ua_chan->name,
-		    ex.what());
-		ret = -1;
-		goto error;
-	}
+	/*
+	 * The registry and consumer daemon channels of a channel created as
+	 * part of a batch by create_ust_app_channels_per_pid() already exist.
+	 */
+	if (!ua_chan->consumer_created) {
+		/* Create and add a new channel registry to session. */
+		try {
+			registry->add_channel(
+				ua_chan->key,
+				ust_channel_type_to_allocation_policy(ua_chan->attr.type));
+		} catch (const std::exception& ex) {
+			ERR("Error creating the UST channel \"%s\" registry instance: %s",
+			    ua_chan->name,
+			    ex.what());
+			ret = -1;
+			goto error;
+		}
 
-	/* Create and get channel on the consumer side. */
-	ret = do_consumer_create_channel(usess,
-					 &ua_sess.get(),
-					 ua_chan,
-					 app->abi.bits_per_long,
-					 registry,
-					 session->trace_format);
-	if (ret < 0) {
-		ERR("Error creating UST channel \"%s\" on the consumer daemon", ua_chan->name);
-		goto error_remove_from_registry;
+		/* Create and get channel on the consumer side. */
+		ret = do_consumer_create_channel(usess,
+						 &ua_sess.get(),
+						 ua_chan,
+						 app->abi.bits_per_long,
+						 registry,
+						 session->trace_format);
+		if (ret < 0) {
+			ERR("Error creating UST channel \"%s\" on the consumer daemon",
+			    ua_chan->name);
+			goto error_remove_from_registry;
+		}
 	}
 
 	ret = send_channel_pid_to_ust(app, &ua_sess.get(), ua_chan);
@@ -4337,6 +4508,7 @@ struct ust_app *ust_app_create(struct ust_register_msg *msg, int sock)
 	lta->compatible = 1;
 
 	lta->pid = msg->pid;
+	set_exe_identity(*lta);
 	lttng_ht_node_init_ulong(&lta->pid_n, (unsigned long) lta->pid);
 	lta->sock = sock;
 	pthread_mutex_init(&lta->sock_lock, nullptr);
@@ -4390,6 +4562,8 @@ void ust_app_add(struct ust_app *app)
 	lttng_ht_node_init_ulong(&app->notify_sock_n, app->notify_sock);
 	lttng_ht_add_unique_ulong(ust_app_ht_by_notify_sock, &app->notify_sock_n);
 
+	the_tracepoint_catalog.add_app(get_provider_set_key(*app));
+
 	DBG("App registered with pid:%d ppid:%d uid:%d gid:%d sock =%d name:%s "
 	    "notify_sock =%d (version %d.%d)",
 	    app->pid,
@@ -4717,6 +4891,8 @@ void ust_app_unregister_by_socket(int sock_fd)
 	ret = lttng_ht_del(ust_app_ht_by_sock, &ust_app_sock_iter);
 	assert(!ret);
 
+	the_tracepoint_catalog.remove_app(get_provider_set_key(*app));
+
 	/*
 	 * The socket is closed: release its reference to the application
 	 * to trigger its eventual teardown.
@@ -4724,186 +4900,238 @@ void ust_app_unregister_by_socket(int sock_fd)
 	ust_app_put(app);
 }
 
+namespace {
 /*
- * Fill events array with all events name of all registered apps.
+ * Release a tracepoint (or tracepoint field) list handle of an application.
+ *
+ * Called with the application's socket lock held.
  */
-int ust_app_list_events(struct lttng_event **events)
+void release_tracepoint_list_handle(const ust_app& app, int handle)
 {
-	int ret, handle;
-	size_t nbmem, count = 0;
-	struct lttng_event *tmp_event;
+	const auto ret = lttng_ust_ctl_release_handle(app.sock, handle);
 
-	nbmem = UST_APP_EVENT_LIST_SIZE;
-	tmp_event = calloc<lttng_event>(nbmem);
-	if (tmp_event == nullptr) {
-		PERROR("zmalloc ust app events");
-		ret = -ENOMEM;
-		goto error;
+	if (ret < 0) {
+		if (ret == -EPIPE || ret == -LTTNG_UST_ERR_EXITING) {
+			DBG3("Error releasing app handle. Application died: pid = %d, sock = %d",
+			     app.pid,
+			     app.sock);
+		} else if (ret == -EAGAIN) {
+			WARN("Error releasing app handle. Communication time out: pid = %d, sock = %d",
+			     app.pid,
+			     app.sock);
+		} else {
+			ERR("Error releasing app handle with ret %d: pid = %d, sock = %d",
+			    ret,
+			    app.pid,
+			    app.sock);
+		}
 	}
+}
 
-	/* Iterate on all apps. */
-	for (auto *app :
-	     lttng::urcu::lfht_iteration_adapter<ust_app, decltype(ust_app::pid_n), &ust_app::pid_n>(
-		     *ust_app_ht->ht)) {
-		struct lttng_ust_abi_tracepoint_iter uiter;
+/*
+ * Query the tracepoints of an application.
+ *
+ * `complete` is set to false if the application died (or could not be
+ * queried) before all its tracepoints were listed.
+ *
+ * Return 0 on success, or a negative value on error.
+ */
+int query_app_tracepoints(struct ust_app& app,
+			  catalog_tracepoint_list& tracepoints,
+			  bool& complete)
+{
+	int ret;
+	struct lttng_ust_abi_tracepoint_iter uiter;
+	const lttng::pthread::lock_guard sock_lock(app.sock_lock);
 
-		health_code_update();
+	complete = false;
 
-		if (!ust_app_get(*app)) {
-			/* Application unregistered concurrently, skip it. */
-			DBG("Could not get application reference as it is being torn down; skipping application");
-			continue;
+	const auto handle = lttng_ust_ctl_tracepoint_list(app.sock);
+	if (handle < 0) {
+		if (handle != -EPIPE && handle != -LTTNG_UST_ERR_EXITING) {
+			ERR("UST app list events getting handle failed for app pid %d", app.pid);
 		}
 
-		/* Prevent app teardown during use. */
-		const ust_app_reference app_ref(app);
+		return 0;
+	}
 
-		if (!app->compatible) {
-			/*
-			 * TODO: In time, we should notice the caller of this error by
-			 * telling him that this is a version error.
-			 */
-			continue;
-		}
+	while ((ret = lttng_ust_ctl_tracepoint_list_get(app.sock, handle, &uiter)) !=
+	       -LTTNG_UST_ERR_NOENT) {
+		struct lttng_event tracepoint;
 
-		pthread_mutex_lock(&app->sock_lock);
-		handle = lttng_ust_ctl_tracepoint_list(app->sock);
-		if (handle < 0) {
-			if (handle != -EPIPE && handle != -LTTNG_UST_ERR_EXITING) {
-				ERR("UST app list events getting handle failed for app pid %d",
-				    app->pid);
+		/* Handle ustctl error. */
+		if (ret < 0) {
+			if (ret != -LTTNG_UST_ERR_EXITING && ret != -EPIPE) {
+				ERR("UST app tp list get failed for app %d with ret %d",
+				    app.sock,
+				    ret);
+				release_tracepoint_list_handle(app, handle);
+				return ret;
 			}
-			pthread_mutex_unlock(&app->sock_lock);
-			continue;
+
+			DBG3("UST app tp list get failed. Application is dead");
+			release_tracepoint_list_handle(app, handle);
+			return 0;
 		}
 
-		while ((ret = lttng_ust_ctl_tracepoint_list_get(app->sock, handle, &uiter)) !=
-		       -LTTNG_UST_ERR_NOENT) {
-			/* Handle ustctl error. */
-			if (ret < 0) {
-				int release_ret;
-
-				if (ret != -LTTNG_UST_ERR_EXITING && ret != -EPIPE) {
-					ERR("UST app tp list get failed for app %d with ret %d",
-					    app->sock,
-					    ret);
-				} else {
-					DBG3("UST app tp list get failed. Application is dead");
-					break;
-				}
+		health_code_update();
 
-				free(tmp_event);
-				release_ret = lttng_ust_ctl_release_handle(app->sock, handle);
-				if (release_ret < 0 && release_ret != -LTTNG_UST_ERR_EXITING &&
-				    release_ret != -EPIPE) {
-					ERR("Error releasing app handle for app %d with ret %d",
-					    app->sock,
-					    release_ret);
-				}
+		/* The PID is set when the list is copied to the reply. */
+		memset(&tracepoint, 0, sizeof(tracepoint));
+		memcpy(tracepoint.name, uiter.name, LTTNG_UST_ABI_SYM_NAME_LEN);
+		tracepoint.loglevel = uiter.loglevel;
+		tracepoint.type = (enum lttng_event_type) LTTNG_UST_ABI_TRACEPOINT;
+		tracepoint.enabled = -1;
+		tracepoints.push_back(tracepoint);
+	}
 
-				pthread_mutex_unlock(&app->sock_lock);
-				goto error;
-			}
+	release_tracepoint_list_handle(app, handle);
+	complete = true;
+	return 0;
+}
 
-			health_code_update();
-			if (count >= nbmem) {
-				/* In case the realloc fails, we free the memory */
-				struct lttng_event *new_tmp_event;
-				size_t new_nbmem;
-
-				new_nbmem = nbmem << 1;
-				DBG2("Reallocating event list from %zu to %zu entries",
-				     nbmem,
-				     new_nbmem);
-				new_tmp_event = (lttng_event *) realloc(
-					tmp_event, new_nbmem * sizeof(struct lttng_event));
-				if (new_tmp_event == nullptr) {
-					int release_ret;
-
-					PERROR("realloc ust app events");
-					free(tmp_event);
-					ret = -ENOMEM;
-					release_ret =
-						lttng_ust_ctl_release_handle(app->sock, handle);
-					if (release_ret < 0 &&
-					    release_ret != -LTTNG_UST_ERR_EXITING &&
-					    release_ret != -EPIPE) {
-						ERR("Error releasing app handle for app %d with ret %d",
-						    app->sock,
-						    release_ret);
-					}
-
-					pthread_mutex_unlock(&app->sock_lock);
-					goto error;
-				}
-				/* Zero the new memory */
-				memset(new_tmp_event + nbmem,
-				       0,
-				       (new_nbmem - nbmem) * sizeof(struct lttng_event));
-				nbmem = new_nbmem;
-				tmp_event = new_tmp_event;
-			}
+/*
+ * Query the tracepoint fields of an application.
+ *
+ * Same semantics as query_app_tracepoints().
+ */
+int query_app_tracepoint_fields(struct ust_app& app,
+				catalog_field_list& fields,
+				bool& complete)
+{
+	int ret;
+	struct lttng_ust_abi_field_iter uiter;
+	const lttng::pthread::lock_guard sock_lock(app.sock_lock);
+
+	complete = false;
 
-			memcpy(tmp_event[count].name, uiter.name, LTTNG_UST_ABI_SYM_NAME_LEN);
-			tmp_event[count].loglevel = uiter.loglevel;
-			tmp_event[count].type = (enum lttng_event_type) LTTNG_UST_ABI_TRACEPOINT;
-			tmp_event[count].pid = app->pid;
-			tmp_event[count].enabled = -1;
-			count++;
+	const auto handle = lttng_ust_ctl_tracepoint_field_list(app.sock);
+	if (handle < 0) {
+		if (handle != -EPIPE && handle != -LTTNG_UST_ERR_EXITING) {
+			ERR("UST app list field getting handle failed for app pid %d", app.pid);
 		}
 
-		ret = lttng_ust_ctl_release_handle(app->sock, handle);
-		pthread_mutex_unlock(&app->sock_lock);
+		return 0;
+	}
+
+	while ((ret = lttng_ust_ctl_tracepoint_field_list_get(app.sock, handle, &uiter)) !=
+	       -LTTNG_UST_ERR_NOENT) {
+		struct lttng_event_field field;
+
+		/* Handle ustctl error. */
 		if (ret < 0) {
-			if (ret == -EPIPE || ret == -LTTNG_UST_ERR_EXITING) {
-				DBG3("Error releasing app handle. Application died: pid = %d, sock = %d",
-				     app->pid,
-				     app->sock);
-			} else if (ret == -EAGAIN) {
-				WARN("Error releasing app handle. Communication time out: pid = %d, sock = %d",
-				     app->pid,
-				     app->sock);
-			} else {
-				ERR("Error releasing app handle with ret %d: pid = %d, sock = %d",
-				    ret,
-				    app->pid,
-				    app->sock);
+			if (ret != -LTTNG_UST_ERR_EXITING && ret != -EPIPE) {
+				ERR("UST app tp list field failed for app %d with ret %d",
+				    app.sock,
+				    ret);
+				release_tracepoint_list_handle(app, handle);
+				return ret;
 			}
+
+			DBG3("UST app tp list field failed. Application is dead");
+			release_tracepoint_list_handle(app, handle);
+			return 0;
 		}
-	}
 
-	ret = count;
-	*events = tmp_event;
+		health_code_update();
 
-	DBG2("UST app list events done (%zu events)", count);
+		/* The PID is set when the list is copied to the reply. */
+		memset(&field, 0, sizeof(field));
+		memcpy(field.field_name, uiter.field_name, LTTNG_UST_ABI_SYM_NAME_LEN);
+		/* Mapping between these enums matches 1 to 1. */
+		field.type = (enum lttng_event_field_type) uiter.type;
+		field.nowrite = uiter.nowrite;
 
-error:
-	health_code_update();
-	return ret;
+		memcpy(field.event.name, uiter.event_name, LTTNG_UST_ABI_SYM_NAME_LEN);
+		field.event.loglevel = uiter.loglevel;
+		field.event.type = LTTNG_EVENT_TRACEPOINT;
+		field.event.enabled = -1;
+		fields.push_back(field);
+	}
+
+	release_tracepoint_list_handle(app, handle);
+	complete = true;
+	return 0;
 }
 
 /*
- * Fill events array with all events name of all registered apps.
+ * Get the tracepoints of an application from the tracepoint catalog, querying
+ * the application if the catalog doesn't have an up-to-date list for its
+ * provider set.
  */
-int ust_app_list_event_fields(struct lttng_event_field **fields)
+int get_app_tracepoints(struct ust_app& app,
+			std::shared_ptr<const catalog_tracepoint_list>& tracepoints)
 {
-	int ret, handle;
-	size_t nbmem, count = 0;
-	struct lttng_event_field *tmp_event;
+	const auto key = get_provider_set_key(app);
+	auto cached = the_tracepoint_catalog.lookup_tracepoints(key);
 
-	nbmem = UST_APP_EVENT_LIST_SIZE;
-	tmp_event = calloc<lttng_event_field>(nbmem);
-	if (tmp_event == nullptr) {
-		PERROR("zmalloc ust app event fields");
-		ret = -ENOMEM;
-		goto error;
+	if (cached.list) {
+		tracepoints = std::move(cached.list);
+		return 0;
 	}
 
-	/* Iterate on all apps. */
-	for (auto *app :
-	     lttng::urcu::lfht_iteration_adapter<ust_app, decltype(ust_app::pid_n), &ust_app::pid_n>(
-		     *ust_app_ht->ht)) {
-		struct lttng_ust_abi_field_iter uiter;
+	auto queried_tracepoints = std::make_shared<catalog_tracepoint_list>();
+	bool complete;
+
+	const auto ret = query_app_tracepoints(app, *queried_tracepoints, complete);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (complete) {
+		the_tracepoint_catalog.add_tracepoints(key, cached.generation, queried_tracepoints);
+	}
+
+	tracepoints = std::move(queried_tracepoints);
+	return 0;
+}
+
+/*
+ * Same as get_app_tracepoints(), for the tracepoint fields.
+ */
+int get_app_tracepoint_fields(struct ust_app& app,
+			      std::shared_ptr<const catalog_field_list>& fields)
+{
+	const auto key = get_provider_set_key(app);
+	auto cached = the_tracepoint_catalog.lookup_fields(key);
+
+	if (cached.list) {
+		fields = std::move(cached.list);
+		return 0;
+	}
+
+	auto queried_fields = std::make_shared<catalog_field_list>();
+	bool complete;
+
+	const auto ret = query_app_tracepoint_fields(app, *queried_fields, complete);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (complete) {
+		the_tracepoint_catalog.add_fields(key, cached.generation, queried_fields);
+	}
+
+	fields = std::move(queried_fields);
+	return 0;
+}
+
+/*
+ * Call `get_list(app, list)` for each registered and compatible application and
+ * return the lists with the PID of their application.
+ */
+template <typename ListType, typename GetListFunction>
+int get_all_app_catalog_lists(std::vector<std::pair<pid_t, std::shared_ptr<const ListType>>>& lists,
+			      std::size_t& total_count,
+			      GetListFunction get_list)
+{
+	total_count = 0;
+
+	/* Iterate on all apps. */
+	for (auto *app :
+	     lttng::urcu::lfht_iteration_adapter<ust_app, decltype(ust_app::pid_n), &ust_app::pid_n>(
+		     *ust_app_ht->ht)) {
+		std::shared_ptr<const ListType> list;
 
 		health_code_update();
 
@@ -4912,6 +5140,7 @@ int ust_app_list_event_fields(struct lttng_event_field **fields)
 			DBG("Could not get application reference as it is being torn down; skipping application");
 			continue;
 		}
+
 		/* Prevent app teardown during use. */
 		const ust_app_reference app_ref(app);
 
@@ -4923,105 +5152,107 @@ int ust_app_list_event_fields(struct lttng_event_field **fields)
 			continue;
 		}
 
-		pthread_mutex_lock(&app->sock_lock);
-		handle = lttng_ust_ctl_tracepoint_field_list(app->sock);
-		if (handle < 0) {
-			if (handle != -EPIPE && handle != -LTTNG_UST_ERR_EXITING) {
-				ERR("UST app list field getting handle failed for app pid %d",
-				    app->pid);
-			}
-			pthread_mutex_unlock(&app->sock_lock);
-			continue;
+		const auto ret = get_list(*app, list);
+		if (ret < 0) {
+			return ret;
 		}
 
-		while ((ret = lttng_ust_ctl_tracepoint_field_list_get(app->sock, handle, &uiter)) !=
-		       -LTTNG_UST_ERR_NOENT) {
-			/* Handle ustctl error. */
-			if (ret < 0) {
-				int release_ret;
-
-				if (ret != -LTTNG_UST_ERR_EXITING && ret != -EPIPE) {
-					ERR("UST app tp list field failed for app %d with ret %d",
-					    app->sock,
-					    ret);
-				} else {
-					DBG3("UST app tp list field failed. Application is dead");
-					break;
-				}
-
-				free(tmp_event);
-				release_ret = lttng_ust_ctl_release_handle(app->sock, handle);
-				pthread_mutex_unlock(&app->sock_lock);
-				if (release_ret < 0 && release_ret != -LTTNG_UST_ERR_EXITING &&
-				    release_ret != -EPIPE) {
-					ERR("Error releasing app handle for app %d with ret %d",
-					    app->sock,
-					    release_ret);
-				}
+		total_count += list->size();
+		lists.emplace_back(app->pid, std::move(list));
+	}
 
-				goto error;
-			}
+	return 0;
+}
+} /* namespace */
 
-			health_code_update();
-			if (count >= nbmem) {
-				/* In case the realloc fails, we free the memory */
-				struct lttng_event_field *new_tmp_event;
-				size_t new_nbmem;
-
-				new_nbmem = nbmem << 1;
-				DBG2("Reallocating event field list from %zu to %zu entries",
-				     nbmem,
-				     new_nbmem);
-				new_tmp_event = (lttng_event_field *) realloc(
-					tmp_event, new_nbmem * sizeof(struct lttng_event_field));
-				if (new_tmp_event == nullptr) {
-					int release_ret;
-
-					PERROR("realloc ust app event fields");
-					free(tmp_event);
-					ret = -ENOMEM;
-					release_ret =
-						lttng_ust_ctl_release_handle(app->sock, handle);
-					pthread_mutex_unlock(&app->sock_lock);
-					if (release_ret && release_ret != -LTTNG_UST_ERR_EXITING &&
-					    release_ret != -EPIPE) {
-						ERR("Error releasing app handle for app %d with ret %d",
-						    app->sock,
-						    release_ret);
-					}
+/*
+ * Fill events array with all events name of all registered apps.
+ *
+ * The tracepoints are listed from the tracepoint catalog; only the applications
+ * of which the catalog doesn't have an up-to-date provider set are queried.
+ */
+int ust_app_list_events(struct lttng_event **events)
+{
+	int ret;
+	std::size_t count, i = 0;
+	struct lttng_event *tmp_event;
+	std::vector<std::pair<pid_t, std::shared_ptr<const catalog_tracepoint_list>>>
+		app_tracepoints;
 
-					goto error;
-				}
+	try {
+		ret = get_all_app_catalog_lists(app_tracepoints, count, get_app_tracepoints);
+	} catch (const std::bad_alloc&) {
+		ERR("Failed to allocate UST app event list");
+		ret = -ENOMEM;
+	}
 
-				/* Zero the new memory */
-				memset(new_tmp_event + nbmem,
-				       0,
-				       (new_nbmem - nbmem) * sizeof(struct lttng_event_field));
-				nbmem = new_nbmem;
-				tmp_event = new_tmp_event;
-			}
+	if (ret < 0) {
+		goto error;
+	}
 
-			memcpy(tmp_event[count].field_name,
-			       uiter.field_name,
-			       LTTNG_UST_ABI_SYM_NAME_LEN);
-			/* Mapping between these enums matches 1 to 1. */
-			tmp_event[count].type = (enum lttng_event_field_type) uiter.type;
-			tmp_event[count].nowrite = uiter.nowrite;
+	/* Never allocate an empty array: the caller expects a valid pointer. */
+	tmp_event = calloc<lttng_event>(std::max<std::size_t>(count, 1));
+	if (tmp_event == nullptr) {
+		PERROR("zmalloc ust app events");
+		ret = -ENOMEM;
+		goto error;
+	}
 
-			memcpy(tmp_event[count].event.name,
-			       uiter.event_name,
-			       LTTNG_UST_ABI_SYM_NAME_LEN);
-			tmp_event[count].event.loglevel = uiter.loglevel;
-			tmp_event[count].event.type = LTTNG_EVENT_TRACEPOINT;
-			tmp_event[count].event.pid = app->pid;
-			tmp_event[count].event.enabled = -1;
-			count++;
+	for (const auto& pid_tracepoints : app_tracepoints) {
+		for (const auto& tracepoint : *pid_tracepoints.second) {
+			tmp_event[i] = tracepoint;
+			tmp_event[i].pid = pid_tracepoints.first;
+			i++;
 		}
+	}
 
-		ret = lttng_ust_ctl_release_handle(app->sock, handle);
-		pthread_mutex_unlock(&app->sock_lock);
-		if (ret < 0 && ret != -LTTNG_UST_ERR_EXITING && ret != -EPIPE) {
-			ERR("Error releasing app handle for app %d with ret %d", app->sock, ret);
+	ret = count;
+	*events = tmp_event;
+
+	DBG2("UST app list events done (%zu events)", count);
+
+error:
+	health_code_update();
+	return ret;
+}
+
+/*
+ * Fill events array with all events name of all registered apps.
+ *
+ * Same as ust_app_list_events(), for the tracepoint fields.
+ */
+int ust_app_list_event_fields(struct lttng_event_field **fields)
+{
+	int ret;
+	std::size_t count, i = 0;
+	struct lttng_event_field *tmp_event;
+	std::vector<std::pair<pid_t, std::shared_ptr<const catalog_field_list>>>
+		app_fields;
+
+	try {
+		ret = get_all_app_catalog_lists(app_fields, count, get_app_tracepoint_fields);
+	} catch (const std::bad_alloc&) {
+		ERR("Failed to allocate UST app event field list");
+		ret = -ENOMEM;
+	}
+
+	if (ret < 0) {
+		goto error;
+	}
+
+	/* Never allocate an empty array: the caller expects a valid pointer. */
+	tmp_event = calloc<lttng_event_field>(std::max<std::size_t>(count, 1));
+	if (tmp_event == nullptr) {
+		PERROR("zmalloc ust app event fields");
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	for (const auto& pid_fields : app_fields) {
+		for (const auto& field : *pid_fields.second) {
+			tmp_event[i] = field;
+			tmp_event[i].event.pid = pid_fields.first;
+			i++;
 		}
 	}
 
@@ -5361,6 +5592,57 @@ static bool is_context_redundant(const struct ltt_ust_channel *uchan,
 	return false;
 }
 
+/*
+ * Send an allocated application channel to the application, creating its
+ * buffers if needed, publish it in the application session and add its
+ * contexts.
+ *
+ * On error, the channel is deleted.
+ *
+ * The ua_sess lock must be held by the caller.
+ */
+static int ust_app_channel_setup(struct ltt_ust_session *usess,
+				 const ust_app_session::locked_weak_ref& ua_sess,
+				 struct ltt_ust_channel *uchan,
+				 struct ust_app *app,
+				 struct ust_app_channel *ua_chan)
+{
+	int ret;
+
+	ret = ust_app_channel_send(app, usess, ua_sess, ua_chan);
+	if (ret) {
+		goto error;
+	}
+
+	/* Only publish the channel if successfully created on the tracer/consumer. */
+	lttng_ht_add_unique_str(ua_sess->channels, &ua_chan->node);
+
+	/* Add contexts. */
+	for (auto *uctx :
+	     lttng::urcu::list_iteration_adapter<ltt_ust_context, &ltt_ust_context::list>(
+		     uchan->ctx_list)) {
+		if (is_context_redundant(uchan, uctx)) {
+			continue;
+		}
+		ret = create_ust_app_channel_context(ua_chan, &uctx->ctx, app);
+		if (ret) {
+			goto error;
+		}
+	}
+
+error:
+	if (ret < 0) {
+		const auto registry = ust_app_get_session_registry(ua_sess->get_identifier());
+		/* The UST app session lock is held, registry shall not be null. */
+		LTTNG_ASSERT(registry);
+
+		const auto locked_registry = registry->lock();
+		delete_ust_app_channel(-1, ua_chan, app, locked_registry);
+	}
+
+	return ret;
+}
+
 /* The ua_sess lock must be held by the caller.  */
 static int ust_app_channel_create(struct ltt_ust_session *usess,
 				  const ust_app_session::locked_weak_ref& ua_sess,
@@ -5389,38 +5671,14 @@ static int ust_app_channel_create(struct ltt_ust_session *usess,
 			goto error;
 		}
 
-		ret = ust_app_channel_send(app, usess, ua_sess, ua_chan);
+		ret = ust_app_channel_setup(usess, ua_sess, uchan, app, ua_chan);
 		if (ret) {
 			goto error;
 		}
-
-		/* Only publish the channel if successfully created on the tracer/consumer. */
-		lttng_ht_add_unique_str(ua_sess->channels, &ua_chan->node);
-
-		/* Add contexts. */
-		for (auto *uctx :
-		     lttng::urcu::list_iteration_adapter<ltt_ust_context, &ltt_ust_context::list>(
-			     uchan->ctx_list)) {
-			if (is_context_redundant(uchan, uctx)) {
-				continue;
-			}
-			ret = create_ust_app_channel_context(ua_chan, &uctx->ctx, app);
-			if (ret) {
-				goto error;
-			}
-		}
 	}
 
 error:
-	if (ret < 0 && ua_chan) {
-		const auto registry = ust_app_get_session_registry(ua_sess->get_identifier());
-		/* The UST app session lock is held, registry shall not be null. */
-		LTTNG_ASSERT(registry);
-
-		const auto locked_registry = registry->lock();
-		delete_ust_app_channel(-1, ua_chan, app, locked_registry);
-		ua_chan = nullptr;
-	} else if (ret == 0 && _ua_chan) {
+	if (ret == 0 && _ua_chan) {
 		/*
 		 * Only return the application's channel on success. Note
 		 * that the channel can still be part of the application's
@@ -6442,6 +6700,134 @@ end:
 	return;
 }
 
+/*
+ * Create the channels of `usess` which don't exist yet in the per-PID buffers
+ * application session `ua_sess` and send them to the application.
+ *
+ * The buffers of all the channels are created by the consumer daemon as a
+ * batch rather than with two round trips per channel, which matters when
+ * many applications register at once.
+ *
+ * Called with UST app session lock and RCU read-side lock held.
+ *
+ * Return 0 on success or else a negative value.
+ */
+static int create_ust_app_channels_per_pid(struct ltt_ust_session *usess,
+					   const ust_app_session::locked_weak_ref& ua_sess,
+					   struct ust_app *app)
+{
+	int ret = 0;
+	std::vector<struct ltt_ust_channel *> uchans;
+	std::vector<struct ust_app_channel *> ua_chans;
+	/* Number of channels handed over to ust_app_channel_setup(). */
+	std::size_t setup_count = 0;
+
+	LTTNG_ASSERT(usess->buffer_type == LTTNG_BUFFER_PER_PID);
+	ASSERT_RCU_READ_LOCKED();
+
+	const auto registry = ust_app_get_session_registry(ua_sess->get_identifier());
+	/* The UST app session lock is held, registry shall not be null. */
+	LTTNG_ASSERT(registry);
+
+	/* Guaranteed to exist; will not throw. */
+	const auto session = ltt_session::find_session(ua_sess->tracing_id);
+
+	try {
+		const auto channel_count = lttng_ht_get_count(usess->domain_global.channels);
+
+		uchans.reserve(channel_count);
+		ua_chans.reserve(channel_count);
+	} catch (const std::bad_alloc&) {
+		return -ENOMEM;
+	}
+
+	for (auto *uchan : lttng::urcu::lfht_iteration_adapter<ltt_ust_channel,
+							       decltype(ltt_ust_channel::node),
+							       &ltt_ust_channel::node>(
+		     *usess->domain_global.channels->ht)) {
+		struct lttng_ht_iter iter;
+		struct ust_app_channel *ua_chan;
+
+		if (!strncmp(uchan->name, DEFAULT_METADATA_NAME, sizeof(uchan->name))) {
+			/* The metadata channel is created separately. */
+			continue;
+		}
+
+		lttng_ht_lookup(ua_sess->channels, (void *) uchan->name, &iter);
+		if (lttng_ht_iter_get_node<lttng_ht_node_str>(&iter)) {
+			continue;
+		}
+
+		ret = ust_app_channel_allocate(
+			ua_sess,
+			uchan,
+			static_cast<enum lttng_ust_abi_chan_type>(uchan->attr.type),
+			usess,
+			&ua_chan);
+		if (ret < 0) {
+			goto error;
+		}
+
+		uchans.emplace_back(uchan);
+		ua_chans.emplace_back(ua_chan);
+
+		/* Create and add a new channel registry to session. */
+		try {
+			registry->add_channel(
+				ua_chan->key,
+				ust_channel_type_to_allocation_policy(ua_chan->attr.type));
+		} catch (const std::exception& ex) {
+			ERR("Error creating the UST channel \"%s\" registry instance: %s",
+			    ua_chan->name,
+			    ex.what());
+			ret = -1;
+			goto error;
+		}
+	}
+
+	if (ua_chans.empty()) {
+		return 0;
+	}
+
+	ret = do_consumer_create_channels(usess,
+					  &ua_sess.get(),
+					  ua_chans,
+					  app->abi.bits_per_long,
+					  registry,
+					  session->trace_format);
+	if (ret < 0) {
+		ERR("Error creating %zu UST channels on the consumer daemon", ua_chans.size());
+		goto error;
+	}
+
+	for (auto *ua_chan : ua_chans) {
+		ua_chan->consumer_created = true;
+	}
+
+	while (setup_count < ua_chans.size()) {
+		const auto i = setup_count++;
+
+		/* The channel is deleted on error. */
+		ret = ust_app_channel_setup(usess, ua_sess, uchans[i], app, ua_chans[i]);
+		if (ret) {
+			goto error;
+		}
+	}
+
+	return 0;
+
+error:
+	{
+		const auto locked_registry = registry->lock();
+
+		for (auto i = setup_count; i < ua_chans.size(); i++) {
+			delete_ust_app_channel(-1, ua_chans[i], app, locked_registry);
+		}
+	}
+
+	return ret;
+}
+
 /*
  * RCU read lock must be held by the caller.
  */
@@ -6453,6 +6839,16 @@ static void ust_app_synchronize_all_channels(struct ltt_ust_session *usess,
 	LTTNG_ASSERT(app);
 	ASSERT_RCU_READ_LOCKED();
 
+	/*
+	 * With per-PID buffers, create all the missing channels of the
+	 * application at once; the loop below then only finds them.
+	 */
+	if (usess->buffer_type == LTTNG_BUFFER_PER_PID &&
+	    create_ust_app_channels_per_pid(usess, ua_sess, app)) {
+		/* Tracer is probably gone or ENOMEM. */
+		return;
+	}
+
 	for (auto *uchan : lttng::urcu::lfht_iteration_adapter<ltt_ust_channel,
 							       decltype(ltt_ust_channel::node),
 							       &ltt_ust_channel::node>(
@@ -7778,57 +8174,14 @@ uint64_t ust_app_get_size_one_more_packet_per_stream(const struct ltt_ust_sessio
 	return tot_size;
 }
 
-int ust_app_uid_get_channel_runtime_stats(uint64_t ust_session_id,
-					  struct cds_list_head *buffer_reg_uid_list,
-					  struct consumer_output *consumer,
-					  uint64_t uchan_id,
-					  int overwrite,
-					  uint64_t *discarded,
-					  uint64_t *lost)
-{
-	int ret;
-	uint64_t consumer_chan_key;
-
-	*discarded = 0;
-	*lost = 0;
-
-	ret = buffer_reg_uid_consumer_channel_key(
-		buffer_reg_uid_list, uchan_id, &consumer_chan_key);
-	if (ret < 0) {
-		/* Not found */
-		ret = 0;
-		goto end;
-	}
-
-	if (overwrite) {
-		ret = consumer_get_lost_packets(ust_session_id, consumer_chan_key, consumer, lost);
-	} else {
-		ret = consumer_get_discarded_events(
-			ust_session_id, consumer_chan_key, consumer, discarded);
-	}
-
-end:
-	return ret;
-}
-
-int ust_app_pid_get_channel_runtime_stats(struct ltt_ust_session *usess,
-					  struct ltt_ust_channel *uchan,
-					  struct consumer_output *consumer,
-					  int overwrite,
-					  uint64_t *discarded,
-					  uint64_t *lost)
+std::vector<uint64_t> ust_app_pid_get_channel_consumer_keys(const struct ltt_ust_session *usess,
+							    const struct ltt_ust_channel *uchan)
 {
-	int ret = 0;
-	struct lttng_ht_node_str *ua_chan_node;
-	struct ust_app_session *ua_sess;
-	struct ust_app_channel *ua_chan;
-
-	*discarded = 0;
-	*lost = 0;
+	std::vector<uint64_t> consumer_keys;
 
 	/*
-	 * Iterate over every registered applications. Sum counters for
-	 * all applications containing requested session and channel.
+	 * Iterate over every registered applications. Collect the keys of the
+	 * channels of all applications containing requested session and channel.
 	 */
 	for (auto *app :
 	     lttng::urcu::lfht_iteration_adapter<ust_app, decltype(ust_app::pid_n), &ust_app::pid_n>(
@@ -7843,40 +8196,24 @@ int ust_app_pid_get_channel_runtime_stats(struct ltt_ust_session *usess,
 		/* Prevent app teardown during use. */
 		const ust_app_reference app_ref(app);
 
-		ua_sess = ust_app_lookup_app_session(usess, app);
+		const auto *ua_sess = ust_app_lookup_app_session(usess, app);
 		if (ua_sess == nullptr) {
 			continue;
 		}
 
 		/* Get channel */
 		lttng_ht_lookup(ua_sess->channels, (void *) uchan->name, &uiter);
-		ua_chan_node = lttng_ht_iter_get_node<lttng_ht_node_str>(&uiter);
+		const auto *ua_chan_node = lttng_ht_iter_get_node<lttng_ht_node_str>(&uiter);
 		/* If the session is found for the app, the channel must be there */
 		LTTNG_ASSERT(ua_chan_node);
 
-		ua_chan = lttng::utils::container_of(ua_chan_node, &ust_app_channel::node);
-
-		if (overwrite) {
-			uint64_t _lost;
+		const auto *ua_chan =
+			lttng::utils::container_of(ua_chan_node, &ust_app_channel::node);
 
-			ret = consumer_get_lost_packets(usess->id, ua_chan->key, consumer, &_lost);
-			if (ret < 0) {
-				break;
-			}
-			(*lost) += _lost;
-		} else {
-			uint64_t _discarded;
-
-			ret = consumer_get_discarded_events(
-				usess->id, ua_chan->key, consumer, &_discarded);
-			if (ret < 0) {
-				break;
-			}
-			(*discarded) += _discarded;
-		}
+		consumer_keys.emplace_back(ua_chan->key);
 	}
 
-	return ret;
+	return consumer_keys;
 }
 
 static int ust_app_regenerate_statedump(struct ltt_ust_session *usess, struct ust_app *app)
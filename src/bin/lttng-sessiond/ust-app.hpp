@@ -14,6 +14,7 @@
 #include "trace-ust.hpp"
 #include "ust-field-quirks.hpp"
 
+#include <common/compression/codec.hpp>
 #include <common/format.hpp>
 #include <common/index-allocator.hpp>
 #include <common/optional.hpp>
@@ -126,7 +127,8 @@ struct ust_app_event {
 	struct lttng_ust_abi_event attr;
 	char name[LTTNG_UST_ABI_SYM_NAME_LEN];
 	struct lttng_ht_node_str node;
-	struct lttng_bytecode *filter;
+	/* Reference to the shared copy held by the_bytecode_cache. */
+	const struct lttng_bytecode *filter;
 	struct lttng_event_exclusion *exclusion;
 };
 
@@ -171,6 +173,11 @@ struct ust_app_channel {
 	uint64_t tracing_channel_id = 0;
 	/* Number of stream that this channel is expected to receive. */
 	unsigned int expected_stream_count = 0;
+	/*
+	 * Set when the channel was created on the consumer daemon as part of a
+	 * batch, before being sent to the application.
+	 */
+	bool consumer_created = false;
 	char name[LTTNG_UST_ABI_SYM_NAME_LEN] = {};
 	struct lttng_ust_abi_object_data *obj = nullptr;
 	struct lttng_ust_ctl_consumer_channel_attr attr = {};
@@ -188,6 +195,7 @@ struct ust_app_channel {
 	lttng::sessiond::recording_channel_configuration::buffer_preallocation_policy_t
 		preallocation_policy = lttng::sessiond::recording_channel_configuration::
 			buffer_preallocation_policy_t::PREALLOCATE;
+	lttng::compression::codec_type compression = lttng::compression::codec_type::NONE;
 	nonstd::optional<std::chrono::microseconds> automatic_memory_reclamation_maximal_age;
 	/*
 	 * Node indexed by channel name in the channels' hash table of a session.
@@ -388,6 +396,18 @@ struct ust_app {
 	uint32_t v_minor = static_cast<uint32_t>(-1); /* Version minor number */
 	/* Extra for the NULL byte. */
 	char name[UST_APP_PROCNAME_LEN + 1] = {};
+	/*
+	 * Identity of the executable of the application, examined through
+	 * /proc/<pid>/exe at registration time. `is_known` is false when it
+	 * can't be examined (e.g. the application exited or lives in another
+	 * PID namespace).
+	 */
+	struct {
+		bool is_known = false;
+		dev_t dev = 0;
+		ino_t ino = 0;
+		time_t mtime = 0;
+	} exe_identity;
 
 	struct lttng_ht *sessions = nullptr;
 	struct lttng_ht_node_ulong pid_n = {};
@@ -526,19 +546,8 @@ enum lttng_error_code ust_app_snapshot_record(const struct ltt_ust_session *uses
 uint64_t ust_app_get_size_one_more_packet_per_stream(const struct ltt_ust_session *usess,
 						     uint64_t cur_nr_packets);
 nonstd::optional<ust_app_reference> ust_app_find_by_sock(int sock);
-int ust_app_uid_get_channel_runtime_stats(uint64_t ust_session_id,
-					  struct cds_list_head *buffer_reg_uid_list,
-					  struct consumer_output *consumer,
-					  uint64_t uchan_id,
-					  int overwrite,
-					  uint64_t *discarded,
-					  uint64_t *lost);
-int ust_app_pid_get_channel_runtime_stats(struct ltt_ust_session *usess,
-					  struct ltt_ust_channel *uchan,
-					  struct consumer_output *consumer,
-					  int overwrite,
-					  uint64_t *discarded,
-					  uint64_t *lost);
+std::vector<uint64_t> ust_app_pid_get_channel_consumer_keys(const struct ltt_ust_session *usess,
+							    const struct ltt_ust_channel *uchan);
 int ust_app_regenerate_statedump_all(struct ltt_ust_session *usess);
 enum lttng_error_code ust_app_create_channel_subdirectories(const struct ltt_ust_session *session);
 int ust_app_release_object(struct ust_app *app, struct lttng_ust_abi_object_data *data);
@@ -794,29 +803,11 @@ ust_app_get_size_one_more_packet_per_stream(const struct ltt_ust_session *usess
 	return 0;
 }
 
-static inline int ust_app_uid_get_channel_runtime_stats(uint64_t ust_session_id
-							__attribute__((unused)),
-							struct cds_list_head *buffer_reg_uid_list
-							__attribute__((unused)),
-							struct consumer_output *consumer
-							__attribute__((unused)),
-							int overwrite __attribute__((unused)),
-							uint64_t uchan_id __attribute__((unused)),
-							uint64_t *discarded __attribute__((unused)),
-							uint64_t *lost __attribute__((unused)))
+static inline std::vector<uint64_t>
+ust_app_pid_get_channel_consumer_keys(const struct ltt_ust_session *usess __attribute__((unused)),
+				      const struct ltt_ust_channel *uchan __attribute__((unused)))
 {
-	return 0;
-}
-
-static inline int
-ust_app_pid_get_channel_runtime_stats(struct ltt_ust_session *usess __attribute__((unused)),
-				      struct ltt_ust_channel *uchan __attribute__((unused)),
-				      struct consumer_output *consumer __attribute__((unused)),
-				      int overwrite __attribute__((unused)),
-				      uint64_t *discarded __attribute__((unused)),
-				      uint64_t *lost __attribute__((unused)))
-{
-	return 0;
+	return {};
 }
 
 static inline int ust_app_regenerate_statedump_all(struct ltt_ust_session *usess
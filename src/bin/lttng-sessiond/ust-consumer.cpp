@@ -24,26 +24,26 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <vector>
 
 namespace lsu = lttng::sessiond::ust;
 
 /*
- * Send a single channel to the consumer using command ASK_CHANNEL_CREATION.
+ * Initialize the ASK_CHANNEL_CREATION message of a single channel.
  *
- * Consumer socket lock MUST be acquired before calling this.
+ * Return 0 on success else a negative value.
  */
-static int ask_channel_creation(struct ust_app_session *ua_sess,
+static int init_ask_channel_msg(struct ust_app_session *ua_sess,
 				struct ust_app_channel *ua_chan,
 				struct consumer_output *consumer,
-				struct consumer_socket *socket,
 				lsu::registry_session *registry,
 				struct lttng_trace_chunk *trace_chunk,
-				enum lttng_trace_format trace_format)
+				enum lttng_trace_format trace_format,
+				struct lttcomm_consumer_msg *msg)
 {
-	int ret, output;
+	int output;
 	uint32_t chan_id;
-	uint64_t key, chan_reg_key;
-	struct lttcomm_consumer_msg msg;
+	uint64_t chan_reg_key;
 	char shm_path[PATH_MAX] = "";
 	char root_shm_path[PATH_MAX] = "";
 	bool is_local_trace;
@@ -51,11 +51,9 @@ static int ask_channel_creation(struct ust_app_session *ua_sess,
 
 	LTTNG_ASSERT(ua_sess);
 	LTTNG_ASSERT(ua_chan);
-	LTTNG_ASSERT(socket);
 	LTTNG_ASSERT(consumer);
 	LTTNG_ASSERT(registry);
-
-	DBG2("Asking UST consumer for channel");
+	LTTNG_ASSERT(msg);
 
 	is_local_trace = consumer->net_seq_index == -1ULL;
 	/* Format the channel's path (relative to the current trace chunk). */
@@ -136,7 +134,7 @@ static int ask_channel_creation(struct ust_app_session *ua_sess,
 		nonstd::nullopt :
 		ua_chan->automatic_memory_reclamation_maximal_age;
 
-	consumer_init_ask_channel_comm_msg(&msg,
+	consumer_init_ask_channel_comm_msg(msg,
 					   ua_chan->attr.subbuf_size,
 					   ua_chan->attr.num_subbuf,
 					   ua_chan->attr.overwrite,
@@ -166,12 +164,42 @@ static int ask_channel_creation(struct ust_app_session *ua_sess,
 					   lttng_credentials_get_uid(&ua_sess->real_credentials),
 					   ua_chan->attr.blocking_timeout,
 					   ua_chan->preallocation_policy,
+					   ua_chan->compression,
 					   automatic_memory_reclamation_maximal_age,
 					   root_shm_path,
 					   shm_path,
 					   trace_chunk,
 					   &ua_sess->effective_credentials,
 					   trace_format);
+	return 0;
+}
+
+/*
+ * Send a single channel to the consumer using command ASK_CHANNEL_CREATION.
+ *
+ * Consumer socket lock MUST be acquired before calling this.
+ */
+static int ask_channel_creation(struct ust_app_session *ua_sess,
+				struct ust_app_channel *ua_chan,
+				struct consumer_output *consumer,
+				struct consumer_socket *socket,
+				lsu::registry_session *registry,
+				struct lttng_trace_chunk *trace_chunk,
+				enum lttng_trace_format trace_format)
+{
+	int ret;
+	uint64_t key;
+	struct lttcomm_consumer_msg msg;
+
+	LTTNG_ASSERT(socket);
+
+	DBG2("Asking UST consumer for channel");
+
+	ret = init_ask_channel_msg(
+		ua_sess, ua_chan, consumer, registry, trace_chunk, trace_format, &msg);
+	if (ret < 0) {
+		return ret;
+	}
 
 	health_code_update();
 
@@ -244,31 +272,17 @@ error:
 }
 
 /*
- * Send a get channel command to consumer using the given channel key.  The
- * channel object is populated and the stream list.
+ * Receive a channel and its streams sent by the consumer in reply to a
+ * GET_CHANNEL command, once the command was acknowledged.
+ *
+ * Consumer socket lock MUST be acquired before calling this.
  *
  * Return 0 on success else a negative value.
  */
-int ust_consumer_get_channel(struct consumer_socket *socket, struct ust_app_channel *ua_chan)
+static int recv_channel_from_consumer(struct consumer_socket *socket,
+				      struct ust_app_channel *ua_chan)
 {
 	int ret;
-	struct lttcomm_consumer_msg msg;
-
-	LTTNG_ASSERT(ua_chan);
-	LTTNG_ASSERT(socket);
-
-	memset(&msg, 0, sizeof(msg));
-	msg.cmd_type = LTTNG_CONSUMER_GET_CHANNEL;
-	msg.u.get_channel.key = ua_chan->key;
-
-	pthread_mutex_lock(socket->lock);
-	health_code_update();
-
-	/* Send command and wait for OK reply. */
-	ret = consumer_send_msg(socket, &msg);
-	if (ret < 0) {
-		goto error;
-	}
 
 	/* First, get the channel from consumer. */
 	ret = lttng_ust_ctl_recv_channel_from_consumer(*socket->fd_ptr, &ua_chan->obj);
@@ -328,6 +342,227 @@ int ust_consumer_get_channel(struct consumer_socket *socket, struct ust_app_chan
 		goto error;
 	}
 
+error:
+	return ret;
+}
+
+/*
+ * Send a get channel command to consumer using the given channel key.  The
+ * channel object is populated and the stream list.
+ *
+ * Return 0 on success else a negative value.
+ */
+int ust_consumer_get_channel(struct consumer_socket *socket, struct ust_app_channel *ua_chan)
+{
+	int ret;
+	struct lttcomm_consumer_msg msg;
+
+	LTTNG_ASSERT(ua_chan);
+	LTTNG_ASSERT(socket);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.cmd_type = LTTNG_CONSUMER_GET_CHANNEL;
+	msg.u.get_channel.key = ua_chan->key;
+
+	pthread_mutex_lock(socket->lock);
+	health_code_update();
+
+	/* Send command and wait for OK reply. */
+	ret = consumer_send_msg(socket, &msg);
+	if (ret < 0) {
+		goto error;
+	}
+
+	ret = recv_channel_from_consumer(socket, ua_chan);
+
+error:
+	health_code_update();
+	pthread_mutex_unlock(socket->lock);
+	return ret;
+}
+
+/*
+ * Ask the consumer to create the channels of `ua_chans` using a single
+ * ASK_CHANNELS_CREATION command rather than one ASK_CHANNEL_CREATION command
+ * per channel.
+ *
+ * On success, the expected stream count of every channel is set. On error, none
+ * of the channels exists on the consumer side.
+ *
+ * Session list and rcu read side locks must be held by the caller.
+ *
+ * Returns 0 on success else a negative value.
+ */
+int ust_consumer_ask_channels(struct ust_app_session *ua_sess,
+			      const std::vector<struct ust_app_channel *>& ua_chans,
+			      struct consumer_output *consumer,
+			      struct consumer_socket *socket,
+			      lsu::registry_session *registry,
+			      struct lttng_trace_chunk *trace_chunk,
+			      enum lttng_trace_format trace_format)
+{
+	int ret;
+	bool created_all = true;
+	/* The command header followed by the message of each channel. */
+	std::vector<struct lttcomm_consumer_msg> request;
+	std::vector<struct lttcomm_consumer_status_channel> replies;
+
+	LTTNG_ASSERT(ua_sess);
+	LTTNG_ASSERT(!ua_chans.empty());
+	LTTNG_ASSERT(consumer);
+	LTTNG_ASSERT(socket);
+	LTTNG_ASSERT(registry);
+
+	if (!consumer->enabled) {
+		DBG3("Consumer is disabled");
+		return -LTTNG_ERR_NO_CONSUMER;
+	}
+
+	DBG2("Asking UST consumer for %zu channels", ua_chans.size());
+
+	try {
+		request.resize(ua_chans.size() + 1);
+		replies.resize(ua_chans.size());
+	} catch (const std::bad_alloc&) {
+		return -ENOMEM;
+	}
+
+	request[0].cmd_type = LTTNG_CONSUMER_ASK_CHANNELS_CREATION;
+	request[0].u.ask_channels_creation.channel_count = ua_chans.size();
+	for (std::size_t i = 0; i < ua_chans.size(); i++) {
+		ret = init_ask_channel_msg(ua_sess,
+					   ua_chans[i],
+					   consumer,
+					   registry,
+					   trace_chunk,
+					   trace_format,
+					   &request[i + 1]);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	health_code_update();
+
+	pthread_mutex_lock(socket->lock);
+	ret = consumer_socket_send(
+		socket, request.data(), request.size() * sizeof(decltype(request)::value_type));
+	if (ret >= 0) {
+		ret = consumer_socket_recv(socket,
+					   replies.data(),
+					   replies.size() * sizeof(decltype(replies)::value_type));
+	}
+	pthread_mutex_unlock(socket->lock);
+	health_code_update();
+	if (ret < 0) {
+		ERR("ask_channels_creation consumer command failed");
+		return ret;
+	}
+
+	for (std::size_t i = 0; i < ua_chans.size(); i++) {
+		auto *ua_chan = ua_chans[i];
+
+		if (replies[i].ret_code != LTTCOMM_CONSUMERD_SUCCESS) {
+			ERR("Consumer failed to create UST channel \"%s\"", ua_chan->name);
+			created_all = false;
+			continue;
+		}
+
+		/* Communication protocol error. */
+		LTTNG_ASSERT(replies[i].key == ua_chan->key);
+		ua_chan->expected_stream_count = replies[i].stream_count;
+		/* We need at least one where 1 stream for 1 cpu. */
+		if (ua_sess->output_traces) {
+			LTTNG_ASSERT(ua_chan->expected_stream_count > 0);
+		}
+
+		DBG2("UST ask channel %" PRIu64 " successfully done with %u stream(s)",
+		     ua_chan->key,
+		     ua_chan->expected_stream_count);
+	}
+
+	if (!created_all) {
+		/* The channels are created as a whole; destroy the ones that were created. */
+		for (std::size_t i = 0; i < ua_chans.size(); i++) {
+			if (replies[i].ret_code == LTTCOMM_CONSUMERD_SUCCESS) {
+				(void) ust_consumer_destroy_channel(socket, ua_chans[i]);
+			}
+		}
+
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Get the channels of `ua_chans`, created by ust_consumer_ask_channels(), and
+ * their streams from the consumer using a single GET_CHANNELS command.
+ *
+ * `received_count` is set to the number of channels, from the start of
+ * `ua_chans`, which were entirely received. The following channels were not
+ * sent by the consumer.
+ *
+ * Return 0 on success else a negative value.
+ */
+int ust_consumer_get_channels(struct consumer_socket *socket,
+			      const std::vector<struct ust_app_channel *>& ua_chans,
+			      std::size_t *received_count)
+{
+	int ret = 0;
+	struct lttcomm_consumer_msg msg;
+	std::vector<uint64_t> request;
+
+	LTTNG_ASSERT(socket);
+	LTTNG_ASSERT(!ua_chans.empty());
+	LTTNG_ASSERT(received_count);
+
+	*received_count = 0;
+
+	try {
+		request.reserve(ua_chans.size());
+		for (const auto *ua_chan : ua_chans) {
+			request.emplace_back(ua_chan->key);
+		}
+	} catch (const std::bad_alloc&) {
+		return -ENOMEM;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	msg.cmd_type = LTTNG_CONSUMER_GET_CHANNELS;
+	msg.u.get_channels.key_count = request.size();
+
+	pthread_mutex_lock(socket->lock);
+	health_code_update();
+
+	ret = consumer_socket_send(socket, &msg, sizeof(msg));
+	if (ret < 0) {
+		goto error;
+	}
+
+	ret = consumer_socket_send(
+		socket, request.data(), request.size() * sizeof(decltype(request)::value_type));
+	if (ret < 0) {
+		goto error;
+	}
+
+	for (auto *ua_chan : ua_chans) {
+		health_code_update();
+
+		/* Each channel's reply starts with an OK reply, as for GET_CHANNEL. */
+		ret = consumer_recv_status_reply(socket);
+		if (ret < 0) {
+			goto error;
+		}
+
+		ret = recv_channel_from_consumer(socket, ua_chan);
+		if (ret < 0) {
+			goto error;
+		}
+
+		(*received_count)++;
+	}
+
 error:
 	health_code_update();
 	pthread_mutex_unlock(socket->lock);
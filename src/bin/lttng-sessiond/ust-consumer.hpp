@@ -12,7 +12,9 @@
 
 #include <common/trace-chunk.hpp>
 
+#include <cstddef>
 #include <stdint.h>
+#include <vector>
 
 namespace lttng {
 namespace sessiond {
@@ -32,6 +34,18 @@ int ust_consumer_ask_channel(struct ust_app_session *ua_sess,
 
 int ust_consumer_get_channel(struct consumer_socket *socket, struct ust_app_channel *ua_chan);
 
+int ust_consumer_ask_channels(struct ust_app_session *ua_sess,
+			      const std::vector<struct ust_app_channel *>& ua_chans,
+			      struct consumer_output *consumer,
+			      struct consumer_socket *socket,
+			      lttng::sessiond::ust::registry_session *registry,
+			      struct lttng_trace_chunk *trace_chunk,
+			      enum lttng_trace_format trace_format);
+
+int ust_consumer_get_channels(struct consumer_socket *socket,
+			      const std::vector<struct ust_app_channel *>& ua_chans,
+			      std::size_t *received_count);
+
 int ust_consumer_destroy_channel(struct consumer_socket *socket, struct ust_app_channel *ua_chan);
 
 int ust_consumer_send_stream_to_ust(struct ust_app *app,
@@ -28,6 +28,7 @@
 #include <common/make-unique.hpp>
 #include <common/pthread-lock.hpp>
 #include <common/runas.hpp>
+#include <common/scope-exit.hpp>
 #include <common/string-utils/c-string-view.hpp>
 #include <common/time.hpp>
 #include <common/urcu.hpp>
@@ -36,6 +37,7 @@
 #include <fcntl.h>
 #include <functional>
 #include <initializer_list>
+#include <limits>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -233,6 +235,69 @@ void lsu::details::locked_registry_session_release(lsu::registry_session *sessio
 	pthread_mutex_unlock(&session->_lock);
 }
 
+/*
+ * Decorates the metadata generating visitor of a registry session to cache the
+ * serialized stream and event classes.
+ *
+ * Once declared, a stream or event class never changes, unlike the trace
+ * class' environment and the clock class (resampled on every regeneration).
+ * Hence, the metadata can be regenerated by reassembling the cached fragments
+ * of the stream and event classes rather than serializing them all again,
+ * which is costly for sessions with many event classes.
+ */
+class lsu::registry_session::metadata_caching_visitor final : public lst::trace_class_visitor {
+public:
+	explicit metadata_caching_visitor(registry_session& session) : _session(session)
+	{
+	}
+
+	void visit(const lst::trace_class& trace_class) override
+	{
+		_session._metadata_generating_visitor->visit(trace_class);
+	}
+
+	void visit(const lst::clock_class& clock_class) override
+	{
+		_session._metadata_generating_visitor->visit(clock_class);
+	}
+
+	void visit(const lst::stream_class& stream_class) override
+	{
+		/* The layout of a channel is only final once the application registers it. */
+		if (!static_cast<const lsu::registry_channel&>(stream_class).is_registered()) {
+			_session._metadata_generating_visitor->visit(stream_class);
+			return;
+		}
+
+		_visit(stream_class, _session._stream_class_metadata_fragments[stream_class.id]);
+	}
+
+	void visit(const lst::event_class& event_class) override
+	{
+		_visit(event_class,
+		       _session._event_class_metadata_fragments[{ event_class.stream_class_id,
+								    event_class.id }]);
+	}
+
+private:
+	template <class ClassType>
+	void _visit(const ClassType& visited_class, std::string& cached_fragment)
+	{
+		if (!cached_fragment.empty()) {
+			_session._append_metadata_fragment(cached_fragment);
+			return;
+		}
+
+		_session._metadata_fragment_capture = &cached_fragment;
+		const auto clear_capture = lttng::make_scope_exit(
+			[this]() noexcept { _session._metadata_fragment_capture = nullptr; });
+
+		_session._metadata_generating_visitor->visit(visited_class);
+	}
+
+	registry_session& _session;
+};
+
 lsu::registry_session::registry_session(enum lttng_trace_format trace_format,
 					const struct lst::abi& in_abi,
 					uint32_t major,
@@ -255,6 +320,9 @@ lsu::registry_session::registry_session(enum lttng_trace_format trace_format,
 	_metadata_generating_visitor{ [&]() -> std::unique_ptr<trace::trace_class_visitor> {
 		auto func = [this](const std::string& fragment) {
 			_append_metadata_fragment(fragment);
+			if (_metadata_fragment_capture) {
+				_metadata_fragment_capture->append(fragment);
+			}
 		};
 
 		if (trace_format == LTTNG_TRACE_FORMAT_CTF_2) {
@@ -263,6 +331,7 @@ lsu::registry_session::registry_session(enum lttng_trace_format trace_format,
 
 		return lttng::make_unique<tsdl::trace_class_visitor>(abi, std::move(func));
 	}() },
+	_metadata_caching_visitor{ lttng::make_unique<metadata_caching_visitor>(*this) },
 	_packet_header{ _create_packet_header() }
 {
 	pthread_mutex_init(&_lock, nullptr);
@@ -486,7 +555,7 @@ void lsu::registry_session::add_channel(
 			 * Channel registration completed, serialize it's layout's
 			 * description.
 			 */
-			registered_channel.accept(*_metadata_generating_visitor);
+			registered_channel.accept(*_metadata_caching_visitor);
 		},
 		/* Added event listener. */
 		[this](const lsu::registry_channel& channel,
@@ -497,7 +566,7 @@ void lsu::registry_session::add_channel(
 			 * declared before their stream class.
 			 */
 			if (channel.is_registered()) {
-				added_event.accept(*_metadata_generating_visitor);
+				added_event.accept(*_metadata_caching_visitor);
 			}
 		});
 
@@ -540,6 +609,12 @@ void lsu::registry_session::remove_channel(uint64_t channel_key, bool notify)
 	iter.iter.node = &channel_to_remove._node.node;
 	ret = lttng_ht_del(_channels.get(), &iter);
 	LTTNG_ASSERT(!ret);
+
+	_stream_class_metadata_fragments.erase(channel_to_remove.id);
+	_event_class_metadata_fragments.erase(
+		_event_class_metadata_fragments.lower_bound({ channel_to_remove.id, 0 }),
+		_event_class_metadata_fragments.upper_bound(
+			{ channel_to_remove.id, std::numeric_limits<unsigned int>::max() }));
 	destroy_channel(&channel_to_remove, notify);
 }
 
@@ -687,7 +762,7 @@ void lsu::registry_session::_reset_metadata()
 
 void lsu::registry_session::_generate_metadata()
 {
-	trace_class::accept(*_metadata_generating_visitor);
+	trace_class::accept(*_metadata_caching_visitor);
 }
 
 void lsu::registry_session::regenerate_metadata()
@@ -21,8 +21,11 @@
 
 #include <cstdint>
 #include <ctime>
+#include <map>
 #include <string>
 #include <unistd.h>
+#include <unordered_map>
+#include <utility>
 
 namespace lttng {
 namespace sessiond {
@@ -119,6 +122,8 @@ protected:
 	void _generate_metadata();
 
 private:
+	class metadata_caching_visitor;
+
 	uint32_t _get_next_channel_id();
 	void _increase_metadata_size(size_t reservation_length);
 	void _append_metadata_fragment(const std::string& fragment);
@@ -203,7 +208,20 @@ private:
 
 	lttng::sessiond::ust::clock_class::cuptr _clock;
 	const lttng::sessiond::trace::trace_class_visitor::cuptr _metadata_generating_visitor;
+	/* Wraps _metadata_generating_visitor; see metadata_caching_visitor. */
+	const lttng::sessiond::trace::trace_class_visitor::cuptr _metadata_caching_visitor;
 	lttng::sessiond::trace::type::cuptr _packet_header;
+
+	/*
+	 * Serialized metadata of the stream classes (indexed by id) and event
+	 * classes (indexed by stream class id and id), reused when the metadata
+	 * is regenerated.
+	 */
+	std::unordered_map<unsigned int, std::string> _stream_class_metadata_fragments;
+	std::map<std::pair<unsigned int, unsigned int>, std::string>
+		_event_class_metadata_fragments;
+	/* Cache entry that also receives the metadata fragments being generated. */
+	std::string *_metadata_fragment_capture = nullptr;
 };
 
 } /* namespace ust */
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "ust-tracepoint-catalog.hpp"
+
+#include <tuple>
+
+namespace lsu = lttng::sessiond::ust;
+
+bool lsu::tracepoint_catalog::provider_set_key::operator<(
+	const provider_set_key& other) const noexcept
+{
+	return std::tie(app_name,
+			uid,
+			bits_per_long,
+			abi_major,
+			abi_minor,
+			exe_dev,
+			exe_ino,
+			exe_mtime,
+			pid) < std::tie(other.app_name,
+					other.uid,
+					other.bits_per_long,
+					other.abi_major,
+					other.abi_minor,
+					other.exe_dev,
+					other.exe_ino,
+					other.exe_mtime,
+					other.pid);
+}
+
+lsu::tracepoint_catalog::tracepoint_catalog(std::chrono::milliseconds max_list_age) :
+	_max_list_age(max_list_age)
+{
+}
+
+void lsu::tracepoint_catalog::_invalidate(provider_set& provider_set) noexcept
+{
+	provider_set.generation = _next_generation++;
+	provider_set.tracepoints.reset();
+	provider_set.fields.reset();
+}
+
+void lsu::tracepoint_catalog::add_app(const provider_set_key& key)
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+	auto& provider_set = _provider_sets[key];
+
+	provider_set.app_count++;
+	_invalidate(provider_set);
+}
+
+void lsu::tracepoint_catalog::remove_app(const provider_set_key& key)
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto provider_set_it = _provider_sets.find(key);
+
+	if (provider_set_it == _provider_sets.end()) {
+		return;
+	}
+
+	if (--provider_set_it->second.app_count == 0) {
+		_provider_sets.erase(provider_set_it);
+	} else {
+		_invalidate(provider_set_it->second);
+	}
+}
+
+lsu::tracepoint_catalog::lookup_result<lsu::tracepoint_catalog::tracepoint_list>
+lsu::tracepoint_catalog::lookup_tracepoints(const provider_set_key& key,
+					    clock::time_point now) const
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto provider_set_it = _provider_sets.find(key);
+
+	if (provider_set_it == _provider_sets.end()) {
+		return { nullptr, 0 };
+	}
+
+	const auto& provider_set = provider_set_it->second;
+	if (!provider_set.tracepoints || now - provider_set.tracepoints_time >= _max_list_age) {
+		return { nullptr, provider_set.generation };
+	}
+
+	return { provider_set.tracepoints, provider_set.generation };
+}
+
+lsu::tracepoint_catalog::lookup_result<lsu::tracepoint_catalog::field_list>
+lsu::tracepoint_catalog::lookup_fields(const provider_set_key& key, clock::time_point now) const
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto provider_set_it = _provider_sets.find(key);
+
+	if (provider_set_it == _provider_sets.end()) {
+		return { nullptr, 0 };
+	}
+
+	const auto& provider_set = provider_set_it->second;
+	if (!provider_set.fields || now - provider_set.fields_time >= _max_list_age) {
+		return { nullptr, provider_set.generation };
+	}
+
+	return { provider_set.fields, provider_set.generation };
+}
+
+void lsu::tracepoint_catalog::add_tracepoints(const provider_set_key& key,
+					      std::uint64_t generation,
+					      std::shared_ptr<const tracepoint_list> tracepoints,
+					      clock::time_point now)
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto provider_set_it = _provider_sets.find(key);
+
+	if (provider_set_it == _provider_sets.end() ||
+	    provider_set_it->second.generation != generation) {
+		/* Invalidated while the list was queried. */
+		return;
+	}
+
+	provider_set_it->second.tracepoints = std::move(tracepoints);
+	provider_set_it->second.tracepoints_time = now;
+}
+
+void lsu::tracepoint_catalog::add_fields(const provider_set_key& key,
+					 std::uint64_t generation,
+					 std::shared_ptr<const field_list> fields,
+					 clock::time_point now)
+{
+	const std::lock_guard<std::mutex> lock(_lock);
+	const auto provider_set_it = _provider_sets.find(key);
+
+	if (provider_set_it == _provider_sets.end() ||
+	    provider_set_it->second.generation != generation) {
+		/* Invalidated while the list was queried. */
+		return;
+	}
+
+	provider_set_it->second.fields = std::move(fields);
+	provider_set_it->second.fields_time = now;
+}
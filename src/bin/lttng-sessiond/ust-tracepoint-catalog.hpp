@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef LTTNG_SESSIOND_UST_TRACEPOINT_CATALOG_HPP
+#define LTTNG_SESSIOND_UST_TRACEPOINT_CATALOG_HPP
+
+#include <lttng/event.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ctime>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace lttng {
+namespace sessiond {
+namespace ust {
+
+/*
+ * Catalog of the tracepoints (and tracepoint fields) of the registered
+ * user space applications, used to answer the listing commands without
+ * querying every application.
+ *
+ * Listing the tracepoints of an application requires one round trip per
+ * tracepoint on its command socket. The catalog shares the lists among the
+ * applications expected to provide the same tracepoints, that is the
+ * applications which have the same provider set key (same executable,
+ * process name, owner, bitness, and tracer ABI): only one of them is queried.
+ *
+ * The lists of a provider set are invalidated when an application having its
+ * key registers or unregisters. Since an application may also load tracepoint
+ * providers at any time (e.g. dlopen(3)), a list is not used once it is older
+ * than `max_list_age`.
+ *
+ * The listed events are stored with a PID of 0; the caller sets the PID of
+ * each application.
+ *
+ * Thread-safe: all operations are protected by an internal mutex.
+ */
+class tracepoint_catalog final {
+public:
+	using clock = std::chrono::steady_clock;
+	using tracepoint_list = std::vector<struct lttng_event>;
+	using field_list = std::vector<struct lttng_event_field>;
+
+	struct provider_set_key {
+		bool operator<(const provider_set_key& other) const noexcept;
+
+		std::string app_name;
+		uid_t uid;
+		std::uint32_t bits_per_long;
+		std::uint32_t abi_major;
+		std::uint32_t abi_minor;
+		/*
+		 * Identity (device, inode, and modification time) of the
+		 * executable of the applications.
+		 */
+		dev_t exe_dev;
+		ino_t exe_ino;
+		time_t exe_mtime;
+		/*
+		 * PID of the application when its executable can't be
+		 * identified, 0 otherwise: such an application has its own
+		 * provider set.
+		 */
+		pid_t pid;
+	};
+
+	/*
+	 * Cached list of a provider set, or a null list if it must be queried.
+	 *
+	 * `generation` must be passed to the matching add_*() method once the
+	 * list is queried: a list queried before an invalidation is not added
+	 * to the catalog.
+	 */
+	template <typename ListType>
+	struct lookup_result {
+		std::shared_ptr<const ListType> list;
+		std::uint64_t generation;
+	};
+
+	explicit tracepoint_catalog(std::chrono::milliseconds max_list_age);
+
+	/* Deactivate copy and assignment. */
+	tracepoint_catalog(const tracepoint_catalog&) = delete;
+	tracepoint_catalog(tracepoint_catalog&&) = delete;
+	tracepoint_catalog& operator=(const tracepoint_catalog&) = delete;
+	tracepoint_catalog& operator=(tracepoint_catalog&&) = delete;
+	~tracepoint_catalog() = default;
+
+	/* An application having the provider set key `key` registered. */
+	void add_app(const provider_set_key& key);
+
+	/* An application having the provider set key `key` unregistered. */
+	void remove_app(const provider_set_key& key);
+
+	lookup_result<tracepoint_list>
+	lookup_tracepoints(const provider_set_key& key, clock::time_point now = clock::now()) const;
+	lookup_result<field_list> lookup_fields(const provider_set_key& key,
+						clock::time_point now = clock::now()) const;
+
+	void add_tracepoints(const provider_set_key& key,
+			     std::uint64_t generation,
+			     std::shared_ptr<const tracepoint_list> tracepoints,
+			     clock::time_point now = clock::now());
+	void add_fields(const provider_set_key& key,
+			std::uint64_t generation,
+			std::shared_ptr<const field_list> fields,
+			clock::time_point now = clock::now());
+
+private:
+	struct provider_set {
+		/* Number of registered applications having this provider set key. */
+		unsigned int app_count = 0;
+		std::uint64_t generation = 0;
+
+		std::shared_ptr<const tracepoint_list> tracepoints;
+		clock::time_point tracepoints_time;
+		std::shared_ptr<const field_list> fields;
+		clock::time_point fields_time;
+	};
+
+	void _invalidate(provider_set& provider_set) noexcept;
+
+	const std::chrono::milliseconds _max_list_age;
+
+	mutable std::mutex _lock;
+	/* Never 0: a null generation designates an unknown provider set. */
+	std::uint64_t _next_generation = 1;
+	std::map<provider_set_key, provider_set> _provider_sets;
+};
+
+} /* namespace ust */
+} /* namespace sessiond */
+} /* namespace lttng */
+
+#endif /* LTTNG_SESSIOND_UST_TRACEPOINT_CATALOG_HPP */
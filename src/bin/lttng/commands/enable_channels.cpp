@@ -40,6 +40,8 @@ static enum lttng_channel_allocation_policy opt_allocation_policy =
 static enum lttng_channel_preallocation_policy opt_preallocation_policy =
 	DEFAULT_CHANNEL_PREALLOCATION_POLICY;
 
+static enum lttng_channel_compression opt_compression = LTTNG_CHANNEL_COMPRESSION_NONE;
+
 static struct {
 	bool set;
 	uint64_t interval;
@@ -91,6 +93,7 @@ enum {
 	OPT_BUFFER_ALLOCATION,
 	OPT_WATCHDOG_TIMER,
 	OPT_BUFFER_PREALLOCATION,
+	OPT_COMPRESSION,
 };
 
 static struct lttng_handle *handle;
@@ -122,6 +125,7 @@ static struct poptOption long_options[] = {
 	{ "buffer-ownership", 0, POPT_ARG_STRING, nullptr, OPT_BUFFER_OWNERSHIP, nullptr, nullptr },
 	{ "buffer-allocation", 0, POPT_ARG_STRING, nullptr, OPT_BUFFER_ALLOCATION, nullptr, nullptr },
 	{ "buffer-preallocation", 0, POPT_ARG_STRING, nullptr, OPT_BUFFER_PREALLOCATION, nullptr, nullptr },
+	{ "compression", 0, POPT_ARG_STRING, nullptr, OPT_COMPRESSION, nullptr, nullptr },
 	{ "tracefile-size", 'C', POPT_ARG_INT, nullptr, OPT_TRACEFILE_SIZE, nullptr, nullptr },
 	{ "tracefile-count", 'W', POPT_ARG_INT, nullptr, OPT_TRACEFILE_COUNT, nullptr, nullptr },
 	{ "blocking-timeout", 0, POPT_ARG_INT, nullptr, OPT_BLOCKING_TIMEOUT, nullptr, nullptr },
@@ -257,6 +261,11 @@ static int enable_channel(char *session_name, char *channel_list)
 			ret = CMD_ERROR;
 			goto error;
 		}
+		if (opt_compression != LTTNG_CHANNEL_COMPRESSION_NONE) {
+			ERR("Compression option not supported for kernel domain (-k)");
+			ret = CMD_ERROR;
+			goto error;
+		}
 	}
 
 	/* Create lttng domain */
@@ -429,6 +438,13 @@ static int enable_channel(char *session_name, char *channel_list)
 			goto error;
 		}
 
+		ret = lttng_channel_set_compression(channel, opt_compression);
+		if (ret != LTTNG_CHANNEL_STATUS_OK) {
+			ERR("Failed to set the channel's compression");
+			error = 1;
+			goto error;
+		}
+
 		if (opt_auto_reclaim_memory.set) {
 			uint64_t reclaim_age = 0;
 
@@ -983,6 +999,27 @@ int cmd_enable_channels(int argc, const char **argv)
 			}
 			break;
 		}
+		case OPT_COMPRESSION:
+		{
+			const auto codec_ptr = lttng::make_unique_wrapper<char, lttng::memory::free>(
+				poptGetOptArg(pc));
+			const lttng::c_string_view codec(codec_ptr.get());
+
+			if (codec == "none") {
+				opt_compression = LTTNG_CHANNEL_COMPRESSION_NONE;
+			} else if (codec == "zstd") {
+				opt_compression = LTTNG_CHANNEL_COMPRESSION_ZSTD;
+			} else if (codec == "lz4") {
+				opt_compression = LTTNG_CHANNEL_COMPRESSION_LZ4;
+			} else {
+				ERR_FMT("Wrong value for --compression: `{}`: "
+					"expecting `none`, `zstd`, or `lz4`",
+					codec.data());
+				ret = CMD_ERROR;
+				goto end;
+			}
+			break;
+		}
 		default:
 			ret = CMD_UNDEFINED;
 			goto end;
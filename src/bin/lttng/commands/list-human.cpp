@@ -223,6 +223,29 @@ private:
 	std::int64_t _period_us;
 };
 
+/*
+ * Measured duration value, in nanoseconds.
+ */
+class duration_property_value final : public property_value {
+public:
+	explicit duration_property_value(const std::uint64_t duration_ns) :
+		_duration_ns(duration_ns)
+	{
+	}
+
+private:
+	std::string _render() const override
+	{
+		if (_duration_ns < 1000) {
+			return lttng::mint_format("[!]{}[/] ns", _duration_ns);
+		}
+
+		return format_period(_duration_ns / 1000);
+	}
+
+	std::uint64_t _duration_ns;
+};
+
 /*
  * Integral count value.
  */
@@ -283,6 +306,11 @@ property make_period_property(std::string key, const std::uint64_t period_us)
 	return { std::move(key), lttng::make_unique<period_property_value>(period_us) };
 }
 
+property make_duration_property(std::string key, const std::uint64_t duration_ns)
+{
+	return { std::move(key), lttng::make_unique<duration_property_value>(duration_ns) };
+}
+
 property make_count_property(std::string key, const std::int64_t count)
 {
 	return { std::move(key), lttng::make_unique<count_property_value>(count) };
@@ -1822,6 +1850,19 @@ std::unique_ptr<node> node_from_channel(const lttng::cli::session& session,
 					properties.emplace(make_string_property(title, "None"));
 				}
 			}
+
+			properties.emplace(make_string_property(
+				"Packet compression", [&ust_channel]() {
+					switch (ust_channel.compression()) {
+					case LTTNG_CHANNEL_COMPRESSION_ZSTD:
+						return "zstd";
+					case LTTNG_CHANNEL_COMPRESSION_LZ4:
+						return "LZ4";
+					case LTTNG_CHANNEL_COMPRESSION_NONE:
+					default:
+						return "None";
+					}
+				}()));
 		}
 
 		children.emplace_back(make_property_set_node(std::move(properties)));
@@ -1887,6 +1928,58 @@ std::unique_ptr<node> node_from_channel(const lttng::cli::session& session,
 				"Discarded packets", channel.discarded_packet_count()));
 		}
 
+		if (channel.domain_type() != LTTNG_DOMAIN_KERNEL &&
+		    channel.as_ust_or_java_python().compression() !=
+			    LTTNG_CHANNEL_COMPRESSION_NONE) {
+			const auto compression_stats =
+				channel.as_ust_or_java_python().compression_stats();
+
+			stats_properties.emplace(make_size_property(
+				"Compressed packet input", compression_stats.input_bytes));
+			stats_properties.emplace(make_size_property(
+				"Compressed packet output", compression_stats.output_bytes));
+
+			if (compression_stats.output_bytes > 0) {
+				const auto ratio = double(compression_stats.input_bytes) /
+					double(compression_stats.output_bytes);
+
+				stats_properties.emplace(make_raw_property(
+					"Compression ratio", lttng::format("{:.2f}", ratio)));
+			}
+
+			stats_properties.emplace(make_period_property(
+				"Compression CPU time", compression_stats.cpu_time_ns / 1000));
+		}
+
+		if (const auto io_stats = channel.io_stats()) {
+			stats_properties.emplace(make_count_property(
+				"Consumed sub-buffers", io_stats->consumed_subbuffer_count));
+			stats_properties.emplace(
+				make_size_property("Written data", io_stats->written_bytes));
+			stats_properties.emplace(make_count_property("Write operations",
+								     io_stats->write_call_count));
+
+			/* Latencies of the slowest stream of the channel. */
+			stats_properties.emplace(
+				make_duration_property("Sub-buffer consumption time (p99)",
+						       io_stats->subbuffer_consumption_p99_ns));
+			stats_properties.emplace(
+				make_duration_property("Sub-buffer consumption time (max.)",
+						       io_stats->subbuffer_consumption_max_ns));
+			stats_properties.emplace(make_duration_property("Write duration (p99)",
+									io_stats->write_p99_ns));
+			stats_properties.emplace(make_duration_property("Write duration (max.)",
+									io_stats->write_max_ns));
+
+			if (io_stats->relayd_send_time_ns > 0) {
+				stats_properties.emplace(make_duration_property(
+					"Relay daemon send time", io_stats->relayd_send_time_ns));
+			}
+		} else {
+			stats_properties.emplace(
+				make_raw_property("I/O statistics", "Unavailable"));
+		}
+
 		auto memory_usage_node = memory_usage_node_from_channel(channel, mem_usage);
 
 		if (!memory_usage_node) {
@@ -1706,6 +1706,52 @@ public:
 		return count;
 	}
 
+	struct io_statistics {
+		std::uint64_t consumed_subbuffer_count;
+		std::uint64_t written_bytes;
+		std::uint64_t write_call_count;
+		std::uint64_t relayd_send_time_ns;
+		std::uint64_t subbuffer_consumption_p99_ns;
+		std::uint64_t subbuffer_consumption_max_ns;
+		std::uint64_t write_p99_ns;
+		std::uint64_t write_max_ns;
+	};
+
+	/*
+	 * Returns a snapshot of the I/O statistics of the consumption of
+	 * this channel.
+	 *
+	 * `nonstd::nullopt` means the session daemon couldn't get them.
+	 */
+	nonstd::optional<io_statistics> io_stats() const
+	{
+		io_statistics stats;
+		auto status = lttng_channel_get_io_statistics(_lib_channel,
+							      &stats.consumed_subbuffer_count,
+							      &stats.written_bytes,
+							      &stats.write_call_count,
+							      &stats.relayd_send_time_ns);
+
+		if (status == LTTNG_CHANNEL_STATUS_UNSET) {
+			return nonstd::nullopt;
+		}
+
+		if (status == LTTNG_CHANNEL_STATUS_OK) {
+			status = lttng_channel_get_io_latency_statistics(
+				_lib_channel,
+				&stats.subbuffer_consumption_p99_ns,
+				&stats.subbuffer_consumption_max_ns,
+				&stats.write_p99_ns,
+				&stats.write_max_ns);
+		}
+
+		if (status != LTTNG_CHANNEL_STATUS_OK) {
+			LTTNG_THROW_ERROR("Failed to get I/O statistics");
+		}
+
+		return stats;
+	}
+
 	/*
 	 * Returns a snapshot of the available recording event rules of
 	 * this channel.
@@ -1840,6 +1886,39 @@ public:
 		return lib_policy;
 	}
 
+	lttng_channel_compression compression() const
+	{
+		lttng_channel_compression lib_compression;
+
+		if (lttng_channel_get_compression(&lib(), &lib_compression) !=
+		    LTTNG_CHANNEL_STATUS_OK) {
+			LTTNG_THROW_ERROR("Failed to get compression");
+		}
+
+		return lib_compression;
+	}
+
+	struct compression_statistics {
+		std::uint64_t input_bytes;
+		std::uint64_t output_bytes;
+		std::uint64_t cpu_time_ns;
+	};
+
+	compression_statistics compression_stats() const
+	{
+		compression_statistics stats;
+
+		if (lttng_channel_get_compression_statistics(&lib(),
+							     &stats.input_bytes,
+							     &stats.output_bytes,
+							     &stats.cpu_time_ns) !=
+		    LTTNG_CHANNEL_STATUS_OK) {
+			LTTNG_THROW_ERROR("Failed to get compression statistics");
+		}
+
+		return stats;
+	}
+
 	nonstd::optional<std::uint64_t> automatic_memory_reclaim_maximal_age_us() const noexcept
 	{
 		std::uint64_t maximal_age_us;
@@ -189,6 +189,20 @@ ssize_t lttng_channel_create_from_buffer(const struct lttng_buffer_view *view,
 				   reclamation_age_value);
 	}
 
+	extended->compression = channel_comm->compression;
+	extended->compression_input_bytes = channel_comm->compression_input_bytes;
+	extended->compression_output_bytes = channel_comm->compression_output_bytes;
+	extended->compression_cpu_time_ns = channel_comm->compression_cpu_time_ns;
+	extended->io_consumed_subbuffers = channel_comm->io_consumed_subbuffers;
+	extended->io_written_bytes = channel_comm->io_written_bytes;
+	extended->io_write_calls = channel_comm->io_write_calls;
+	extended->io_relayd_send_time_ns = channel_comm->io_relayd_send_time_ns;
+	extended->io_subbuffer_consumption_p99_ns = channel_comm->io_subbuffer_consumption_p99_ns;
+	extended->io_subbuffer_consumption_max_ns = channel_comm->io_subbuffer_consumption_max_ns;
+	extended->io_write_p99_ns = channel_comm->io_write_p99_ns;
+	extended->io_write_max_ns = channel_comm->io_write_max_ns;
+	extended->has_io_stats = channel_comm->has_io_stats;
+
 	*channel = local_channel;
 	local_channel = nullptr;
 
@@ -258,6 +272,20 @@ int lttng_channel_serialize(struct lttng_channel *channel, struct lttng_dynamic_
 				   reclamation_age_value);
 	}
 
+	channel_comm.compression = extended->compression;
+	channel_comm.compression_input_bytes = extended->compression_input_bytes;
+	channel_comm.compression_output_bytes = extended->compression_output_bytes;
+	channel_comm.compression_cpu_time_ns = extended->compression_cpu_time_ns;
+	channel_comm.io_consumed_subbuffers = extended->io_consumed_subbuffers;
+	channel_comm.io_written_bytes = extended->io_written_bytes;
+	channel_comm.io_write_calls = extended->io_write_calls;
+	channel_comm.io_relayd_send_time_ns = extended->io_relayd_send_time_ns;
+	channel_comm.io_subbuffer_consumption_p99_ns = extended->io_subbuffer_consumption_p99_ns;
+	channel_comm.io_subbuffer_consumption_max_ns = extended->io_subbuffer_consumption_max_ns;
+	channel_comm.io_write_p99_ns = extended->io_write_p99_ns;
+	channel_comm.io_write_max_ns = extended->io_write_max_ns;
+	channel_comm.has_io_stats = extended->has_io_stats;
+
 	/* Header */
 	ret = lttng_dynamic_buffer_append(buf, &channel_comm, sizeof(channel_comm));
 	if (ret) {
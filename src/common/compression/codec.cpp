@@ -0,0 +1,239 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/compression/codec.hpp>
+#include <common/exception.hpp>
+#include <common/format.hpp>
+#include <common/make-unique.hpp>
+
+#include <limits>
+
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif /* HAVE_LIBZSTD */
+
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif /* HAVE_LIBLZ4 */
+
+namespace lcomp = lttng::compression;
+
+namespace {
+#ifdef HAVE_LIBZSTD
+/*
+ * Packets are compressed independently of each other and are rather small:
+ * favour speed over ratio, like the zstd command line tool does by default.
+ */
+constexpr int zstd_compression_level = 3;
+
+class zstd_codec final : public lcomp::codec {
+public:
+	zstd_codec() :
+		_compression_context(ZSTD_createCCtx()), _decompression_context(ZSTD_createDCtx())
+	{
+		if (!_compression_context || !_decompression_context) {
+			ZSTD_freeCCtx(_compression_context);
+			ZSTD_freeDCtx(_decompression_context);
+			LTTNG_THROW_ALLOCATION_FAILURE_ERROR("Failed to allocate zstd contexts");
+		}
+	}
+
+	~zstd_codec() override
+	{
+		ZSTD_freeCCtx(_compression_context);
+		ZSTD_freeDCtx(_decompression_context);
+	}
+
+	/* Deactivate copy and assignment. */
+	zstd_codec(const zstd_codec&) = delete;
+	zstd_codec(zstd_codec&&) = delete;
+	zstd_codec& operator=(const zstd_codec&) = delete;
+	zstd_codec& operator=(zstd_codec&&) = delete;
+
+	lcomp::codec_type type() const noexcept override
+	{
+		return lcomp::codec_type::ZSTD;
+	}
+
+	std::size_t compress_bound(std::size_t size) const override
+	{
+		return ZSTD_compressBound(size);
+	}
+
+	std::size_t compress(const void *source,
+			     std::size_t source_size,
+			     void *destination,
+			     std::size_t destination_capacity) override
+	{
+		const auto ret = ZSTD_compressCCtx(_compression_context,
+						   destination,
+						   destination_capacity,
+						   source,
+						   source_size,
+						   zstd_compression_level);
+
+		if (ZSTD_isError(ret)) {
+			LTTNG_THROW_ERROR(fmt::format("Failed to compress packet with zstd: {}",
+						      ZSTD_getErrorName(ret)));
+		}
+
+		return ret;
+	}
+
+	std::size_t decompress(const void *source,
+			       std::size_t source_size,
+			       void *destination,
+			       std::size_t destination_capacity) override
+	{
+		const auto ret = ZSTD_decompressDCtx(_decompression_context,
+						     destination,
+						     destination_capacity,
+						     source,
+						     source_size);
+
+		if (ZSTD_isError(ret)) {
+			LTTNG_THROW_ERROR(fmt::format("Failed to decompress packet with zstd: {}",
+						      ZSTD_getErrorName(ret)));
+		}
+
+		return ret;
+	}
+
+private:
+	ZSTD_CCtx *const _compression_context;
+	ZSTD_DCtx *const _decompression_context;
+};
+#endif /* HAVE_LIBZSTD */
+
+#ifdef HAVE_LIBLZ4
+/* The lz4 block API is limited to int-sized buffers. */
+int lz4_buffer_size(std::size_t size)
+{
+	if (size > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+		LTTNG_THROW_OUT_OF_RANGE(fmt::format("Buffer is too large for lz4: size={}", size));
+	}
+
+	return static_cast<int>(size);
+}
+
+class lz4_codec final : public lcomp::codec {
+public:
+	lz4_codec() = default;
+	~lz4_codec() override = default;
+
+	/* Deactivate copy and assignment. */
+	lz4_codec(const lz4_codec&) = delete;
+	lz4_codec(lz4_codec&&) = delete;
+	lz4_codec& operator=(const lz4_codec&) = delete;
+	lz4_codec& operator=(lz4_codec&&) = delete;
+
+	lcomp::codec_type type() const noexcept override
+	{
+		return lcomp::codec_type::LZ4;
+	}
+
+	std::size_t compress_bound(std::size_t size) const override
+	{
+		return static_cast<std::size_t>(LZ4_compressBound(lz4_buffer_size(size)));
+	}
+
+	std::size_t compress(const void *source,
+			     std::size_t source_size,
+			     void *destination,
+			     std::size_t destination_capacity) override
+	{
+		const auto ret = LZ4_compress_default(static_cast<const char *>(source),
+						      static_cast<char *>(destination),
+						      lz4_buffer_size(source_size),
+						      lz4_buffer_size(destination_capacity));
+
+		if (ret <= 0) {
+			LTTNG_THROW_ERROR(fmt::format(
+				"Failed to compress packet with lz4: size={}, destination_capacity={}",
+				source_size,
+				destination_capacity));
+		}
+
+		return static_cast<std::size_t>(ret);
+	}
+
+	std::size_t decompress(const void *source,
+			       std::size_t source_size,
+			       void *destination,
+			       std::size_t destination_capacity) override
+	{
+		const auto ret = LZ4_decompress_safe(static_cast<const char *>(source),
+						     static_cast<char *>(destination),
+						     lz4_buffer_size(source_size),
+						     lz4_buffer_size(destination_capacity));
+
+		if (ret < 0) {
+			LTTNG_THROW_ERROR(fmt::format(
+				"Failed to decompress packet with lz4: size={}, destination_capacity={}",
+				source_size,
+				destination_capacity));
+		}
+
+		return static_cast<std::size_t>(ret);
+	}
+};
+#endif /* HAVE_LIBLZ4 */
+} /* namespace */
+
+bool lcomp::is_codec_supported(codec_type type) noexcept
+{
+	switch (type) {
+	case codec_type::NONE:
+		return false;
+	case codec_type::ZSTD:
+#ifdef HAVE_LIBZSTD
+		return true;
+#else
+		return false;
+#endif /* HAVE_LIBZSTD */
+	case codec_type::LZ4:
+#ifdef HAVE_LIBLZ4
+		return true;
+#else
+		return false;
+#endif /* HAVE_LIBLZ4 */
+	}
+
+	return false;
+}
+
+lcomp::codec::uptr lcomp::create_codec(codec_type type)
+{
+	switch (type) {
+#ifdef HAVE_LIBZSTD
+	case codec_type::ZSTD:
+		return lttng::make_unique<zstd_codec>();
+#endif /* HAVE_LIBZSTD */
+#ifdef HAVE_LIBLZ4
+	case codec_type::LZ4:
+		return lttng::make_unique<lz4_codec>();
+#endif /* HAVE_LIBLZ4 */
+	default:
+		LTTNG_THROW_UNSUPPORTED_ERROR(
+			fmt::format("Packet compression codec is not supported by this build: codec={}",
+				    codec_type_name(type)));
+	}
+}
+
+const char *lcomp::codec_type_name(codec_type type) noexcept
+{
+	switch (type) {
+	case codec_type::NONE:
+		return "none";
+	case codec_type::ZSTD:
+		return "zstd";
+	case codec_type::LZ4:
+		return "lz4";
+	}
+
+	return "unknown";
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef LTTNG_COMPRESSION_CODEC_HPP
+#define LTTNG_COMPRESSION_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace lttng {
+namespace compression {
+
+/*
+ * Codec used to compress a trace packet.
+ *
+ * The values are recorded in the packet indexes (see ctf-index.hpp) and
+ * exchanged with the relay daemon: they must never change.
+ */
+enum class codec_type : std::uint8_t {
+	NONE = 0,
+	ZSTD = 1,
+	LZ4 = 2,
+};
+
+/*
+ * Compresses and decompresses whole trace packets.
+ *
+ * A codec instance holds its own compression context and may be reused
+ * indefinitely, but it must not be used by more than one thread at a time.
+ */
+class codec {
+public:
+	using uptr = std::unique_ptr<codec>;
+
+	virtual ~codec() = default;
+
+	/* Deactivate copy and assignment. */
+	codec(const codec&) = delete;
+	codec(codec&&) = delete;
+	codec& operator=(const codec&) = delete;
+	codec& operator=(codec&&) = delete;
+
+	virtual codec_type type() const noexcept = 0;
+
+	/* Size of the buffer needed to compress `size` bytes in the worst case. */
+	virtual std::size_t compress_bound(std::size_t size) const = 0;
+
+	/*
+	 * Compress [source, source + source_size) to `destination`, which can
+	 * hold `destination_capacity` bytes, and return the compressed size.
+	 *
+	 * Throws on error (notably if the destination is too small).
+	 */
+	virtual std::size_t compress(const void *source,
+				     std::size_t source_size,
+				     void *destination,
+				     std::size_t destination_capacity) = 0;
+
+	/*
+	 * Decompress [source, source + source_size) to `destination` and return
+	 * the decompressed size.
+	 *
+	 * `destination_capacity` must be at least the size of the original
+	 * packet, as recorded in its index. Throws on error.
+	 */
+	virtual std::size_t decompress(const void *source,
+				       std::size_t source_size,
+				       void *destination,
+				       std::size_t destination_capacity) = 0;
+
+protected:
+	codec() = default;
+};
+
+/* Whether or not this build can compress packets with a given codec. */
+bool is_codec_supported(codec_type type) noexcept;
+
+/* Throws if the codec is not supported by this build. */
+codec::uptr create_codec(codec_type type);
+
+const char *codec_type_name(codec_type type) noexcept;
+
+} /* namespace compression */
+} /* namespace lttng */
+
+#endif /* LTTNG_COMPRESSION_CODEC_HPP */
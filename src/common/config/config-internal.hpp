@@ -5,9 +5,49 @@
  *
  */
 
-#include <libxml/xmlwriter.h>
 #include <stdio.h>
+#include <string>
+#include <vector>
 
+/*
+ * Streaming XML writer.
+ *
+ * The document is serialized directly into a buffer which is written to the
+ * output file descriptor whenever it fills up. Hence, the memory usage of the
+ * writer only depends on the nesting depth of the document, not on its size.
+ *
+ * The output is identical to that of libxml2's xmlTextWriter.
+ */
 struct config_writer {
-	xmlTextWriterPtr writer;
+	enum class element_state {
+		/* The start tag is open: attributes can still be added. */
+		START_TAG,
+		/* The element has content (text or child elements). */
+		CONTENT,
+	};
+
+	struct element {
+		std::string name;
+		element_state state;
+	};
+
+	config_writer(int fd_output, bool indent_output) : fd(fd_output), indent(indent_output)
+	{
+	}
+
+	/* Deactivate copy and assignment. */
+	config_writer(const config_writer&) = delete;
+	config_writer(config_writer&&) = delete;
+	config_writer& operator=(const config_writer&) = delete;
+	config_writer& operator=(config_writer&&) = delete;
+	~config_writer() = default;
+
+	const int fd;
+	const bool indent;
+	/* The next end tag must be indented (its element has child elements). */
+	bool indent_end_tag = true;
+	/* Serialized output not yet written to `fd`. */
+	std::string buffer;
+	/* Open elements, from the root element to the current element. */
+	std::vector<element> open_elements;
 };
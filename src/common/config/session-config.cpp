@@ -14,8 +14,10 @@
 #include <common/defaults.hpp>
 #include <common/dynamic-buffer.hpp>
 #include <common/error.hpp>
+#include <common/format.hpp>
 #include <common/macros.hpp>
 #include <common/make-unique-wrapper.hpp>
+#include <common/readwrite.hpp>
 #include <common/string-utils/c-string-view.hpp>
 #include <common/utils.hpp>
 
@@ -25,6 +27,8 @@
 #include <lttng/snapshot.h>
 #include <lttng/userspace-probe.h>
 
+#include <algorithm>
+#include <atomic>
 #include <ctype.h>
 #include <dirent.h>
 #include <inttypes.h>
@@ -36,63 +40,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 #define CONFIG_USERSPACE_PROBE_LOOKUP_METHOD_NAME_MAX_LEN 7
 
 namespace {
-using xmlBuffer_uptr =
-	std::unique_ptr<xmlBuffer, lttng::memory::create_deleter_class<xmlBuffer, xmlBufferFree>>;
+using xmlDoc_uptr =
+	std::unique_ptr<xmlDoc, lttng::memory::create_deleter_class<xmlDoc, xmlFreeDoc>>;
 
-class encoded_string {
-public:
-	encoded_string() noexcept = default;
-
-	encoded_string(encoded_string&& other) noexcept : _buffer(std::move(other._buffer))
-	{
-	}
-
-	explicit encoded_string(xmlBuffer_uptr buffer) noexcept : _buffer(std::move(buffer))
+/* Session configuration file of a directory, parsed ahead of its replay. */
+struct session_config_file {
+	explicit session_config_file(std::string file_path) : path(std::move(file_path))
 	{
 	}
 
-	~encoded_string() noexcept = default;
-
-	encoded_string& operator=(encoded_string&& other) noexcept
-	{
-		if (this != &other) {
-			_buffer = std::move(other._buffer);
-		}
-
-		return *this;
-	}
-
-	/* Copying is disallowed to prevent multiple ownership of the underlying XML buffer. */
-	encoded_string(const encoded_string&) = delete;
-	encoded_string& operator=(const encoded_string&) = delete;
-
-	const xmlChar *value() const noexcept
-	{
-		LTTNG_ASSERT(_buffer);
-		return xmlBufferContent(_buffer.get());
-	}
-
-	/* NOLINTBEGIN(google-explicit-constructor) */
-	operator bool() const noexcept
-	{
-		return !!_buffer;
-	}
-
-	operator const xmlChar *() const noexcept
-	{
-		return value();
-	}
-	/* NOLINTEND(google-explicit-constructor) */
-
-private:
-	xmlBuffer_uptr _buffer;
+	std::string path;
+	xmlDoc_uptr doc;
+	/* 0 or the negative LTTng error code of the parsing of the file. */
+	int parse_ret = 0;
 };
 
 struct session_config_validation_ctx {
@@ -329,81 +299,183 @@ struct consumer_output {
 	char *data_uri;
 };
 
-encoded_string encode_string(const char *in_str)
+/* Size above which the buffered output of a configuration writer is written out. */
+constexpr std::size_t config_writer_flush_threshold = 64 * 1024;
+
+int flush_config_writer(struct config_writer& writer)
 {
-	LTTNG_ASSERT(in_str);
+	if (writer.buffer.empty()) {
+		return 0;
+	}
 
-	xmlCharEncodingHandlerPtr handler = xmlFindCharEncodingHandler(config_xml_encoding);
-	if (!handler) {
-		ERR_FMT("xmlFindCharEncodingHandler returned null: encoding=`{}`",
-			config_xml_encoding);
-		return encoded_string();
+	const auto write_ret = lttng_write(writer.fd, writer.buffer.data(), writer.buffer.size());
+	if (write_ret != static_cast<ssize_t>(writer.buffer.size())) {
+		PERROR("Failed to write XML document: fd=%d", writer.fd);
+		return -1;
 	}
 
-	const xmlBuffer_uptr in_buffer(xmlBufferCreate());
-	xmlBuffer_uptr out_buffer(xmlBufferCreate());
-	if (!in_buffer || !out_buffer) {
-		ERR("Failed to allocate XML buffer");
-		return encoded_string();
+	writer.buffer.clear();
+	return 0;
+}
+
+void append_indentation(struct config_writer& writer)
+{
+	for (std::size_t i = 1; i < writer.open_elements.size(); i++) {
+		writer.buffer.append(config_xml_indent_string);
 	}
+}
 
-	const auto buffer_add_ret =
-		xmlBufferAdd(in_buffer.get(), reinterpret_cast<const xmlChar *>(in_str), -1);
-	if (buffer_add_ret < 0) {
-		ERR_FMT("Failed to add string to XML buffer: value=`{}`", in_str);
-		return encoded_string();
+/* Escape the content of an element the same way as xmlEncodeSpecialChars(). */
+void append_escaped_text(std::string& buffer, const char *text)
+{
+	for (const char *c = text; *c; c++) {
+		switch (*c) {
+		case '<':
+			buffer.append("&lt;");
+			break;
+		case '>':
+			buffer.append("&gt;");
+			break;
+		case '&':
+			buffer.append("&amp;");
+			break;
+		case '"':
+			buffer.append("&quot;");
+			break;
+		case '\r':
+			buffer.append("&#13;");
+			break;
+		default:
+			buffer.push_back(*c);
+			break;
+		}
 	}
+}
 
-	const auto encode_ret = xmlCharEncInFunc(handler, out_buffer.get(), in_buffer.get());
-	if (encode_ret < 0) {
-		ERR_FMT("Failed to encode string: value=`{}`, target_encoding=`{}`",
-			in_str,
-			config_xml_encoding);
-		return encoded_string();
+/* Escape an attribute value the same way as xmlTextWriterWriteAttribute(). */
+void append_escaped_attribute_value(std::string& buffer, const char *value)
+{
+	for (const char *c = value; *c; c++) {
+		switch (*c) {
+		case '<':
+			buffer.append("&lt;");
+			break;
+		case '>':
+			buffer.append("&gt;");
+			break;
+		case '&':
+			buffer.append("&amp;");
+			break;
+		case '"':
+			buffer.append("&quot;");
+			break;
+		case '\n':
+			buffer.append("&#10;");
+			break;
+		case '\r':
+			buffer.append("&#13;");
+			break;
+		case '\t':
+			buffer.append("&#9;");
+			break;
+		default:
+			buffer.push_back(*c);
+			break;
+		}
 	}
+}
+
+/* Give content to the current element, closing its start tag if needed. */
+void begin_element_content(struct config_writer& writer)
+{
+	auto& current_element = writer.open_elements.back();
 
-	return encoded_string(std::move(out_buffer));
+	if (current_element.state == config_writer::element_state::START_TAG) {
+		writer.buffer.push_back('>');
+		current_element.state = config_writer::element_state::CONTENT;
+	}
 }
-} /* namespace */
 
-struct config_writer *config_writer_create(int fd_output, int indent)
+void open_element(struct config_writer& writer, const char *element_name)
 {
-	int ret;
-	struct config_writer *writer;
-	xmlOutputBufferPtr buffer;
+	if (!writer.open_elements.empty() &&
+	    writer.open_elements.back().state == config_writer::element_state::START_TAG) {
+		begin_element_content(writer);
+		if (writer.indent) {
+			writer.buffer.push_back('\n');
+		}
+	}
 
-	writer = zmalloc<config_writer>();
-	if (!writer) {
-		PERROR("zmalloc config_writer_create");
-		goto end;
+	writer.open_elements.push_back(
+		{ element_name, config_writer::element_state::START_TAG });
+	if (writer.indent) {
+		append_indentation(writer);
 	}
 
-	buffer = xmlOutputBufferCreateFd(fd_output, nullptr);
-	if (!buffer) {
-		goto error_destroy;
+	writer.buffer.push_back('<');
+	writer.buffer.append(element_name);
+}
+
+void write_text(struct config_writer& writer, const char *text)
+{
+	begin_element_content(writer);
+	writer.indent_end_tag = false;
+	append_escaped_text(writer.buffer, text);
+}
+
+int close_element(struct config_writer& writer)
+{
+	if (writer.open_elements.empty()) {
+		return -1;
 	}
 
-	writer->writer = xmlNewTextWriter(buffer);
-	ret = xmlTextWriterStartDocument(writer->writer, nullptr, config_xml_encoding, nullptr);
-	if (ret < 0) {
-		goto error_destroy;
+	const auto& current_element = writer.open_elements.back();
+	if (current_element.state == config_writer::element_state::START_TAG) {
+		writer.buffer.append("/>");
+	} else {
+		if (writer.indent && writer.indent_end_tag) {
+			append_indentation(writer);
+		}
+
+		writer.buffer.append("</");
+		writer.buffer.append(current_element.name);
+		writer.buffer.push_back('>');
 	}
 
-	ret = xmlTextWriterSetIndentString(writer->writer, BAD_CAST config_xml_indent_string);
-	if (ret) {
-		goto error_destroy;
+	writer.indent_end_tag = true;
+	if (writer.indent) {
+		writer.buffer.push_back('\n');
 	}
 
-	ret = xmlTextWriterSetIndent(writer->writer, indent);
-	if (ret) {
-		goto error_destroy;
+	writer.open_elements.pop_back();
+	return writer.buffer.size() >= config_writer_flush_threshold ?
+		flush_config_writer(writer) :
+		0;
+}
+
+int write_element(struct config_writer& writer, const char *element_name, const char *value)
+{
+	open_element(writer, element_name);
+	write_text(writer, value);
+	return close_element(writer);
+}
+} /* namespace */
+
+struct config_writer *config_writer_create(int fd_output, int indent)
+{
+	struct config_writer *writer;
+
+	try {
+		writer = new config_writer(fd_output, indent != 0);
+		writer->buffer.reserve(config_writer_flush_threshold);
+		writer->buffer.append(fmt::format("<?xml version=\"1.0\" encoding=\"{}\"?>\n",
+						  config_xml_encoding));
+	} catch (const std::bad_alloc&) {
+		ERR("Failed to allocate configuration writer");
+		return nullptr;
 	}
 
-end:
 	return writer;
-error_destroy:
-	config_writer_destroy(writer);
-	return nullptr;
 }
 
 int config_writer_destroy(struct config_writer *writer)
@@ -411,104 +483,108 @@ int config_writer_destroy(struct config_writer *writer)
 	int ret = 0;
 
 	if (!writer) {
-		ret = -EINVAL;
-		goto end;
+		return -EINVAL;
 	}
 
-	if (xmlTextWriterEndDocument(writer->writer) < 0) {
-		WARN("Could not close XML document");
-		ret = -EIO;
+	try {
+		/* End the document. */
+		while (!writer->open_elements.empty()) {
+			close_element(*writer);
+		}
+
+		if (!writer->indent) {
+			writer->buffer.push_back('\n');
+		}
+	} catch (const std::bad_alloc&) {
+		ERR("Failed to allocate memory while closing XML document");
+		ret = -ENOMEM;
 	}
 
-	if (writer->writer) {
-		xmlFreeTextWriter(writer->writer);
+	if (flush_config_writer(*writer)) {
+		WARN("Could not close XML document");
+		ret = -EIO;
 	}
 
-	free(writer);
-end:
+	delete writer;
 	return ret;
 }
 
 int config_writer_open_element(struct config_writer *writer, const char *element_name)
 {
-	if (!writer || !writer->writer || !element_name || !element_name[0]) {
+	if (!writer || !element_name || !element_name[0]) {
 		return -1;
 	}
 
-	const auto encoded_element_name = encode_string(element_name);
-	if (!encoded_element_name) {
+	try {
+		open_element(*writer, element_name);
+	} catch (const std::bad_alloc&) {
 		return -1;
 	}
 
-	const auto write_ret = xmlTextWriterStartElement(writer->writer, encoded_element_name);
-	return std::min(write_ret, 0);
+	return 0;
 }
 
 int config_writer_write_attribute(struct config_writer *writer, const char *name, const char *value)
 {
-	if (!writer || !writer->writer || !name || !name[0]) {
-		return -1;
-	}
-
-	const auto encoded_name = encode_string(name);
-	if (!encoded_name) {
+	if (!writer || !name || !name[0] || !value || writer->open_elements.empty() ||
+	    writer->open_elements.back().state != config_writer::element_state::START_TAG) {
 		return -1;
 	}
 
-	const auto encoded_value = encode_string(value);
-	if (!encoded_value) {
+	try {
+		writer->buffer.push_back(' ');
+		writer->buffer.append(name);
+		writer->buffer.append("=\"");
+		append_escaped_attribute_value(writer->buffer, value);
+		writer->buffer.push_back('"');
+	} catch (const std::bad_alloc&) {
 		return -1;
 	}
 
-	const auto write_ret =
-		xmlTextWriterWriteAttribute(writer->writer, encoded_name, encoded_value);
-	return std::min(write_ret, 0);
+	return 0;
 }
 
 int config_writer_close_element(struct config_writer *writer)
 {
-	if (!writer || !writer->writer) {
+	if (!writer) {
 		return -1;
 	}
 
-	const auto write_ret = xmlTextWriterEndElement(writer->writer);
-	return std::min(write_ret, 0);
+	try {
+		return close_element(*writer);
+	} catch (const std::bad_alloc&) {
+		return -1;
+	}
 }
 
 int config_writer_write_element_unsigned_int(struct config_writer *writer,
 					     const char *element_name,
 					     uint64_t value)
 {
-	if (!writer || !writer->writer || !element_name || !element_name[0]) {
+	if (!writer || !element_name || !element_name[0]) {
 		return -1;
 	}
 
-	const auto encoded_element_name = encode_string(element_name);
-	if (!encoded_element_name) {
+	try {
+		return write_element(*writer, element_name, std::to_string(value).c_str());
+	} catch (const std::bad_alloc&) {
 		return -1;
 	}
-
-	const auto write_ret = xmlTextWriterWriteFormatElement(
-		writer->writer, encoded_element_name, "%" PRIu64, value);
-	return std::min(write_ret, 0);
 }
 
 int config_writer_write_element_signed_int(struct config_writer *writer,
 					   const char *element_name,
 					   int64_t value)
 {
-	if (!writer || !writer->writer || !element_name || !element_name[0]) {
+	if (!writer || !element_name || !element_name[0]) {
 		return -1;
 	}
 
-	const auto encoded_element_name = encode_string(element_name);
-	if (!encoded_element_name) {
+	try {
+		return write_element(*writer, element_name, std::to_string(value).c_str());
+	} catch (const std::bad_alloc&) {
 		return -1;
 	}
-
-	const auto write_ret = xmlTextWriterWriteFormatElement(
-		writer->writer, encoded_element_name, "%" PRIi64, value);
-	return std::min(write_ret, 0);
 }
 
 int config_writer_write_element_bool(struct config_writer *writer,
@@ -523,41 +599,31 @@ int config_writer_write_element_double(struct config_writer *writer,
 				       const char *element_name,
 				       double value)
 {
-	if (!writer || !writer->writer || !element_name || !element_name[0]) {
+	if (!writer || !element_name || !element_name[0]) {
 		return -1;
 	}
 
-	const auto encoded_element_name = encode_string(element_name);
-	if (!encoded_element_name) {
+	try {
+		/* Same formatting as "%f". */
+		return write_element(*writer, element_name, std::to_string(value).c_str());
+	} catch (const std::bad_alloc&) {
 		return -1;
 	}
-
-	const auto write_ret =
-		xmlTextWriterWriteFormatElement(writer->writer, encoded_element_name, "%f", value);
-	return std::min(write_ret, 0);
 }
 
 int config_writer_write_element_string(struct config_writer *writer,
 				       const char *element_name,
 				       const char *value)
 {
-	if (!writer || !writer->writer || !element_name || !element_name[0] || !value) {
-		return -1;
-	}
-
-	const auto encoded_element_name = encode_string(element_name);
-	if (!encoded_element_name) {
+	if (!writer || !element_name || !element_name[0] || !value) {
 		return -1;
 	}
 
-	const auto encoded_value = encode_string(value);
-	if (!encoded_value) {
+	try {
+		return write_element(*writer, element_name, value);
+	} catch (const std::bad_alloc&) {
 		return -1;
 	}
-
-	const auto write_ret =
-		xmlTextWriterWriteElement(writer->writer, encoded_element_name, encoded_value);
-	return std::min(write_ret, 0);
 }
 
 static ATTR_FORMAT_PRINTF(2, 3) void xml_error_handler(void *ctx __attribute__((unused)),
@@ -3624,43 +3690,52 @@ valid:
 	return 1;
 }
 
-static int load_session_from_file(const char *path,
-				  const char *session_name,
-				  struct session_config_validation_ctx *validation_ctx,
-				  int overwrite,
-				  const struct config_load_session_override_attr *overrides)
+/*
+ * Parse the session configuration file at `path` and validate it against the
+ * schema using `schema_validation_ctx`.
+ *
+ * Returns 0 and sets `doc` on success, a negative LTTng error code otherwise.
+ */
+static int parse_session_config_file(const char *path,
+				     xmlSchemaValidCtxtPtr schema_validation_ctx,
+				     xmlDoc_uptr& doc)
 {
-	int ret, session_found = !session_name;
-	xmlDocPtr doc = nullptr;
-	xmlNodePtr sessions_node;
-	xmlNodePtr session_node;
+	int ret;
 
 	LTTNG_ASSERT(path);
-	LTTNG_ASSERT(validation_ctx);
+	LTTNG_ASSERT(schema_validation_ctx);
 
 	ret = validate_file_read_creds(path);
 	if (ret != 1) {
-		if (ret == -1) {
-			ret = -LTTNG_ERR_EPERM;
-		} else {
-			ret = -LTTNG_ERR_LOAD_SESSION_NOENT;
-		}
-		goto end;
+		return ret == -1 ? -LTTNG_ERR_EPERM : -LTTNG_ERR_LOAD_SESSION_NOENT;
 	}
 
-	doc = xmlParseFile(path);
-	if (!doc) {
-		ret = -LTTNG_ERR_LOAD_IO_FAIL;
-		goto end;
+	xmlDoc_uptr parsed_doc(xmlParseFile(path));
+	if (!parsed_doc) {
+		return -LTTNG_ERR_LOAD_IO_FAIL;
 	}
 
-	ret = xmlSchemaValidateDoc(validation_ctx->schema_validation_ctx, doc);
+	ret = xmlSchemaValidateDoc(schema_validation_ctx, parsed_doc.get());
 	if (ret) {
-		ERR("Session configuration file validation failed");
-		ret = -LTTNG_ERR_LOAD_INVALID_CONFIG;
-		goto end;
+		ERR("Session configuration file \"%s\" validation failed", path);
+		return -LTTNG_ERR_LOAD_INVALID_CONFIG;
 	}
 
+	doc = std::move(parsed_doc);
+	return 0;
+}
+
+static int load_session_from_doc(xmlDocPtr doc,
+				 const char *session_name,
+				 int overwrite,
+				 const struct config_load_session_override_attr *overrides)
+{
+	int ret = 0, session_found = !session_name;
+	xmlNodePtr sessions_node;
+	xmlNodePtr session_node;
+
+	LTTNG_ASSERT(doc);
+
 	sessions_node = xmlDocGetRootElement(doc);
 	if (!sessions_node) {
 		ret = -LTTNG_ERR_LOAD_INVALID_CONFIG;
@@ -3691,13 +3766,101 @@ static int load_session_from_file(const char *path,
 		}
 	}
 end:
-	xmlFreeDoc(doc);
 	if (!ret) {
 		ret = session_found ? 0 : -LTTNG_ERR_LOAD_SESSION_NOENT;
 	}
 	return ret;
 }
 
+static int load_session_from_file(const char *path,
+				  const char *session_name,
+				  struct session_config_validation_ctx *validation_ctx,
+				  int overwrite,
+				  const struct config_load_session_override_attr *overrides)
+{
+	xmlDoc_uptr doc;
+
+	LTTNG_ASSERT(path);
+	LTTNG_ASSERT(validation_ctx);
+
+	const auto ret =
+		parse_session_config_file(path, validation_ctx->schema_validation_ctx, doc);
+	if (ret) {
+		return ret;
+	}
+
+	return load_session_from_doc(doc.get(), session_name, overwrite, overrides);
+}
+
+/*
+ * Parse and validate `files` concurrently, using up to one thread per
+ * processor.
+ *
+ * The parsing and validation of the files dominate the load time of large
+ * configurations and are independent from one another, unlike the
+ * replay of the sessions which must be done in order.
+ *
+ * The threads share the schema, but a validation context can't be used by
+ * more than one thread at a time: each thread uses its own.
+ */
+static void parse_session_config_files(std::vector<session_config_file>& files,
+				       const struct session_config_validation_ctx *validation_ctx)
+{
+	std::atomic<std::size_t> next_file_index(0);
+	std::vector<std::thread> workers;
+
+	/* Initialize libxml2 before it is used by multiple threads. */
+	xmlInitParser();
+
+	const auto parse_files = [&files, &next_file_index](
+					 xmlSchemaValidCtxtPtr schema_validation_ctx) noexcept {
+		for (auto index = next_file_index++; index < files.size();
+		     index = next_file_index++) {
+			auto& file = files[index];
+
+			file.parse_ret = parse_session_config_file(
+				file.path.c_str(), schema_validation_ctx, file.doc);
+		}
+	};
+
+	const auto worker_count = std::min<std::size_t>(
+		std::max(std::thread::hardware_concurrency(), 1U), files.size());
+
+	/* The calling thread accounts for one of the workers. */
+	for (std::size_t i = 1; i < worker_count; i++) {
+		auto *schema_validation_ctx = xmlSchemaNewValidCtxt(validation_ctx->schema);
+		if (!schema_validation_ctx) {
+			DBG("Failed to create a validation context for a session configuration parsing thread");
+			break;
+		}
+
+		xmlSchemaSetValidErrors(
+			schema_validation_ctx, xml_error_handler, xml_error_handler, nullptr);
+
+		try {
+			workers.emplace_back([&parse_files, schema_validation_ctx]() {
+				parse_files(schema_validation_ctx);
+				xmlSchemaFreeValidCtxt(schema_validation_ctx);
+			});
+		} catch (const std::exception& ex) {
+			DBG("Failed to launch a session configuration parsing thread: %s",
+			    ex.what());
+			xmlSchemaFreeValidCtxt(schema_validation_ctx);
+			break;
+		}
+	}
+
+	DBG("Parsing session configuration files: file_count=%zu, thread_count=%zu",
+	    files.size(),
+	    workers.size() + 1);
+
+	/* Parse the remaining files alone if no thread could be launched. */
+	parse_files(validation_ctx->schema_validation_ctx);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
 static int load_session_from_path(const char *path,
 				  const char *session_name,
 				  struct session_config_validation_ctx *validation_ctx,
@@ -3708,6 +3871,7 @@ static int load_session_from_path(const char *path,
 	DIR *directory = nullptr;
 	struct lttng_dynamic_buffer file_path;
 	size_t path_len;
+	std::vector<session_config_file> files;
 
 	LTTNG_ASSERT(path);
 	LTTNG_ASSERT(validation_ctx);
@@ -3820,15 +3984,13 @@ static int load_session_from_path(const char *path,
 				goto end;
 			}
 
-			ret = load_session_from_file(
-				file_path.data, session_name, validation_ctx, overwrite, overrides);
-			if (session_name && (!ret || ret != -LTTNG_ERR_LOAD_SESSION_NOENT)) {
-				session_found = 1;
-				break;
-			}
-			if (ret && ret != -LTTNG_ERR_LOAD_SESSION_NOENT) {
+			try {
+				files.emplace_back(file_path.data);
+			} catch (const std::bad_alloc&) {
+				ret = -LTTNG_ERR_NOMEM;
 				goto end;
 			}
+
 			/*
 			 * Reset the buffer's size to the location of the
 			 * path's trailing '/'.
@@ -3839,6 +4001,29 @@ static int load_session_from_path(const char *path,
 				goto end;
 			}
 		}
+
+		parse_session_config_files(files, validation_ctx);
+
+		/* Replay the sessions in the order in which the files were listed. */
+		for (const auto& file : files) {
+			ret = file.parse_ret ? file.parse_ret :
+					       load_session_from_doc(file.doc.get(),
+								     session_name,
+								     overwrite,
+								     overrides);
+			if (session_name && (!ret || ret != -LTTNG_ERR_LOAD_SESSION_NOENT)) {
+				session_found = 1;
+				break;
+			}
+			if (ret && ret != -LTTNG_ERR_LOAD_SESSION_NOENT) {
+				goto end;
+			}
+		}
+
+		/* Not finding the session in the last file isn't an error. */
+		if (ret == -LTTNG_ERR_LOAD_SESSION_NOENT) {
+			ret = 0;
+		}
 	} else {
 		ret = load_session_from_file(
 			path, session_name, validation_ctx, overwrite, overrides);
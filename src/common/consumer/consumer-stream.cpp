@@ -12,6 +12,7 @@
 
 #include <common/buffer-view.hpp>
 #include <common/common.hpp>
+#include <common/compat/time.hpp>
 #include <common/consumer/consumer-timer.hpp>
 #include <common/consumer/consumer.hpp>
 #include <common/consumer/metadata-bucket.hpp>
@@ -22,6 +23,7 @@
 #include <common/macros.hpp>
 #include <common/make-unique.hpp>
 #include <common/relayd/relayd.hpp>
+#include <common/time.hpp>
 #include <common/urcu.hpp>
 #include <common/ust-consumer/ust-consumer.hpp>
 #include <common/utils.hpp>
@@ -216,6 +218,8 @@ end:
 
 static void ctf_packet_index_populate(struct ctf_packet_index *index,
 				      off_t offset,
+				      uint64_t stored_size,
+				      lttng::compression::codec_type codec,
 				      const struct stream_subbuffer *subbuffer)
 {
 	*index = (typeof(*index)){
@@ -233,6 +237,8 @@ static void ctf_packet_index_populate(struct ctf_packet_index *index,
 		.packet_seq_num = htobe64(subbuffer->info.data.sequence_number.is_set ?
 						  subbuffer->info.data.sequence_number.value :
 						  -1ULL),
+		.stored_size = htobe64(stored_size),
+		.compression_codec = static_cast<uint8_t>(codec),
 	};
 }
 
@@ -315,6 +321,76 @@ static ssize_t consumer_stream_consume_mmap(struct lttng_consumer_local_data *ct
 	return written_bytes + metadata_written_bytes;
 }
 
+/*
+ * Compress the whole padded sub-buffer and write the resulting packet.
+ *
+ * The compressed packet is written as is (without padding), both on disk and
+ * over the network; its size in the trace file is kept to produce its index.
+ */
+static ssize_t consumer_stream_consume_mmap_compressed(struct lttng_consumer_local_data *ctx
+						       __attribute__((unused)),
+						       struct lttng_consumer_stream *stream,
+						       const struct stream_subbuffer *subbuffer)
+{
+	struct timespec cpu_time_begin, cpu_time_end;
+	const auto& packet = subbuffer->buffer.buffer;
+	std::size_t compressed_size;
+
+	LTTNG_ASSERT(stream->codec);
+
+	const bool has_cpu_time = !lttng_clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time_begin);
+
+	try {
+		const auto bound = stream->codec->compress_bound(packet.size);
+
+		if (stream->compression_buffer.size() < bound) {
+			stream->compression_buffer.resize(bound);
+		}
+
+		compressed_size = stream->codec->compress(packet.data,
+							  packet.size,
+							  stream->compression_buffer.data(),
+							  stream->compression_buffer.size());
+	} catch (const std::exception& e) {
+		ERR_FMT("Failed to compress packet: channel_name=`{}`, stream_key={}, packet_size={}: {}",
+			stream->chan->name,
+			stream->key,
+			packet.size,
+			e.what());
+		return -1;
+	}
+
+	if (has_cpu_time && !lttng_clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time_end)) {
+		const auto cpu_time = timespec_abs_diff(cpu_time_end, cpu_time_begin);
+
+		stream->chan->compression_cpu_time_ns.fetch_add(
+			uint64_t(cpu_time.tv_sec) * NSEC_PER_SEC + cpu_time.tv_nsec,
+			std::memory_order_relaxed);
+	}
+
+	const auto compressed_packet =
+		lttng_buffer_view_init(stream->compression_buffer.data(), 0, compressed_size);
+	const ssize_t written_bytes =
+		lttng_consumer_on_read_subbuffer_mmap(stream, &compressed_packet, 0);
+
+	if (written_bytes < 0) {
+		ERR("Error writing compressed mmap subbuffer: %zd", written_bytes);
+		return written_bytes;
+	}
+
+	if (written_bytes != compressed_size) {
+		DBG("Failed to write the entire compressed packet (written_bytes: %zd, compressed size %zu)",
+		    written_bytes,
+		    compressed_size);
+	}
+
+	stream->compressed_packet_size = compressed_size;
+	stream->chan->compression_input_bytes.fetch_add(packet.size, std::memory_order_relaxed);
+	stream->chan->compression_output_bytes.fetch_add(compressed_size,
+							 std::memory_order_relaxed);
+	return written_bytes;
+}
+
 static ssize_t consumer_stream_consume_splice(struct lttng_consumer_local_data *ctx,
 					      struct lttng_consumer_stream *stream,
 					      const struct stream_subbuffer *subbuffer)
@@ -345,16 +421,20 @@ static int consumer_stream_send_index(lttng_consumer_stream& stream,
 {
 	off_t packet_offset = 0;
 	struct ctf_packet_index index = {};
+	const auto codec = stream.chan->compression_codec;
+	const uint64_t stored_size = codec != lttng::compression::codec_type::NONE ?
+		stream.compressed_packet_size :
+		subbuffer->info.data.padded_subbuf_size;
 
 	/*
 	 * This is called after consuming the sub-buffer; substract the
 	 * effect this sub-buffer from the offset.
 	 */
 	if (!stream.has_network_destination()) {
-		packet_offset = stream.out_fd_offset - subbuffer->info.data.padded_subbuf_size;
+		packet_offset = stream.out_fd_offset - stored_size;
 	}
 
-	ctf_packet_index_populate(&index, packet_offset, subbuffer);
+	ctf_packet_index_populate(&index, packet_offset, stored_size, codec, subbuffer);
 	return consumer_stream_write_index(stream, index);
 }
 
@@ -961,6 +1041,7 @@ struct lttng_consumer_stream *consumer_stream_create(struct lttng_consumer_chann
 	stream->output_written = 0;
 	stream->net_seq_idx = relayd_id;
 	stream->session_id = session_id;
+	stream->cpu = cpu;
 	stream->monitor = monitor;
 	stream->endpoint_status = CONSUMER_ENDPOINT_ACTIVE;
 	stream->index_file = nullptr;
@@ -1102,7 +1183,26 @@ struct lttng_consumer_stream *consumer_stream_create(struct lttng_consumer_chann
 		stream->read_subbuffer_ops.pre_consume_subbuffer = consumer_stream_update_stats;
 	}
 
-	if (channel->output == CONSUMER_CHANNEL_MMAP) {
+	if (type != CONSUMER_CHANNEL_TYPE_METADATA &&
+	    channel->compression_codec != lttng::compression::codec_type::NONE) {
+		/* Compressed packets are staged in memory; splice is not used. */
+		LTTNG_ASSERT(channel->output == CONSUMER_CHANNEL_MMAP);
+
+		try {
+			stream->codec =
+				lttng::compression::create_codec(channel->compression_codec);
+		} catch (const std::exception& e) {
+			ERR_FMT("Failed to create packet compression codec: channel_name=`{}`, codec=`{}`: {}",
+				channel->name,
+				lttng::compression::codec_type_name(channel->compression_codec),
+				e.what());
+			ret = -1;
+			goto error;
+		}
+
+		stream->read_subbuffer_ops.consume_subbuffer =
+			consumer_stream_consume_mmap_compressed;
+	} else if (channel->output == CONSUMER_CHANNEL_MMAP) {
 		stream->read_subbuffer_ops.consume_subbuffer = consumer_stream_consume_mmap;
 	} else {
 		stream->read_subbuffer_ops.consume_subbuffer = consumer_stream_consume_splice;
@@ -1513,6 +1613,12 @@ int consumer_stream_create_output_files(struct lttng_consumer_stream *stream, bo
 	}
 
 	if (!stream->metadata_flag && (create_index || stream->index_file)) {
+		/* Only the streams of compressed channels use the 1.2 index. */
+		const uint32_t index_minor =
+			stream->chan->compression_codec != lttng::compression::codec_type::NONE ?
+			CTF_INDEX_COMPRESSED_MINOR :
+			CTF_INDEX_MINOR;
+
 		if (stream->index_file) {
 			lttng_index_file_put(stream->index_file);
 		}
@@ -1523,7 +1629,7 @@ int consumer_stream_create_output_files(struct lttng_consumer_stream *stream, bo
 								 stream->chan->tracefile_size,
 								 stream->tracefile_count_current,
 								 CTF_INDEX_MAJOR,
-								 CTF_INDEX_MINOR,
+								 index_minor,
 								 false,
 								 &stream->index_file);
 		if (chunk_status != LTTNG_TRACE_CHUNK_STATUS_OK) {
@@ -38,6 +38,24 @@ bool is_userspace_consumer() noexcept
 		abort();
 	}
 }
+
+/*
+ * Cancel a timer task of `channel` and release the channel's reference to it.
+ *
+ * The task is unlinked from the scheduler that runs it, if any, rather than left
+ * queued until its deadline.
+ */
+void cancel_timer_task(const lttng_consumer_channel& channel,
+		       lttng::scheduling::periodic_task::sptr& task) noexcept
+{
+	if (channel.timer_task_scheduler) {
+		channel.timer_task_scheduler->cancel(task);
+	} else {
+		task->cancel();
+	}
+
+	task.reset();
+}
 } /* namespace */
 
 static int the_channel_monitor_pipe = -1;
@@ -65,6 +83,7 @@ void consumer_timer_switch_start(struct lttng_consumer_channel *channel,
 				sessiond_metadata_socket,
 				consumer_error_socket);
 
+		channel->timer_task_scheduler = &scheduler;
 		scheduler.schedule(channel->live_timer_task,
 				   std::chrono::steady_clock::now() +
 					   std::chrono::microseconds(switch_timer_interval_us));
@@ -79,8 +98,7 @@ void consumer_timer_switch_stop(struct lttng_consumer_channel *channel)
 {
 	LTTNG_ASSERT(channel);
 
-	channel->metadata_switch_timer_task->cancel();
-	channel->metadata_switch_timer_task.reset();
+	cancel_timer_task(*channel, channel->metadata_switch_timer_task);
 }
 
 /* Start the channel's periodic "live mode" management task. */
@@ -101,6 +119,7 @@ void consumer_timer_live_start(struct lttng_consumer_channel *channel,
 		channel->live_timer_task = std::make_shared<lttng::consumer::live_timer_task>(
 			std::chrono::microseconds(live_timer_interval_us), *channel);
 
+		channel->timer_task_scheduler = &scheduler;
 		scheduler.schedule(channel->live_timer_task,
 				   std::chrono::steady_clock::now() +
 					   std::chrono::microseconds(live_timer_interval_us));
@@ -123,8 +142,7 @@ void consumer_timer_live_stop(struct lttng_consumer_channel *channel)
 	}
 
 	/* Cancel the live timer task if it is scheduled. */
-	channel->live_timer_task->cancel();
-	channel->live_timer_task.reset();
+	cancel_timer_task(*channel, channel->live_timer_task);
 }
 
 /*
@@ -153,6 +171,7 @@ int consumer_timer_monitor_start(struct lttng_consumer_channel *channel,
 			*channel,
 			consumer_timer_thread_get_channel_monitor_pipe());
 
+		channel->timer_task_scheduler = &scheduler;
 		scheduler.schedule(channel->monitor_timer_task,
 				   std::chrono::steady_clock::now() +
 					   std::chrono::microseconds(monitor_timer_interval_us));
@@ -177,8 +196,7 @@ int consumer_timer_monitor_stop(struct lttng_consumer_channel *channel)
 	LTTNG_ASSERT(channel->monitor_timer_task);
 
 	/* Cancel the monitor timer task if it is scheduled. */
-	channel->monitor_timer_task->cancel();
-	channel->monitor_timer_task.reset();
+	cancel_timer_task(*channel, channel->monitor_timer_task);
 	return 0;
 }
 
@@ -212,6 +230,7 @@ int consumer_timer_stall_watchdog_start(struct lttng_consumer_channel *channel,
 				*channel,
 				consumer_error_socket);
 		if (watchdog_timer_interval_us != 0) {
+			channel->timer_task_scheduler = &scheduler;
 			scheduler.schedule(
 				channel->stall_watchdog_timer_task,
 				std::chrono::steady_clock::now() +
@@ -239,8 +258,7 @@ int consumer_timer_stall_watchdog_stop(struct lttng_consumer_channel *channel)
 	LTTNG_ASSERT(channel->stall_watchdog_timer_task);
 
 	/* Cancel the watchdog timer task if it is scheduled. */
-	channel->stall_watchdog_timer_task->cancel();
-	channel->stall_watchdog_timer_task.reset();
+	cancel_timer_task(*channel, channel->stall_watchdog_timer_task);
 	return 0;
 }
 
@@ -276,6 +294,7 @@ int consumer_timer_memory_reclaim_start(lttng_consumer_channel& channel,
 			std::make_shared<lttng::consumer::memory_reclaim_timer_task>(
 				period, channel, max_age);
 
+		channel.timer_task_scheduler = &scheduler;
 		scheduler.schedule(channel.memory_reclaim_timer_task,
 				   std::chrono::steady_clock::now() + period);
 	} catch (const std::bad_alloc& e) {
@@ -296,8 +315,7 @@ void consumer_timer_memory_reclaim_stop(lttng_consumer_channel *channel)
 	LTTNG_ASSERT(channel->memory_reclaim_timer_task);
 
 	/* Cancel the memory reclaim timer task if it is scheduled. */
-	channel->memory_reclaim_timer_task->cancel();
-	channel->memory_reclaim_timer_task.reset();
+	cancel_timer_task(*channel, channel->memory_reclaim_timer_task);
 }
 
 int consumer_timer_thread_get_channel_monitor_pipe()
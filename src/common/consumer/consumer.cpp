@@ -738,7 +738,8 @@ int consumer_send_relayd_stream(struct lttng_consumer_stream *stream, char *path
 					&stream->relayd_stream_id,
 					stream->chan->tracefile_size,
 					stream->chan->tracefile_count,
-					stream->trace_chunk);
+					stream->trace_chunk,
+					static_cast<uint8_t>(stream->chan->compression_codec));
 		pthread_mutex_unlock(&relayd->ctrl_sock_mutex);
 		if (ret < 0) {
 			ERR("Relayd add stream failed. Cleaning up relayd %" PRIu64 ".",
@@ -1651,6 +1652,7 @@ ssize_t lttng_consumer_on_read_subbuffer_mmap(struct lttng_consumer_stream *stre
 	unsigned int relayd_hang_up = 0;
 	const size_t subbuf_content_size = buffer->size - padding;
 	size_t write_len;
+	std::chrono::steady_clock::time_point relayd_send_begin_time;
 
 	/* RCU lock for the relayd pointer */
 	const lttng::urcu::read_lock_guard read_lock;
@@ -1679,6 +1681,7 @@ ssize_t lttng_consumer_on_read_subbuffer_mmap(struct lttng_consumer_stream *stre
 			netlen += sizeof(struct lttcomm_relayd_metadata_payload);
 		}
 
+		relayd_send_begin_time = std::chrono::steady_clock::now();
 		ret = write_relayd_stream_header(stream, netlen, padding, relayd);
 		if (ret < 0) {
 			relayd_hang_up = 1;
@@ -1721,7 +1724,13 @@ ssize_t lttng_consumer_on_read_subbuffer_mmap(struct lttng_consumer_stream *stre
 	 * This call guarantee that len or less is returned. It's impossible to
 	 * receive a ret value that is bigger than len.
 	 */
-	ret = lttng_write(outfd, buffer->data, write_len);
+	{
+		const auto write_begin_time = std::chrono::steady_clock::now();
+
+		ret = lttng_write(outfd, buffer->data, write_len);
+		stream->io_stats.write_time.record(std::chrono::steady_clock::now() -
+						   write_begin_time);
+	}
 	DBG("Consumer mmap write() ret %zd (len %zu)", ret, write_len);
 	if (ret < 0 || ((size_t) ret != write_len)) {
 		/*
@@ -1749,6 +1758,7 @@ ssize_t lttng_consumer_on_read_subbuffer_mmap(struct lttng_consumer_stream *stre
 		goto write_error;
 	}
 	stream->output_written += ret;
+	stream->io_stats.written_bytes.fetch_add(ret, std::memory_order_relaxed);
 
 	/* This call is useless on a socket so better save a syscall. */
 	if (!relayd) {
@@ -1756,6 +1766,9 @@ ssize_t lttng_consumer_on_read_subbuffer_mmap(struct lttng_consumer_stream *stre
 		lttng::io::hint_flush_range_async(outfd, stream->out_fd_offset, write_len);
 		stream->out_fd_offset += write_len;
 		lttng_consumer_sync_trace_file(stream, orig_offset);
+	} else {
+		stream->io_stats.relayd_send_time.record(std::chrono::steady_clock::now() -
+							 relayd_send_begin_time);
 	}
 
 write_error:
@@ -1798,6 +1811,7 @@ ssize_t lttng_consumer_on_read_subbuffer_splice(struct lttng_consumer_local_data
 	struct consumer_relayd_sock_pair *relayd = nullptr;
 	int *splice_pipe;
 	unsigned int relayd_hang_up = 0;
+	std::chrono::steady_clock::time_point relayd_send_begin_time;
 
 	switch (the_consumer_data.type) {
 	case LTTNG_CONSUMER_KERNEL:
@@ -1828,6 +1842,7 @@ ssize_t lttng_consumer_on_read_subbuffer_splice(struct lttng_consumer_local_data
 	if (relayd) {
 		unsigned long total_len = len;
 
+		relayd_send_begin_time = std::chrono::steady_clock::now();
 		if (stream->metadata_flag) {
 			/*
 			 * Lock the control socket for the complete duration of the function
@@ -1874,6 +1889,8 @@ ssize_t lttng_consumer_on_read_subbuffer_splice(struct lttng_consumer_local_data
 	}
 
 	while (len > 0) {
+		const auto splice_begin_time = std::chrono::steady_clock::now();
+
 		DBG("splice chan to pipe offset %lu of len %lu (fd : %d, pipe: %d)",
 		    (unsigned long) offset,
 		    len,
@@ -1938,10 +1955,16 @@ ssize_t lttng_consumer_on_read_subbuffer_splice(struct lttng_consumer_local_data
 			stream->out_fd_offset += ret_splice;
 		}
 		stream->output_written += ret_splice;
+		stream->io_stats.written_bytes.fetch_add(ret_splice, std::memory_order_relaxed);
+		stream->io_stats.write_time.record(std::chrono::steady_clock::now() -
+						   splice_begin_time);
 		written += ret_splice;
 	}
 	if (!relayd) {
 		lttng_consumer_sync_trace_file(stream, orig_offset);
+	} else {
+		stream->io_stats.relayd_send_time.record(std::chrono::steady_clock::now() -
+							 relayd_send_begin_time);
 	}
 	goto end;
 
@@ -3391,6 +3414,7 @@ ssize_t lttng_consumer_read_subbuffer(struct lttng_consumer_stream *stream,
 	int rotation_ret;
 	struct stream_subbuffer subbuffer = {};
 	enum get_next_subbuffer_status get_next_status;
+	std::chrono::steady_clock::time_point subbuffer_acquisition_time;
 
 	if (!locked_by_caller) {
 		stream->read_subbuffer_ops.lock(stream);
@@ -3421,6 +3445,7 @@ ssize_t lttng_consumer_read_subbuffer(struct lttng_consumer_stream *stream,
 	get_next_status = stream->read_subbuffer_ops.get_next_subbuffer(stream, &subbuffer);
 	switch (get_next_status) {
 	case GET_NEXT_SUBBUFFER_STATUS_OK:
+		subbuffer_acquisition_time = std::chrono::steady_clock::now();
 		break;
 	case GET_NEXT_SUBBUFFER_STATUS_NO_DATA:
 		/* Not an error. */
@@ -3450,6 +3475,9 @@ ssize_t lttng_consumer_read_subbuffer(struct lttng_consumer_stream *stream,
 		goto end;
 	}
 
+	stream->io_stats.subbuffer_consumption_time.record(std::chrono::steady_clock::now() -
+							   subbuffer_acquisition_time);
+
 	ret = post_consume(*stream, &subbuffer, ctx);
 	if (ret) {
 		goto end;
@@ -5263,6 +5291,209 @@ enum lttcomm_return_code lttng_consumer_open_channel_packets(struct lttng_consum
 	return ret;
 }
 
+void lttng_consumer_send_session_channels_runtime_stats(int sock, uint64_t session_id)
+{
+	/*
+	 * The reply has the following structure:
+	 * - generic reply header (announcing the command status and payload size)
+	 * - command-specific reply header (announcing the number of channel entries)
+	 * - channel runtime statistics entries
+	 *
+	 * The counters of the channels are aggregated by the data threads as the
+	 * packets are consumed: building the reply only requires a walk of the
+	 * channels of the session.
+	 */
+	std::vector<std::uint8_t> reply_payload;
+	lttcomm_consumer_status_msg generic_reply_header = {};
+	lttcomm_consumer_session_channels_runtime_stats_reply_header command_specific_reply_header =
+		{};
+	const auto reset_payload = [&reply_payload]() {
+		reply_payload.resize(sizeof(generic_reply_header) +
+				     sizeof(command_specific_reply_header));
+	};
+
+	std::uint32_t channel_count = 0;
+
+	try {
+		reset_payload();
+		const lttng::pthread::lock_guard consumer_data_lock(the_consumer_data.lock);
+		const auto *ht = the_consumer_data.channels_by_session_id_ht;
+
+		for (const auto *channel : lttng::urcu::lfht_filtered_iteration_adapter<
+			     lttng_consumer_channel,
+			     decltype(lttng_consumer_channel::channels_by_session_id_ht_node),
+			     &lttng_consumer_channel::channels_by_session_id_ht_node,
+			     std::uint64_t>(*ht->ht,
+					    &session_id,
+					    ht->hash_fct(&session_id, lttng_ht_seed),
+					    ht->match_fct)) {
+			if (channel->type == CONSUMER_CHANNEL_TYPE_METADATA) {
+				continue;
+			}
+
+			const lttcomm_channel_runtime_stats channel_stats = {
+				.channel_key = channel->key,
+				.discarded_events = channel->discarded_events,
+				.lost_packets = channel->lost_packets,
+				.compression = {
+					.input_bytes = channel->compression_input_bytes.load(
+						std::memory_order_relaxed),
+					.output_bytes = channel->compression_output_bytes.load(
+						std::memory_order_relaxed),
+					.cpu_time_ns = channel->compression_cpu_time_ns.load(
+						std::memory_order_relaxed),
+				},
+			};
+
+			reply_payload.insert(
+				reply_payload.end(),
+				reinterpret_cast<const std::uint8_t *>(&channel_stats),
+				reinterpret_cast<const std::uint8_t *>(&channel_stats) +
+					sizeof(channel_stats));
+			channel_count++;
+		}
+
+		generic_reply_header.ret_code = LTTCOMM_CONSUMERD_SUCCESS;
+	} catch (const std::exception& exn) {
+		ERR_FMT("Exception while reporting channel runtime statistics: session_id={}, error=`{}`",
+			session_id,
+			exn.what());
+		reset_payload();
+		generic_reply_header.ret_code = LTTCOMM_CONSUMERD_UNKNOWN_ERROR;
+		channel_count = 0;
+	}
+
+	DBG_FMT("Reporting runtime statistics of session channels: session_id={}, channel_count={}",
+		session_id,
+		channel_count);
+
+	/* Update the payload headers. */
+	generic_reply_header.payload_size = reply_payload.size() - sizeof(generic_reply_header);
+	memcpy(reply_payload.data(), &generic_reply_header, sizeof(generic_reply_header));
+
+	command_specific_reply_header.count = channel_count;
+	memcpy(reply_payload.data() + sizeof(generic_reply_header),
+	       &command_specific_reply_header,
+	       sizeof(command_specific_reply_header));
+
+	const auto send_ret =
+		lttcomm_send_unix_sock(sock, reply_payload.data(), reply_payload.size());
+	if (send_ret < 0 || static_cast<std::size_t>(send_ret) != reply_payload.size()) {
+		LTTNG_THROW_POSIX(
+			fmt::format(
+				"Failed to send session channels runtime statistics reply to session daemon: payload_size={} bytes",
+				reply_payload.size()),
+			errno);
+	}
+}
+
+namespace {
+lttcomm_duration_stats
+duration_stats_from_histogram(const lttng::log2_duration_histogram& histogram) noexcept
+{
+	const auto snapshot = histogram.get_snapshot();
+
+	return {
+		.count = snapshot.count(),
+		.total_ns = snapshot.sum(),
+		.p50_ns = snapshot.quantile_upper_bound(0.5),
+		.p99_ns = snapshot.quantile_upper_bound(0.99),
+		.max_ns = snapshot.max(),
+	};
+}
+} /* namespace */
+
+void lttng_consumer_send_session_streams_io_stats(int sock, uint64_t session_id)
+{
+	/*
+	 * The reply has the following structure:
+	 * - generic reply header (announcing the command status and payload size)
+	 * - command-specific reply header (announcing the number of stream entries)
+	 * - stream I/O statistics entries
+	 *
+	 * The statistics are updated by the data threads as the sub-buffers are
+	 * consumed and are read without holding the stream locks.
+	 */
+	std::vector<std::uint8_t> reply_payload;
+	lttcomm_consumer_status_msg generic_reply_header = {};
+	lttcomm_consumer_session_streams_io_stats_reply_header command_specific_reply_header = {};
+	const auto reset_payload = [&reply_payload]() {
+		reply_payload.resize(sizeof(generic_reply_header) +
+				     sizeof(command_specific_reply_header));
+	};
+
+	std::uint32_t stream_count = 0;
+
+	try {
+		reset_payload();
+		const lttng::pthread::lock_guard consumer_data_lock(the_consumer_data.lock);
+		const auto *ht = the_consumer_data.stream_list_ht;
+
+		for (const auto *stream : lttng::urcu::lfht_filtered_iteration_adapter<
+			     lttng_consumer_stream,
+			     decltype(lttng_consumer_stream::node_session_id),
+			     &lttng_consumer_stream::node_session_id,
+			     std::uint64_t>(*ht->ht,
+					    &session_id,
+					    ht->hash_fct(&session_id, lttng_ht_seed),
+					    ht->match_fct)) {
+			if (stream->metadata_flag) {
+				continue;
+			}
+
+			const auto& io = stream->io_stats;
+			const lttcomm_stream_io_stats stream_stats = {
+				.channel_key = stream->chan->key,
+				.stream_key = stream->key,
+				.cpu = stream->cpu,
+				.written_bytes = io.written_bytes.load(std::memory_order_relaxed),
+				.subbuffer_consumption = duration_stats_from_histogram(
+					io.subbuffer_consumption_time),
+				.write = duration_stats_from_histogram(io.write_time),
+				.relayd_send = duration_stats_from_histogram(io.relayd_send_time),
+			};
+
+			reply_payload.insert(reply_payload.end(),
+					     reinterpret_cast<const std::uint8_t *>(&stream_stats),
+					     reinterpret_cast<const std::uint8_t *>(&stream_stats) +
+						     sizeof(stream_stats));
+			stream_count++;
+		}
+
+		generic_reply_header.ret_code = LTTCOMM_CONSUMERD_SUCCESS;
+	} catch (const std::exception& exn) {
+		ERR_FMT("Exception while reporting stream I/O statistics: session_id={}, error=`{}`",
+			session_id,
+			exn.what());
+		reset_payload();
+		generic_reply_header.ret_code = LTTCOMM_CONSUMERD_UNKNOWN_ERROR;
+		stream_count = 0;
+	}
+
+	DBG_FMT("Reporting I/O statistics of session streams: session_id={}, stream_count={}",
+		session_id,
+		stream_count);
+
+	/* Update the payload headers. */
+	generic_reply_header.payload_size = reply_payload.size() - sizeof(generic_reply_header);
+	memcpy(reply_payload.data(), &generic_reply_header, sizeof(generic_reply_header));
+
+	command_specific_reply_header.count = stream_count;
+	memcpy(reply_payload.data() + sizeof(generic_reply_header),
+	       &command_specific_reply_header,
+	       sizeof(command_specific_reply_header));
+
+	const auto send_ret =
+		lttcomm_send_unix_sock(sock, reply_payload.data(), reply_payload.size());
+	if (send_ret < 0 || static_cast<std::size_t>(send_ret) != reply_payload.size()) {
+		LTTNG_THROW_POSIX(
+			fmt::format(
+				"Failed to send session streams I/O statistics reply to session daemon: payload_size={} bytes",
+				reply_payload.size()),
+			errno);
+	}
+}
+
 void lttng_consumer_sigbus_handle(void *addr)
 {
 	lttng_ustconsumer_sigbus_handle(addr);
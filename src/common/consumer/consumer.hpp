@@ -14,12 +14,16 @@
 #include "consumer-type.hpp"
 
 #include <common/buffer-view.hpp>
+#include <common/compression/codec.hpp>
 #include <common/consumer/consumer-channel.hpp>
 #include <common/credentials.hpp>
+#include <common/defaults.hpp>
 #include <common/dynamic-array.hpp>
 #include <common/exception.hpp>
 #include <common/hashtable/hashtable.hpp>
+#include <common/histogram.hpp>
 #include <common/index/ctf-index.hpp>
+#include <common/memory-usage-sampler.hpp>
 #include <common/pipe.hpp>
 #include <common/scheduler.hpp>
 #include <common/sessiond-comm/sessiond-comm.hpp>
@@ -33,6 +37,7 @@
 
 #include <vendor/optional.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <limits.h>
@@ -234,6 +239,12 @@ struct lttng_consumer_channel {
 	/* For periodic channel memory reclamation. */
 	lttng::scheduling::periodic_task::sptr memory_reclaim_timer_task;
 
+	/*
+	 * Scheduler of the channel's timer tasks, set when the first one is
+	 * started. Used to cancel the tasks when they are stopped.
+	 */
+	lttng::scheduling::scheduler *timer_task_scheduler = nullptr;
+
 	/* On-disk circular buffer */
 	uint64_t tracefile_size = 0;
 	uint64_t tracefile_count = 0;
@@ -285,6 +296,16 @@ struct lttng_consumer_channel {
 	/* Total number of missed packets due to overwriting (overwrite). */
 	uint64_t lost_packets = 0;
 
+	/* Codec used to compress the packets of the data streams. */
+	lttng::compression::codec_type compression_codec = lttng::compression::codec_type::NONE;
+	/*
+	 * Compression statistics of the data streams, updated by the data
+	 * thread and read when the session daemon lists the channel.
+	 */
+	std::atomic<uint64_t> compression_input_bytes{ 0 };
+	std::atomic<uint64_t> compression_output_bytes{ 0 };
+	std::atomic<uint64_t> compression_cpu_time_ns{ 0 };
+
 	bool streams_sent_to_relayd = false;
 	uint64_t consumed_size_as_of_last_sample_sent = 0;
 
@@ -632,6 +653,8 @@ struct lttng_consumer_stream {
 	enum consumer_endpoint_status endpoint_status;
 	/* Stream name. Format is: <channel_name>_<cpu_number> */
 	char name[LTTNG_SYMBOL_NAME_LEN];
+	/* CPU of the stream's ring buffer. */
+	int cpu;
 	/* Internal state of libustctl. */
 	struct lttng_ust_ctl_consumer_stream *ustream;
 	/* On-disk circular buffer */
@@ -754,6 +777,41 @@ struct lttng_consumer_stream {
 	std::vector<struct stream_subbuffer_transaction_state> subbuffer_transaction_states = {};
 
 	nonstd::optional<consumer_stream_pending_reclamation> pending_memory_reclamation;
+
+	/*
+	 * Cached physical memory usage of the stream's buffer, reported to the
+	 * session daemon. Invalidated whenever sub-buffers are reclaimed.
+	 */
+	lttng::memory_usage_sampler memory_usage_sampler{
+		std::chrono::milliseconds(DEFAULT_CONSUMER_MEMORY_USAGE_SAMPLE_MAX_AGE_MS),
+		std::chrono::milliseconds(DEFAULT_CONSUMER_MEMORY_USAGE_FULL_SCAN_INTERVAL_MS)
+	};
+
+	/*
+	 * Packet compression state of data streams; only set when the channel
+	 * compresses its packets.
+	 *
+	 * `compressed_packet_size` is the size, in the trace file, of the
+	 * last packet written and is used to produce its index.
+	 */
+	lttng::compression::codec::uptr codec;
+	std::vector<char> compression_buffer;
+	uint64_t compressed_packet_size = 0;
+
+	/*
+	 * I/O statistics of the consumption of the stream, updated by the
+	 * thread consuming it and read, without holding the stream lock, when
+	 * the session daemon queries them.
+	 */
+	struct io_statistics {
+		std::atomic<uint64_t> written_bytes{ 0 };
+		/* From the acquisition of a sub-buffer to its release. */
+		lttng::log2_duration_histogram subbuffer_consumption_time;
+		/* Duration of each write() call or splice() iteration. */
+		lttng::log2_duration_histogram write_time;
+		/* Transmission of a packet (header and payload) to a relay daemon. */
+		lttng::log2_duration_histogram relayd_send_time;
+	} io_stats;
 };
 
 /*
@@ -895,8 +953,17 @@ struct lttng_consumer_local_data {
 	int channel_monitor_pipe = -1;
 	nonstd::optional<lttng_uuid> sessiond_uuid;
 
-	lttng::scheduling::scheduler timer_task_scheduler;
-	lttng::scheduling::task_executor timer_task_executor{ timer_task_scheduler };
+	/*
+	 * Every channel schedules up to five periodic timer tasks; the timing
+	 * wheel keeps their insertion and cancellation constant-time as the
+	 * number of channels grows.
+	 */
+	lttng::scheduling::scheduler timer_task_scheduler{
+		lttng::scheduling::scheduler::backend_type::TIMING_WHEEL
+	};
+	lttng::scheduling::task_executor timer_task_executor{
+		timer_task_scheduler, DEFAULT_CONSUMER_TIMER_TASK_WORKER_COUNT
+	};
 };
 
 /*
@@ -1205,6 +1272,23 @@ int lttng_consumer_clear_channel(struct lttng_consumer_channel *channel);
 enum lttcomm_return_code
 lttng_consumer_open_channel_packets(struct lttng_consumer_channel *channel);
 
+/*
+ * Send the runtime statistics (discarded events, lost packets, and compression
+ * statistics) of all the data channels of a session to the session daemon in
+ * reply to LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS.
+ *
+ * Throws if the reply can't be sent.
+ */
+void lttng_consumer_send_session_channels_runtime_stats(int sock, uint64_t session_id);
+
+/*
+ * Send the I/O statistics of all the data streams of a session to the session
+ * daemon in reply to LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS.
+ *
+ * Throws if the reply can't be sent.
+ */
+void lttng_consumer_send_session_streams_io_stats(int sock, uint64_t session_id);
+
 namespace lttng {
 namespace consumer {
 struct stream_memory_usage {
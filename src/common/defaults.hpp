@@ -139,6 +139,12 @@
 /* Default relay health unix socket path */
 #define DEFAULT_RELAY_HEALTH_UNIX_SOCK DEFAULT_LTTNG_EXPLICIT_RUNDIR "/relayd/health-%d"
 
+/* Default relay metrics unix socket path */
+#define DEFAULT_RELAY_METRICS_UNIX_SOCK DEFAULT_LTTNG_EXPLICIT_RUNDIR "/relayd/metrics-%d"
+
+/* Timeout of the sending of the metrics to a client of the relay metrics socket */
+#define DEFAULT_RELAY_METRICS_SEND_TIMEOUT 5000 /* ms */
+
 /* Default daemon configuration file path */
 #define DEFAULT_SYSTEM_CONFIGPATH     \
 	CONFIG_LTTNG_SYSTEM_CONFIGDIR \
@@ -330,6 +336,19 @@
 #define DEFAULT_APP_SOCKET_RW_TIMEOUT  CONFIG_DEFAULT_APP_SOCKET_RW_TIMEOUT
 #define DEFAULT_APP_SOCKET_TIMEOUT_ENV "LTTNG_APP_SOCKET_TIMEOUT"
 
+/*
+ * Default number of session daemon threads processing client commands.
+ */
+#define DEFAULT_SESSIOND_CLIENT_WORKER_COUNT	 4
+#define DEFAULT_SESSIOND_CLIENT_WORKER_COUNT_ENV "LTTNG_SESSIOND_CLIENT_WORKER_COUNT"
+
+/*
+ * Allow the creation of channels compressing their packets (experimental:
+ * current trace readers can't decode those packets).
+ */
+#define DEFAULT_SESSIOND_EXPERIMENTAL_PACKET_COMPRESSION_ENV \
+	"LTTNG_SESSIOND_EXPERIMENTAL_PACKET_COMPRESSION"
+
 #define DEFAULT_UST_STREAM_FD_NUM 2 /* Number of fd per UST stream. */
 
 #define DEFAULT_SNAPSHOT_NAME	  "snapshot"
@@ -392,6 +411,25 @@
 
 #define DEFAULT_MINIMAL_MEMORY_RECLAIM_TIMER_PERIOD_MS 250
 
+/*
+ * Number of threads running the consumer daemon's timer tasks (live, monitor,
+ * memory reclaim, etc.).
+ *
+ * The timer tasks of a channel (and the tasks of different channels) were
+ * written to run serially on a single thread: their interactions (e.g. the
+ * watchdog flushing a stream sampled by the monitor task, or the live beacon
+ * racing the metadata switch) have not been validated under concurrency.
+ * Hence, they are run by a single worker.
+ */
+#define DEFAULT_CONSUMER_TIMER_TASK_WORKER_COUNT 1
+
+/*
+ * Maximal age of a cached stream memory usage sample reported to the session
+ * daemon, and maximal interval between two complete scans of a stream's buffer.
+ */
+#define DEFAULT_CONSUMER_MEMORY_USAGE_SAMPLE_MAX_AGE_MS	    500
+#define DEFAULT_CONSUMER_MEMORY_USAGE_FULL_SCAN_INTERVAL_MS 10000
+
 /*
  * Filename used to test the support for `MADV_REMOVE` using `madvise(2)`.
  *
@@ -441,6 +441,19 @@ void fd_tracker_log(struct fd_tracker *tracker)
 	pthread_mutex_unlock(&tracker->lock);
 }
 
+void fd_tracker_get_stats(struct fd_tracker *tracker, struct fd_tracker_stats *stats)
+{
+	pthread_mutex_lock(&tracker->lock);
+	stats->uses = tracker->stats.uses;
+	stats->misses = tracker->stats.misses;
+	stats->errors = tracker->stats.errors;
+	stats->active_suspendable = tracker->count.suspendable.active;
+	stats->suspended = SUSPENDED_COUNT(tracker);
+	stats->unsuspendable = UNSUSPENDABLE_COUNT(tracker);
+	stats->capacity = tracker->capacity;
+	pthread_mutex_unlock(&tracker->lock);
+}
+
 int fd_tracker_destroy(struct fd_tracker *tracker)
 {
 	int ret = 0;
@@ -17,6 +17,20 @@
 struct fs_handle;
 struct fd_tracker;
 
+/* Snapshot of the usage statistics of an fd_tracker. */
+struct fd_tracker_stats {
+	/* Count of uses of suspendable fs handles. */
+	uint64_t uses;
+	/* Count of uses that required a suspended fs handle to be restored. */
+	uint64_t misses;
+	/* Failures to suspend or restore fs handles. */
+	uint64_t errors;
+	unsigned int active_suspendable;
+	unsigned int suspended;
+	unsigned int unsuspendable;
+	unsigned int capacity;
+};
+
 /*
  * Callback which returns a file descriptor to track through the fd
  * tracker. This callback must not make use of the fd_tracker as a deadlock
@@ -135,4 +149,9 @@ int fd_tracker_close_unsuspendable_fd(
  */
 void fd_tracker_log(struct fd_tracker *tracker);
 
+/*
+ * Get a consistent snapshot of the statistics and counts of the fd_tracker.
+ */
+void fd_tracker_get_stats(struct fd_tracker *tracker, struct fd_tracker_stats *stats);
+
 #endif /* FD_TRACKER_H */
@@ -0,0 +1,746 @@
+/*
+ * filter-visitor-ir-optimize.cpp
+ *
+ * LTTng filter IR optimization
+ *
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+
+#include "filter-ast.hpp"
+#include "filter-ir.hpp"
+#include "filter-parser.hpp"
+
+#include <common/compat/errno.hpp>
+#include <common/macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/*
+ * The optimizations below must not change the value of an expression as
+ * computed by the tracers' bytecode interpreters:
+ *
+ *   - A logical operator evaluates to its right operand (cast to s64) when
+ *     its left operand doesn't short-circuit it, and to 0 (`&&`) or 1 (`||`)
+ *     otherwise.
+ *   - An error (e.g. a field which can't be compared to a number) stops the
+ *     interpretation and the event is not recorded.
+ *
+ * The conjunctions which determine the result of the filter by themselves
+ * (that is, the `&&` operands of the root expression, recursively) are only
+ * evaluated for their truth value, and an error has the same outcome as a
+ * false operand: those conjunctions can be reordered, and the comparisons
+ * they contain can be merged.
+ */
+
+namespace {
+/*
+ * Integer literals compared with the same operand are only merged when they
+ * are exactly representable as double precision floating point numbers (the
+ * operand may be a floating point field) and when their order is the same
+ * whether they are interpreted as signed or unsigned (the operand may be an
+ * unsigned field).
+ */
+constexpr int64_t max_mergeable_literal = INT64_C(1) << 53;
+
+bool is_numeric_literal(const struct ir_op *node)
+{
+	return node->op == IR_OP_LOAD && node->data_type == IR_DATA_NUMERIC;
+}
+
+bool is_float_literal(const struct ir_op *node)
+{
+	return node->op == IR_OP_LOAD && node->data_type == IR_DATA_FLOAT;
+}
+
+bool is_comparator(enum op_type type)
+{
+	switch (type) {
+	case AST_OP_EQ:
+	case AST_OP_NE:
+	case AST_OP_GT:
+	case AST_OP_LT:
+	case AST_OP_GE:
+	case AST_OP_LE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* The expression always evaluates to 0 or 1. */
+bool is_boolean(const struct ir_op *node)
+{
+	switch (node->op) {
+	case IR_OP_LOAD:
+		return is_numeric_literal(node) &&
+			(node->u.load.u.num == 0 || node->u.load.u.num == 1);
+	case IR_OP_UNARY:
+		return node->u.unary.type == AST_UNARY_NOT;
+	case IR_OP_BINARY:
+		return is_comparator(node->u.binary.type);
+	case IR_OP_LOGICAL:
+		/* The left operand only contributes a 0 or 1 result. */
+		return is_boolean(node->u.logical.right);
+	default:
+		return false;
+	}
+}
+
+/*
+ * Replace the expression `node` by `replacement`, one of its descendants
+ * which was detached from it.
+ */
+struct ir_op *replace_op(struct ir_op *node, struct ir_op *replacement)
+{
+	replacement->side = node->side;
+	filter_free_ir_recursive(node);
+	return replacement;
+}
+
+/* Replace the expression `node` by an integer literal. */
+struct ir_op *replace_with_numeric_literal(struct ir_op *node, int64_t value)
+{
+	switch (node->op) {
+	case IR_OP_UNARY:
+		filter_free_ir_recursive(node->u.unary.child);
+		break;
+	case IR_OP_BINARY:
+		filter_free_ir_recursive(node->u.binary.left);
+		filter_free_ir_recursive(node->u.binary.right);
+		break;
+	case IR_OP_LOGICAL:
+		filter_free_ir_recursive(node->u.logical.left);
+		filter_free_ir_recursive(node->u.logical.right);
+		break;
+	default:
+		abort();
+	}
+
+	node->op = IR_OP_LOAD;
+	node->data_type = IR_DATA_NUMERIC;
+	node->signedness = IR_SIGNED;
+	node->u.load.u.num = value;
+	return node;
+}
+
+/*
+ * Rough cost of evaluating an expression in the tracer, used to evaluate the
+ * cheapest operands of a conjunction first.
+ */
+unsigned int evaluation_cost(const struct ir_op *node)
+{
+	switch (node->op) {
+	case IR_OP_LOAD:
+		switch (node->data_type) {
+		case IR_DATA_EXPRESSION:
+		{
+			unsigned int cost = 0;
+
+			for (auto *op = node->u.load.u.expression->child; op; op = op->next) {
+				cost++;
+			}
+
+			return cost;
+		}
+		case IR_DATA_FIELD_REF:
+		case IR_DATA_GET_CONTEXT_REF:
+			return 2;
+		default:
+			return 1;
+		}
+	case IR_OP_UNARY:
+		return evaluation_cost(node->u.unary.child) + 1;
+	case IR_OP_BINARY:
+	{
+		unsigned int cost = evaluation_cost(node->u.binary.left) +
+			evaluation_cost(node->u.binary.right) + 1;
+
+		/* String comparisons walk both strings. */
+		if (node->u.binary.left->data_type == IR_DATA_STRING ||
+		    node->u.binary.right->data_type == IR_DATA_STRING) {
+			cost += 8;
+		}
+
+		return cost;
+	}
+	case IR_OP_LOGICAL:
+		return evaluation_cost(node->u.logical.left) +
+			evaluation_cost(node->u.logical.right) + 1;
+	default:
+		return 0;
+	}
+}
+
+bool load_expressions_equal(const struct ir_load_expression *a, const struct ir_load_expression *b)
+{
+	const struct ir_load_expression_op *op_a = a->child, *op_b = b->child;
+
+	for (; op_a && op_b; op_a = op_a->next, op_b = op_b->next) {
+		if (op_a->type != op_b->type) {
+			return false;
+		}
+
+		switch (op_a->type) {
+		case IR_LOAD_EXPRESSION_GET_SYMBOL:
+			if (strcmp(op_a->u.symbol, op_b->u.symbol) != 0) {
+				return false;
+			}
+
+			break;
+		case IR_LOAD_EXPRESSION_GET_INDEX:
+			if (op_a->u.index != op_b->u.index) {
+				return false;
+			}
+
+			break;
+		default:
+			break;
+		}
+	}
+
+	return !op_a && !op_b;
+}
+
+enum op_type mirror_comparator(enum op_type type)
+{
+	switch (type) {
+	case AST_OP_GT:
+		return AST_OP_LT;
+	case AST_OP_LT:
+		return AST_OP_GT;
+	case AST_OP_GE:
+		return AST_OP_LE;
+	case AST_OP_LE:
+		return AST_OP_GE;
+	default:
+		return type;
+	}
+}
+
+template <typename ValueType>
+int64_t fold_comparison(enum op_type type, ValueType left, ValueType right)
+{
+	switch (type) {
+	case AST_OP_EQ:
+		return left == right;
+	case AST_OP_NE:
+		return left != right;
+	case AST_OP_GT:
+		return left > right;
+	case AST_OP_LT:
+		return left < right;
+	case AST_OP_GE:
+		return left >= right;
+	case AST_OP_LE:
+		return left <= right;
+	default:
+		abort();
+	}
+}
+
+struct ir_op *optimize_recursive(struct ir_op *node, bool is_root_conjunction);
+
+struct ir_op *optimize_unary(struct ir_op *node)
+{
+	struct ir_op *child = optimize_recursive(node->u.unary.child, false);
+
+	node->u.unary.child = child;
+
+	switch (node->u.unary.type) {
+	case AST_UNARY_PLUS:
+		if (is_numeric_literal(child) || is_float_literal(child)) {
+			node->u.unary.child = nullptr;
+			return replace_op(node, child);
+		}
+
+		break;
+	case AST_UNARY_MINUS:
+		if (is_numeric_literal(child) &&
+		    child->u.load.u.num != std::numeric_limits<int64_t>::min()) {
+			child->u.load.u.num = -child->u.load.u.num;
+			node->u.unary.child = nullptr;
+			return replace_op(node, child);
+		}
+
+		if (is_float_literal(child)) {
+			child->u.load.u.flt = -child->u.load.u.flt;
+			node->u.unary.child = nullptr;
+			return replace_op(node, child);
+		}
+
+		break;
+	case AST_UNARY_NOT:
+		if (is_numeric_literal(child)) {
+			return replace_with_numeric_literal(node, !child->u.load.u.num);
+		}
+
+		/* `!(a == b)` is `a != b`, and conversely. */
+		if (child->op == IR_OP_BINARY &&
+		    (child->u.binary.type == AST_OP_EQ || child->u.binary.type == AST_OP_NE)) {
+			child->u.binary.type =
+				child->u.binary.type == AST_OP_EQ ? AST_OP_NE : AST_OP_EQ;
+			node->u.unary.child = nullptr;
+			return replace_op(node, child);
+		}
+
+		/* `!!a` is `a` when `a` is already 0 or 1. */
+		if (child->op == IR_OP_UNARY && child->u.unary.type == AST_UNARY_NOT &&
+		    is_boolean(child->u.unary.child)) {
+			struct ir_op *grandchild = child->u.unary.child;
+
+			child->u.unary.child = nullptr;
+			return replace_op(node, grandchild);
+		}
+
+		break;
+	case AST_UNARY_BIT_NOT:
+		if (is_numeric_literal(child)) {
+			return replace_with_numeric_literal(node, ~child->u.load.u.num);
+		}
+
+		break;
+	default:
+		break;
+	}
+
+	node->data_type = child->data_type;
+	return node;
+}
+
+struct ir_op *optimize_binary(struct ir_op *node)
+{
+	struct ir_op *left = optimize_recursive(node->u.binary.left, false);
+	struct ir_op *right = optimize_recursive(node->u.binary.right, false);
+
+	node->u.binary.left = left;
+	node->u.binary.right = right;
+
+	if (is_numeric_literal(left) && is_numeric_literal(right)) {
+		const int64_t left_value = left->u.load.u.num, right_value = right->u.load.u.num;
+
+		switch (node->u.binary.type) {
+		case AST_OP_BIT_AND:
+			return replace_with_numeric_literal(node, left_value & right_value);
+		case AST_OP_BIT_OR:
+			return replace_with_numeric_literal(node, left_value | right_value);
+		case AST_OP_BIT_XOR:
+			return replace_with_numeric_literal(node, left_value ^ right_value);
+		default:
+			if (is_comparator(node->u.binary.type)) {
+				return replace_with_numeric_literal(
+					node,
+					fold_comparison(node->u.binary.type,
+							left_value,
+							right_value));
+			}
+
+			/* Leave shifts to the tracer, which validates the shift amount. */
+			return node;
+		}
+	}
+
+	if ((is_numeric_literal(left) || is_float_literal(left)) &&
+	    (is_numeric_literal(right) || is_float_literal(right)) &&
+	    is_comparator(node->u.binary.type)) {
+		/* Mixed comparisons promote the integer operand to double. */
+		const double left_value = is_float_literal(left) ? left->u.load.u.flt :
+								   (double) left->u.load.u.num;
+		const double right_value = is_float_literal(right) ? right->u.load.u.flt :
+								     (double) right->u.load.u.num;
+
+		return replace_with_numeric_literal(
+			node, fold_comparison(node->u.binary.type, left_value, right_value));
+	}
+
+	return node;
+}
+
+/*
+ * Short-circuit the logical operations having a constant operand.
+ *
+ * The operand which is removed is either never evaluated by the tracer or
+ * is a constant, and the remaining operand is only kept as is when its value
+ * is the one the logical operation would evaluate to.
+ */
+struct ir_op *optimize_logical(struct ir_op *node)
+{
+	struct ir_op *left = optimize_recursive(node->u.logical.left, false);
+	struct ir_op *right = optimize_recursive(node->u.logical.right, false);
+	const bool is_and = node->u.logical.type == AST_OP_AND;
+
+	node->u.logical.left = left;
+	node->u.logical.right = right;
+
+	if (is_numeric_literal(left)) {
+		const bool left_value = left->u.load.u.num != 0;
+
+		if (is_and != left_value) {
+			/* `0 && a` is 0 and `1 || a` is 1: `a` is never evaluated. */
+			return replace_with_numeric_literal(node, left_value);
+		}
+
+		/*
+		 * `1 && a` and `0 || a` evaluate to `a`, as long as it doesn't
+		 * need to be cast to an integer.
+		 */
+		if (right->data_type == IR_DATA_NUMERIC) {
+			node->u.logical.right = nullptr;
+			return replace_op(node, right);
+		}
+
+		return node;
+	}
+
+	if (is_numeric_literal(right) && (right->u.load.u.num != 0) == is_and &&
+	    is_boolean(left)) {
+		/* `a && 1` and `a || 0` evaluate to `a` when it is 0 or 1. */
+		node->u.logical.left = nullptr;
+		return replace_op(node, left);
+	}
+
+	return node;
+}
+
+/* Comparison of an operand with an integer literal which can be merged. */
+struct mergeable_comparison {
+	struct ir_op *node;
+	const struct ir_load_expression *operand;
+	/* Comparator, as if the operand was on the left. */
+	enum op_type type;
+	int64_t value;
+};
+
+bool get_mergeable_comparison(struct ir_op *node, mergeable_comparison& comparison)
+{
+	if (node->op != IR_OP_BINARY || !is_comparator(node->u.binary.type) ||
+	    node->u.binary.type == AST_OP_NE) {
+		return false;
+	}
+
+	const struct ir_op *operand, *literal;
+	enum op_type type = node->u.binary.type;
+
+	if (node->u.binary.left->data_type == IR_DATA_EXPRESSION &&
+	    node->u.binary.left->op == IR_OP_LOAD) {
+		operand = node->u.binary.left;
+		literal = node->u.binary.right;
+	} else {
+		operand = node->u.binary.right;
+		literal = node->u.binary.left;
+		type = mirror_comparator(type);
+	}
+
+	if (operand->op != IR_OP_LOAD || operand->data_type != IR_DATA_EXPRESSION ||
+	    !is_numeric_literal(literal) || literal->u.load.u.num < 0 ||
+	    literal->u.load.u.num > max_mergeable_literal) {
+		return false;
+	}
+
+	comparison.node = node;
+	comparison.operand = operand->u.load.u.expression;
+	comparison.type = type;
+	comparison.value = literal->u.load.u.num;
+	return true;
+}
+
+/* Rewrite a mergeable comparison as `operand <type> value`. */
+void set_comparison(mergeable_comparison& comparison, enum op_type type, int64_t value)
+{
+	struct ir_op *node = comparison.node;
+
+	if (node->u.binary.left->data_type != IR_DATA_EXPRESSION ||
+	    node->u.binary.left->op != IR_OP_LOAD) {
+		std::swap(node->u.binary.left, node->u.binary.right);
+		std::swap(node->u.binary.left->side, node->u.binary.right->side);
+	}
+
+	node->u.binary.type = type;
+	node->u.binary.right->u.load.u.num = value;
+}
+
+struct bound {
+	bool is_set;
+	int64_t value;
+	bool is_inclusive;
+};
+
+/*
+ * Merge the comparisons of a conjunction having the same operand into the
+ * tightest lower and upper bounds of that operand: `x > 10 && x >= 15` is
+ * `x >= 15`, and `x >= 10 && x <= 10` is `x == 10`.
+ *
+ * Returns false if the bounds can't be satisfied (e.g. `x > 10 && x < 5`).
+ */
+bool merge_comparisons(std::vector<struct ir_op *>& conjuncts)
+{
+	std::vector<mergeable_comparison> comparisons;
+
+	for (auto *conjunct : conjuncts) {
+		mergeable_comparison comparison;
+
+		if (get_mergeable_comparison(conjunct, comparison)) {
+			comparisons.emplace_back(comparison);
+		}
+	}
+
+	std::vector<bool> is_merged(comparisons.size(), false);
+
+	for (std::size_t i = 0; i < comparisons.size(); i++) {
+		if (is_merged[i]) {
+			continue;
+		}
+
+		std::vector<std::size_t> group = { i };
+		bound lower = {}, upper = {};
+
+		for (std::size_t j = i + 1; j < comparisons.size(); j++) {
+			if (!is_merged[j] &&
+			    load_expressions_equal(comparisons[i].operand,
+						   comparisons[j].operand)) {
+				group.emplace_back(j);
+			}
+		}
+
+		if (group.size() < 2) {
+			continue;
+		}
+
+		for (const auto index : group) {
+			const auto& comparison = comparisons[index];
+			const bool is_lower = comparison.type == AST_OP_EQ ||
+				comparison.type == AST_OP_GT || comparison.type == AST_OP_GE;
+			const bool is_upper = comparison.type == AST_OP_EQ ||
+				comparison.type == AST_OP_LT || comparison.type == AST_OP_LE;
+			const bool is_inclusive = comparison.type == AST_OP_EQ ||
+				comparison.type == AST_OP_GE || comparison.type == AST_OP_LE;
+
+			is_merged[index] = true;
+
+			if (is_lower &&
+			    (!lower.is_set || comparison.value > lower.value ||
+			     (comparison.value == lower.value && !is_inclusive))) {
+				lower = { true, comparison.value, is_inclusive };
+			}
+
+			if (is_upper &&
+			    (!upper.is_set || comparison.value < upper.value ||
+			     (comparison.value == upper.value && !is_inclusive))) {
+				upper = { true, comparison.value, is_inclusive };
+			}
+		}
+
+		if (lower.is_set && upper.is_set &&
+		    (lower.value > upper.value ||
+		     (lower.value == upper.value &&
+		      (!lower.is_inclusive || !upper.is_inclusive)))) {
+			return false;
+		}
+
+		/* Reuse the first comparisons of the group for the bounds. */
+		auto group_it = group.cbegin();
+		std::vector<struct ir_op *> bound_nodes;
+
+		if (lower.is_set && upper.is_set && lower.value == upper.value) {
+			set_comparison(comparisons[*group_it], AST_OP_EQ, lower.value);
+			bound_nodes.emplace_back(comparisons[*group_it++].node);
+		} else {
+			if (lower.is_set) {
+				set_comparison(comparisons[*group_it],
+					       lower.is_inclusive ? AST_OP_GE : AST_OP_GT,
+					       lower.value);
+				bound_nodes.emplace_back(comparisons[*group_it++].node);
+			}
+
+			if (upper.is_set) {
+				set_comparison(comparisons[*group_it],
+					       upper.is_inclusive ? AST_OP_LE : AST_OP_LT,
+					       upper.value);
+				bound_nodes.emplace_back(comparisons[*group_it++].node);
+			}
+		}
+
+		/*
+		 * Put the bounds where the first comparison of the group was and
+		 * remove the other comparisons. The comparisons of a group keep
+		 * their relative order in `conjuncts`.
+		 */
+		const auto first_index =
+			std::find(conjuncts.begin(), conjuncts.end(), comparisons[group[0]].node) -
+			conjuncts.begin();
+
+		for (const auto index : group) {
+			auto *node = comparisons[index].node;
+
+			conjuncts.erase(std::find(conjuncts.begin(), conjuncts.end(), node));
+			if (std::find(bound_nodes.begin(), bound_nodes.end(), node) ==
+			    bound_nodes.end()) {
+				filter_free_ir_recursive(node);
+			}
+		}
+
+		conjuncts.insert(
+			conjuncts.begin() + first_index, bound_nodes.begin(), bound_nodes.end());
+	}
+
+	return true;
+}
+
+void collect_conjuncts(struct ir_op *node,
+		       std::vector<struct ir_op *>& conjuncts,
+		       std::vector<struct ir_op *>& and_nodes)
+{
+	if (node->op == IR_OP_LOGICAL && node->u.logical.type == AST_OP_AND) {
+		and_nodes.emplace_back(node);
+		collect_conjuncts(node->u.logical.left, conjuncts, and_nodes);
+		collect_conjuncts(node->u.logical.right, conjuncts, and_nodes);
+		node->u.logical.left = nullptr;
+		node->u.logical.right = nullptr;
+		return;
+	}
+
+	conjuncts.emplace_back(node);
+}
+
+/*
+ * Optimize a conjunction which determines the result of the filter by
+ * itself: remove its true constant operands, merge its comparisons, and
+ * evaluate its cheapest operands first.
+ */
+struct ir_op *optimize_root_conjunction(struct ir_op *node)
+{
+	std::vector<struct ir_op *> conjuncts, and_nodes, true_literals;
+	const auto side = node->side;
+	bool is_false = false;
+
+	collect_conjuncts(node, conjuncts, and_nodes);
+
+	for (auto& conjunct : conjuncts) {
+		conjunct = optimize_recursive(conjunct, false);
+		if (is_numeric_literal(conjunct)) {
+			if (conjunct->u.load.u.num == 0) {
+				is_false = true;
+			} else {
+				true_literals.emplace_back(conjunct);
+			}
+		}
+	}
+
+	conjuncts.erase(std::remove_if(conjuncts.begin(),
+				       conjuncts.end(),
+				       [](const struct ir_op *conjunct) {
+					       return is_numeric_literal(conjunct) &&
+						       conjunct->u.load.u.num != 0;
+				       }),
+			conjuncts.end());
+
+	if (!is_false) {
+		is_false = !merge_comparisons(conjuncts);
+	}
+
+	/*
+	 * The root of the filter must evaluate to an integer: keep a true
+	 * constant operand to cast a lone field or floating point operand.
+	 */
+	if (!true_literals.empty() &&
+	    (conjuncts.empty() ||
+	     (conjuncts.size() == 1 && conjuncts[0]->data_type != IR_DATA_NUMERIC))) {
+		conjuncts.emplace_back(true_literals.back());
+		true_literals.pop_back();
+	}
+
+	for (auto *true_literal : true_literals) {
+		filter_free_ir_recursive(true_literal);
+	}
+
+	if (is_false) {
+		for (auto *conjunct : conjuncts) {
+			filter_free_ir_recursive(conjunct);
+		}
+
+		conjuncts.clear();
+	}
+
+	std::stable_sort(conjuncts.begin(),
+			 conjuncts.end(),
+			 [](const struct ir_op *a, const struct ir_op *b) {
+				 return evaluation_cost(a) < evaluation_cost(b);
+			 });
+
+	/* Rebuild a left-deep conjunction, reusing the original `&&` nodes. */
+	struct ir_op *result = conjuncts.empty() ? nullptr : conjuncts[0];
+
+	for (std::size_t i = 1; i < conjuncts.size(); i++) {
+		auto *and_node = and_nodes[i - 1];
+
+		and_node->u.logical.left = result;
+		and_node->u.logical.right = conjuncts[i];
+		and_node->u.logical.left->side = IR_LEFT;
+		and_node->u.logical.right->side = IR_RIGHT;
+		result = and_node;
+	}
+
+	for (std::size_t i = conjuncts.empty() ? 0 : conjuncts.size() - 1; i < and_nodes.size();
+	     i++) {
+		if (!result) {
+			/* Reuse an `&&` node as the false constant. */
+			result = and_nodes[i];
+			result->op = IR_OP_LOAD;
+			result->data_type = IR_DATA_NUMERIC;
+			result->signedness = IR_SIGNED;
+			result->u.load.u.num = 0;
+			continue;
+		}
+
+		free(and_nodes[i]);
+	}
+
+	result->side = side;
+	return result;
+}
+
+struct ir_op *optimize_recursive(struct ir_op *node, bool is_root_conjunction)
+{
+	switch (node->op) {
+	case IR_OP_ROOT:
+		node->u.root.child = optimize_recursive(node->u.root.child, true);
+		node->data_type = node->u.root.child->data_type;
+		node->signedness = node->u.root.child->signedness;
+		return node;
+	case IR_OP_UNARY:
+		return optimize_unary(node);
+	case IR_OP_BINARY:
+		return optimize_binary(node);
+	case IR_OP_LOGICAL:
+		if (is_root_conjunction && node->u.logical.type == AST_OP_AND) {
+			return optimize_root_conjunction(node);
+		}
+
+		return optimize_logical(node);
+	case IR_OP_LOAD:
+	default:
+		return node;
+	}
+}
+} /* namespace */
+
+int filter_visitor_ir_optimize(struct filter_parser_ctx *ctx)
+{
+	try {
+		ctx->ir_root = optimize_recursive(ctx->ir_root, false);
+	} catch (const std::bad_alloc&) {
+		fprintf(stderr, "[error] %s: out of memory\n", __func__);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+
+#ifndef LTTNG_HISTOGRAM_HPP
+#define LTTNG_HISTOGRAM_HPP
+
+#include <common/macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace lttng {
+
+/*
+ * Log-linear histogram of unsigned values (typically durations in nanoseconds).
+ *
+ * Each power-of-two range is split into 2^SubBucketBits linear sub-buckets, which bounds
+ * the relative error of a bucket to 2^-SubBucketBits. Values of 2^MaxValueBits and more are
+ * accounted in the last bucket.
+ *
+ * Recording a value is wait-free (relaxed atomic increments) so that a histogram can be
+ * updated from hot paths and read concurrently. A snapshot is not guaranteed to be
+ * consistent with respect to concurrent updates.
+ */
+template <unsigned int SubBucketBits, unsigned int MaxValueBits>
+class log_linear_histogram final {
+	static_assert(SubBucketBits < MaxValueBits, "Sub-buckets must be narrower than the range");
+	static_assert(MaxValueBits < 64, "Values are 64-bit wide");
+
+public:
+	static constexpr unsigned int sub_bucket_count = 1U << SubBucketBits;
+	static constexpr unsigned int bucket_count =
+		(MaxValueBits - SubBucketBits + 1) * sub_bucket_count;
+
+	class snapshot final {
+	public:
+		std::uint64_t count() const noexcept
+		{
+			return _count;
+		}
+
+		std::uint64_t sum() const noexcept
+		{
+			return _sum;
+		}
+
+		std::uint64_t max() const noexcept
+		{
+			return _max;
+		}
+
+		std::uint64_t bucket_value_count(unsigned int bucket_index) const noexcept
+		{
+			LTTNG_ASSERT(bucket_index < bucket_count);
+			return _buckets[bucket_index];
+		}
+
+		/*
+		 * Upper bound of the bucket containing the value at the given quantile
+		 * (e.g. 0.99 for the 99th percentile). Returns 0 if no value was recorded.
+		 */
+		std::uint64_t quantile_upper_bound(double quantile) const noexcept
+		{
+			if (_count == 0) {
+				return 0;
+			}
+
+			quantile = std::min(std::max(quantile, 0.0), 1.0);
+
+			const auto rank = std::max<std::uint64_t>(
+				1, static_cast<std::uint64_t>(quantile * double(_count) + 0.5));
+			std::uint64_t cumulated_count = 0;
+
+			for (unsigned int i = 0; i < bucket_count; i++) {
+				cumulated_count += _buckets[i];
+				if (cumulated_count >= rank) {
+					/* Never report more than the largest recorded value. */
+					return std::min(bucket_upper_bound(i), _max);
+				}
+			}
+
+			return _max;
+		}
+
+	private:
+		friend class log_linear_histogram;
+
+		std::array<std::uint64_t, bucket_count> _buckets{};
+		std::uint64_t _count = 0;
+		std::uint64_t _sum = 0;
+		std::uint64_t _max = 0;
+	};
+
+	log_linear_histogram() noexcept
+	{
+		reset();
+	}
+
+	/* Deactivate copy and assignment. */
+	log_linear_histogram(const log_linear_histogram&) = delete;
+	log_linear_histogram(log_linear_histogram&&) = delete;
+	log_linear_histogram& operator=(const log_linear_histogram&) = delete;
+	log_linear_histogram& operator=(log_linear_histogram&&) = delete;
+	~log_linear_histogram() = default;
+
+	void record(std::uint64_t value) noexcept
+	{
+		_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+		_count.fetch_add(1, std::memory_order_relaxed);
+		_sum.fetch_add(value, std::memory_order_relaxed);
+
+		auto current_max = _max.load(std::memory_order_relaxed);
+		while (value > current_max &&
+		       !_max.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {
+			/* current_max is updated on failure; retry. */
+		}
+	}
+
+	template <class RepType, class PeriodType>
+	void record(std::chrono::duration<RepType, PeriodType> duration) noexcept
+	{
+		const auto duration_ns =
+			std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+
+		/* Negative durations (e.g. a task ran ahead of its deadline) are clamped. */
+		record(duration_ns < 0 ? 0 : static_cast<std::uint64_t>(duration_ns));
+	}
+
+	snapshot get_snapshot() const noexcept
+	{
+		snapshot values;
+
+		for (unsigned int i = 0; i < bucket_count; i++) {
+			values._buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		}
+
+		values._count = _count.load(std::memory_order_relaxed);
+		values._sum = _sum.load(std::memory_order_relaxed);
+		values._max = _max.load(std::memory_order_relaxed);
+		return values;
+	}
+
+	void reset() noexcept
+	{
+		for (auto& bucket : _buckets) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+
+		_count.store(0, std::memory_order_relaxed);
+		_sum.store(0, std::memory_order_relaxed);
+		_max.store(0, std::memory_order_relaxed);
+	}
+
+	static unsigned int bucket_index(std::uint64_t value) noexcept
+	{
+		if (value < sub_bucket_count) {
+			return static_cast<unsigned int>(value);
+		}
+
+		const auto exponent = 63U - static_cast<unsigned int>(__builtin_clzll(value));
+		if (exponent >= MaxValueBits) {
+			return bucket_count - 1;
+		}
+
+		const auto sub_bucket = static_cast<unsigned int>(
+			(value >> (exponent - SubBucketBits)) & (sub_bucket_count - 1));
+
+		return (exponent - SubBucketBits + 1) * sub_bucket_count + sub_bucket;
+	}
+
+	/* Smallest value accounted in a bucket. */
+	static std::uint64_t bucket_lower_bound(unsigned int bucket_index) noexcept
+	{
+		if (bucket_index < sub_bucket_count) {
+			return bucket_index;
+		}
+
+		const auto exponent = bucket_index / sub_bucket_count - 1 + SubBucketBits;
+		const auto sub_bucket = std::uint64_t(bucket_index % sub_bucket_count);
+
+		return (std::uint64_t(1) << exponent) + (sub_bucket << (exponent - SubBucketBits));
+	}
+
+	/* Largest value accounted in a bucket. */
+	static std::uint64_t bucket_upper_bound(unsigned int bucket_index) noexcept
+	{
+		if (bucket_index + 1 >= bucket_count) {
+			return std::numeric_limits<std::uint64_t>::max();
+		}
+
+		return bucket_lower_bound(bucket_index + 1) - 1;
+	}
+
+private:
+	std::array<std::atomic<std::uint64_t>, bucket_count> _buckets;
+	std::atomic<std::uint64_t> _count;
+	std::atomic<std::uint64_t> _sum;
+	std::atomic<std::uint64_t> _max;
+};
+
+/*
+ * Power-of-two buckets from 1 ns to ~18 minutes; compact enough to be kept for every
+ * instance of a frequently instantiated object.
+ */
+using log2_duration_histogram = log_linear_histogram<0, 40>;
+
+} /* namespace lttng */
+
+#endif /* LTTNG_HISTOGRAM_HPP */
@@ -20,6 +20,12 @@
 #define CTF_INDEX_MAGIC 0xC1F1DCC1
 #define CTF_INDEX_MAJOR 1
 #define CTF_INDEX_MINOR 1
+/*
+ * Index of the streams of compressed channels (experimental): records the
+ * stored size and codec of each packet. Only used by those streams so that
+ * the traces of the other channels remain readable by every reader.
+ */
+#define CTF_INDEX_COMPRESSED_MINOR 2
 
 /*
  * Header at the beginning of each index file.
@@ -48,6 +54,9 @@ struct ctf_packet_index {
 	/* CTF_INDEX 1.0 limit */
 	uint64_t stream_instance_id; /* ID of the channel instance */
 	uint64_t packet_seq_num; /* packet sequence number */
+	/* CTF_INDEX 1.1 limit */
+	uint64_t stored_size; /* size of the packet in the file, in bytes */
+	uint8_t compression_codec; /* lttng::compression::codec_type, 0 if not compressed */
 } __attribute__((__packed__));
 
 static inline size_t ctf_packet_index_len(uint32_t major, uint32_t minor)
@@ -60,6 +69,9 @@ static inline size_t ctf_packet_index_len(uint32_t major, uint32_t minor)
 		case 1:
 			return offsetof(struct ctf_packet_index, packet_seq_num) +
 				member_sizeof(struct ctf_packet_index, packet_seq_num);
+		case 2:
+			return offsetof(struct ctf_packet_index, compression_codec) +
+				member_sizeof(struct ctf_packet_index, compression_codec);
 		default:
 			abort();
 		}
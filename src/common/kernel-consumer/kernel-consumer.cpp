@@ -1179,6 +1179,44 @@ int lttng_kconsumer_recv_cmd(struct lttng_consumer_local_data *ctx,
 
 		break;
 	}
+	case LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS:
+	{
+		const uint64_t id = msg.u.get_session_channels_runtime_stats.session_id;
+
+		DBG_FMT("Kernel consumer session runtime statistics command: session_id={}",
+			id);
+
+		health_code_update();
+
+		try {
+			lttng_consumer_send_session_channels_runtime_stats(sock, id);
+		} catch (const std::exception& ex) {
+			/* The session daemon is not responding anymore. */
+			ERR_FMT("Failed to send session channels runtime statistics: {}",
+				ex.what());
+			goto error_fatal;
+		}
+
+		break;
+	}
+	case LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS:
+	{
+		const uint64_t id = msg.u.get_session_streams_io_stats.session_id;
+
+		DBG_FMT("Kernel consumer session streams I/O statistics command: session_id={}", id);
+
+		health_code_update();
+
+		try {
+			lttng_consumer_send_session_streams_io_stats(sock, id);
+		} catch (const std::exception& ex) {
+			/* The session daemon is not responding anymore. */
+			ERR_FMT("Failed to send session streams I/O statistics: {}", ex.what());
+			goto error_fatal;
+		}
+
+		break;
+	}
 	case LTTNG_CONSUMER_SET_CHANNEL_MONITOR_PIPE:
 	{
 		int channel_monitor_pipe;
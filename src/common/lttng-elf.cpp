@@ -11,18 +11,25 @@
 #include <common/error.hpp>
 #include <common/lttng-elf.hpp>
 #include <common/macros.hpp>
+#include <common/make-unique.hpp>
 #include <common/readwrite.hpp>
 
 #include <algorithm>
 #include <elf.h>
 #include <fcntl.h>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 #define BUF_LEN				4096
 #define TEXT_SECTION_NAME		".text"
@@ -34,6 +41,7 @@
 #define NOTE_STAPSDT_NAME		"stapsdt"
 #define NOTE_STAPSDT_TYPE		3
 #define MAX_SECTION_DATA_SIZE		(512 * 1024 * 1024)
+#define ELF_INDEX_CACHE_MAX_ENTRIES	4
 
 #if BYTE_ORDER == LITTLE_ENDIAN
 #define NATIVE_ELF_ENDIANNESS ELFDATA2LSB
@@ -670,6 +678,64 @@ error:
 	return nullptr;
 }
 
+namespace {
+/*
+ * Identity of an ELF file. A file that is modified is considered to be a
+ * different file.
+ */
+struct elf_file_id {
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+
+	bool operator==(const elf_file_id& other) const noexcept
+	{
+		return dev == other.dev && ino == other.ino && size == other.size &&
+			mtime.tv_sec == other.mtime.tv_sec && mtime.tv_nsec == other.mtime.tv_nsec;
+	}
+};
+
+struct elf_sdt_probe {
+	std::string provider_name;
+	std::string probe_name;
+	uint64_t location;
+	uint64_t semaphore_location;
+};
+
+/*
+ * Content of an ELF file that is needed to compute the offsets of userspace
+ * probes.
+ *
+ * The symbol table and the SDT probe notes are only indexed when they are first
+ * needed. Only successful indexations are kept: a failure may be transient
+ * (e.g. memory allocation or read failure), so the file is parsed again on the
+ * next look-up.
+ */
+struct elf_index {
+	explicit elf_index(const elf_file_id& file_id) : id(file_id)
+	{
+	}
+
+	const elf_file_id id;
+
+	bool text_section_indexed = false;
+	bool has_text_section = false;
+	struct lttng_elf_shdr text_section_hdr = {};
+
+	bool symbols_indexed = false;
+	/* Virtual address of the function symbols, by name. */
+	std::unordered_map<std::string, uint64_t> function_addresses;
+
+	bool sdt_probes_indexed = false;
+	std::vector<elf_sdt_probe> sdt_probes;
+};
+
+/* Indexes of the most recently used ELF files, the most recent first. */
+std::list<std::unique_ptr<elf_index>> elf_index_cache;
+std::mutex elf_index_cache_lock;
+} /* namespace */
+
 /*
  * Convert the virtual address in a binary's mapping to the offset of
  * the corresponding instruction in the binary file.
@@ -677,34 +743,24 @@ error:
  *
  * Returns the offset on success or non-zero in case of failure.
  */
-static int lttng_elf_convert_addr_in_text_to_offset(struct lttng_elf *elf_handle,
-						    size_t addr,
-						    uint64_t *offset)
+static int
+elf_index_convert_addr_in_text_to_offset(const elf_index& index, size_t addr, uint64_t *offset)
 {
 	int ret = 0;
 	off_t text_section_offset;
 	off_t text_section_addr_beg;
 	off_t text_section_addr_end;
 	off_t offset_in_section;
-	struct lttng_elf_shdr text_section_hdr;
 
-	if (!elf_handle) {
-		DBG("Invalid ELF handle.");
-		ret = LTTNG_ERR_ELF_PARSING;
-		goto error;
-	}
-
-	/* Get a pointer to the .text section header. */
-	ret = lttng_elf_get_section_hdr_by_name(elf_handle, TEXT_SECTION_NAME, &text_section_hdr);
-	if (ret) {
+	if (!index.has_text_section) {
 		DBG("Text section not found in binary.");
 		ret = LTTNG_ERR_ELF_PARSING;
 		goto error;
 	}
 
-	text_section_offset = text_section_hdr.sh_offset;
-	text_section_addr_beg = text_section_hdr.sh_addr;
-	text_section_addr_end = text_section_addr_beg + text_section_hdr.sh_size;
+	text_section_offset = index.text_section_hdr.sh_offset;
+	text_section_addr_beg = index.text_section_hdr.sh_addr;
+	text_section_addr_end = text_section_addr_beg + index.text_section_hdr.sh_size;
 
 	/*
 	 * Verify that the address is within the .text section boundaries.
@@ -731,37 +787,34 @@ error:
 	return ret;
 }
 
+static void elf_index_populate_text_section(struct lttng_elf *elf, elf_index& index)
+{
+	if (index.text_section_indexed) {
+		return;
+	}
+
+	index.has_text_section = lttng_elf_get_section_hdr_by_name(
+					 elf, TEXT_SECTION_NAME, &index.text_section_hdr) == 0;
+	/* Look for the section again on the next look-up if it was not found. */
+	index.text_section_indexed = index.has_text_section;
+}
+
 /*
- * Compute the offset of a symbol from the begining of the ELF binary.
+ * Index the function symbols of an ELF binary by name.
  *
- * On success, returns 0 offset parameter is set to the computed value
- * On failure, returns -1.
+ * Returns 0 on success or else LTTNG_ERR_ELF_PARSING.
  */
-int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
+static int elf_index_populate_symbols(struct lttng_elf *elf, elf_index& index)
 {
 	int ret = 0;
-	int sym_found = 0;
 	int sym_count = 0;
 	int sym_idx = 0;
-	uint64_t addr = 0;
 	char *curr_sym_str = nullptr;
 	char *symbol_table_data = nullptr;
 	char *string_table_data = nullptr;
 	const char *string_table_name = nullptr;
 	struct lttng_elf_shdr symtab_hdr;
 	struct lttng_elf_shdr strtab_hdr;
-	struct lttng_elf *elf = nullptr;
-
-	if (!symbol || !offset) {
-		ret = LTTNG_ERR_ELF_PARSING;
-		goto end;
-	}
-
-	elf = lttng_elf_create(fd);
-	if (!elf) {
-		ret = LTTNG_ERR_ELF_PARSING;
-		goto end;
-	}
 
 	/*
 	 * The .symtab section might not exist on stripped binaries.
@@ -778,7 +831,7 @@ int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
 		if (ret) {
 			DBG("Cannot get ELF Symbol Table nor Dynamic Symbol Table sections.");
 			ret = LTTNG_ERR_ELF_PARSING;
-			goto destroy_elf;
+			goto end;
 		}
 		string_table_name = DYNAMIC_STRING_TAB_SECTION_NAME;
 	} else {
@@ -790,7 +843,7 @@ int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
 	if (symbol_table_data == nullptr) {
 		DBG("Cannot get ELF Symbol Table data.");
 		ret = LTTNG_ERR_ELF_PARSING;
-		goto destroy_elf;
+		goto end;
 	}
 
 	/* Get the string table section header. */
@@ -816,6 +869,7 @@ int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
 	}
 
 	sym_count = symtab_hdr.sh_size / symtab_hdr.sh_entsize;
+	index.function_addresses.reserve(sym_count);
 
 	/* Loop over all symbol. */
 	for (sym_idx = 0; sym_idx < sym_count; sym_idx++) {
@@ -832,18 +886,13 @@ int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
 
 		/*
 		 * If the st_name field is zero, there is no string name for
-		 * this symbol; skip to the next symbol.
+		 * this symbol; skip to the next symbol. Names that are outside
+		 * of the string table are skipped too.
 		 */
-		if (curr_sym.st_name == 0) {
+		if (curr_sym.st_name == 0 || curr_sym.st_name >= strtab_hdr.sh_size) {
 			continue;
 		}
 
-		/*
-		 * Use the st_name field in the lttng_elf_sym struct to get offset of
-		 * the symbol's name from the beginning of the string table.
-		 */
-		curr_sym_str = string_table_data + curr_sym.st_name;
-
 		/*
 		 * If the current symbol is not a function; skip to the next symbol.
 		 */
@@ -853,85 +902,44 @@ int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
 		}
 
 		/*
-		 * Compare with the search symbol. If there is a match set the address
-		 * output parameter and return success.
+		 * Use the st_name field in the lttng_elf_sym struct to get offset of
+		 * the symbol's name from the beginning of the string table.
 		 */
-		if (strcmp(symbol, curr_sym_str) == 0) {
-			sym_found = 1;
-			addr = curr_sym.st_value;
-			break;
-		}
-	}
+		curr_sym_str = string_table_data + curr_sym.st_name;
 
-	if (!sym_found) {
-		DBG("Symbol not found.");
-		ret = LTTNG_ERR_ELF_PARSING;
-		goto free_string_table_data;
-	}
-
-	/*
-	 * Use the virtual address of the symbol to compute the offset of this
-	 * symbol from the beginning of the executable file.
-	 */
-	ret = lttng_elf_convert_addr_in_text_to_offset(elf, addr, offset);
-	if (ret) {
-		DBG("Cannot convert addr to offset.");
-		goto free_string_table_data;
+		/* The first symbol of a given name is kept, as done by a linear search. */
+		index.function_addresses.emplace(curr_sym_str, curr_sym.st_value);
 	}
 
 free_string_table_data:
 	free(string_table_data);
 free_symbol_table_data:
 	free(symbol_table_data);
-destroy_elf:
-	lttng_elf_destroy(elf);
 end:
 	return ret;
 }
 
 /*
- * Compute the offsets of SDT probes from the begining of the ELF binary.
+ * Index the SDT probe descriptions of the stap note section of an ELF binary.
  *
- * On success, returns 0 and the nb_probes parameter is set to the number of
- * offsets found and the offsets parameter points to an array of offsets where
- * the SDT probes are.
- * On failure, returns -1.
+ * Returns 0 on success or else a non-zero value.
  */
-int lttng_elf_get_sdt_probe_offsets(int fd,
-				    const char *provider_name,
-				    const char *probe_name,
-				    uint64_t **offsets,
-				    uint32_t *nb_probes)
+static int elf_index_populate_sdt_probes(struct lttng_elf *elf, elf_index& index)
 {
-	int ret = 0, nb_match = 0;
+	int ret = 0;
 	struct lttng_elf_shdr stap_note_section_hdr;
-	struct lttng_elf *elf = nullptr;
 	char *stap_note_section_data = nullptr;
 	char *curr_note_section_begin, *curr_data_ptr, *curr_probe, *curr_provider;
 	char *next_note_ptr;
 	uint32_t name_size, desc_size, note_type;
-	uint64_t curr_probe_location, curr_probe_offset, curr_semaphore_location;
-	uint64_t *probe_locs = nullptr, *new_probe_locs = nullptr;
-
-	if (!provider_name || !probe_name || !nb_probes || !offsets) {
-		DBG("Invalid arguments.");
-		ret = LTTNG_ERR_ELF_PARSING;
-		goto error;
-	}
-
-	elf = lttng_elf_create(fd);
-	if (!elf) {
-		DBG("Error allocation ELF.");
-		ret = LTTNG_ERR_ELF_PARSING;
-		goto error;
-	}
+	uint64_t curr_probe_location, curr_semaphore_location;
 
 	/* Get the stap note section header. */
 	ret = lttng_elf_get_section_hdr_by_name(
 		elf, NOTE_STAPSDT_SECTION_NAME, &stap_note_section_hdr);
 	if (ret) {
 		DBG("Cannot get ELF stap note section.");
-		goto destroy_elf_error;
+		goto end;
 	}
 
 	/* Get the data associated with the stap note section. */
@@ -939,19 +947,16 @@ int lttng_elf_get_sdt_probe_offsets(int fd,
 	if (stap_note_section_data == nullptr) {
 		DBG("Cannot get ELF stap note section data.");
 		ret = LTTNG_ERR_ELF_PARSING;
-		goto destroy_elf_error;
+		goto end;
 	}
 
 	next_note_ptr = stap_note_section_data;
 	curr_note_section_begin = stap_note_section_data;
 
-	*offsets = nullptr;
 	while (true) {
 		curr_data_ptr = next_note_ptr;
 		/* Check if we have reached the end of the note section. */
 		if (curr_data_ptr >= curr_note_section_begin + stap_note_section_hdr.sh_size) {
-			*nb_probes = nb_match;
-			*offsets = probe_locs;
 			ret = 0;
 			break;
 		}
@@ -964,7 +969,8 @@ int lttng_elf_get_sdt_probe_offsets(int fd,
 			DBG("Invalid name size field in SDT probe descriptions"
 			    "section.");
 			ret = -1;
-			goto realloc_error;
+			index.sdt_probes.clear();
+			break;
 		}
 
 		/* Get description size field. */
@@ -1012,17 +1018,212 @@ int lttng_elf_get_sdt_probe_offsets(int fd,
 		/* Get probe name. */
 		curr_probe = curr_data_ptr;
 
-		/* Check if the provider and probe name match */
-		if (strcmp(provider_name, curr_provider) == 0 &&
-		    strcmp(probe_name, curr_probe) == 0) {
+		index.sdt_probes.push_back({ curr_provider,
+					     curr_probe,
+					     curr_probe_location,
+					     curr_semaphore_location });
+	}
+
+	free(stap_note_section_data);
+end:
+	return ret;
+}
+
+/*
+ * Get the index of the ELF file referred to by `fd`, populating the parts that
+ * are needed and were not indexed yet.
+ *
+ * The index cache lock must be held by the caller.
+ *
+ * Returns 0 and sets `out_index` on success, or else a non-zero value.
+ */
+static int
+get_elf_index(int fd, bool need_symbols, bool need_sdt_probes, const elf_index **out_index)
+{
+	int ret = 0;
+	struct stat stat_buf;
+	elf_index *index = nullptr;
+	struct lttng_elf *elf = nullptr;
+	elf_file_id id;
+
+	if (fd < 0) {
+		ret = LTTNG_ERR_ELF_PARSING;
+		goto end;
+	}
+
+	ret = fstat(fd, &stat_buf);
+	if (ret) {
+		PERROR("Failed to determine size of elf file");
+		ret = LTTNG_ERR_ELF_PARSING;
+		goto end;
+	}
+
+	id.dev = stat_buf.st_dev;
+	id.ino = stat_buf.st_ino;
+	id.size = stat_buf.st_size;
+	id.mtime = stat_buf.st_mtim;
+
+	for (auto it = elf_index_cache.begin(); it != elf_index_cache.end(); ++it) {
+		if ((*it)->id == id) {
+			/* Move the index to the front as the most recently used. */
+			elf_index_cache.splice(elf_index_cache.begin(), elf_index_cache, it);
+			index = elf_index_cache.front().get();
+			break;
+		}
+	}
+
+	if (!index) {
+		if (elf_index_cache.size() >= ELF_INDEX_CACHE_MAX_ENTRIES) {
+			elf_index_cache.pop_back();
+		}
+
+		elf_index_cache.emplace_front(lttng::make_unique<elf_index>(id));
+		index = elf_index_cache.front().get();
+	}
+
+	if ((!need_symbols || index->symbols_indexed) &&
+	    (!need_sdt_probes || index->sdt_probes_indexed)) {
+		*out_index = index;
+		goto end;
+	}
+
+	elf = lttng_elf_create(fd);
+	if (!elf) {
+		ret = LTTNG_ERR_ELF_PARSING;
+		goto end;
+	}
+
+	elf_index_populate_text_section(elf, *index);
+
+	if (need_symbols && !index->symbols_indexed) {
+		ret = elf_index_populate_symbols(elf, *index);
+		if (ret) {
+			index->function_addresses.clear();
+			goto destroy_elf;
+		}
+
+		index->symbols_indexed = true;
+	}
+
+	if (need_sdt_probes && !index->sdt_probes_indexed) {
+		ret = elf_index_populate_sdt_probes(elf, *index);
+		if (ret) {
+			index->sdt_probes.clear();
+			goto destroy_elf;
+		}
+
+		index->sdt_probes_indexed = true;
+	}
+
+	*out_index = index;
+
+destroy_elf:
+	lttng_elf_destroy(elf);
+end:
+	return ret;
+}
+
+/*
+ * Compute the offset of a symbol from the begining of the ELF binary.
+ *
+ * The symbol table of the binary is indexed on the first call and kept in a
+ * cache of the most recently used binaries, making subsequent look-ups in the
+ * same binary independent of the size of its symbol table.
+ *
+ * On success, returns 0 offset parameter is set to the computed value
+ * On failure, returns -1.
+ */
+int lttng_elf_get_symbol_offset(int fd, char *symbol, uint64_t *offset)
+{
+	int ret = 0;
+	const elf_index *index;
+
+	if (!symbol || !offset) {
+		ret = LTTNG_ERR_ELF_PARSING;
+		goto end;
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(elf_index_cache_lock);
+
+		ret = get_elf_index(fd, true, false, &index);
+		if (ret) {
+			goto end;
+		}
+
+		const auto symbol_it = index->function_addresses.find(symbol);
+		if (symbol_it == index->function_addresses.end()) {
+			DBG("Symbol not found.");
+			ret = LTTNG_ERR_ELF_PARSING;
+			goto end;
+		}
+
+		/*
+		 * Use the virtual address of the symbol to compute the offset of this
+		 * symbol from the beginning of the executable file.
+		 */
+		ret = elf_index_convert_addr_in_text_to_offset(*index, symbol_it->second, offset);
+		if (ret) {
+			DBG("Cannot convert addr to offset.");
+			goto end;
+		}
+	}
+
+end:
+	return ret;
+}
+
+/*
+ * Compute the offsets of SDT probes from the begining of the ELF binary.
+ *
+ * As for lttng_elf_get_symbol_offset(), the SDT probe descriptions of the
+ * binary are indexed on the first call and kept in a cache.
+ *
+ * On success, returns 0 and the nb_probes parameter is set to the number of
+ * offsets found and the offsets parameter points to an array of offsets where
+ * the SDT probes are.
+ * On failure, returns -1.
+ */
+int lttng_elf_get_sdt_probe_offsets(int fd,
+				    const char *provider_name,
+				    const char *probe_name,
+				    uint64_t **offsets,
+				    uint32_t *nb_probes)
+{
+	int ret = 0, nb_match = 0;
+	const elf_index *index;
+	uint64_t curr_probe_offset;
+	uint64_t *probe_locs = nullptr, *new_probe_locs = nullptr;
+
+	if (!provider_name || !probe_name || !nb_probes || !offsets) {
+		DBG("Invalid arguments.");
+		ret = LTTNG_ERR_ELF_PARSING;
+		goto error;
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(elf_index_cache_lock);
+
+		ret = get_elf_index(fd, false, true, &index);
+		if (ret) {
+			goto error;
+		}
+
+		for (const auto& probe : index->sdt_probes) {
 			int new_size;
 
+			/* Check if the provider and probe name match */
+			if (probe.provider_name != provider_name ||
+			    probe.probe_name != probe_name) {
+				continue;
+			}
+
 			/*
 			 * We currently don't support SDT probes with semaphores. Return
 			 * success as we found a matching probe but it's guarded by a
 			 * semaphore.
 			 */
-			if (curr_semaphore_location != 0) {
+			if (probe.semaphore_location != 0) {
 				ret = LTTNG_ERR_SDT_PROBE_SEMAPHORE;
 				goto realloc_error;
 			}
@@ -1047,8 +1248,8 @@ int lttng_elf_get_sdt_probe_offsets(int fd,
 			 * Use the virtual address of the probe to compute the offset of
 			 * this probe from the beginning of the executable file.
 			 */
-			ret = lttng_elf_convert_addr_in_text_to_offset(
-				elf, curr_probe_location, &curr_probe_offset);
+			ret = elf_index_convert_addr_in_text_to_offset(
+				*index, probe.location, &curr_probe_offset);
 			if (ret) {
 				DBG("Conversion error in SDT.");
 				goto realloc_error;
@@ -1058,13 +1259,12 @@ int lttng_elf_get_sdt_probe_offsets(int fd,
 		}
 	}
 
-end:
-	free(stap_note_section_data);
-destroy_elf_error:
-	lttng_elf_destroy(elf);
+	*nb_probes = nb_match;
+	*offsets = probe_locs;
+
 error:
 	return ret;
 realloc_error:
 	free(probe_locs);
-	goto end;
+	goto error;
 }
@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/align.hpp>
+#include <common/error.hpp>
+#include <common/exception.hpp>
+#include <common/memory-usage-sampler.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+/* Pages per chunk; also the size of the residency vector passed to mincore(2). */
+constexpr std::size_t chunk_page_count = 4096;
+
+std::size_t get_page_size()
+{
+	const long maybe_page_size = sysconf(_SC_PAGESIZE);
+
+	if (maybe_page_size < 0) {
+		LTTNG_THROW_POSIX("Failed to call sysconf(_SC_PAGESIZE)", errno);
+	}
+
+	return static_cast<std::size_t>(maybe_page_size);
+}
+} /* namespace */
+
+lttng::memory_usage_sampler::memory_usage_sampler(std::chrono::milliseconds max_sample_age,
+						  std::chrono::milliseconds full_scan_interval) :
+	_max_sample_age(max_sample_age),
+	_full_scan_interval(full_scan_interval),
+	_page_size(get_page_size())
+{
+}
+
+nonstd::optional<lttng::memory_usage_sampler::sample>
+lttng::memory_usage_sampler::get_fresh_sample(clock::time_point now) const
+{
+	if (!_last_sample || _invalidated.load(std::memory_order_relaxed) ||
+	    now - _last_sample_time >= _max_sample_age) {
+		return nonstd::nullopt;
+	}
+
+	return _last_sample;
+}
+
+void lttng::memory_usage_sampler::invalidate() noexcept
+{
+	_invalidated.store(true, std::memory_order_relaxed);
+}
+
+std::size_t lttng::memory_usage_sampler::count_resident_pages(const unsigned char *residency_vector,
+							      std::size_t page_count) noexcept
+{
+	/*
+	 * mincore(2): Only the least significant bit of each byte is meaningful.
+	 *
+	 * Accumulate the masked bytes eight at a time in the lanes of a 64-bit
+	 * word (a loop the compiler can vectorize further), folding the lanes
+	 * before any of them can overflow.
+	 */
+	constexpr std::uint64_t lsb_mask = 0x0101010101010101ULL;
+	constexpr std::size_t max_words_per_fold = 255;
+	std::size_t resident_page_count = 0;
+	std::size_t i = 0;
+
+	while (page_count - i >= sizeof(std::uint64_t)) {
+		const auto word_count = std::min((page_count - i) / sizeof(std::uint64_t),
+						 max_words_per_fold);
+		std::uint64_t lanes = 0;
+
+		for (std::size_t word_index = 0; word_index < word_count; word_index++) {
+			std::uint64_t word;
+
+			std::memcpy(&word, residency_vector + i, sizeof(word));
+			lanes += word & lsb_mask;
+			i += sizeof(word);
+		}
+
+		/* Widen to four 16-bit lanes, then sum them in the most significant one. */
+		lanes = (lanes & 0x00ff00ff00ff00ffULL) + ((lanes >> 8) & 0x00ff00ff00ff00ffULL);
+		resident_page_count +=
+			static_cast<std::size_t>((lanes * 0x0001000100010001ULL) >> 48);
+	}
+
+	for (; i < page_count; i++) {
+		resident_page_count += residency_vector[i] & 1;
+	}
+
+	return resident_page_count;
+}
+
+void lttng::memory_usage_sampler::_reset(const void *area, std::size_t area_size)
+{
+	/*
+	 * mincore(2): The `addr` argument must be a multiple of the system page
+	 * size, but the `length` argument need not be.
+	 */
+	LTTNG_ASSERT(lttng_align_floor(reinterpret_cast<uintptr_t>(area), _page_size) ==
+		     reinterpret_cast<uintptr_t>(area));
+
+	_area = static_cast<const char *>(area);
+	_area_page_count = lttng_align_ceil(area_size, _page_size) / _page_size;
+	_chunk_resident_page_counts.assign(
+		(_area_page_count + chunk_page_count - 1) / chunk_page_count, 0);
+	_last_sample.reset();
+	_invalidated.store(true, std::memory_order_relaxed);
+}
+
+std::size_t lttng::memory_usage_sampler::_scan_chunk(std::size_t chunk_index)
+{
+	unsigned char residency_vector[chunk_page_count];
+	const auto first_page = chunk_index * chunk_page_count;
+	const auto page_count = std::min(chunk_page_count, _area_page_count - first_page);
+
+	/* NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) */
+	const auto ret = ::mincore(const_cast<char *>(_area) + first_page * _page_size,
+				   page_count * _page_size,
+				   residency_vector);
+	if (ret) {
+		/*
+		 * Something bad happened; assume full physical memory usage
+		 * and scan everything again next time.
+		 */
+		PWARN_FMT("Failed to determine memory usage using mincore()");
+		invalidate();
+		return page_count;
+	}
+
+	return count_resident_pages(residency_vector, page_count);
+}
+
+lttng::memory_usage_sampler::sample
+lttng::memory_usage_sampler::get_sample(const void *area,
+					std::size_t area_size,
+					std::uint64_t write_position,
+					clock::time_point now)
+{
+	if (area != _area ||
+	    lttng_align_ceil(area_size, _page_size) / _page_size != _area_page_count) {
+		_reset(area, area_size);
+	}
+
+	const bool full_scan = _invalidated.exchange(false, std::memory_order_relaxed) ||
+		now - _last_full_scan_time >= _full_scan_interval;
+
+	if (!full_scan && _last_sample && write_position == _last_write_position) {
+		/* Nothing was written since the last scan. */
+		_last_sample_time = now;
+		return *_last_sample;
+	}
+
+	std::size_t resident_page_count = 0;
+	for (std::size_t chunk_index = 0; chunk_index < _chunk_resident_page_counts.size();
+	     chunk_index++) {
+		auto& chunk_resident_page_count = _chunk_resident_page_counts[chunk_index];
+		const auto chunk_size = std::min(chunk_page_count,
+						 _area_page_count - chunk_index * chunk_page_count);
+
+		/* Writing to the area can't make a resident page non-resident. */
+		if (full_scan || chunk_resident_page_count != chunk_size) {
+			chunk_resident_page_count = _scan_chunk(chunk_index);
+		}
+
+		resident_page_count += chunk_resident_page_count;
+	}
+
+	if (full_scan) {
+		_last_full_scan_time = now;
+	}
+
+	_last_sample = sample{ static_cast<std::uint64_t>(_area_page_count) * _page_size,
+			       static_cast<std::uint64_t>(resident_page_count) * _page_size };
+	_last_sample_time = now;
+	_last_write_position = write_position;
+	return *_last_sample;
+}
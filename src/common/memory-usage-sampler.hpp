@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef LTTNG_MEMORY_USAGE_SAMPLER_HPP
+#define LTTNG_MEMORY_USAGE_SAMPLER_HPP
+
+#include <vendor/optional.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lttng {
+
+/*
+ * Samples the physical memory usage (resident pages) of a memory area, such as
+ * the backend area of a ring buffer, using mincore(2).
+ *
+ * Pages only become resident as the area is written to, until some of them
+ * are explicitly released (e.g. sub-buffers reclaimed by the consumer). The
+ * sampler relies on this to avoid scanning the whole area on every sample:
+ *
+ *   - the area is split in chunks and the chunks which were completely
+ *     resident during the last scan are not scanned again,
+ *   - nothing is scanned if the area was not written to since the last scan
+ *     (the caller provides a write position, e.g. the produced position of a
+ *     ring buffer),
+ *   - samples younger than `max_sample_age` are served as is.
+ *
+ * Pages can also be evicted by the kernel (swapped out); such changes are
+ * picked up by a full scan of the area, at least every `full_scan_interval`,
+ * or on the next sample following a call to invalidate().
+ *
+ * Calls to get_sample() must be serialized by the caller. invalidate() may be
+ * called concurrently.
+ */
+class memory_usage_sampler final {
+public:
+	using clock = std::chrono::steady_clock;
+
+	struct sample {
+		std::uint64_t logical_size;
+		std::uint64_t physical_size;
+	};
+
+	memory_usage_sampler(std::chrono::milliseconds max_sample_age,
+			     std::chrono::milliseconds full_scan_interval);
+
+	/* Deactivate copy and assignment. */
+	memory_usage_sampler(const memory_usage_sampler&) = delete;
+	memory_usage_sampler(memory_usage_sampler&&) = delete;
+	memory_usage_sampler& operator=(const memory_usage_sampler&) = delete;
+	memory_usage_sampler& operator=(memory_usage_sampler&&) = delete;
+	~memory_usage_sampler() = default;
+
+	/* Last sample, if it is younger than `max_sample_age`. */
+	nonstd::optional<sample> get_fresh_sample(clock::time_point now = clock::now()) const;
+
+	/*
+	 * Sample the memory usage of the page-aligned area [area, area + area_size).
+	 *
+	 * `write_position` must change whenever the area is written to.
+	 */
+	sample get_sample(const void *area,
+			  std::size_t area_size,
+			  std::uint64_t write_position,
+			  clock::time_point now = clock::now());
+
+	/* Some pages of the area were released; the next sample scans the whole area. */
+	void invalidate() noexcept;
+
+	/* Count the resident pages flagged in a mincore(2) residency vector. */
+	static std::size_t count_resident_pages(const unsigned char *residency_vector,
+						std::size_t page_count) noexcept;
+
+private:
+	void _reset(const void *area, std::size_t area_size);
+	std::size_t _scan_chunk(std::size_t chunk_index);
+
+	const std::chrono::milliseconds _max_sample_age;
+	const std::chrono::milliseconds _full_scan_interval;
+	const std::size_t _page_size;
+
+	const char *_area = nullptr;
+	std::size_t _area_page_count = 0;
+	/* Resident page count of each chunk of the area, as of the last scan. */
+	std::vector<std::size_t> _chunk_resident_page_counts;
+
+	nonstd::optional<sample> _last_sample;
+	clock::time_point _last_sample_time;
+	clock::time_point _last_full_scan_time;
+	std::uint64_t _last_write_position = 0;
+	std::atomic<bool> _invalidated{ true };
+};
+
+} /* namespace lttng */
+
+#endif /* LTTNG_MEMORY_USAGE_SAMPLER_HPP */
@@ -664,6 +664,64 @@ error:
 	return ret;
 }
 
+static int relayd_add_stream_2_16(struct lttcomm_relayd_sock *rsock,
+				  const char *channel_name,
+				  const char *pathname,
+				  uint64_t tracefile_size,
+				  uint64_t tracefile_count,
+				  uint64_t trace_archive_id,
+				  uint8_t compression_codec)
+{
+	int ret;
+	struct lttcomm_relayd_add_stream_2_16 *msg = nullptr;
+	size_t channel_name_len;
+	size_t pathname_len;
+	size_t msg_length;
+
+	/* The two names are sent with a '\0' delimiter between them. */
+	channel_name_len = strlen(channel_name) + 1;
+	pathname_len = strlen(pathname) + 1;
+
+	msg_length = sizeof(*msg) + channel_name_len + pathname_len;
+	msg = zmalloc<lttcomm_relayd_add_stream_2_16>(msg_length);
+	if (!msg) {
+		PERROR("zmalloc add_stream_2_16 command message");
+		ret = -1;
+		goto error;
+	}
+
+	msg->compression_codec = compression_codec;
+
+	LTTNG_ASSERT(channel_name_len <= UINT32_MAX);
+	msg->channel_name_len = htobe32(channel_name_len);
+
+	LTTNG_ASSERT(pathname_len <= UINT32_MAX);
+	msg->pathname_len = htobe32(pathname_len);
+
+	if (lttng_strncpy(msg->names, channel_name, channel_name_len)) {
+		ret = -1;
+		goto error;
+	}
+	if (lttng_strncpy(msg->names + channel_name_len, pathname, pathname_len)) {
+		ret = -1;
+		goto error;
+	}
+
+	msg->tracefile_size = htobe64(tracefile_size);
+	msg->tracefile_count = htobe64(tracefile_count);
+	msg->trace_chunk_id = htobe64(trace_archive_id);
+
+	/* Send command */
+	ret = send_command(*rsock, RELAYD_ADD_STREAM, (void *) msg, msg_length, 0);
+	if (ret < 0) {
+		goto error;
+	}
+	ret = 0;
+error:
+	free(msg);
+	return ret;
+}
+
 /*
  * Add stream on the relayd and assign stream handle to the stream_id argument.
  *
@@ -671,6 +729,9 @@ error:
  * internally between session daemon and consumer daemon to keep track
  * of the channel and stream output path.
  *
+ * Streams of compressed channels (non-zero `compression_codec`) require
+ * relayd 2.16 or later.
+ *
  * On success return 0 else return ret_code negative value.
  */
 int relayd_add_stream(struct lttcomm_relayd_sock *rsock,
@@ -680,7 +741,8 @@ int relayd_add_stream(struct lttcomm_relayd_sock *rsock,
 		      uint64_t *stream_id,
 		      uint64_t tracefile_size,
 		      uint64_t tracefile_count,
-		      struct lttng_trace_chunk *trace_chunk)
+		      struct lttng_trace_chunk *trace_chunk,
+		      uint8_t compression_codec)
 {
 	int ret;
 	struct lttcomm_relayd_status_stream reply;
@@ -695,6 +757,13 @@ int relayd_add_stream(struct lttcomm_relayd_sock *rsock,
 
 	DBG("Relayd adding stream for channel name %s", channel_name);
 
+	if (compression_codec != 0 && rsock->minor < 16) {
+		ERR("Relayd does not support compressed packets before protocol 2.16: relayd_minor=%u",
+		    rsock->minor);
+		ret = -1;
+		goto error;
+	}
+
 	/* Compat with relayd 2.1 */
 	if (rsock->minor == 1) {
 		/* For 2.1 */
@@ -731,9 +800,24 @@ int relayd_add_stream(struct lttcomm_relayd_sock *rsock,
 		chunk_status = lttng_trace_chunk_get_id(trace_chunk, &chunk_id);
 		LTTNG_ASSERT(chunk_status == LTTNG_TRACE_CHUNK_STATUS_OK);
 
-		/* From 2.11 to ...*/
-		ret = relayd_add_stream_2_11(
-			rsock, channel_name, pathname, tracefile_size, tracefile_count, chunk_id);
+		if (rsock->minor < 16) {
+			/* From 2.11 to 2.15 */
+			ret = relayd_add_stream_2_11(rsock,
+						     channel_name,
+						     pathname,
+						     tracefile_size,
+						     tracefile_count,
+						     chunk_id);
+		} else {
+			/* From 2.16 to ... */
+			ret = relayd_add_stream_2_16(rsock,
+						     channel_name,
+						     pathname,
+						     tracefile_size,
+						     tracefile_count,
+						     chunk_id,
+						     compression_codec);
+		}
 	}
 
 	if (ret) {
@@ -1303,12 +1387,21 @@ int relayd_send_index(lttcomm_relayd_sock& rsock,
 		msg.packet_seq_num = index.packet_seq_num;
 	}
 
+	if (rsock.minor >= 16) {
+		msg.stored_size = index.stored_size;
+		msg.compression_codec = index.compression_codec;
+	} else if (index.compression_codec != 0) {
+		ERR("Relayd does not support compressed packets before protocol 2.16: relayd_minor=%u",
+		    rsock.minor);
+		ret = -1;
+		goto error;
+	}
+
 	/* Send command */
 	ret = send_command(rsock,
 			   RELAYD_SEND_INDEX,
 			   &msg,
-			   lttcomm_relayd_index_len(lttng_to_index_major(rsock.major, rsock.minor),
-						    lttng_to_index_minor(rsock.major, rsock.minor)),
+			   lttcomm_relayd_index_msg_len(rsock.major, rsock.minor),
 			   0);
 	if (ret < 0) {
 		goto error;
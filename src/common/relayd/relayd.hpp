@@ -52,7 +52,8 @@ int relayd_add_stream(struct lttcomm_relayd_sock *sock,
 		      uint64_t *stream_id,
 		      uint64_t tracefile_size,
 		      uint64_t tracefile_count,
-		      struct lttng_trace_chunk *trace_chunk);
+		      struct lttng_trace_chunk *trace_chunk,
+		      uint8_t compression_codec);
 int relayd_streams_sent(struct lttcomm_relayd_sock *rsock);
 int relayd_send_close_stream(struct lttcomm_relayd_sock *sock,
 			     uint64_t stream_id,
@@ -12,13 +12,19 @@
 
 #include <common/error.hpp>
 #include <common/format.hpp>
+#include <common/histogram.hpp>
 #include <common/macros.hpp>
+#include <common/make-unique.hpp>
 
 #include <vendor/optional.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <iterator>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <stddef.h>
@@ -39,6 +45,13 @@ class task {
 public:
 	using sptr = std::shared_ptr<task>;
 
+	struct statistics {
+		/* Duration of the task's runs. */
+		lttng::log2_duration_histogram::snapshot run_time;
+		/* Delay between the deadline of the task and the beginning of its runs. */
+		lttng::log2_duration_histogram::snapshot lateness;
+	};
+
 	/*
 	 * gcc 4.8.5 can't generate a default constructor that is noexcept.
 	 * Hence, a trivial one is provided here.
@@ -96,6 +109,17 @@ public:
 		return _canceled;
 	}
 
+	const std::string& name() const noexcept
+	{
+		return _name;
+	}
+
+	/* Can be sampled at any time, including while the task is running. */
+	statistics get_statistics() const noexcept
+	{
+		return { _run_time_histogram.get_snapshot(), _lateness_histogram.get_snapshot() };
+	}
+
 protected:
 	virtual void _run(absolute_time current_time) noexcept = 0;
 
@@ -109,30 +133,46 @@ private:
 		return false;
 	}
 
+	/*
+	 * The scheduled time is only accessed by the scheduler, with its lock held. Hence,
+	 * the task's lock is not acquired when comparing deadlines.
+	 */
 	absolute_time _get_next_scheduled_time() const noexcept
 	{
-		const std::lock_guard<std::mutex> lock(_mutex);
-
 		LTTNG_ASSERT(_next_scheduled_time.has_value());
 		return *_next_scheduled_time;
 	}
 
 	void _set_next_scheduled_time(absolute_time next_time) noexcept
 	{
-		const std::lock_guard<std::mutex> lock(_mutex);
-
 		_next_scheduled_time = next_time;
 	}
 
 	/*
 	 * nullopt means not scheduled.
 	 *
-	 * Don't access directly, use _get_next_scheduled_time() and
-	 * _set_next_scheduled_time() to ensure proper locking.
+	 * Protected by the lock of the scheduler to which the task is submitted.
 	 */
 	nonstd::optional<absolute_time> _next_scheduled_time;
 
+	/*
+	 * Position of the task within the scheduler's timing wheel (if that backend is
+	 * used), allowing the task to be unlinked in constant time.
+	 *
+	 * Protected by the lock of the scheduler to which the task is submitted.
+	 */
+	struct {
+		bool linked = false;
+		unsigned int level = 0;
+		unsigned int index = 0;
+		std::list<sptr>::iterator position;
+	} _wheel_hook;
+
 	const std::string _name{ "Anonymous" };
+
+	/* Updated by the scheduler every time the task is run. */
+	lttng::log2_duration_histogram _run_time_histogram;
+	lttng::log2_duration_histogram _lateness_histogram;
 };
 
 class periodic_task : public task {
@@ -203,13 +243,41 @@ class scheduler final {
 public:
 	using task_scheduled_callback = std::function<void(absolute_time)>;
 
-	/*
-	 * gcc 4.8.5 can't generate a default constructor that is noexcept.
-	 * Hence, a trivial one is provided here.
-	 * NOLINTBEGIN (modernize-use-equals-default)
-	 */
-	scheduler() noexcept {};
-	/* NOLINTEND (modernize-use-equals-default) */
+	/* Data structure used to keep track of the scheduled tasks. */
+	enum class backend_type {
+		/*
+		 * Binary min-heap ordered by deadline: O(log n) insertion and removal of
+		 * the nearest task. Exact wake-up times.
+		 */
+		PRIORITY_HEAP,
+		/*
+		 * Hierarchical timing wheel: O(1) insertion and cancellation, expired tasks
+		 * are collected in batches. Wake-up times are rounded down to the wheel's
+		 * resolution (or to the next cascade of the wheel), which may cause
+		 * spurious (but harmless) ticks.
+		 */
+		TIMING_WHEEL,
+	};
+
+	scheduler() : scheduler(backend_type::PRIORITY_HEAP)
+	{
+	}
+
+	explicit scheduler(backend_type backend,
+			   duration_ns timing_wheel_resolution = std::chrono::milliseconds(1))
+	{
+		switch (backend) {
+		case backend_type::PRIORITY_HEAP:
+			_task_queue = lttng::make_unique<task_heap>();
+			break;
+		case backend_type::TIMING_WHEEL:
+			_task_queue = lttng::make_unique<timing_wheel>(timing_wheel_resolution);
+			break;
+		}
+
+		LTTNG_ASSERT(_task_queue);
+	}
+
 	~scheduler() = default;
 
 	/* Deactivate copy and assignment. */
@@ -228,53 +296,142 @@ public:
 		}
 
 		task->_set_next_scheduled_time(when_to_run);
-		_task_heap.insert(std::move(task));
+		_task_queue->insert(std::move(task));
+	}
+
+	/*
+	 * Cancel a task and release the scheduler's reference to it.
+	 *
+	 * Same guarantees as task::cancel(). In addition, the backends that support it
+	 * (e.g. the timing wheel) unlink the task immediately instead of discarding it
+	 * when its deadline is reached.
+	 */
+	void cancel(const task::sptr& task) noexcept
+	{
+		task->cancel();
+
+		const std::lock_guard<std::mutex> lock(_mutex);
+		_task_queue->remove(*task);
 	}
 
+	/*
+	 * An expired task handed over to a task dispatcher. It must be passed back to
+	 * scheduler::run() to be run and, if it is periodic, rescheduled.
+	 */
+	class dispatched_task final {
+	public:
+		dispatched_task() = default;
+
+		const task& get_task() const noexcept
+		{
+			LTTNG_ASSERT(_task);
+			return *_task;
+		}
+
+	private:
+		friend class scheduler;
+
+		dispatched_task(task::sptr task_to_run,
+				absolute_time deadline,
+				absolute_time tick_time) noexcept :
+			_task(std::move(task_to_run)), _deadline(deadline), _tick_time(tick_time)
+		{
+		}
+
+		task::sptr _task;
+		absolute_time _deadline;
+		/* Time of the tick that expired the task. */
+		absolute_time _tick_time;
+	};
+
+	using task_dispatcher = std::function<void(dispatched_task)>;
+
 	/*
 	 * Run scheduled tasks that have expired as of the current time.
 	 *
 	 * Returns:
 	 * - The number of nanoseconds until the next task, if one is still scheduled.
+	 *   Depending on the backend, this may be earlier than the actual deadline of the
+	 *   next task, in which case the next tick will not run any task.
 	 * - `nonstd::nullopt` if no tasks are currently scheduled.
 	 */
 	nonstd::optional<duration_ns>
 	tick(absolute_time current_time = std::chrono::steady_clock::now()) noexcept
 	{
-		_last_tick = current_time;
+		return tick(current_time,
+			    [this](dispatched_task task_to_run) { run(std::move(task_to_run)); });
+	}
 
+	/*
+	 * Same as tick(), but hand the expired tasks over to `dispatcher` instead of running
+	 * them on the calling thread (e.g. to run them on a pool of threads).
+	 *
+	 * A periodic task is only rescheduled once it has been run by scheduler::run(). Hence,
+	 * a given task is never dispatched again before its current run completes.
+	 */
+	nonstd::optional<duration_ns> tick(absolute_time current_time,
+					   const task_dispatcher& dispatcher) noexcept
+	{
 		while (true) {
-			lttng::scheduling::task::sptr task_to_run = nullptr;
+			std::vector<task::sptr> expired_tasks;
+			std::vector<absolute_time> deadlines;
 
 			{
 				const std::lock_guard<std::mutex> lock(_mutex);
 
-				const auto candidate = _task_heap.peek();
+				/* Collect all the tasks that are ready to run in one pass. */
+				_task_queue->pop_expired(current_time, expired_tasks);
+				if (expired_tasks.empty()) {
+					const auto next_wake_up_time =
+						_task_queue->next_wake_up_time();
 
-				/* If the task heap is empty, return no next task. */
-				if (candidate == nullptr) {
-					return nonstd::nullopt;
-				}
+					/* If no task is scheduled, return no next task. */
+					if (!next_wake_up_time) {
+						return nonstd::nullopt;
+					}
 
-				if (candidate->_get_next_scheduled_time() > _last_tick) {
-					return candidate->_get_next_scheduled_time() - current_time;
+					return *next_wake_up_time - current_time;
 				}
 
-				/* The task is ready to run. */
-				task_to_run = _task_heap.pop();
+				deadlines.reserve(expired_tasks.size());
+				for (const auto& expired_task : expired_tasks) {
+					deadlines.emplace_back(
+						expired_task->_get_next_scheduled_time());
+				}
 			}
 
 			/*
-			 * The scheduler lock doesn't need to be held while the task is being run.
+			 * The scheduler lock doesn't need to be held while the tasks are being run.
+			 * Periodic tasks are rescheduled after their deadline which guarantees
+			 * progress.
 			 */
+			for (std::size_t i = 0; i < expired_tasks.size(); i++) {
+				dispatcher(dispatched_task(
+					std::move(expired_tasks[i]), deadlines[i], current_time));
+			}
+		}
+	}
+
+	/* Run a dispatched task and reschedule it, if necessary. */
+	void run(dispatched_task task_to_run) noexcept
+	{
+		auto& task = *task_to_run._task;
+		const auto time_before_task_run = std::chrono::steady_clock::now();
 
-			const auto time_before_task_run = std::chrono::steady_clock::now();
-			DBG_FMT("Running task: name=`{}`", task_to_run->_name);
+		DBG_FMT("Running task: name=`{}`", task._name);
+		task._lateness_histogram.record(time_before_task_run - task_to_run._deadline);
 
-			_run_task(std::move(task_to_run));
+		task.run(task_to_run._tick_time);
 
-			DBG_FMT("Task completed: duration={}",
-				std::chrono::steady_clock::now() - time_before_task_run);
+		const auto run_duration = std::chrono::steady_clock::now() - time_before_task_run;
+		task._run_time_histogram.record(run_duration);
+		DBG_FMT("Task completed: duration={}", run_duration);
+
+		if (task._must_be_rescheduled()) {
+			auto& periodic_task_to_schedule = static_cast<periodic_task&>(task);
+
+			schedule(std::move(task_to_run._task),
+				 task_to_run._tick_time + periodic_task_to_schedule.period());
 		}
 	}
 
@@ -285,21 +442,45 @@ public:
 	}
 
 private:
-	/* Run a task and reschedule it, if necessary. */
-	void _run_task(task::sptr task) noexcept
-	{
-		task->run(_last_tick);
-		if (task->_must_be_rescheduled()) {
-			auto& periodic_task_to_schedule = static_cast<periodic_task&>(*task);
+	/*
+	 * Interface of the scheduler's backends. All methods are called with the scheduler's
+	 * lock held.
+	 */
+	class task_queue {
+	public:
+		task_queue() = default;
+		virtual ~task_queue() = default;
 
-			schedule(std::move(task), _last_tick + periodic_task_to_schedule.period());
-		}
-	}
+		task_queue(const task_queue&) = delete;
+		task_queue(task_queue&&) = delete;
+		task_queue& operator=(const task_queue&) = delete;
+		task_queue& operator=(task_queue&&) = delete;
 
-	class task_heap {
+		/* Insert task to schedule. */
+		virtual void insert(task::sptr new_task) = 0;
+
+		/*
+		 * Remove a task from the queue, if the backend supports it. Otherwise, the task
+		 * remains queued until its deadline, at which point it is run (as a no-op, since
+		 * it is canceled).
+		 */
+		virtual void remove(task& task_to_remove) noexcept = 0;
+
+		/*
+		 * Append all tasks with a deadline at or before `current_time` to
+		 * `expired_tasks`, in deadline order.
+		 */
+		virtual void pop_expired(absolute_time current_time,
+					 std::vector<task::sptr>& expired_tasks) = 0;
+
+		/* Time at which the queue must be polled again, if any task is queued. */
+		virtual nonstd::optional<absolute_time> next_wake_up_time() const noexcept = 0;
+	};
+
+	class task_heap final : public task_queue {
 	public:
 		/* Insert task to schedule. */
-		void insert(task::sptr new_task)
+		void insert(task::sptr new_task) override
 		{
 			/* Position starts at the last element. */
 			auto position = _tasks.size();
@@ -316,6 +497,29 @@ private:
 			_tasks[position] = std::move(new_task);
 		}
 
+		/* Canceled tasks are discarded when they reach the top of the heap. */
+		void remove(task& task_to_remove [[maybe_unused]]) noexcept override
+		{
+		}
+
+		void pop_expired(absolute_time current_time,
+				 std::vector<task::sptr>& expired_tasks) override
+		{
+			while (!_tasks.empty() &&
+			       peek()->_get_next_scheduled_time() <= current_time) {
+				expired_tasks.emplace_back(pop());
+			}
+		}
+
+		nonstd::optional<absolute_time> next_wake_up_time() const noexcept override
+		{
+			if (_tasks.empty()) {
+				return nonstd::nullopt;
+			}
+
+			return peek()->_get_next_scheduled_time();
+		}
+
 		/* Peek at task with the nearest deadline. */
 		task *peek() const noexcept
 		{
@@ -395,10 +599,327 @@ private:
 		}
 
 		std::vector<task::sptr> _tasks;
-	} _task_heap;
+	};
+
+	/*
+	 * Hierarchical timing wheel (Varghese & Lauck).
+	 *
+	 * Time is divided in ticks of `resolution` nanoseconds. Each level of the wheel has
+	 * 64 slots; a slot of level `n` covers 64^n ticks. A task is linked in the slot of
+	 * the highest level at which the tick of its deadline differs from the current tick
+	 * of the wheel. As the wheel advances, a slot that becomes current is "cascaded":
+	 * its tasks are relinked in the lower levels until they land in the "due" list,
+	 * which holds the tasks whose deadline falls within the current tick.
+	 *
+	 * Occupancy bitmaps make it possible to skip empty slots, so advancing the wheel
+	 * over long idle periods costs O(levels).
+	 */
+	class timing_wheel final : public task_queue {
+	public:
+		explicit timing_wheel(duration_ns resolution) :
+			_resolution_ns(static_cast<std::uint64_t>(resolution.count()))
+		{
+			LTTNG_ASSERT(resolution.count() > 0);
+		}
+
+		~timing_wheel() override = default;
+
+		timing_wheel(const timing_wheel&) = delete;
+		timing_wheel(timing_wheel&&) = delete;
+		timing_wheel& operator=(const timing_wheel&) = delete;
+		timing_wheel& operator=(timing_wheel&&) = delete;
+
+		void insert(task::sptr new_task) override
+		{
+			if (new_task->_wheel_hook.linked) {
+				/* Rescheduling a queued task moves it to its new deadline. */
+				remove(*new_task);
+			}
+
+			const auto destination =
+				_location_of_tick(_tick_of(new_task->_get_next_scheduled_time()));
+			auto& destination_slot = _slot(destination);
+			auto& hook = new_task->_wheel_hook;
+
+			destination_slot.emplace_back(std::move(new_task));
+			hook.linked = true;
+			hook.level = destination.level;
+			hook.index = destination.index;
+			hook.position = std::prev(destination_slot.end());
+			_mark_occupied(destination);
+		}
+
+		void remove(task& task_to_remove) noexcept override
+		{
+			auto& hook = task_to_remove._wheel_hook;
+
+			if (!hook.linked) {
+				return;
+			}
+
+			const location source = { hook.level, hook.index };
+			auto& source_slot = _slot(source);
+
+			hook.linked = false;
+			/* May release the last reference to the task; don't touch it afterwards. */
+			source_slot.erase(hook.position);
+			_clear_if_empty(source);
+		}
+
+		void pop_expired(absolute_time current_time,
+				 std::vector<task::sptr>& expired_tasks) override
+		{
+			const auto first_expired_task_index = expired_tasks.size();
+
+			_advance(_tick_of(current_time));
+
+			for (auto it = _due.begin(); it != _due.end();) {
+				if ((*it)->_get_next_scheduled_time() > current_time) {
+					++it;
+					continue;
+				}
+
+				(*it)->_wheel_hook.linked = false;
+				expired_tasks.emplace_back(std::move(*it));
+				it = _due.erase(it);
+			}
+
+			/* Tasks are linked in insertion order; run them in deadline order. */
+			std::stable_sort(expired_tasks.begin() + first_expired_task_index,
+					 expired_tasks.end(),
+					 [](const task::sptr& a, const task::sptr& b) {
+						 return a->_get_next_scheduled_time() <
+							 b->_get_next_scheduled_time();
+					 });
+		}
+
+		nonstd::optional<absolute_time> next_wake_up_time() const noexcept override
+		{
+			if (!_due.empty()) {
+				/* The due list only contains tasks of the current tick. */
+				auto earliest_deadline = _due.front()->_get_next_scheduled_time();
+
+				for (const auto& due_task : _due) {
+					earliest_deadline =
+						std::min(earliest_deadline,
+							 due_task->_get_next_scheduled_time());
+				}
+
+				return earliest_deadline;
+			}
+
+			const auto next_cascade_tick = _next_cascade_tick();
+			if (!next_cascade_tick) {
+				return nonstd::nullopt;
+			}
+
+			return absolute_time(duration_ns(*next_cascade_tick * _resolution_ns));
+		}
+
+	private:
+		enum : unsigned int {
+			SLOT_BITS = 6,
+			SLOTS_PER_LEVEL = 1U << SLOT_BITS,
+			LEVEL_COUNT = 6,
+			/* Pseudo-levels used to address the due and overflow lists. */
+			DUE_LEVEL = LEVEL_COUNT,
+			OVERFLOW_LEVEL = LEVEL_COUNT + 1,
+		};
+
+		using slot = std::list<task::sptr>;
+
+		struct location {
+			unsigned int level;
+			unsigned int index;
+		};
+
+		std::uint64_t _tick_of(absolute_time time) const noexcept
+		{
+			const auto time_ns = time.time_since_epoch().count();
+
+			if (time_ns <= 0) {
+				return 0;
+			}
+
+			return static_cast<std::uint64_t>(time_ns) / _resolution_ns;
+		}
+
+		unsigned int _index_at_level(std::uint64_t tick, unsigned int level) const noexcept
+		{
+			return (tick >> (level * SLOT_BITS)) & (SLOTS_PER_LEVEL - 1);
+		}
+
+		location _location_of_tick(std::uint64_t tick) const noexcept
+		{
+			if (tick <= _current_tick) {
+				return { DUE_LEVEL, 0 };
+			}
+
+			/* Highest level at which the deadline and the current tick differ. */
+			const auto differing_bits = tick ^ _current_tick;
+			const auto highest_differing_bit =
+				63U - static_cast<unsigned int>(__builtin_clzll(differing_bits));
+			const auto level = highest_differing_bit / SLOT_BITS;
+
+			if (level >= LEVEL_COUNT) {
+				return { OVERFLOW_LEVEL, 0 };
+			}
+
+			return { level, _index_at_level(tick, level) };
+		}
+
+		slot& _slot(const location& slot_location) noexcept
+		{
+			switch (slot_location.level) {
+			case DUE_LEVEL:
+				return _due;
+			case OVERFLOW_LEVEL:
+				return _overflow;
+			default:
+				return _levels[slot_location.level][slot_location.index];
+			}
+		}
+
+		void _mark_occupied(const location& slot_location) noexcept
+		{
+			if (slot_location.level < LEVEL_COUNT) {
+				_occupied_slots[slot_location.level] |= UINT64_C(1)
+					<< slot_location.index;
+			}
+		}
+
+		void _clear_if_empty(const location& slot_location) noexcept
+		{
+			if (slot_location.level < LEVEL_COUNT &&
+			    _levels[slot_location.level][slot_location.index].empty()) {
+				_occupied_slots[slot_location.level] &=
+					~(UINT64_C(1) << slot_location.index);
+			}
+		}
+
+		/*
+		 * Tick at which the next non-empty slot becomes current and must be cascaded.
+		 * Only slots "after" the current index of each level can be occupied.
+		 */
+		nonstd::optional<std::uint64_t> _next_cascade_tick() const noexcept
+		{
+			nonstd::optional<std::uint64_t> next_tick;
+
+			for (unsigned int level = 0; level < LEVEL_COUNT; level++) {
+				const auto current_index = _index_at_level(_current_tick, level);
+
+				if (current_index == SLOTS_PER_LEVEL - 1) {
+					continue;
+				}
+
+				const auto pending_slots = _occupied_slots[level] &
+					(~UINT64_C(0) << (current_index + 1));
+				if (!pending_slots) {
+					continue;
+				}
+
+				const auto group_shift = (level + 1) * SLOT_BITS;
+				const auto slot_index =
+					static_cast<std::uint64_t>(__builtin_ctzll(pending_slots));
+				const auto group_start_tick = (_current_tick >> group_shift)
+					<< group_shift;
+				const auto slot_tick = group_start_tick |
+					(slot_index << (level * SLOT_BITS));
+
+				if (!next_tick || slot_tick < *next_tick) {
+					next_tick = slot_tick;
+				}
+			}
+
+			if (!_overflow.empty()) {
+				/* Tick at which the top level wraps around. */
+				const auto wrap_shift = LEVEL_COUNT * SLOT_BITS;
+				const auto wrap_tick = ((_current_tick >> wrap_shift) + 1)
+					<< wrap_shift;
+
+				if (!next_tick || wrap_tick < *next_tick) {
+					next_tick = wrap_tick;
+				}
+			}
+
+			return next_tick;
+		}
+
+		/* Relink all the tasks of a slot according to the current tick. */
+		void _cascade(const location& source) noexcept
+		{
+			/*
+			 * Detach the slot's tasks first since a task of the overflow list can be
+			 * relinked into it.
+			 */
+			slot source_slot;
+
+			source_slot.splice(source_slot.end(), _slot(source));
+			_clear_if_empty(source);
+
+			while (!source_slot.empty()) {
+				const auto it = source_slot.begin();
+				auto& hook = (*it)->_wheel_hook;
+				const auto tick = _tick_of((*it)->_get_next_scheduled_time());
+				const auto destination = _location_of_tick(tick);
+				auto& destination_slot = _slot(destination);
+
+				/* Splicing doesn't invalidate the hook's iterator. */
+				destination_slot.splice(destination_slot.end(), source_slot, it);
+				hook.level = destination.level;
+				hook.index = destination.index;
+				_mark_occupied(destination);
+			}
+		}
+
+		void _advance(std::uint64_t target_tick) noexcept
+		{
+			while (_current_tick < target_tick) {
+				const auto next_cascade_tick = _next_cascade_tick();
+
+				if (!next_cascade_tick || *next_cascade_tick > target_tick) {
+					/* No slot becomes current before the target tick. */
+					_current_tick = target_tick;
+					return;
+				}
+
+				_current_tick = *next_cascade_tick;
+
+				/*
+				 * Cascade from the highest level down; tasks are always relinked
+				 * at a lower level, in slots that are not current.
+				 */
+				const auto wheel_span_mask =
+					(UINT64_C(1) << (LEVEL_COUNT * SLOT_BITS)) - 1;
+
+				if ((_current_tick & wheel_span_mask) == 0) {
+					_cascade({ OVERFLOW_LEVEL, 0 });
+				}
+
+				for (unsigned int level = LEVEL_COUNT; level-- > 0;) {
+					const location current_slot = {
+						level, _index_at_level(_current_tick, level)
+					};
+
+					const auto slot_mask = UINT64_C(1) << current_slot.index;
+
+					if (_occupied_slots[level] & slot_mask) {
+						_cascade(current_slot);
+					}
+				}
+			}
+		}
+
+		const std::uint64_t _resolution_ns;
+		std::uint64_t _current_tick = 0;
+		std::array<std::array<slot, SLOTS_PER_LEVEL>, LEVEL_COUNT> _levels;
+		std::array<std::uint64_t, LEVEL_COUNT> _occupied_slots{};
+		slot _due;
+		slot _overflow;
+	};
+
+	std::unique_ptr<task_queue> _task_queue;
 
-	/* Initialized to epoch. */
-	absolute_time _last_tick;
 	std::mutex _mutex;
 	std::vector<task_scheduled_callback> _task_scheduled_callbacks;
 };
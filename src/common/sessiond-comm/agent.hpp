@@ -26,6 +26,8 @@ enum lttcomm_agent_command {
 	AGENT_CMD_REG_DONE = 4, /* End registration process. */
 	AGENT_CMD_APP_CTX_ENABLE = 5,
 	AGENT_CMD_APP_CTX_DISABLE = 6,
+	/* Since protocol version 2.1. */
+	AGENT_CMD_APPLY_RULE_SET = 7,
 };
 
 /*
@@ -68,6 +70,20 @@ struct lttcomm_agent_disable_event {
 	char name[LTTNG_SYMBOL_NAME_LEN];
 } LTTNG_PACKED;
 
+/*
+ * Apply rule set command payload. Will be immediately followed by
+ * `event_count` enable event command payloads (each followed by its filter
+ * expression) and by `app_ctx_count` application contexts, each made of the
+ * provider name and context name as Pascal-style strings.
+ *
+ * On success, the generic reply is followed by one 32-bit return code per
+ * event and then one per application context, in the order of the payload.
+ */
+struct lttcomm_agent_apply_rule_set {
+	uint32_t event_count;
+	uint32_t app_ctx_count;
+} LTTNG_PACKED;
+
 /*
  * Generic reply coming from the agent.
  */
@@ -22,7 +22,7 @@
 #include <stdint.h>
 
 #define RELAYD_VERSION_COMM_MAJOR VERSION_MAJOR
-#define RELAYD_VERSION_COMM_MINOR 15
+#define RELAYD_VERSION_COMM_MINOR 16
 
 #define RELAYD_COMM_LTTNG_HOST_NAME_MAX_2_4 64
 #define RELAYD_COMM_LTTNG_NAME_MAX_2_4	    255
@@ -88,6 +88,20 @@ struct lttcomm_relayd_add_stream_2_11 {
 	char names[LTTNG_FLEXIBLE_ARRAY_MEMBER_LENGTH];
 } LTTNG_PACKED;
 
+/*
+ * Protocol version 2.16: a 2.11 message preceded by the codec used to
+ * compress the stream's packets (lttng::compression::codec_type).
+ */
+struct lttcomm_relayd_add_stream_2_16 {
+	uint8_t compression_codec;
+	uint32_t channel_name_len;
+	uint32_t pathname_len;
+	uint64_t tracefile_size;
+	uint64_t tracefile_count;
+	uint64_t trace_chunk_id;
+	char names[LTTNG_FLEXIBLE_ARRAY_MEMBER_LENGTH];
+} LTTNG_PACKED;
+
 /*
  * Answer from an add stream command.
  */
@@ -164,6 +178,9 @@ struct lttcomm_relayd_index {
 	/* 2.8+ */
 	uint64_t stream_instance_id;
 	uint64_t packet_seq_num;
+	/* 2.16+ */
+	uint64_t stored_size;
+	uint8_t compression_codec;
 } LTTNG_PACKED;
 
 static inline size_t lttcomm_relayd_index_len(uint32_t major, uint32_t minor)
@@ -176,6 +193,9 @@ static inline size_t lttcomm_relayd_index_len(uint32_t major, uint32_t minor)
 		case 1:
 			return offsetof(struct lttcomm_relayd_index, packet_seq_num) +
 				member_sizeof(struct lttcomm_relayd_index, packet_seq_num);
+		case 2:
+			return offsetof(struct lttcomm_relayd_index, compression_codec) +
+				member_sizeof(struct lttcomm_relayd_index, compression_codec);
 		default:
 			abort();
 		}
@@ -183,6 +203,20 @@ static inline size_t lttcomm_relayd_index_len(uint32_t major, uint32_t minor)
 	abort();
 }
 
+/*
+ * Length of the index message of a given relay protocol version. From 2.16,
+ * the message carries the fields of the compressed packets' index.
+ */
+static inline size_t lttcomm_relayd_index_msg_len(uint32_t relayd_major, uint32_t relayd_minor)
+{
+	const uint32_t index_minor = relayd_minor >= 16 ?
+		CTF_INDEX_COMPRESSED_MINOR :
+		lttng_to_index_minor(relayd_major, relayd_minor);
+
+	return lttcomm_relayd_index_len(lttng_to_index_major(relayd_major, relayd_minor),
+					index_minor);
+}
+
 /*
  * Create session in 2.4 adds additionnal parameters for live reading.
  */
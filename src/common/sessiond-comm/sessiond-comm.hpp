@@ -103,6 +103,9 @@ enum lttcomm_sessiond_command {
 	LTTCOMM_SESSIOND_COMMAND_KERNEL_TRACER_STATUS,
 	LTTCOMM_SESSIOND_COMMAND_RECLAIM_CHANNEL_MEMORY,
 	LTTCOMM_SESSIOND_COMMAND_GET_CHANNEL_DATA_STREAM_INFO_SETS,
+	LTTCOMM_SESSIOND_COMMAND_ENABLE_PERSISTENT_CONNECTION,
+	LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_ADD_INCLUDE_VALUES,
+	LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_REMOVE_INCLUDE_VALUES,
 	LTTCOMM_SESSIOND_COMMAND_MAX,
 };
 
@@ -206,6 +209,12 @@ static inline const char *lttcomm_sessiond_command_str(enum lttcomm_sessiond_com
 		return "RECLAIM_CHANNEL_MEMORY";
 	case LTTCOMM_SESSIOND_COMMAND_GET_CHANNEL_DATA_STREAM_INFO_SETS:
 		return "GET_CHANNEL_DATA_STREAM_INFO_SETS";
+	case LTTCOMM_SESSIOND_COMMAND_ENABLE_PERSISTENT_CONNECTION:
+		return "ENABLE_PERSISTENT_CONNECTION";
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_ADD_INCLUDE_VALUES:
+		return "PROCESS_ATTR_TRACKER_ADD_INCLUDE_VALUES";
+	case LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_REMOVE_INCLUDE_VALUES:
+		return "PROCESS_ATTR_TRACKER_REMOVE_INCLUDE_VALUES";
 	default:
 		abort();
 	}
@@ -525,6 +534,12 @@ enum lttng_consumer_command : std::uint8_t {
 	LTTNG_CONSUMER_RECLAIM_SESSION_OWNER_ID,
 	LTTNG_CONSUMER_GET_CHANNELS_MEMORY_USAGE,
 	LTTNG_CONSUMER_RECLAIM_CHANNELS_MEMORY,
+	LTTNG_CONSUMER_GET_CHANNEL_COMPRESSION_STATS,
+	LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS,
+	/* Batched variants of ASK_CHANNEL_CREATION and GET_CHANNEL. */
+	LTTNG_CONSUMER_ASK_CHANNELS_CREATION,
+	LTTNG_CONSUMER_GET_CHANNELS,
+	LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS,
 };
 
 /*
@@ -634,6 +649,21 @@ struct formatter<lttng_consumer_command> : formatter<std::string> {
 		case LTTNG_CONSUMER_RECLAIM_CHANNELS_MEMORY:
 			name = "RECLAIM_CHANNELS_MEMORY";
 			break;
+		case LTTNG_CONSUMER_GET_CHANNEL_COMPRESSION_STATS:
+			name = "GET_CHANNEL_COMPRESSION_STATS";
+			break;
+		case LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS:
+			name = "GET_SESSION_CHANNELS_RUNTIME_STATS";
+			break;
+		case LTTNG_CONSUMER_ASK_CHANNELS_CREATION:
+			name = "ASK_CHANNELS_CREATION";
+			break;
+		case LTTNG_CONSUMER_GET_CHANNELS:
+			name = "GET_CHANNELS";
+			break;
+		case LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS:
+			name = "GET_SESSION_STREAMS_IO_STATS";
+			break;
 		}
 
 		return format_to(ctx.out(), name);
@@ -806,6 +836,18 @@ struct lttcomm_session_msg {
 			 */
 			uint32_t name_len;
 		} LTTNG_PACKED process_attr_tracker_add_remove_include_value;
+		struct {
+			/* enum lttng_process_attr */
+			int32_t process_attr;
+			/*
+			 * Size of the serialized set of values that follows
+			 * (see lttng_process_attr_values_serialize()).
+			 *
+			 * The reply holds one int32_t lttng_error_code per
+			 * value, in the order of the set.
+			 */
+			uint32_t length;
+		} LTTNG_PACKED process_attr_tracker_add_remove_include_values;
 		struct {
 			/* enum lttng_process_attr */
 			int32_t process_attr;
@@ -863,8 +905,26 @@ struct lttcomm_session_msg {
 	uint32_t fd_count;
 } LTTNG_PACKED;
 
-#define LTTNG_FILTER_MAX_LEN		 65536
-#define LTTNG_SESSION_DESCRIPTOR_MAX_LEN 65536
+#define LTTNG_FILTER_MAX_LEN		  65536
+#define LTTNG_SESSION_DESCRIPTOR_MAX_LEN  65536
+#define LTTNG_PROCESS_ATTR_VALUES_MAX_LEN 1048576
+#define LTTNG_SESSION_MSG_DATA_MAX_LEN	  16777216
+
+/*
+ * Header preceding each command sent on a persistent connection, once the
+ * LTTCOMM_SESSIOND_COMMAND_ENABLE_PERSISTENT_CONNECTION command succeeded.
+ * The credentials of the client are sent along with this header.
+ *
+ * The session daemon receives a whole command before processing it, so that
+ * the connection remains usable when a command fails before consuming its
+ * variable length data.
+ */
+struct lttcomm_session_msg_frame {
+	/* Size of the variable length data following the lttcomm_session_msg. */
+	uint64_t data_size;
+	/* Count of fds sent after the variable length data. */
+	uint32_t fd_count;
+} LTTNG_PACKED;
 
 /*
  * Filter bytecode data. The reloc table is located at the end of the
@@ -1071,6 +1131,8 @@ struct lttcomm_consumer_msg {
 			char shm_path[PATH_MAX];
 			/* trace format (enum lttng_trace_format) */
 			uint8_t trace_format;
+			/* Packet compression codec (lttng::compression::codec_type) */
+			uint8_t compression_codec;
 		} LTTNG_PACKED ask_channel;
 		struct {
 			uint64_t key;
@@ -1192,6 +1254,23 @@ struct lttcomm_consumer_msg {
 			/* Token for async completion tracking. */
 			uint64_t memory_reclaim_request_token;
 		} LTTNG_PACKED reclaim_channels_memory;
+		struct {
+			uint64_t session_id;
+			uint64_t channel_key;
+		} LTTNG_PACKED channel_compression_stats;
+		struct {
+			uint64_t session_id;
+		} LTTNG_PACKED get_session_channels_runtime_stats;
+		struct {
+			/* Number of ASK_CHANNEL_CREATION messages in payload. */
+			uint64_t channel_count;
+		} LTTNG_PACKED ask_channels_creation;
+		struct {
+			uint64_t key_count; /* Number of keys in payload. */
+		} LTTNG_PACKED get_channels;
+		struct {
+			uint64_t session_id;
+		} LTTNG_PACKED get_session_streams_io_stats;
 	} u;
 } LTTNG_PACKED;
 
@@ -1255,6 +1334,69 @@ struct lttcomm_consumer_status_channel {
 	unsigned int stream_count;
 } LTTNG_PACKED;
 
+/*
+ * Packet compression statistics of a channel, returned to the session daemon
+ * in reply to LTTNG_CONSUMER_GET_CHANNEL_COMPRESSION_STATS.
+ */
+struct lttcomm_consumer_channel_compression_stats {
+	/* Size of the packets before compression, in bytes. */
+	uint64_t input_bytes;
+	/* Size of the packets written to the trace, in bytes. */
+	uint64_t output_bytes;
+	/* CPU time spent compressing packets, in nanoseconds. */
+	uint64_t cpu_time_ns;
+} LTTNG_PACKED;
+
+/*
+ * Runtime statistics of a channel, returned to the session daemon in reply to
+ * LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS.
+ */
+struct lttcomm_channel_runtime_stats {
+	uint64_t channel_key;
+	uint64_t discarded_events;
+	uint64_t lost_packets;
+	struct lttcomm_consumer_channel_compression_stats compression;
+} LTTNG_PACKED;
+
+struct lttcomm_consumer_session_channels_runtime_stats_reply_header {
+	uint32_t count;
+	/* A set of lttcomm_channel_runtime_stats follows. */
+} LTTNG_PACKED;
+
+/*
+ * Summary of a duration histogram of a stream. All durations are in
+ * nanoseconds; the percentiles are the upper bounds of their histogram bucket.
+ */
+struct lttcomm_duration_stats {
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t p50_ns;
+	uint64_t p99_ns;
+	uint64_t max_ns;
+} LTTNG_PACKED;
+
+/*
+ * I/O statistics of a data stream, returned to the session daemon in reply to
+ * LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS.
+ */
+struct lttcomm_stream_io_stats {
+	uint64_t channel_key;
+	uint64_t stream_key;
+	int32_t cpu;
+	uint64_t written_bytes;
+	/* Time from the acquisition of a sub-buffer to its release. */
+	struct lttcomm_duration_stats subbuffer_consumption;
+	/* Duration of each write() call or splice() iteration. */
+	struct lttcomm_duration_stats write;
+	/* Transmission of each packet to a relay daemon. */
+	struct lttcomm_duration_stats relayd_send;
+} LTTNG_PACKED;
+
+struct lttcomm_consumer_session_streams_io_stats_reply_header {
+	uint32_t count;
+	/* A set of lttcomm_stream_io_stats follows. */
+} LTTNG_PACKED;
+
 struct lttcomm_consumer_close_trace_chunk_reply {
 	enum lttcomm_return_code ret_code;
 	uint32_t path_length;
@@ -5,12 +5,16 @@
  */
 
 #include <common/error.hpp>
+#include <common/make-unique.hpp>
 #include <common/task-executor.hpp>
 #include <common/urcu.hpp>
 
-lttng::scheduling::task_executor::task_executor(scheduler& scheduler) :
+lttng::scheduling::task_executor::task_executor(scheduler& scheduler,
+						     unsigned int worker_count) :
 	_scheduler(scheduler), _wake_eventfd(true)
 {
+	LTTNG_ASSERT(worker_count > 0);
+
 	_scheduler.add_task_scheduled_callback(
 		[this](lttng::scheduling::absolute_time next_task_time [[maybe_unused]]) {
 			/* Wake-up to re-evaluate the nearest deadline. */
@@ -49,6 +53,17 @@ lttng::scheduling::task_executor::task_executor(scheduler& scheduler) :
 			    }
 		    });
 
+	/* With a single worker, tasks are run directly by the executor's thread. */
+	if (worker_count > 1) {
+		for (unsigned int i = 0; i < worker_count; i++) {
+			_workers.emplace_back(lttng::make_unique<worker>());
+		}
+
+		for (unsigned int i = 0; i < worker_count; i++) {
+			_workers[i]->thread = std::thread(&task_executor::_run_worker, this, i);
+		}
+	}
+
 	_thread = std::thread(&task_executor::_run, this);
 	_launch_waiter.wait();
 }
@@ -68,12 +83,19 @@ void lttng::scheduling::task_executor::_run() noexcept
 	_is_active.store(true);
 	_launch_waiter.get_waker().wake();
 
-	DBG_FMT("Task executor thread started, waiting for tasks");
+	DBG_FMT("Task executor thread started, waiting for tasks: worker_count={}",
+		worker_count());
+
+	const scheduler::task_dispatcher dispatcher =
+		[this](scheduler::dispatched_task task) { _dispatch(std::move(task)); };
 
 	while (_is_active.load()) {
 		_poller.poll(lttng::poller::timeout_type::WAIT_FOREVER);
 
-		const auto next_task_delay = _scheduler.tick(std::chrono::steady_clock::now());
+		const auto current_time = std::chrono::steady_clock::now();
+		const auto next_task_delay = _workers.empty() ?
+			_scheduler.tick(current_time) :
+			_scheduler.tick(current_time, dispatcher);
 		if (next_task_delay) {
 			/* Arm the timerfd to wake up when the next task is due. */
 			_wake_timerfd.settime(*next_task_delay);
@@ -83,6 +105,82 @@ void lttng::scheduling::task_executor::_run() noexcept
 	DBG_FMT("Task executor thread exiting");
 }
 
+void lttng::scheduling::task_executor::_run_worker(unsigned int worker_index) noexcept
+{
+	const lttng::urcu::scoped_thread_registration rcu_thread_registration;
+
+	logger_set_thread_name("Timer task worker", true);
+	DBG_FMT("Task executor worker thread started: worker_index={}", worker_index);
+
+	while (!_workers_must_quit.load()) {
+		scheduler::dispatched_task task;
+
+		if (_try_get_task(worker_index, task)) {
+			_scheduler.run(std::move(task));
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_idle_workers_lock);
+		_task_available.wait(lock, [this]() {
+			return _workers_must_quit.load() || _queued_task_count.load() > 0;
+		});
+	}
+
+	DBG_FMT("Task executor worker thread exiting: worker_index={}", worker_index);
+}
+
+void lttng::scheduling::task_executor::_dispatch(scheduler::dispatched_task task) noexcept
+{
+	auto& target_worker = *_workers[_next_worker_index];
+
+	_next_worker_index = (_next_worker_index + 1) % _workers.size();
+
+	try {
+		const std::lock_guard<std::mutex> lock(target_worker.lock);
+
+		target_worker.queue.emplace_back(std::move(task));
+	} catch (const std::bad_alloc&) {
+		/* Run the task on the executor's thread rather than dropping it. */
+		ERR_FMT("Failed to queue task on a worker, running it on the executor thread: name=`{}`",
+			task.get_task().name());
+		_scheduler.run(std::move(task));
+		return;
+	}
+
+	{
+		/* Hold the lock to not miss a worker about to wait. */
+		const std::lock_guard<std::mutex> lock(_idle_workers_lock);
+
+		_queued_task_count++;
+	}
+
+	_task_available.notify_one();
+}
+
+bool lttng::scheduling::task_executor::_try_get_task(unsigned int worker_index,
+						     scheduler::dispatched_task& task) noexcept
+{
+	/*
+	 * Start with the worker's own queue, then steal from the other workers. The oldest
+	 * task of a queue is always taken first to minimize lateness.
+	 */
+	for (unsigned int i = 0; i < _workers.size(); i++) {
+		auto& candidate_worker = *_workers[(worker_index + i) % _workers.size()];
+		const std::lock_guard<std::mutex> lock(candidate_worker.lock);
+
+		if (candidate_worker.queue.empty()) {
+			continue;
+		}
+
+		task = std::move(candidate_worker.queue.front());
+		candidate_worker.queue.pop_front();
+		_queued_task_count--;
+		return true;
+	}
+
+	return false;
+}
+
 void lttng::scheduling::task_executor::_wake() noexcept
 {
 	if (_thread.get_id() == std::this_thread::get_id()) {
@@ -106,4 +204,20 @@ void lttng::scheduling::task_executor::stop()
 	/* Wake the thread to make sure it sees it should exit. */
 	_wake();
 	_thread.join();
+
+	if (_workers.empty()) {
+		return;
+	}
+
+	/* Tasks that are still queued are discarded. */
+	{
+		const std::lock_guard<std::mutex> lock(_idle_workers_lock);
+
+		_workers_must_quit.store(true);
+	}
+
+	_task_available.notify_all();
+	for (auto& worker : _workers) {
+		worker->thread.join();
+	}
 }
@@ -14,14 +14,31 @@
 #include <common/waiter.hpp>
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 namespace lttng {
 namespace scheduling {
+/*
+ * Runs the tasks of a scheduler as they expire.
+ *
+ * A dedicated thread waits for the deadline of the next task. With a single worker, the
+ * expired tasks are run on that thread. Otherwise, they are handed over to a pool of
+ * worker threads so that a slow task doesn't delay the other tasks that expire at the
+ * same time.
+ *
+ * Each worker thread has its own queue of tasks; a worker that runs out of tasks steals
+ * the oldest task queued for another (busy) worker. A task is never run concurrently
+ * with itself: a periodic task is only rescheduled once its current run is completed.
+ */
 class task_executor final {
 public:
-	explicit task_executor(scheduler& scheduler);
+	explicit task_executor(scheduler& scheduler, unsigned int worker_count = 1);
 	~task_executor();
 
 	task_executor(const task_executor&) = delete;
@@ -29,11 +46,29 @@ public:
 	task_executor(task_executor&&) = delete;
 	task_executor& operator=(task_executor&&) = delete;
 
-	/* Signal the thread to stop and join it. */
+	/* Signal the threads to stop and join them. */
 	void stop();
 
+	unsigned int worker_count() const noexcept
+	{
+		return _workers.empty() ? 1 : static_cast<unsigned int>(_workers.size());
+	}
+
 private:
+	struct worker {
+		std::mutex lock;
+		std::deque<scheduler::dispatched_task> queue;
+		std::thread thread;
+	};
+
 	void _run() noexcept;
+	void _run_worker(unsigned int worker_index) noexcept;
+
+	/* Queue an expired task on a worker's queue. */
+	void _dispatch(scheduler::dispatched_task task) noexcept;
+
+	/* Pop a task from a worker's queue or steal one from another worker. */
+	bool _try_get_task(unsigned int worker_index, scheduler::dispatched_task& task) noexcept;
 
 	/* Wake up the thread (e.g., when a new task is scheduled) */
 	void _wake() noexcept;
@@ -45,6 +80,17 @@ private:
 	lttng::timerfd _wake_timerfd;
 	lttng::poller _poller;
 	lttng::synchro::waiter _launch_waiter;
+
+	/* Empty when the tasks are run by the executor's thread. */
+	std::vector<std::unique_ptr<worker>> _workers;
+	/* Round-robin dispatch position; only used by the executor's thread. */
+	unsigned int _next_worker_index = 0;
+
+	/* Protects the idle workers' sleep on `_task_available`. */
+	std::mutex _idle_workers_lock;
+	std::condition_variable _task_available;
+	std::atomic<std::size_t> _queued_task_count{ 0 };
+	std::atomic<bool> _workers_must_quit{ false };
 };
 } /* namespace scheduling */
 } /* namespace lttng */
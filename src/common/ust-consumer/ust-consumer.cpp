@@ -17,6 +17,7 @@
 #include <common/align.hpp>
 #include <common/common.hpp>
 #include <common/compat/endian.hpp>
+#include <common/compression/codec.hpp>
 #include <common/consumer/consumer-channel.hpp>
 #include <common/consumer/consumer-metadata-cache.hpp>
 #include <common/consumer/consumer-stream.hpp>
@@ -1405,6 +1406,56 @@ end:
 	return ret;
 }
 
+static unsigned long get_current_consumed_position(lttng_consumer_stream& stream)
+{
+	unsigned long consumed_pos = 0;
+	const auto snapshot_ret = lttng_consumer_sample_snapshot_positions(&stream);
+
+	if (snapshot_ret < 0 && snapshot_ret != -ENODATA && snapshot_ret != -EAGAIN) {
+		LTTNG_THROW_ERROR(fmt::format(
+			"Failed to take position snapshot of stream: channel_name=`{}`, stream_key={}, error={}",
+			stream.chan->name,
+			stream.key,
+			snapshot_ret));
+	}
+
+	const auto consumed_ret = lttng_consumer_get_consumed_snapshot(&stream, &consumed_pos);
+	if (consumed_ret < 0) {
+		LTTNG_THROW_ERROR(fmt::format(
+			"Failed to get consumed position of stream: channel_name=`{}`, stream_key={}, error={}",
+			stream.chan->name,
+			stream.key,
+			consumed_ret));
+	}
+
+	return consumed_pos;
+}
+
+static unsigned long get_current_produced_position(lttng_consumer_stream& stream)
+{
+	unsigned long produced_pos = 0;
+	const auto snapshot_ret = lttng_consumer_sample_snapshot_positions(&stream);
+
+	if (snapshot_ret < 0 && snapshot_ret != -ENODATA && snapshot_ret != -EAGAIN) {
+		LTTNG_THROW_ERROR(fmt::format(
+			"Failed to take position snapshot of stream: channel_name=`{}`, stream_key={}, error={}",
+			stream.chan->name,
+			stream.key,
+			snapshot_ret));
+	}
+
+	const auto produced_ret = lttng_consumer_get_produced_snapshot(&stream, &produced_pos);
+	if (produced_ret < 0) {
+		LTTNG_THROW_ERROR(fmt::format(
+			"Failed to get produced position of stream: channel_name=`{}`, stream_key={}, error={}",
+			stream.chan->name,
+			stream.key,
+			produced_ret));
+	}
+
+	return produced_pos;
+}
+
 template <typename ReportFn>
 static void report_channel_memory_usage_by_streams_fstat(const lttng_consumer_channel& channel,
 							 ReportFn&& report)
@@ -1431,19 +1482,28 @@ static void report_channel_memory_usage_by_streams_fstat(const lttng_consumer_ch
 }
 
 #ifdef __linux__
+/*
+ * Report the resident memory of each stream's backend area.
+ *
+ * The samples are cached by each stream's sampler: a stream whose last
+ * sample is fresh enough is not examined at all and, otherwise, only the
+ * parts of its buffer that may have changed since the last sample are
+ * scanned.
+ */
 template <typename ReportFn>
 static void report_channel_memory_usage_by_streams_mincore(lttng_consumer_channel& channel,
 							   ReportFn&& report)
 {
-	const long maybe_page_size = sysconf(_SC_PAGESIZE);
+	const auto now = lttng::memory_usage_sampler::clock::now();
 
-	if (maybe_page_size < 0) {
-		LTTNG_THROW_POSIX("Failed to call sysconf(_SC_PAGESIZE)", errno);
-	}
+	for (auto& stream : channel.get_streams()) {
+		const auto fresh_sample = stream.memory_usage_sampler.get_fresh_sample(now);
 
-	const std::size_t page_size = static_cast<std::size_t>(maybe_page_size);
+		if (fresh_sample) {
+			report(fresh_sample->logical_size, fresh_sample->physical_size);
+			continue;
+		}
 
-	for (const auto& stream : channel.get_streams()) {
 		void *backend_addr;
 		unsigned long backend_size;
 		const auto get_area_ret = lttng_ust_ctl_stream_get_backend_area(
@@ -1455,72 +1515,20 @@ static void report_channel_memory_usage_by_streams_mincore(lttng_consumer_channe
 		}
 
 		/*
-		 * mincore(2): The `addr` argument must be a multiple of the
-		 * system page size.
+		 * The produced position changes whenever the buffer is written
+		 * to. Sampling it modifies the stream's position snapshot.
 		 */
-		LTTNG_ASSERT(
-			lttng_align_floor(reinterpret_cast<uintptr_t>(backend_addr), page_size) ==
-			reinterpret_cast<uintptr_t>(backend_addr));
-
-		/*
-		 * mincore(2): The `length` argument need not be a multiple of
-		 * the page size.
-		 */
-		backend_size = lttng_align_ceil(backend_size, page_size);
-
-		/*
-		 * mincore(2): The `vec` argument must point to an array
-		 * containing at least `(length+PAGE_SIZE-1) / PAGE_SIZE` bytes.
-		 *
-		 * To avoid dynamic allocation, process the ring-buffer in
-		 * batches of 4096 pages.
-		 */
-		unsigned char vec[4096];
-		const std::size_t total_page_count = backend_size / page_size;
-		const std::size_t loop_count = total_page_count / sizeof(vec);
-		const std::size_t rest = total_page_count % sizeof(vec);
-		char *current_addr = static_cast<char *>(backend_addr);
-
-		const auto report_mincore = [&vec, &report, &current_addr, page_size](
-						    const std::size_t page_count) {
-			const std::uint64_t logical_size = page_size * page_count;
-			const int result = ::mincore(current_addr, logical_size, vec);
-
-			std::uint64_t physical_size;
-			if (result == 0) {
-				physical_size = 0;
-				for (std::size_t j = 0; j < page_count; ++j) {
-					/*
-					 * mincore(2): On return, the least
-					 * significant bit of each byte will be
-					 * set if the corresponding page is
-					 * currently resident in memory, and be
-					 * clear otherwise.
-					 */
-					if (vec[j] & 1) {
-						physical_size += page_size;
-					}
-				}
-			} else {
-				/*
-				 * Something bad happened; assume full
-				 * physical memory usage.
-				 */
-				PWARN_FMT("Failed to determine memory usage using mincore()");
-				physical_size = logical_size;
-			}
-
-			report(logical_size, physical_size);
-			current_addr += logical_size;
-		};
+		unsigned long produced_pos;
+		{
+			const lttng::pthread::lock_guard stream_lock(stream.lock);
 
-		for (std::size_t i = 0; i < loop_count; ++i) {
-			report_mincore(sizeof(vec));
+			produced_pos = get_current_produced_position(stream);
 		}
 
-		if (rest > 0) {
-			report_mincore(rest);
-		}
+		const auto sample = stream.memory_usage_sampler.get_sample(
+			backend_addr, backend_size, produced_pos, now);
+
+		report(sample.logical_size, sample.physical_size);
 	}
 }
 
@@ -1692,56 +1700,6 @@ static void destroy_subbuf_iter(lttng_ust_ctl_subbuf_iter *it)
 	LTTNG_ASSERT(ret == 0);
 }
 
-static unsigned long get_current_consumed_position(lttng_consumer_stream& stream)
-{
-	unsigned long consumed_pos = 0;
-	const auto snapshot_ret = lttng_consumer_sample_snapshot_positions(&stream);
-
-	if (snapshot_ret < 0 && snapshot_ret != -ENODATA && snapshot_ret != -EAGAIN) {
-		LTTNG_THROW_ERROR(fmt::format(
-			"Failed to take position snapshot of stream: channel_name=`{}`, stream_key={}, error={}",
-			stream.chan->name,
-			stream.key,
-			snapshot_ret));
-	}
-
-	const auto consumed_ret = lttng_consumer_get_consumed_snapshot(&stream, &consumed_pos);
-	if (consumed_ret < 0) {
-		LTTNG_THROW_ERROR(fmt::format(
-			"Failed to get consumed position of stream: channel_name=`{}`, stream_key={}, error={}",
-			stream.chan->name,
-			stream.key,
-			consumed_ret));
-	}
-
-	return consumed_pos;
-}
-
-static unsigned long get_current_produced_position(lttng_consumer_stream& stream)
-{
-	unsigned long produced_pos = 0;
-	const auto snapshot_ret = lttng_consumer_sample_snapshot_positions(&stream);
-
-	if (snapshot_ret < 0 && snapshot_ret != -ENODATA && snapshot_ret != -EAGAIN) {
-		LTTNG_THROW_ERROR(fmt::format(
-			"Failed to take position snapshot of stream: channel_name=`{}`, stream_key={}, error={}",
-			stream.chan->name,
-			stream.key,
-			snapshot_ret));
-	}
-
-	const auto produced_ret = lttng_consumer_get_produced_snapshot(&stream, &produced_pos);
-	if (produced_ret < 0) {
-		LTTNG_THROW_ERROR(fmt::format(
-			"Failed to get produced position of stream: channel_name=`{}`, stream_key={}, error={}",
-			stream.chan->name,
-			stream.key,
-			produced_ret));
-	}
-
-	return produced_pos;
-}
-
 lttng::consumer::memory_reclaim_result lttng_ustconsumer_reclaim_stream_memory(
 	lttng_consumer_stream& stream,
 	nonstd::optional<std::chrono::microseconds> age_limit,
@@ -1906,6 +1864,9 @@ lttng::consumer::memory_reclaim_result lttng_ustconsumer_reclaim_stream_memory(
 		}
 	}
 
+	/* Pages of the buffer may be released, even by a failed exchange. */
+	stream.memory_usage_sampler.invalidate();
+
 	unsigned int reclaimed_subbuf_count = 0;
 	/*
 	 * When a subbuffer is flushed, it affects its "timestamp". For instance, if a subbuffer
@@ -2466,6 +2427,421 @@ end:
 	return ret_code;
 }
 
+/*
+ * Create a channel and its streams from an ASK_CHANNEL_CREATION message and add
+ * the channel to the internal state.
+ *
+ * Return the created channel or NULL on error.
+ */
+static struct lttng_consumer_channel *
+create_channel_from_ask_msg(struct lttng_consumer_local_data *ctx,
+			    const struct lttcomm_consumer_msg *msg)
+{
+	int ret_ask_channel, ret_add_channel;
+	struct lttng_consumer_channel *channel;
+	struct lttng_ust_ctl_consumer_channel_attr attr = {};
+	const uint64_t chunk_id = msg->u.ask_channel.chunk_id.value;
+	const struct lttng_credentials buffer_credentials = {
+		.uid = LTTNG_OPTIONAL_INIT_VALUE(msg->u.ask_channel.buffer_credentials.uid),
+		.gid = LTTNG_OPTIONAL_INIT_VALUE(msg->u.ask_channel.buffer_credentials.gid),
+	};
+
+	nonstd::optional<std::chrono::microseconds> automatic_memory_reclamation_max_age;
+	if (msg->u.ask_channel.automatic_memory_reclamation_maximal_age_us.is_set) {
+		automatic_memory_reclamation_max_age =
+			std::chrono::microseconds(LTTNG_OPTIONAL_GET(
+				msg->u.ask_channel
+					.automatic_memory_reclamation_maximal_age_us));
+	}
+
+	/* Create a plain object and reserve a channel key. */
+	channel = consumer_allocate_channel(
+		msg->u.ask_channel.key,
+		msg->u.ask_channel.session_id,
+		msg->u.ask_channel.chunk_id.is_set ? &chunk_id : nullptr,
+		msg->u.ask_channel.pathname,
+		msg->u.ask_channel.name,
+		msg->u.ask_channel.relayd_id,
+		(enum lttng_event_output) msg->u.ask_channel.output,
+		msg->u.ask_channel.tracefile_size,
+		msg->u.ask_channel.tracefile_count,
+		msg->u.ask_channel.num_subbuf,
+		msg->u.ask_channel.session_id_per_pid,
+		msg->u.ask_channel.monitor,
+		msg->u.ask_channel.live_timer_interval,
+		msg->u.ask_channel.is_live,
+		msg->u.ask_channel.continuously_reclaimed,
+		automatic_memory_reclamation_max_age,
+		msg->u.ask_channel.root_shm_path,
+		msg->u.ask_channel.shm_path,
+		static_cast<enum lttng_trace_format>(msg->u.ask_channel.trace_format));
+	if (!channel) {
+		goto error;
+	}
+
+	LTTNG_OPTIONAL_SET(&channel->buffer_credentials, buffer_credentials);
+
+	/*
+	 * Assign UST application UID to the channel. This value is ignored for
+	 * per PID buffers. This is specific to UST thus setting this after the
+	 * allocation.
+	 */
+	channel->ust_app_uid = msg->u.ask_channel.ust_app_uid;
+
+	channel->event_loss_mode = msg->u.ask_channel.overwrite ?
+		CONSUMER_CHANNEL_EVENT_LOSS_MODE_OVERWRITE_OLDEST_PACKET :
+		CONSUMER_CHANNEL_EVENT_LOSS_MODE_DISCARD_EVENTS;
+
+	/* Build channel attributes from received message. */
+	attr.subbuf_size = msg->u.ask_channel.subbuf_size;
+	attr.num_subbuf = msg->u.ask_channel.num_subbuf;
+	attr.overwrite = msg->u.ask_channel.overwrite;
+	attr.switch_timer_interval = msg->u.ask_channel.switch_timer_interval;
+	attr.read_timer_interval = msg->u.ask_channel.read_timer_interval;
+	attr.chan_id = msg->u.ask_channel.chan_id;
+	memcpy(attr.uuid, msg->u.ask_channel.uuid, sizeof(attr.uuid));
+	attr.blocking_timeout = msg->u.ask_channel.blocking_timeout;
+	attr.owner_id = LTTNG_UST_ABI_OWNER_ID_CONSUMER;
+	attr.preallocate_backing = msg->u.ask_channel.preallocate_backing;
+
+	/* Match channel buffer type to the UST abi. */
+	switch (msg->u.ask_channel.output) {
+	case LTTNG_EVENT_MMAP:
+	default:
+		attr.output = LTTNG_UST_ABI_MMAP;
+		break;
+	}
+
+	/* Translate and save channel type. */
+	switch (msg->u.ask_channel.type) {
+	case LTTNG_UST_ABI_CHAN_PER_CPU:
+		/* fall-through */
+	case LTTNG_UST_ABI_CHAN_PER_CHANNEL:
+
+		if (msg->u.ask_channel.type == LTTNG_UST_ABI_CHAN_PER_CPU) {
+			channel->type = CONSUMER_CHANNEL_TYPE_DATA_PER_CPU;
+			attr.type = LTTNG_UST_ABI_CHAN_PER_CPU;
+		} else {
+			channel->type = CONSUMER_CHANNEL_TYPE_DATA_PER_CHANNEL;
+			attr.type = LTTNG_UST_ABI_CHAN_PER_CHANNEL;
+		}
+
+		/*
+		 * Set refcount to 1 for owner. Below, we will
+		 * pass ownership to the
+		 * consumer_thread_channel_poll() thread.
+		 */
+		channel->refcount = 1;
+		break;
+	case LTTNG_UST_ABI_CHAN_METADATA:
+		channel->type = CONSUMER_CHANNEL_TYPE_METADATA;
+		attr.type = LTTNG_UST_ABI_CHAN_METADATA;
+		break;
+	default:
+		abort();
+	};
+
+	if (channel->type != CONSUMER_CHANNEL_TYPE_METADATA) {
+		const auto codec_type = static_cast<lttng::compression::codec_type>(
+			msg->u.ask_channel.compression_codec);
+
+		if (codec_type != lttng::compression::codec_type::NONE &&
+		    !lttng::compression::is_codec_supported(codec_type)) {
+			ERR_FMT("Packet compression codec is not supported by this consumer: channel_name=`{}`, codec={}",
+				channel->name,
+				msg->u.ask_channel.compression_codec);
+			goto error;
+		}
+
+		channel->compression_codec = codec_type;
+	}
+
+	health_code_update();
+
+	ret_ask_channel = ask_channel(ctx, channel, &attr);
+	if (ret_ask_channel < 0) {
+		goto error;
+	}
+
+	if (msg->u.ask_channel.type == LTTNG_UST_ABI_CHAN_METADATA) {
+		int ret_allocate;
+
+		ret_allocate = consumer_metadata_cache_allocate(channel);
+		if (ret_allocate < 0) {
+			ERR("Allocating metadata cache");
+			goto error;
+		}
+
+		consumer_timer_switch_start(channel,
+					    attr.switch_timer_interval,
+					    ctx->metadata_socket,
+					    ctx->consumer_error_socket,
+					    ctx->timer_task_scheduler);
+	} else {
+		int monitor_start_ret;
+
+		consumer_timer_live_start(channel,
+					  msg->u.ask_channel.live_timer_interval,
+					  ctx->timer_task_scheduler);
+		monitor_start_ret = consumer_timer_monitor_start(
+			channel,
+			msg->u.ask_channel.monitor_timer_interval,
+			ctx->timer_task_scheduler);
+		if (monitor_start_ret < 0) {
+			ERR("Starting channel monitoring timer failed");
+			goto error;
+		}
+
+		if (msg->u.ask_channel.watchdog_timer_interval.is_set) {
+			int stall_watchdog_start_ret = consumer_timer_stall_watchdog_start(
+				channel,
+				ctx->consumer_error_socket,
+				LTTNG_OPTIONAL_GET(
+					msg->u.ask_channel.watchdog_timer_interval),
+				ctx->timer_task_scheduler);
+
+			if (stall_watchdog_start_ret < 0) {
+				ERR("Failed to start buffer-stall watchdog timer of channel: "
+				    "session_id=%" PRIu64 ", channel_name=`%s`",
+				    msg->u.ask_channel.session_id,
+				    msg->u.ask_channel.name);
+				goto error;
+			}
+		}
+
+		if (automatic_memory_reclamation_max_age.has_value()) {
+			consumer_timer_memory_reclaim_start(
+				*channel,
+				*automatic_memory_reclamation_max_age,
+				ctx->timer_task_scheduler);
+		}
+	}
+
+	health_code_update();
+
+	/*
+	 * Add the channel to the internal state AFTER all streams were created
+	 * and successfully sent to session daemon. This way, all streams must
+	 * be ready before this channel is visible to the threads.
+	 * If add_channel succeeds, ownership of the channel is
+	 * passed to consumer_thread_channel_poll().
+	 */
+	ret_add_channel = add_channel(channel, ctx);
+	if (ret_add_channel < 0) {
+		if (msg->u.ask_channel.type == LTTNG_UST_ABI_CHAN_METADATA) {
+			if (channel->metadata_switch_timer_task) {
+				consumer_timer_switch_stop(channel);
+			}
+			consumer_metadata_cache_destroy(channel);
+		}
+		if (channel->live_timer_task) {
+			consumer_timer_live_stop(channel);
+		}
+		if (channel->monitor_timer_task) {
+			consumer_timer_monitor_stop(channel);
+		}
+		if (channel->stall_watchdog_timer_task) {
+			consumer_timer_stall_watchdog_stop(channel);
+		}
+		if (channel->memory_reclaim_timer_task) {
+			consumer_timer_memory_reclaim_stop(channel);
+		}
+
+		goto error;
+	}
+
+	health_code_update();
+
+	return channel;
+
+error:
+	if (channel) {
+		consumer_del_channel(channel);
+	}
+
+	return nullptr;
+}
+
+/*
+ * Send a channel created by create_channel_from_ask_msg() and its streams to
+ * the session daemon, then hand the streams over to the data thread.
+ *
+ * Return 0 when the reply must be completed by a status message carrying
+ * `ret_code`, 1 when it was already completed by an error status message, or a
+ * negative value when the communication with the session daemon is broken.
+ */
+static int get_channel(struct lttng_consumer_local_data *ctx,
+		       int sock,
+		       uint64_t key,
+		       enum lttcomm_return_code *ret_code)
+{
+	int ret, relayd_err = 0;
+	struct lttng_consumer_channel *channel;
+
+	const lttng::pthread::lock_guard consumer_data_lock(the_consumer_data.lock);
+
+	channel = consumer_find_channel(key);
+	if (!channel) {
+		ERR("UST consumer get channel key %" PRIu64 " not found", key);
+		*ret_code = LTTCOMM_CONSUMERD_CHAN_NOT_FOUND;
+		return 0;
+	}
+
+	health_code_update();
+	const lttng::pthread::lock_guard channel_lock(channel->lock);
+	const lttng::pthread::lock_guard channel_timer_lock(channel->timer_lock);
+
+	/* Send the channel to sessiond (and relayd, if applicable). */
+	ret = send_channel_to_sessiond_and_relayd(sock, channel, ctx, &relayd_err);
+	if (ret < 0) {
+		if (relayd_err) {
+			/*
+			 * We were unable to send to the relayd the stream so avoid
+			 * sending back a fatal error to the thread since this is OK
+			 * and the consumer can continue its work. The above call
+			 * has sent the error status message to the sessiond.
+			 */
+			return 1;
+		}
+		/*
+		 * The communicaton was broken hence there is a bad state between
+		 * the consumer and sessiond so stop everything.
+		 */
+		return -1;
+	}
+
+	health_code_update();
+
+	/*
+	 * In no monitor mode, the streams ownership is kept inside the channel
+	 * so don't send them to the data thread.
+	 */
+	if (!channel->monitor) {
+		return 0;
+	}
+
+	ret = send_streams_to_thread(channel, ctx);
+	if (ret < 0) {
+		/*
+		 * If we are unable to send the stream to the thread, there is
+		 * a big problem so just stop everything.
+		 */
+		return -1;
+	}
+	/* List MUST be empty after or else it could be reused. */
+	LTTNG_ASSERT(cds_list_empty(&channel->streams.head));
+	return 0;
+}
+
+/*
+ * Create the channels described by the `channel_count` ASK_CHANNEL_CREATION
+ * messages following an ASK_CHANNELS_CREATION command, then reply with the
+ * status of every channel, in order, in a single message.
+ *
+ * A channel which can't be created doesn't prevent the creation of the
+ * following ones; its status reports the error.
+ *
+ * Throws on communication error with the session daemon.
+ */
+static void lttng_ustconsumer_ask_channels_creation(struct lttng_consumer_local_data *ctx,
+						    int sock,
+						    std::uint64_t channel_count)
+{
+	std::vector<lttcomm_consumer_status_channel> replies;
+
+	replies.reserve(channel_count);
+	for (std::uint64_t i = 0; i < channel_count; i++) {
+		lttcomm_consumer_msg ask_msg;
+		lttcomm_consumer_status_channel reply = {};
+
+		const auto recv_ret = lttcomm_recv_unix_sock(sock, &ask_msg, sizeof(ask_msg));
+		if (recv_ret != sizeof(ask_msg)) {
+			LTTNG_THROW_POSIX("Failed to receive channel creation message", errno);
+		}
+
+		if (ask_msg.cmd_type != LTTNG_CONSUMER_ASK_CHANNEL_CREATION) {
+			LTTNG_THROW_PROTOCOL_ERROR(fmt::format(
+				"Unexpected command in batch of channel creations: command={}",
+				static_cast<lttng_consumer_command>(ask_msg.cmd_type)));
+		}
+
+		health_code_update();
+
+		const auto *channel = create_channel_from_ask_msg(ctx, &ask_msg);
+		if (channel) {
+			reply.ret_code = LTTCOMM_CONSUMERD_SUCCESS;
+			reply.key = channel->key;
+			reply.stream_count = channel->streams.count;
+		} else {
+			reply.ret_code = LTTCOMM_CONSUMERD_CHANNEL_FAIL;
+		}
+
+		replies.push_back(reply);
+	}
+
+	if (replies.empty()) {
+		return;
+	}
+
+	const auto reply_size = replies.size() * sizeof(decltype(replies)::value_type);
+	const auto send_ret = lttcomm_send_unix_sock(sock, replies.data(), reply_size);
+	if (send_ret != reply_size) {
+		LTTNG_THROW_POSIX("Failed to send channel creation statuses to session daemon",
+				  errno);
+	}
+}
+
+/*
+ * Send the channels identified by the `key_count` keys following a
+ * GET_CHANNELS command, in order, to the session daemon. The reply of each
+ * channel is the same as the reply to a GET_CHANNEL command.
+ *
+ * The batch stops at the first channel which can't be sent; the session daemon
+ * doesn't expect the following channels after receiving an error status.
+ *
+ * Throws on communication error with the session daemon.
+ */
+static void lttng_ustconsumer_get_channels(struct lttng_consumer_local_data *ctx,
+					   int sock,
+					   std::uint64_t key_count)
+{
+	std::vector<std::uint64_t> keys;
+
+	if (key_count == 0) {
+		return;
+	}
+
+	keys.resize(key_count);
+	const auto keys_payload_size = key_count * sizeof(decltype(keys)::value_type);
+	const auto recv_ret = lttcomm_recv_unix_sock(sock, keys.data(), keys_payload_size);
+	if (recv_ret != keys_payload_size) {
+		LTTNG_THROW_POSIX("Failed to receive channel keys from session daemon", errno);
+	}
+
+	for (const auto key : keys) {
+		auto ret_code = LTTCOMM_CONSUMERD_SUCCESS;
+
+		health_code_update();
+
+		const auto ret_get_channel = get_channel(ctx, sock, key, &ret_code);
+		if (ret_get_channel < 0) {
+			LTTNG_THROW_ERROR(fmt::format(
+				"Failed to send channel to session daemon: key={}", key));
+		} else if (ret_get_channel > 0) {
+			/* The error status of the channel was already sent. */
+			return;
+		}
+
+		if (consumer_send_status_msg(sock, ret_code) < 0) {
+			LTTNG_THROW_POSIX("Failed to send channel status to session daemon", errno);
+		}
+
+		if (ret_code != LTTCOMM_CONSUMERD_SUCCESS) {
+			return;
+		}
+	}
+}
+
 /*
  * Receive command from session daemon and process it.
  *
@@ -2478,7 +2854,6 @@ int lttng_ustconsumer_recv_cmd(struct lttng_consumer_local_data *ctx,
 	int ret_func;
 	enum lttcomm_return_code ret_code = LTTCOMM_CONSUMERD_SUCCESS;
 	struct lttcomm_consumer_msg msg;
-	struct lttng_consumer_channel *channel = nullptr;
 
 	health_code_update();
 
@@ -2593,210 +2968,14 @@ int lttng_ustconsumer_recv_cmd(struct lttng_consumer_local_data *ctx,
 	}
 	case LTTNG_CONSUMER_ASK_CHANNEL_CREATION:
 	{
-		int ret_ask_channel, ret_add_channel, ret_send;
-		struct lttng_ust_ctl_consumer_channel_attr attr = {};
-		const uint64_t chunk_id = msg.u.ask_channel.chunk_id.value;
-		const struct lttng_credentials buffer_credentials = {
-			.uid = LTTNG_OPTIONAL_INIT_VALUE(msg.u.ask_channel.buffer_credentials.uid),
-			.gid = LTTNG_OPTIONAL_INIT_VALUE(msg.u.ask_channel.buffer_credentials.gid),
-		};
-
-		nonstd::optional<std::chrono::microseconds> automatic_memory_reclamation_max_age;
-		if (msg.u.ask_channel.automatic_memory_reclamation_maximal_age_us.is_set) {
-			automatic_memory_reclamation_max_age =
-				std::chrono::microseconds(LTTNG_OPTIONAL_GET(
-					msg.u.ask_channel
-						.automatic_memory_reclamation_maximal_age_us));
-		}
-
-		/* Create a plain object and reserve a channel key. */
-		channel = consumer_allocate_channel(
-			msg.u.ask_channel.key,
-			msg.u.ask_channel.session_id,
-			msg.u.ask_channel.chunk_id.is_set ? &chunk_id : nullptr,
-			msg.u.ask_channel.pathname,
-			msg.u.ask_channel.name,
-			msg.u.ask_channel.relayd_id,
-			(enum lttng_event_output) msg.u.ask_channel.output,
-			msg.u.ask_channel.tracefile_size,
-			msg.u.ask_channel.tracefile_count,
-			msg.u.ask_channel.num_subbuf,
-			msg.u.ask_channel.session_id_per_pid,
-			msg.u.ask_channel.monitor,
-			msg.u.ask_channel.live_timer_interval,
-			msg.u.ask_channel.is_live,
-			msg.u.ask_channel.continuously_reclaimed,
-			automatic_memory_reclamation_max_age,
-			msg.u.ask_channel.root_shm_path,
-			msg.u.ask_channel.shm_path,
-			static_cast<enum lttng_trace_format>(msg.u.ask_channel.trace_format));
-		if (!channel) {
-			goto end_channel_error;
-		}
-
-		LTTNG_OPTIONAL_SET(&channel->buffer_credentials, buffer_credentials);
-
-		/*
-		 * Assign UST application UID to the channel. This value is ignored for
-		 * per PID buffers. This is specific to UST thus setting this after the
-		 * allocation.
-		 */
-		channel->ust_app_uid = msg.u.ask_channel.ust_app_uid;
-
-		channel->event_loss_mode = msg.u.ask_channel.overwrite ?
-			CONSUMER_CHANNEL_EVENT_LOSS_MODE_OVERWRITE_OLDEST_PACKET :
-			CONSUMER_CHANNEL_EVENT_LOSS_MODE_DISCARD_EVENTS;
-
-		/* Build channel attributes from received message. */
-		attr.subbuf_size = msg.u.ask_channel.subbuf_size;
-		attr.num_subbuf = msg.u.ask_channel.num_subbuf;
-		attr.overwrite = msg.u.ask_channel.overwrite;
-		attr.switch_timer_interval = msg.u.ask_channel.switch_timer_interval;
-		attr.read_timer_interval = msg.u.ask_channel.read_timer_interval;
-		attr.chan_id = msg.u.ask_channel.chan_id;
-		memcpy(attr.uuid, msg.u.ask_channel.uuid, sizeof(attr.uuid));
-		attr.blocking_timeout = msg.u.ask_channel.blocking_timeout;
-		attr.owner_id = LTTNG_UST_ABI_OWNER_ID_CONSUMER;
-		attr.preallocate_backing = msg.u.ask_channel.preallocate_backing;
-
-		/* Match channel buffer type to the UST abi. */
-		switch (msg.u.ask_channel.output) {
-		case LTTNG_EVENT_MMAP:
-		default:
-			attr.output = LTTNG_UST_ABI_MMAP;
-			break;
-		}
-
-		/* Translate and save channel type. */
-		switch (msg.u.ask_channel.type) {
-		case LTTNG_UST_ABI_CHAN_PER_CPU:
-			/* fall-through */
-		case LTTNG_UST_ABI_CHAN_PER_CHANNEL:
-
-			if (msg.u.ask_channel.type == LTTNG_UST_ABI_CHAN_PER_CPU) {
-				channel->type = CONSUMER_CHANNEL_TYPE_DATA_PER_CPU;
-				attr.type = LTTNG_UST_ABI_CHAN_PER_CPU;
-			} else {
-				channel->type = CONSUMER_CHANNEL_TYPE_DATA_PER_CHANNEL;
-				attr.type = LTTNG_UST_ABI_CHAN_PER_CHANNEL;
-			}
-
-			/*
-			 * Set refcount to 1 for owner. Below, we will
-			 * pass ownership to the
-			 * consumer_thread_channel_poll() thread.
-			 */
-			channel->refcount = 1;
-			break;
-		case LTTNG_UST_ABI_CHAN_METADATA:
-			channel->type = CONSUMER_CHANNEL_TYPE_METADATA;
-			attr.type = LTTNG_UST_ABI_CHAN_METADATA;
-			break;
-		default:
-			abort();
-			goto error_fatal;
-		};
-
-		health_code_update();
-
-		ret_ask_channel = ask_channel(ctx, channel, &attr);
-		if (ret_ask_channel < 0) {
-			goto end_channel_error;
-		}
-
-		if (msg.u.ask_channel.type == LTTNG_UST_ABI_CHAN_METADATA) {
-			int ret_allocate;
-
-			ret_allocate = consumer_metadata_cache_allocate(channel);
-			if (ret_allocate < 0) {
-				ERR("Allocating metadata cache");
-				goto end_channel_error;
-			}
-
-			consumer_timer_switch_start(channel,
-						    attr.switch_timer_interval,
-						    ctx->metadata_socket,
-						    ctx->consumer_error_socket,
-						    ctx->timer_task_scheduler);
-		} else {
-			int monitor_start_ret;
-
-			consumer_timer_live_start(channel,
-						  msg.u.ask_channel.live_timer_interval,
-						  ctx->timer_task_scheduler);
-			monitor_start_ret = consumer_timer_monitor_start(
-				channel,
-				msg.u.ask_channel.monitor_timer_interval,
-				ctx->timer_task_scheduler);
-			if (monitor_start_ret < 0) {
-				ERR("Starting channel monitoring timer failed");
-				goto end_channel_error;
-			}
-
-			if (msg.u.ask_channel.watchdog_timer_interval.is_set) {
-				int stall_watchdog_start_ret = consumer_timer_stall_watchdog_start(
-					channel,
-					ctx->consumer_error_socket,
-					LTTNG_OPTIONAL_GET(
-						msg.u.ask_channel.watchdog_timer_interval),
-					ctx->timer_task_scheduler);
-
-				if (stall_watchdog_start_ret < 0) {
-					ERR("Failed to start buffer-stall watchdog timer of channel: "
-					    "session_id=%" PRIu64 ", channel_name=`%s`",
-					    msg.u.ask_channel.session_id,
-					    msg.u.ask_channel.name);
-					goto end_channel_error;
-				}
-			}
-
-			if (automatic_memory_reclamation_max_age.has_value()) {
-				consumer_timer_memory_reclaim_start(
-					*channel,
-					*automatic_memory_reclamation_max_age,
-					ctx->timer_task_scheduler);
-			}
-		}
-
-		health_code_update();
-
-		/*
-		 * Add the channel to the internal state AFTER all streams were created
-		 * and successfully sent to session daemon. This way, all streams must
-		 * be ready before this channel is visible to the threads.
-		 * If add_channel succeeds, ownership of the channel is
-		 * passed to consumer_thread_channel_poll().
-		 */
-		ret_add_channel = add_channel(channel, ctx);
-		if (ret_add_channel < 0) {
-			if (msg.u.ask_channel.type == LTTNG_UST_ABI_CHAN_METADATA) {
-				if (channel->metadata_switch_timer_task) {
-					consumer_timer_switch_stop(channel);
-				}
-				consumer_metadata_cache_destroy(channel);
-			}
-			if (channel->live_timer_task) {
-				consumer_timer_live_stop(channel);
-			}
-			if (channel->monitor_timer_task) {
-				consumer_timer_monitor_stop(channel);
-			}
-			if (channel->stall_watchdog_timer_task) {
-				consumer_timer_stall_watchdog_stop(channel);
-			}
-			if (channel->memory_reclaim_timer_task) {
-				consumer_timer_memory_reclaim_stop(channel);
-			}
-
-			goto end_channel_error;
-		}
+		int ret_send;
+		struct lttng_consumer_channel *channel;
 
-		health_code_update();
+		channel = create_channel_from_ask_msg(ctx, &msg);
 
 		/*
-		 * Channel and streams are now created. Inform the session daemon that
-		 * everything went well and should wait to receive the channel and
-		 * streams with ustctl API.
+		 * Inform the session daemon of the outcome. When the channel and
+		 * streams are created, it then waits to receive them with ustctl API.
 		 */
 		ret_send = consumer_send_status_channel(sock, channel);
 		if (ret_send < 0) {
@@ -2810,69 +2989,42 @@ int lttng_ustconsumer_recv_cmd(struct lttng_consumer_local_data *ctx,
 	}
 	case LTTNG_CONSUMER_GET_CHANNEL:
 	{
-		int ret, relayd_err = 0;
-		const uint64_t key = msg.u.get_channel.key;
-		struct lttng_consumer_channel *found_channel;
-
-		const lttng::pthread::lock_guard consumer_data_lock(the_consumer_data.lock);
-
-		found_channel = consumer_find_channel(key);
-		if (!found_channel) {
-			ERR("UST consumer get channel key %" PRIu64 " not found", key);
-			ret_code = LTTCOMM_CONSUMERD_CHAN_NOT_FOUND;
-		} else {
-			health_code_update();
-			const lttng::pthread::lock_guard channel_lock(found_channel->lock);
-			const lttng::pthread::lock_guard channel_timer_lock(
-				found_channel->timer_lock);
+		int ret_get_channel;
 
-			/* Send the channel to sessiond (and relayd, if applicable). */
-			ret = send_channel_to_sessiond_and_relayd(
-				sock, found_channel, ctx, &relayd_err);
-			if (ret < 0) {
-				if (relayd_err) {
-					/*
-					 * We were unable to send to the relayd the stream so avoid
-					 * sending back a fatal error to the thread since this is OK
-					 * and the consumer can continue its work. The above call
-					 * has sent the error status message to the sessiond.
-					 */
-					goto end_get_channel_nosignal;
-				}
-				/*
-				 * The communicaton was broken hence there is a bad state between
-				 * the consumer and sessiond so stop everything.
-				 */
-				goto error_get_channel_fatal;
-			}
-
-			health_code_update();
+		ret_get_channel = get_channel(ctx, sock, msg.u.get_channel.key, &ret_code);
+		if (ret_get_channel < 0) {
+			goto error_fatal;
+		} else if (ret_get_channel > 0) {
+			goto end_nosignal;
+		}
 
-			/*
-			 * In no monitor mode, the streams ownership is kept inside the channel
-			 * so don't send them to the data thread.
-			 */
-			if (!found_channel->monitor) {
-				goto end_get_channel;
-			}
+		goto end_msg_sessiond;
+	}
+	case LTTNG_CONSUMER_ASK_CHANNELS_CREATION:
+	{
+		try {
+			lttng_ustconsumer_ask_channels_creation(
+				ctx, sock, msg.u.ask_channels_creation.channel_count);
+		} catch (const std::exception& ex) {
+			/* The session daemon is not responding anymore. */
+			ERR_FMT("Failed to create batch of channels: {}", ex.what());
+			goto error_fatal;
+		}
 
-			ret = send_streams_to_thread(found_channel, ctx);
-			if (ret < 0) {
-				/*
-				 * If we are unable to send the stream to the thread, there is
-				 * a big problem so just stop everything.
-				 */
-				goto error_get_channel_fatal;
-			}
-			/* List MUST be empty after or else it could be reused. */
-			LTTNG_ASSERT(cds_list_empty(&found_channel->streams.head));
+		/* The status of each channel is the response. */
+		goto end_nosignal;
+	}
+	case LTTNG_CONSUMER_GET_CHANNELS:
+	{
+		try {
+			lttng_ustconsumer_get_channels(ctx, sock, msg.u.get_channels.key_count);
+		} catch (const std::exception& ex) {
+			/* The session daemon is not responding anymore. */
+			ERR_FMT("Failed to send batch of channels: {}", ex.what());
+			goto error_fatal;
 		}
 
-	end_get_channel:
-		goto end_msg_sessiond;
-	error_get_channel_fatal:
-		goto error_fatal;
-	end_get_channel_nosignal:
+		/* The reply of each channel ends with its own status message. */
 		goto end_nosignal;
 	}
 	case LTTNG_CONSUMER_DESTROY_CHANNEL:
@@ -3149,6 +3301,78 @@ int lttng_ustconsumer_recv_cmd(struct lttng_consumer_local_data *ctx,
 
 		break;
 	}
+	case LTTNG_CONSUMER_GET_CHANNEL_COMPRESSION_STATS:
+	{
+		ssize_t ret;
+		struct lttcomm_consumer_channel_compression_stats stats = {};
+		const uint64_t id = msg.u.channel_compression_stats.session_id;
+		const uint64_t key = msg.u.channel_compression_stats.channel_key;
+
+		DBG("UST consumer channel compression statistics command for session id %" PRIu64
+		    ", channel key %" PRIu64,
+		    id,
+		    key);
+
+		/* Report nothing if the channel is not (or no longer) known. */
+		const auto channel = consumer_find_channel(key);
+		if (channel) {
+			stats.input_bytes =
+				channel->compression_input_bytes.load(std::memory_order_relaxed);
+			stats.output_bytes =
+				channel->compression_output_bytes.load(std::memory_order_relaxed);
+			stats.cpu_time_ns =
+				channel->compression_cpu_time_ns.load(std::memory_order_relaxed);
+		}
+
+		health_code_update();
+
+		/* Send back returned value to session daemon */
+		ret = lttcomm_send_unix_sock(sock, &stats, sizeof(stats));
+		if (ret < 0) {
+			PERROR("send channel compression statistics");
+			goto error_fatal;
+		}
+
+		break;
+	}
+	case LTTNG_CONSUMER_GET_SESSION_CHANNELS_RUNTIME_STATS:
+	{
+		const auto id = msg.u.get_session_channels_runtime_stats.session_id;
+
+		DBG_FMT("UST consumer session runtime statistics command: session_id={}",
+			id);
+
+		health_code_update();
+
+		try {
+			lttng_consumer_send_session_channels_runtime_stats(sock, id);
+		} catch (const std::exception& ex) {
+			/* The session daemon is not responding anymore. */
+			ERR_FMT("Failed to send session channels runtime statistics: {}",
+				ex.what());
+			goto error_fatal;
+		}
+
+		break;
+	}
+	case LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS:
+	{
+		const auto id = msg.u.get_session_streams_io_stats.session_id;
+
+		DBG_FMT("UST consumer session streams I/O statistics command: session_id={}", id);
+
+		health_code_update();
+
+		try {
+			lttng_consumer_send_session_streams_io_stats(sock, id);
+		} catch (const std::exception& ex) {
+			/* The session daemon is not responding anymore. */
+			ERR_FMT("Failed to send session streams I/O statistics: {}", ex.what());
+			goto error_fatal;
+		}
+
+		break;
+	}
 	case LTTNG_CONSUMER_SET_CHANNEL_MONITOR_PIPE:
 	{
 		int channel_monitor_pipe, ret_send, ret_set_channel_monitor_pipe;
@@ -3548,24 +3772,6 @@ end_msg_sessiond:
 	ret_func = 1;
 	goto end;
 
-end_channel_error:
-	if (channel) {
-		consumer_del_channel(channel);
-	}
-	/* We have to send a status channel message indicating an error. */
-	{
-		int ret_send_status;
-
-		ret_send_status = consumer_send_status_channel(sock, nullptr);
-		if (ret_send_status < 0) {
-			/* Stop everything if session daemon can not be notified. */
-			goto error_fatal;
-		}
-	}
-
-	ret_func = 1;
-	goto end;
-
 error_fatal:
 	/* This will issue a consumer stop. */
 	ret_func = -1;
@@ -5168,6 +5374,8 @@ void lttng_ustconsumer_quiescent_stalled_channel(struct lttng_consumer_local_dat
 	 */
 	if (need_schedule) {
 		auto& scheduler = ctx.timer_task_scheduler;
+
+		channel.timer_task_scheduler = &scheduler;
 		scheduler.schedule(stall_watchdog_task, std::chrono::steady_clock::now());
 	}
 }
@@ -5215,6 +5423,9 @@ void lttng_ustconsumer_try_reclaim_current_subbuffer(lttng_consumer_stream& stre
 		return;
 	}
 
+	/* Pages of the buffer are about to be released. */
+	stream.memory_usage_sampler.invalidate();
+
 	const auto initial_reclaim_ret = lttng_ust_ctl_reclaim_reader_subbuf(stream.ustream);
 
 	/*
@@ -13,6 +13,7 @@
 #define _LGPL_SOURCE
 #include "event-rule-convert.hpp"
 #include "lttng-ctl-helper.hpp"
+#include "session-daemon-connection.hpp"
 
 #include <common/align.hpp>
 #include <common/bytecode/bytecode.hpp>
@@ -503,6 +504,109 @@ end:
 	return ret;
 }
 
+/*
+ * Same as recv_sessiond_optional_data(), but copies the data from a reply
+ * received on a persistent session daemon connection.
+ */
+static int copy_sessiond_optional_data(const char *data,
+				       size_t len,
+				       void **user_buf,
+				       size_t *user_len)
+{
+	char *buf;
+
+	if (!len) {
+		/* No command header. */
+		if (user_len) {
+			*user_len = 0;
+		}
+
+		if (user_buf) {
+			*user_buf = nullptr;
+		}
+
+		return 0;
+	}
+
+	if (!user_len || !user_buf) {
+		return -LTTNG_ERR_INVALID;
+	}
+
+	buf = zmalloc<char>(len);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	memcpy(buf, data, len);
+
+	/* Move ownership of the buffer to user. */
+	*user_buf = buf;
+	*user_len = len;
+	return 0;
+}
+
+/*
+ * lttng_ctl_ask_sessiond_fds_varlen() on a persistent session daemon
+ * connection.
+ */
+static int ask_sessiond_fds_varlen_persistent(struct lttng_session_daemon_connection *connection,
+					      struct lttcomm_session_msg *lsm,
+					      const int *fds,
+					      size_t nb_fd,
+					      const void *vardata,
+					      size_t vardata_len,
+					      void **user_payload_buf,
+					      void **user_cmd_header_buf,
+					      size_t *user_cmd_header_len)
+{
+	int ret;
+	size_t payload_len;
+	struct lttcomm_lttng_msg llm;
+	struct lttng_dynamic_buffer request;
+	struct lttng_payload reply;
+
+	lttng_dynamic_buffer_init(&request);
+	lttng_payload_init(&reply);
+	const auto reset_buffers = lttng::make_scope_exit([&request, &reply]() noexcept {
+		lttng_dynamic_buffer_reset(&request);
+		lttng_payload_reset(&reply);
+	});
+
+	/* The variable length data immediately follows the message on the socket. */
+	if (lttng_dynamic_buffer_append(&request, lsm, sizeof(*lsm)) ||
+	    (vardata_len > 0 && lttng_dynamic_buffer_append(&request, vardata, vardata_len))) {
+		return -LTTNG_ERR_NOMEM;
+	}
+
+	ret = connection->execute(request.data, request.size, fds, nb_fd, reply);
+	if (ret < 0) {
+		return ret;
+	}
+
+	memcpy(&llm, reply.buffer.data, sizeof(llm));
+	if (llm.ret_code != LTTNG_OK) {
+		return -llm.ret_code;
+	}
+
+	ret = copy_sessiond_optional_data(reply.buffer.data + sizeof(llm),
+					  llm.cmd_header_size,
+					  user_cmd_header_buf,
+					  user_cmd_header_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = copy_sessiond_optional_data(reply.buffer.data + sizeof(llm) + llm.cmd_header_size,
+					  llm.data_size,
+					  user_payload_buf,
+					  &payload_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return llm.data_size;
+}
+
 /*
  * Ask the session daemon a specific command and put the data into buf.
  * Takes extra var. len. data and file descriptors as input to send to the
@@ -522,6 +626,20 @@ int lttng_ctl_ask_sessiond_fds_varlen(struct lttcomm_session_msg *lsm,
 	int ret;
 	size_t payload_len;
 	struct lttcomm_lttng_msg llm;
+	auto *persistent_connection =
+		lttng_ctl_get_current_sessiond_connection((lttcomm_sessiond_command) lsm->cmd_type);
+
+	if (persistent_connection) {
+		return ask_sessiond_fds_varlen_persistent(persistent_connection,
+							  lsm,
+							  fds,
+							  nb_fd,
+							  vardata,
+							  vardata_len,
+							  user_payload_buf,
+							  user_cmd_header_buf,
+							  user_cmd_header_len);
+	}
 
 	ret = connect_sessiond();
 	if (ret < 0) {
@@ -584,6 +702,26 @@ end:
 	return ret;
 }
 
+/*
+ * Remove the llm header from a reply received from the session daemon.
+ *
+ * Returns the size of the remaining reply.
+ */
+static int strip_sessiond_reply_header(struct lttng_payload *reply)
+{
+	/* Don't return the llm header to the caller. */
+	memmove(reply->buffer.data,
+		reply->buffer.data + sizeof(struct lttcomm_lttng_msg),
+		reply->buffer.size - sizeof(struct lttcomm_lttng_msg));
+	if (lttng_dynamic_buffer_set_size(&reply->buffer,
+					  reply->buffer.size - sizeof(struct lttcomm_lttng_msg))) {
+		/* Can't happen as size is reduced. */
+		abort();
+	}
+
+	return reply->buffer.size;
+}
+
 int lttng_ctl_ask_sessiond_payload(struct lttng_payload_view *message, struct lttng_payload *reply)
 {
 	int ret;
@@ -592,6 +730,31 @@ int lttng_ctl_ask_sessiond_payload(struct lttng_payload_view *message, struct lt
 
 	LTTNG_ASSERT(reply->buffer.size == 0);
 	LTTNG_ASSERT(lttng_dynamic_pointer_array_get_count(&reply->_fd_handles) == 0);
+	LTTNG_ASSERT(message->buffer.size >= sizeof(struct lttcomm_session_msg));
+
+	auto *persistent_connection = lttng_ctl_get_current_sessiond_connection(
+		(lttcomm_sessiond_command) ((const struct lttcomm_session_msg *)
+						    message->buffer.data)
+			->cmd_type);
+	if (persistent_connection) {
+		ret = persistent_connection->execute(*message, *reply);
+		if (ret < 0) {
+			return ret;
+		}
+
+		llm = *((typeof(llm) *) reply->buffer.data);
+		if (llm.ret_code != LTTNG_OK) {
+			lttng_payload_clear(reply);
+			if (llm.ret_code < LTTNG_OK || llm.ret_code >= LTTNG_ERR_NR) {
+				/* Invalid error code received. */
+				return -LTTNG_ERR_UNK;
+			}
+
+			return -llm.ret_code;
+		}
+
+		return strip_sessiond_reply_header(reply);
+	}
 
 	ret = connect_sessiond();
 	if (ret < 0) {
@@ -660,17 +823,7 @@ int lttng_ctl_ask_sessiond_payload(struct lttng_payload_view *message, struct lt
 		}
 	}
 
-	/* Don't return the llm header to the caller. */
-	memmove(reply->buffer.data,
-		reply->buffer.data + sizeof(llm),
-		reply->buffer.size - sizeof(llm));
-	ret = lttng_dynamic_buffer_set_size(&reply->buffer, reply->buffer.size - sizeof(llm));
-	if (ret) {
-		/* Can't happen as size is reduced. */
-		abort();
-	}
-
-	ret = reply->buffer.size;
+	ret = strip_sessiond_reply_header(reply);
 
 end:
 	disconnect_sessiond();
@@ -2888,6 +3041,139 @@ lttng_channel_set_preallocation_policy(struct lttng_channel *chan,
 	return LTTNG_CHANNEL_STATUS_OK;
 }
 
+enum lttng_channel_status
+lttng_channel_get_compression(const struct lttng_channel *chan,
+			      enum lttng_channel_compression *compression)
+{
+	if (!chan || !compression) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	const auto extended =
+		static_cast<const struct lttng_channel_extended *>(chan->attr.extended.ptr);
+
+	if (!extended) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	*compression = static_cast<enum lttng_channel_compression>(extended->compression);
+
+	return LTTNG_CHANNEL_STATUS_OK;
+}
+
+enum lttng_channel_status lttng_channel_set_compression(struct lttng_channel *chan,
+							enum lttng_channel_compression compression)
+{
+	if (!chan) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	const auto extended = static_cast<struct lttng_channel_extended *>(chan->attr.extended.ptr);
+
+	if (!extended) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	switch (compression) {
+	case LTTNG_CHANNEL_COMPRESSION_NONE:
+		/* Fallthrough */
+	case LTTNG_CHANNEL_COMPRESSION_ZSTD:
+		/* Fallthrough */
+	case LTTNG_CHANNEL_COMPRESSION_LZ4:
+		break;
+	default:
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	extended->compression = static_cast<uint8_t>(compression);
+
+	return LTTNG_CHANNEL_STATUS_OK;
+}
+
+enum lttng_channel_status lttng_channel_get_compression_statistics(const struct lttng_channel *chan,
+								   uint64_t *input_bytes,
+								   uint64_t *output_bytes,
+								   uint64_t *cpu_time_ns)
+{
+	if (!chan || !input_bytes || !output_bytes || !cpu_time_ns) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	const auto extended =
+		static_cast<const struct lttng_channel_extended *>(chan->attr.extended.ptr);
+
+	if (!extended) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	*input_bytes = extended->compression_input_bytes;
+	*output_bytes = extended->compression_output_bytes;
+	*cpu_time_ns = extended->compression_cpu_time_ns;
+
+	return LTTNG_CHANNEL_STATUS_OK;
+}
+
+enum lttng_channel_status lttng_channel_get_io_statistics(const struct lttng_channel *chan,
+							  uint64_t *consumed_subbuffer_count,
+							  uint64_t *written_bytes,
+							  uint64_t *write_call_count,
+							  uint64_t *relayd_send_time_ns)
+{
+	if (!chan || !consumed_subbuffer_count || !written_bytes || !write_call_count ||
+	    !relayd_send_time_ns) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	const auto extended =
+		static_cast<const struct lttng_channel_extended *>(chan->attr.extended.ptr);
+
+	if (!extended) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	if (!extended->has_io_stats) {
+		return LTTNG_CHANNEL_STATUS_UNSET;
+	}
+
+	*consumed_subbuffer_count = extended->io_consumed_subbuffers;
+	*written_bytes = extended->io_written_bytes;
+	*write_call_count = extended->io_write_calls;
+	*relayd_send_time_ns = extended->io_relayd_send_time_ns;
+
+	return LTTNG_CHANNEL_STATUS_OK;
+}
+
+enum lttng_channel_status
+lttng_channel_get_io_latency_statistics(const struct lttng_channel *chan,
+					uint64_t *subbuffer_consumption_p99_ns,
+					uint64_t *subbuffer_consumption_max_ns,
+					uint64_t *write_p99_ns,
+					uint64_t *write_max_ns)
+{
+	if (!chan || !subbuffer_consumption_p99_ns || !subbuffer_consumption_max_ns ||
+	    !write_p99_ns || !write_max_ns) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	const auto extended =
+		static_cast<const struct lttng_channel_extended *>(chan->attr.extended.ptr);
+
+	if (!extended) {
+		return LTTNG_CHANNEL_STATUS_INVALID;
+	}
+
+	if (!extended->has_io_stats) {
+		return LTTNG_CHANNEL_STATUS_UNSET;
+	}
+
+	*subbuffer_consumption_p99_ns = extended->io_subbuffer_consumption_p99_ns;
+	*subbuffer_consumption_max_ns = extended->io_subbuffer_consumption_max_ns;
+	*write_p99_ns = extended->io_write_p99_ns;
+	*write_max_ns = extended->io_write_max_ns;
+
+	return LTTNG_CHANNEL_STATUS_OK;
+}
+
 enum lttng_channel_status
 lttng_channel_get_automatic_memory_reclamation_policy(const struct lttng_channel *chan,
 						      uint64_t *maximal_age_us)
@@ -0,0 +1,306 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+
+#define _LGPL_SOURCE
+#include "lttng-ctl-helper.hpp"
+#include "session-daemon-connection.hpp"
+
+#include <common/error.hpp>
+#include <common/scope-exit.hpp>
+#include <common/unix.hpp>
+
+#include <lttng/session-daemon-connection.h>
+
+#include <memory>
+#include <new>
+#include <string.h>
+#include <sys/socket.h>
+
+namespace {
+/* Persistent connection used by the liblttng-ctl functions called by this thread. */
+thread_local struct lttng_session_daemon_connection *current_connection;
+} /* namespace */
+
+lttng_session_daemon_connection::lttng_session_daemon_connection(lttng::stream_descriptor socket) :
+	_socket(std::move(socket))
+{
+}
+
+/*
+ * Send the credentials of the client along with the request's frame, if the
+ * connection is persistent, or with the request itself otherwise.
+ */
+bool lttng_session_daemon_connection::_send_request_data(const void *request,
+							 std::size_t request_size,
+							 std::size_t fd_count)
+{
+	struct lttcomm_session_msg_frame frame;
+
+	LTTNG_ASSERT(request_size >= sizeof(struct lttcomm_session_msg));
+
+	if (!_is_persistent) {
+		return lttcomm_send_creds_unix_sock(_socket.fd(), request, request_size) >= 0;
+	}
+
+	frame.data_size = request_size - sizeof(struct lttcomm_session_msg);
+	frame.fd_count = fd_count;
+	return lttcomm_send_creds_unix_sock(_socket.fd(), &frame, sizeof(frame)) >= 0 &&
+		lttcomm_send_unix_sock(_socket.fd(), request, request_size) >= 0;
+}
+
+int lttng_session_daemon_connection::_receive_reply(struct lttng_payload& reply)
+{
+	struct lttcomm_lttng_msg llm;
+	ssize_t ret;
+
+	ret = lttcomm_recv_unix_sock(_socket.fd(), &llm, sizeof(llm));
+	if (ret <= 0) {
+		return ret == 0 ? -LTTNG_ERR_NO_SESSIOND : -LTTNG_ERR_FATAL;
+	}
+
+	/* Packed fields can't be bound to references; copy to locals. */
+	const std::size_t reply_size = sizeof(llm) + llm.cmd_header_size + llm.data_size;
+	const std::size_t fd_count = llm.fd_count;
+
+	if (lttng_dynamic_buffer_set_size(&reply.buffer, reply_size)) {
+		return -LTTNG_ERR_NOMEM;
+	}
+
+	memcpy(reply.buffer.data, &llm, sizeof(llm));
+	if (reply_size > sizeof(llm)) {
+		ret = lttcomm_recv_unix_sock(
+			_socket.fd(), reply.buffer.data + sizeof(llm), reply_size - sizeof(llm));
+		if (ret <= 0) {
+			return ret == 0 ? -LTTNG_ERR_NO_SESSIOND : -LTTNG_ERR_FATAL;
+		}
+	}
+
+	if (fd_count > 0) {
+		ret = lttcomm_recv_payload_fds_unix_sock(_socket.fd(), fd_count, &reply);
+		if (ret <= 0) {
+			return -LTTNG_ERR_FATAL;
+		}
+	}
+
+	return 0;
+}
+
+template <typename SendRequestFunction>
+int lttng_session_daemon_connection::_execute(SendRequestFunction send_request,
+					      struct lttng_payload& reply)
+{
+	std::uint64_t tag;
+
+	LTTNG_ASSERT(reply.buffer.size == 0);
+
+	{
+		const std::lock_guard<std::mutex> send_lock(_send_lock);
+
+		{
+			const std::lock_guard<std::mutex> reply_lock(_reply_lock);
+
+			if (_error) {
+				return _error;
+			}
+
+			tag = _next_request_tag++;
+			_pending_replies.emplace(tag, pending_reply{ &reply, false });
+		}
+
+		if (!send_request()) {
+			const std::lock_guard<std::mutex> reply_lock(_reply_lock);
+
+			/*
+			 * The session daemon may have received part of the request:
+			 * the connection can't be used anymore. Shut it down to wake
+			 * up the thread receiving a reply, if any.
+			 */
+			_error = -LTTNG_ERR_FATAL;
+			(void) shutdown(_socket.fd(), SHUT_RDWR);
+			_reply_received.notify_all();
+		}
+	}
+
+	std::unique_lock<std::mutex> reply_lock(_reply_lock);
+
+	while (true) {
+		const auto pending_reply_it = _pending_replies.find(tag);
+
+		LTTNG_ASSERT(pending_reply_it != _pending_replies.end());
+		if (pending_reply_it->second.received) {
+			_pending_replies.erase(pending_reply_it);
+			return 0;
+		}
+
+		if (_error && !_is_receiving) {
+			/* Nobody is writing to `reply` anymore. */
+			_pending_replies.erase(pending_reply_it);
+			return _error;
+		}
+
+		if (!_error && !_is_receiving) {
+			/*
+			 * Receive the next reply, which belongs to this request or to
+			 * one which was sent before it.
+			 */
+			auto& next_pending_reply = _pending_replies.at(_next_reply_tag);
+
+			_is_receiving = true;
+			reply_lock.unlock();
+			const auto ret = _receive_reply(*next_pending_reply.reply);
+			reply_lock.lock();
+			_is_receiving = false;
+
+			if (ret < 0) {
+				_error = ret;
+			} else {
+				next_pending_reply.received = true;
+				_next_reply_tag++;
+			}
+
+			_reply_received.notify_all();
+			continue;
+		}
+
+		_reply_received.wait(reply_lock);
+	}
+}
+
+int lttng_session_daemon_connection::execute(const void *request,
+					     std::size_t request_size,
+					     const int *fds,
+					     std::size_t fd_count,
+					     struct lttng_payload& reply)
+{
+	return _execute(
+		[&]() {
+			if (!_send_request_data(request, request_size, fd_count)) {
+				return false;
+			}
+
+			return fd_count == 0 ||
+				lttcomm_send_fds_unix_sock(_socket.fd(), fds, fd_count) >= 0;
+		},
+		reply);
+}
+
+int lttng_session_daemon_connection::execute(struct lttng_payload_view& request,
+					     struct lttng_payload& reply)
+{
+	return _execute(
+		[&]() {
+			const auto fd_count = lttng_payload_view_get_fd_handle_count(&request);
+
+			if (fd_count < 0 ||
+			    !_send_request_data(
+				    request.buffer.data, request.buffer.size, fd_count)) {
+				return false;
+			}
+
+			if (fd_count == 0) {
+				return true;
+			}
+
+			return lttcomm_send_payload_view_fds_unix_sock(_socket.fd(), &request) >= 0;
+		},
+		reply);
+}
+
+int lttng_session_daemon_connection::enable_persistence()
+{
+	struct lttcomm_session_msg lsm;
+	struct lttng_payload reply;
+
+	LTTNG_ASSERT(!_is_persistent);
+
+	lttng_payload_init(&reply);
+	const auto reset_reply =
+		lttng::make_scope_exit([&reply]() noexcept { lttng_payload_reset(&reply); });
+
+	memset(&lsm, 0, sizeof(lsm));
+	lsm.cmd_type = LTTCOMM_SESSIOND_COMMAND_ENABLE_PERSISTENT_CONNECTION;
+
+	const auto ret = execute(&lsm, sizeof(lsm), nullptr, 0, reply);
+	if (ret < 0) {
+		return ret;
+	}
+
+	const auto ret_code =
+		reinterpret_cast<const struct lttcomm_lttng_msg *>(reply.buffer.data)->ret_code;
+	if (ret_code != LTTNG_OK) {
+		DBG_FMT("Session daemon refused to enable the persistent connection: ret_code={}",
+			ret_code);
+		return ret_code > LTTNG_OK && ret_code < LTTNG_ERR_NR ? -ret_code : -LTTNG_ERR_UNK;
+	}
+
+	_is_persistent = true;
+	return 0;
+}
+
+struct lttng_session_daemon_connection *
+lttng_ctl_get_current_sessiond_connection(enum lttcomm_sessiond_command command_type)
+{
+	switch (command_type) {
+	case LTTCOMM_SESSIOND_COMMAND_DESTROY_SESSION:
+	case LTTCOMM_SESSIOND_COMMAND_CLEAR_SESSION:
+	case LTTCOMM_SESSIOND_COMMAND_RECLAIM_CHANNEL_MEMORY:
+		/*
+		 * The session daemon may take ownership of the socket to reply
+		 * asynchronously, which ends the connection.
+		 */
+		return nullptr;
+	default:
+		return current_connection;
+	}
+}
+
+enum lttng_session_daemon_connection_status
+lttng_session_daemon_connection_create(struct lttng_session_daemon_connection **connection)
+{
+	if (!connection) {
+		return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_INVALID;
+	}
+
+	const auto sessiond_socket_fd = connect_sessiond();
+	if (sessiond_socket_fd < 0) {
+		return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_NO_SESSION_DAEMON;
+	}
+
+	lttng::stream_descriptor sessiond_socket(sessiond_socket_fd);
+	std::unique_ptr<lttng_session_daemon_connection> new_connection(
+		new (std::nothrow) lttng_session_daemon_connection(std::move(sessiond_socket)));
+	if (!new_connection) {
+		return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_ERROR;
+	}
+
+	const auto ret = new_connection->enable_persistence();
+	switch (ret) {
+	case 0:
+		break;
+	case -LTTNG_ERR_NO_SESSIOND:
+		return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_NO_SESSION_DAEMON;
+	case -LTTNG_ERR_UND:
+		return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_UNSUPPORTED;
+	default:
+		return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_ERROR;
+	}
+
+	*connection = new_connection.release();
+	return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_OK;
+}
+
+enum lttng_session_daemon_connection_status
+lttng_session_daemon_connection_set_current(struct lttng_session_daemon_connection *connection)
+{
+	current_connection = connection;
+	return LTTNG_SESSION_DAEMON_CONNECTION_STATUS_OK;
+}
+
+void lttng_session_daemon_connection_destroy(struct lttng_session_daemon_connection *connection)
+{
+	delete connection;
+}
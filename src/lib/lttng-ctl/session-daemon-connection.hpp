@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+
+#ifndef LTTNG_CTL_SESSION_DAEMON_CONNECTION_HPP
+#define LTTNG_CTL_SESSION_DAEMON_CONNECTION_HPP
+
+#include <common/payload-view.hpp>
+#include <common/payload.hpp>
+#include <common/sessiond-comm/sessiond-comm.hpp>
+#include <common/stream-descriptor.hpp>
+
+#include <lttng/session-daemon-connection.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+/*
+ * A persistent connection to the session daemon, shared by any number of
+ * threads.
+ *
+ * The session daemon processes the commands received on a connection one at a
+ * time and replies in the same order. Each request is tagged with a sequence
+ * number when it is sent, which makes it possible for many threads to send
+ * their request without waiting for the reply to the previous one: the replies
+ * are matched to their request by order of arrival.
+ *
+ * Whichever thread waits for a reply receives the replies in order (on behalf
+ * of the other waiting threads) until its own reply arrives.
+ */
+struct lttng_session_daemon_connection {
+public:
+	explicit lttng_session_daemon_connection(lttng::stream_descriptor socket);
+
+	/* Deactivate copy and assignment. */
+	lttng_session_daemon_connection(const lttng_session_daemon_connection&) = delete;
+	lttng_session_daemon_connection(lttng_session_daemon_connection&&) = delete;
+	lttng_session_daemon_connection& operator=(const lttng_session_daemon_connection&) = delete;
+	lttng_session_daemon_connection& operator=(lttng_session_daemon_connection&&) = delete;
+	~lttng_session_daemon_connection() = default;
+
+	/*
+	 * Ask the session daemon to keep the connection open after each reply.
+	 * Must be called before the connection is shared.
+	 *
+	 * Once enabled, each request is preceded by a frame announcing the size
+	 * of its variable length data and its fd count (see
+	 * `struct lttcomm_session_msg_frame`).
+	 *
+	 * Returns 0 on success or else a negative lttng error code
+	 * (-LTTNG_ERR_UND if the session daemon doesn't support persistent
+	 * connections).
+	 */
+	int enable_persistence();
+
+	/*
+	 * Send a request (a `struct lttcomm_session_msg` followed by its
+	 * variable length data) and the file descriptors `fds`, and wait for
+	 * the reply.
+	 *
+	 * On success, `reply` contains the complete reply, including its
+	 * `struct lttcomm_lttng_msg` header, and 0 is returned. On error, a
+	 * negative lttng error code is returned.
+	 */
+	int execute(const void *request,
+		    std::size_t request_size,
+		    const int *fds,
+		    std::size_t fd_count,
+		    struct lttng_payload& reply);
+	int execute(struct lttng_payload_view& request, struct lttng_payload& reply);
+
+private:
+	struct pending_reply {
+		struct lttng_payload *reply;
+		bool received;
+	};
+
+	template <typename SendRequestFunction>
+	int _execute(SendRequestFunction send_request, struct lttng_payload& reply);
+	bool
+	_send_request_data(const void *request, std::size_t request_size, std::size_t fd_count);
+	int _receive_reply(struct lttng_payload& reply);
+
+	const lttng::stream_descriptor _socket;
+	/* Requests are framed once the session daemon keeps the connection open. */
+	bool _is_persistent = false;
+
+	/* Protects the sending of the requests and `_next_request_tag`. */
+	std::mutex _send_lock;
+	std::uint64_t _next_request_tag = 0;
+
+	/* Protects the members below. */
+	std::mutex _reply_lock;
+	std::condition_variable _reply_received;
+	/* Tag of the request to which the next reply to receive belongs. */
+	std::uint64_t _next_reply_tag = 0;
+	/* A thread is receiving a reply, with `_reply_lock` released. */
+	bool _is_receiving = false;
+	/*
+	 * Negative lttng error code set when the connection is broken: the
+	 * outstanding and future requests fail.
+	 */
+	int _error = 0;
+	std::unordered_map<std::uint64_t, pending_reply> _pending_replies;
+};
+
+/*
+ * Persistent session daemon connection used by the current thread, if any (see
+ * lttng_session_daemon_connection_set_current()).
+ *
+ * Returns `nullptr` if commands of type `command_type` must be sent on a
+ * connection of their own.
+ */
+struct lttng_session_daemon_connection *
+lttng_ctl_get_current_sessiond_connection(enum lttcomm_sessiond_command command_type);
+
+#endif /* LTTNG_CTL_SESSION_DAEMON_CONNECTION_HPP */
@@ -354,6 +354,172 @@ DEFINE_TRACKER_ADD_REMOVE_STRING_VALUE_FUNC(ADD, add, virtual_group_id, group_na
 DEFINE_TRACKER_ADD_REMOVE_STRING_VALUE_FUNC(
 	REMOVE, remove, virtual_group_id, group_name, GROUP_NAME);
 
+static enum lttng_process_attr_tracker_handle_status
+process_attr_tracker_handle_status_from_error_code(enum lttng_error_code ret_code)
+{
+	switch (ret_code) {
+	case LTTNG_OK:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK;
+	case LTTNG_ERR_PROCESS_ATTR_EXISTS:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS;
+	case LTTNG_ERR_PROCESS_ATTR_MISSING:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING;
+	case LTTNG_ERR_PROCESS_ATTR_TRACKER_INVALID_TRACKING_POLICY:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID_TRACKING_POLICY;
+	case LTTNG_ERR_USER_NOT_FOUND:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_USER_NOT_FOUND;
+	case LTTNG_ERR_GROUP_NOT_FOUND:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_GROUP_NOT_FOUND;
+	case LTTNG_ERR_SESSION_NOT_EXIST:
+	case LTTNG_ERR_SESS_NOT_FOUND:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_SESSION_DOES_NOT_EXIST;
+	default:
+		return LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_ERROR;
+	}
+}
+
+/*
+ * Send a set of values to add to, or remove from, the inclusion set of a
+ * tracker in a single command. The session daemon replies with the outcome of
+ * the operation for each value, in order.
+ */
+static enum lttng_process_attr_tracker_handle_status
+process_attr_tracker_handle_add_remove_values(
+	const struct lttng_process_attr_tracker_handle *tracker,
+	enum lttcomm_sessiond_command command_type,
+	const struct lttng_process_attr_values *values,
+	enum lttng_process_attr_tracker_handle_status *statuses)
+{
+	int ret;
+	enum lttng_process_attr_tracker_handle_status status =
+		LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK;
+	const unsigned int count = _lttng_process_attr_values_get_count(values);
+	int32_t *value_ret_codes = nullptr;
+	struct lttng_dynamic_buffer payload;
+	struct lttcomm_session_msg lsm = {
+		.cmd_type = command_type,
+		.session = {},
+		.domain = {},
+		.u = {},
+		.fd_count = 0,
+	};
+
+	lttng_dynamic_buffer_init(&payload);
+
+	ret = lttng_strncpy(lsm.session.name, tracker->session_name, sizeof(lsm.session.name));
+	if (ret) {
+		status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID;
+		goto end;
+	}
+
+	ret = lttng_process_attr_values_serialize(values, &payload);
+	if (ret) {
+		status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_ERROR;
+		goto end;
+	}
+
+	if (payload.size > LTTNG_PROCESS_ATTR_VALUES_MAX_LEN) {
+		status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID;
+		goto end;
+	}
+
+	lsm.domain.type = tracker->domain;
+	lsm.u.process_attr_tracker_add_remove_include_values.process_attr =
+		(int32_t) tracker->process_attr;
+	lsm.u.process_attr_tracker_add_remove_include_values.length = (uint32_t) payload.size;
+
+	ret = lttng_ctl_ask_sessiond_varlen_no_cmd_header(
+		&lsm, payload.data, payload.size, (void **) &value_ret_codes);
+	if (ret < 0) {
+		status = process_attr_tracker_handle_status_from_error_code(
+			(enum lttng_error_code) - ret);
+		goto end;
+	}
+
+	if ((size_t) ret != count * sizeof(*value_ret_codes)) {
+		status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_COMMUNICATION_ERROR;
+		goto end;
+	}
+
+	if (statuses) {
+		for (unsigned int i = 0; i < count; i++) {
+			statuses[i] = process_attr_tracker_handle_status_from_error_code(
+				(enum lttng_error_code) value_ret_codes[i]);
+		}
+	}
+end:
+	free(value_ret_codes);
+	lttng_dynamic_buffer_reset(&payload);
+	return status;
+}
+
+#define DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(command_upper,                                          \
+						       command_lower,                                          \
+						       process_attr_name,                                      \
+						       value_type_name,                                        \
+						       value_type_c,                                           \
+						       value_type_enum)                                        \
+	enum lttng_process_attr_tracker_handle_status                                                          \
+		lttng_process_attr_##process_attr_name##_tracker_handle_##command_lower##_##value_type_name##s( \
+			const struct lttng_process_attr_tracker_handle *tracker,                               \
+			const value_type_c *values,                                                            \
+			unsigned int count,                                                                    \
+			enum lttng_process_attr_tracker_handle_status *statuses)                               \
+	{                                                                                                      \
+		enum lttng_process_attr_tracker_handle_status status;                                          \
+		struct lttng_process_attr_values *value_set = nullptr;                                         \
+                                                                                                               \
+		if (!tracker || (count > 0 && !values)) {                                                      \
+			status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID;                             \
+			goto end;                                                                              \
+		}                                                                                              \
+                                                                                                               \
+		value_set = lttng_process_attr_values_create();                                                \
+		if (!value_set) {                                                                              \
+			status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_ERROR;                               \
+			goto end;                                                                              \
+		}                                                                                              \
+                                                                                                               \
+		for (unsigned int i = 0; i < count; i++) {                                                     \
+			auto *value = zmalloc<process_attr_value>();                                           \
+                                                                                                               \
+			if (!value) {                                                                          \
+				status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_ERROR;                       \
+				goto end;                                                                      \
+			}                                                                                      \
+                                                                                                               \
+			value->type = LTTNG_PROCESS_ATTR_VALUE_TYPE_##value_type_enum;                         \
+			value->value.value_type_name = values[i];                                              \
+			if (lttng_dynamic_pointer_array_add_pointer(&value_set->array, value)) {               \
+				process_attr_value_destroy(value);                                             \
+				status = LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_ERROR;                       \
+				goto end;                                                                      \
+			}                                                                                      \
+		}                                                                                              \
+                                                                                                               \
+		status = process_attr_tracker_handle_add_remove_values(                                        \
+			tracker,                                                                               \
+			LTTCOMM_SESSIOND_COMMAND_PROCESS_ATTR_TRACKER_##command_upper##_INCLUDE_VALUES,        \
+			value_set,                                                                             \
+			statuses);                                                                             \
+	end:                                                                                                   \
+		lttng_process_attr_values_destroy(value_set);                                                  \
+		return status;                                                                                 \
+	}
+
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(ADD, add, process_id, pid, pid_t, PID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(REMOVE, remove, process_id, pid, pid_t, PID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(ADD, add, virtual_process_id, pid, pid_t, PID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(REMOVE, remove, virtual_process_id, pid, pid_t, PID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(ADD, add, user_id, uid, uid_t, UID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(REMOVE, remove, user_id, uid, uid_t, UID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(ADD, add, virtual_user_id, uid, uid_t, UID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(REMOVE, remove, virtual_user_id, uid, uid_t, UID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(ADD, add, group_id, gid, gid_t, GID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(REMOVE, remove, group_id, gid, gid_t, GID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(ADD, add, virtual_group_id, gid, gid_t, GID);
+DEFINE_TRACKER_ADD_REMOVE_INTEGRAL_VALUES_FUNC(REMOVE, remove, virtual_group_id, gid, gid_t, GID);
+
 enum lttng_process_attr_tracker_handle_status lttng_process_attr_tracker_handle_get_inclusion_set(
 	struct lttng_process_attr_tracker_handle *tracker,
 	const struct lttng_process_attr_values **values)
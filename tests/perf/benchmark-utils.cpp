@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "benchmark-utils.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+bool get_process_cpu_ticks(pid_t pid, uint64_t& ticks)
+{
+	const auto stat_path = "/proc/" + std::to_string(pid) + "/stat";
+	auto *stat_file = fopen(stat_path.c_str(), "r");
+	char stat_line[1024];
+	bool found = false;
+
+	if (!stat_file) {
+		return false;
+	}
+
+	if (fgets(stat_line, sizeof(stat_line), stat_file)) {
+		/* Skip the command name, which may contain spaces. */
+		const char *fields = strrchr(stat_line, ')');
+		unsigned long utime, stime;
+
+		found = fields &&
+			sscanf(fields + 2,
+			       "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+			       &utime,
+			       &stime) == 2;
+		if (found) {
+			ticks = utime + stime;
+		}
+	}
+
+	fclose(stat_file);
+	return found;
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted_values, double percent)
+{
+	if (sorted_values.empty()) {
+		return 0;
+	}
+
+	const auto rank = static_cast<std::size_t>(percent / 100.0 * (sorted_values.size() - 1));
+	return sorted_values[rank];
+}
@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef LTTNG_TESTS_PERF_BENCHMARK_UTILS_HPP
+#define LTTNG_TESTS_PERF_BENCHMARK_UTILS_HPP
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <vector>
+
+/* User and system CPU time consumed by a process, in clock ticks. */
+bool get_process_cpu_ticks(pid_t pid, uint64_t& ticks);
+
+/* Value at `percent` (0 to 100) of a sorted list of values, 0 if it is empty. */
+uint32_t percentile(const std::vector<uint32_t>& sorted_values, double percent);
+
+#endif /* LTTNG_TESTS_PERF_BENCHMARK_UTILS_HPP */
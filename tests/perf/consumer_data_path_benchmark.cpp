@@ -0,0 +1,803 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+/*
+ * Measure the data path of the consumer daemon without a tracer.
+ *
+ * The streams of a kernel consumer channel are created as lttng-consumerd
+ * does, but their `get_next_subbuffer`, `extract_subbuffer_info` and
+ * `put_next_subbuffer` operations are replaced by stand-ins reading from
+ * in-process ring buffers. Those ring buffers are made of shared memory files,
+ * one per sub-buffer, so that both the mmap and the splice output paths can be
+ * exercised. A producer thread per stream fills the sub-buffers as fast as
+ * the consumer releases them while a single consumer thread, like the data
+ * thread of lttng-consumerd, calls lttng_consumer_read_subbuffer() on each
+ * stream in turn.
+ *
+ * The benchmark reports the sub-buffers and bytes consumed per second, the
+ * number of system calls made by the consumer thread per sub-buffer (when the
+ * `raw_syscalls:sys_enter` tracepoint is available to perf_event_open()), and
+ * the distribution of the time taken to consume a sub-buffer.
+ *
+ * This is not part of the test suite; run it manually once per output:
+ *   ./consumer_data_path_benchmark --output=disk --path=/tmp/consumer-benchmark
+ *   ./consumer_data_path_benchmark --output=null --mode=splice
+ *   lttng-relayd -d -o /tmp/relayd-output
+ *   ./consumer_data_path_benchmark --output=relayd --url=net://localhost
+ */
+
+#include "benchmark-utils.hpp"
+
+#include <common/compat/directory-handle.hpp>
+#include <common/compat/endian.hpp>
+#include <common/consumer/consumer-stream.hpp>
+#include <common/consumer/consumer.hpp>
+#include <common/defaults.hpp>
+#include <common/error.hpp>
+#include <common/relayd/relayd.hpp>
+#include <common/sessiond-comm/relayd.hpp>
+#include <common/trace-chunk.hpp>
+#include <common/urcu.hpp>
+#include <common/uri.hpp>
+#include <common/utils.hpp>
+#include <common/uuid.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <linux/perf_event.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* For error.h */
+int lttng_opt_quiet = 1;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+/* Defined by lttng-consumerd and used by the consumer library. */
+struct health_app *health_consumerd;
+int health_quit_pipe[2] = { -1, -1 };
+
+namespace {
+/* CTF packet header magic number. */
+constexpr uint32_t ctf_magic = 0xC1FC1FC1;
+constexpr uint64_t benchmark_session_id = 1;
+constexpr uint64_t benchmark_channel_key = 1;
+constexpr uint64_t benchmark_relayd_id = 0;
+
+enum class benchmark_output {
+	DISK,
+	NUL,
+	RELAYD,
+};
+
+struct benchmark_config {
+	benchmark_output output = benchmark_output::DISK;
+	enum lttng_event_output mode = LTTNG_EVENT_MMAP;
+	std::string path = "/tmp/lttng-consumer-benchmark";
+	std::string url = "net://localhost";
+	unsigned int stream_count = 4;
+	std::size_t subbuffer_size = 256 * 1024;
+	unsigned int subbuffer_count = 4;
+	std::chrono::seconds duration{ 10 };
+};
+
+/*
+ * Stand-in for the ring buffer of a tracer.
+ *
+ * Each sub-buffer is a shared memory file mapped in the address space of the
+ * benchmark: the mmap output path reads the mapping while the splice output
+ * path reads the file, from its beginning, as it does with the sub-buffer
+ * file descriptor of an lttng-modules ring buffer.
+ */
+class standin_ring_buffer {
+public:
+	standin_ring_buffer(std::size_t subbuffer_size, unsigned int subbuffer_count) :
+		_subbuffer_size(subbuffer_size)
+	{
+		for (unsigned int i = 0; i < subbuffer_count; i++) {
+			const auto shm_path = "/lttng-consumer-benchmark-" +
+				std::to_string(getpid()) + "-" +
+				std::to_string(reinterpret_cast<uintptr_t>(this)) + "-" +
+				std::to_string(i);
+			const int fd = shm_open(
+				shm_path.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+			if (fd < 0) {
+				PERROR("Failed to create sub-buffer shared memory file");
+				return;
+			}
+
+			(void) shm_unlink(shm_path.c_str());
+			_subbuffer_fds.push_back(fd);
+
+			if (ftruncate(fd, subbuffer_size)) {
+				PERROR("Failed to size sub-buffer shared memory file");
+				return;
+			}
+
+			auto *subbuffer = static_cast<char *>(mmap(nullptr,
+								   subbuffer_size,
+								   PROT_READ | PROT_WRITE,
+								   MAP_SHARED,
+								   fd,
+								   0));
+			if (subbuffer == MAP_FAILED) {
+				PERROR("Failed to map sub-buffer");
+				return;
+			}
+
+			_subbuffers.push_back(subbuffer);
+		}
+	}
+
+	~standin_ring_buffer()
+	{
+		for (auto *subbuffer : _subbuffers) {
+			(void) munmap(subbuffer, _subbuffer_size);
+		}
+
+		for (const auto fd : _subbuffer_fds) {
+			(void) close(fd);
+		}
+	}
+
+	/* Deactivate copy and assignment. */
+	standin_ring_buffer(const standin_ring_buffer&) = delete;
+	standin_ring_buffer(standin_ring_buffer&&) = delete;
+	standin_ring_buffer& operator=(const standin_ring_buffer&) = delete;
+	standin_ring_buffer& operator=(standin_ring_buffer&&) = delete;
+
+	bool is_valid() const noexcept
+	{
+		return !_subbuffers.empty() && _subbuffers.size() == _subbuffer_fds.size();
+	}
+
+	/* Fill the sub-buffers until `stop` is set, waiting for the consumer when full. */
+	void produce(uint64_t stream_key, const std::atomic<bool>& stop)
+	{
+		uint64_t position = 0;
+
+		while (!stop.load(std::memory_order_relaxed)) {
+			if (position - consumed_count.load(std::memory_order_acquire) ==
+			    _subbuffers.size()) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			auto *subbuffer = this->subbuffer(position);
+			const auto magic = htobe32(ctf_magic);
+			const auto sequence_number = htobe64(position);
+
+			/* Synthetic packet: a CTF packet header magic and a payload. */
+			memset(subbuffer, static_cast<int>(stream_key + position), _subbuffer_size);
+			memcpy(subbuffer, &magic, sizeof(magic));
+			memcpy(subbuffer + sizeof(magic) + LTTNG_UUID_LEN,
+			       &sequence_number,
+			       sizeof(sequence_number));
+			position++;
+			produced_count.store(position, std::memory_order_release);
+		}
+	}
+
+	std::size_t subbuffer_size() const noexcept
+	{
+		return _subbuffer_size;
+	}
+
+	unsigned int subbuffer_count() const noexcept
+	{
+		return _subbuffers.size();
+	}
+
+	char *subbuffer(uint64_t position) const noexcept
+	{
+		return _subbuffers[position % _subbuffers.size()];
+	}
+
+	int subbuffer_fd(uint64_t position) const noexcept
+	{
+		return _subbuffer_fds[position % _subbuffer_fds.size()];
+	}
+
+	std::atomic<uint64_t> produced_count{ 0 };
+	std::atomic<uint64_t> consumed_count{ 0 };
+
+private:
+	const std::size_t _subbuffer_size;
+	std::vector<char *> _subbuffers;
+	std::vector<int> _subbuffer_fds;
+};
+
+/* Ring buffers of the streams, indexed by stream key. */
+std::vector<std::unique_ptr<standin_ring_buffer>> ring_buffers;
+
+int extract_subbuffer_info(struct lttng_consumer_stream *stream, struct stream_subbuffer *subbuffer)
+{
+	const auto& ring_buffer = *ring_buffers[stream->key];
+	const auto position = ring_buffer.consumed_count.load(std::memory_order_relaxed);
+	const uint64_t size_bits = ring_buffer.subbuffer_size() * CHAR_BIT;
+
+	subbuffer->info.data.subbuf_size = ring_buffer.subbuffer_size();
+	subbuffer->info.data.padded_subbuf_size = ring_buffer.subbuffer_size();
+	subbuffer->info.data.packet_size = size_bits;
+	subbuffer->info.data.content_size = size_bits;
+	subbuffer->info.data.timestamp_begin = position;
+	subbuffer->info.data.timestamp_end = position + 1;
+	subbuffer->info.data.events_discarded = 0;
+	LTTNG_OPTIONAL_SET(&subbuffer->info.data.sequence_number, position);
+	subbuffer->info.data.stream_id = 0;
+	LTTNG_OPTIONAL_SET(&subbuffer->info.data.stream_instance_id, stream->key);
+	return 0;
+}
+
+enum get_next_subbuffer_status get_next_subbuffer(struct lttng_consumer_stream *stream,
+						  struct stream_subbuffer *subbuffer)
+{
+	const auto& ring_buffer = *ring_buffers[stream->key];
+	const auto position = ring_buffer.consumed_count.load(std::memory_order_relaxed);
+
+	if (ring_buffer.produced_count.load(std::memory_order_acquire) == position) {
+		return GET_NEXT_SUBBUFFER_STATUS_NO_DATA;
+	}
+
+	if (stream->read_subbuffer_ops.extract_subbuffer_info(stream, subbuffer)) {
+		return GET_NEXT_SUBBUFFER_STATUS_ERROR;
+	}
+
+	if (stream->output == LTTNG_EVENT_SPLICE) {
+		/* The splice output path reads the sub-buffer through the stream's wait fd. */
+		stream->wait_fd = ring_buffer.subbuffer_fd(position);
+		subbuffer->buffer.fd = stream->wait_fd;
+	} else {
+		subbuffer->buffer.buffer = lttng_buffer_view_init(
+			ring_buffer.subbuffer(position), 0, ring_buffer.subbuffer_size());
+	}
+
+	return GET_NEXT_SUBBUFFER_STATUS_OK;
+}
+
+int put_next_subbuffer(struct lttng_consumer_stream *stream,
+		       struct stream_subbuffer *subbuffer __attribute__((unused)))
+{
+	auto& ring_buffer = *ring_buffers[stream->key];
+
+	ring_buffer.consumed_count.fetch_add(1, std::memory_order_release);
+	return 0;
+}
+
+void print_usage(const char *program_name)
+{
+	fprintf(stderr,
+		"Usage: %s [OPTIONS]\n"
+		"\n"
+		"  -o, --output=OUTPUT          disk, null or relayd (default: disk)\n"
+		"  -m, --mode=MODE              mmap or splice (default: mmap)\n"
+		"  -p, --path=PATH              Output directory of the disk and null outputs,\n"
+		"                               which also receives the index files\n"
+		"                               (default: /tmp/lttng-consumer-benchmark)\n"
+		"  -u, --url=URL                Relay daemon URL (default: net://localhost)\n"
+		"  -n, --streams=COUNT          Number of streams (default: 4)\n"
+		"  -s, --subbuf-size=SIZE       Size of the sub-buffers, in bytes (default: 262144)\n"
+		"  -c, --subbuf-count=COUNT     Number of sub-buffers per stream (default: 4)\n"
+		"  -d, --duration=SECONDS       Duration of the measurement (default: 10)\n",
+		program_name);
+}
+
+bool parse_arguments(int argc, char **argv, benchmark_config& config)
+{
+	static const struct option long_options[] = {
+		{ "output", required_argument, nullptr, 'o' },
+		{ "mode", required_argument, nullptr, 'm' },
+		{ "path", required_argument, nullptr, 'p' },
+		{ "url", required_argument, nullptr, 'u' },
+		{ "streams", required_argument, nullptr, 'n' },
+		{ "subbuf-size", required_argument, nullptr, 's' },
+		{ "subbuf-count", required_argument, nullptr, 'c' },
+		{ "duration", required_argument, nullptr, 'd' },
+		{ "help", no_argument, nullptr, 'h' },
+		{ nullptr, 0, nullptr, 0 },
+	};
+	int option;
+
+	while ((option = getopt_long(argc, argv, "o:m:p:u:n:s:c:d:h", long_options, nullptr)) !=
+	       -1) {
+		switch (option) {
+		case 'o':
+			if (!strcmp(optarg, "disk")) {
+				config.output = benchmark_output::DISK;
+			} else if (!strcmp(optarg, "null")) {
+				config.output = benchmark_output::NUL;
+			} else if (!strcmp(optarg, "relayd")) {
+				config.output = benchmark_output::RELAYD;
+			} else {
+				return false;
+			}
+			break;
+		case 'm':
+			if (!strcmp(optarg, "mmap")) {
+				config.mode = LTTNG_EVENT_MMAP;
+			} else if (!strcmp(optarg, "splice")) {
+				config.mode = LTTNG_EVENT_SPLICE;
+			} else {
+				return false;
+			}
+			break;
+		case 'p':
+			config.path = optarg;
+			break;
+		case 'u':
+			config.url = optarg;
+			break;
+		case 'n':
+			config.stream_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 's':
+			config.subbuffer_size = strtoull(optarg, nullptr, 10);
+			break;
+		case 'c':
+			config.subbuffer_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 'd':
+			config.duration = std::chrono::seconds(strtoul(optarg, nullptr, 10));
+			break;
+		default:
+			return false;
+		}
+	}
+
+	/* The packet must at least hold its header. */
+	return config.stream_count > 0 && config.subbuffer_count > 0 &&
+		config.subbuffer_size >= sizeof(uint32_t) + LTTNG_UUID_LEN + sizeof(uint64_t) &&
+		config.duration.count() > 0;
+}
+
+/*
+ * Open a counter of the system calls made by the calling thread.
+ *
+ * Returns -1 when the `raw_syscalls:sys_enter` tracepoint is unavailable or
+ * when the user is not allowed to use it.
+ */
+int open_syscall_counter()
+{
+	static const char *const tracepoint_id_paths[] = {
+		"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+		"/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id",
+	};
+	unsigned long long tracepoint_id;
+	bool found = false;
+
+	for (const auto *path : tracepoint_id_paths) {
+		auto *id_file = fopen(path, "r");
+
+		if (!id_file) {
+			continue;
+		}
+
+		found = fscanf(id_file, "%llu", &tracepoint_id) == 1;
+		fclose(id_file);
+		if (found) {
+			break;
+		}
+	}
+
+	if (!found) {
+		return -1;
+	}
+
+	struct perf_event_attr attr = {};
+	attr.type = PERF_TYPE_TRACEPOINT;
+	attr.size = sizeof(attr);
+	attr.config = tracepoint_id;
+	attr.sample_period = 1;
+
+	return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Connect to the relay daemon and register the connection as the consumer's relayd. */
+bool add_relayd(const benchmark_config& config,
+		struct lttng_trace_chunk *trace_chunk,
+		struct lttng_consumer_local_data *ctx)
+{
+	struct lttng_uri *uris = nullptr;
+	struct lttcomm_relayd_sock *control_sock = nullptr, *data_sock = nullptr;
+	char hostname[LTTNG_HOST_NAME_MAX] = {};
+	char output_path[LTTNG_PATH_MAX];
+	uint64_t relayd_session_id;
+	lttng_uuid sessiond_uuid;
+	bool added = false;
+
+	if (uri_parse(config.url.c_str(), &uris) != 2) {
+		fprintf(stderr, "Invalid relay daemon URL: %s\n", config.url.c_str());
+		goto end;
+	}
+
+	control_sock = lttcomm_alloc_relayd_sock(
+		&uris[0], RELAYD_VERSION_COMM_MAJOR, RELAYD_VERSION_COMM_MINOR);
+	data_sock = lttcomm_alloc_relayd_sock(
+		&uris[1], RELAYD_VERSION_COMM_MAJOR, RELAYD_VERSION_COMM_MINOR);
+	if (!control_sock || !data_sock || relayd_connect(control_sock) < 0 ||
+	    relayd_connect(data_sock) < 0) {
+		fprintf(stderr,
+			"Failed to connect to the relay daemon at %s\n",
+			config.url.c_str());
+		goto end;
+	}
+
+	(void) gethostname(hostname, sizeof(hostname) - 1);
+	if (relayd_version_check(control_sock) || lttng_uuid_generate(sessiond_uuid) ||
+	    relayd_create_session(control_sock,
+				  &relayd_session_id,
+				  "consumer-data-path-benchmark",
+				  hostname,
+				  nullptr,
+				  0,
+				  0,
+				  benchmark_session_id,
+				  sessiond_uuid,
+				  nullptr,
+				  time(nullptr),
+				  false,
+				  LTTNG_TRACE_FORMAT_DEFAULT,
+				  output_path) ||
+	    relayd_create_trace_chunk(control_sock, trace_chunk)) {
+		fprintf(stderr, "Failed to create a session on the relay daemon\n");
+		goto end;
+	}
+
+	{
+		auto *relayd = zmalloc<consumer_relayd_sock_pair>();
+
+		if (!relayd) {
+			goto end;
+		}
+
+		relayd->net_seq_idx = benchmark_relayd_id;
+		relayd->control_sock = *control_sock;
+		relayd->data_sock = *data_sock;
+		relayd->relayd_session_id = relayd_session_id;
+		relayd->sessiond_session_id = benchmark_session_id;
+		relayd->ctx = ctx;
+		pthread_mutex_init(&relayd->ctrl_sock_mutex, nullptr);
+		lttng_ht_node_init_u64(&relayd->node, relayd->net_seq_idx);
+
+		const lttng::urcu::read_lock_guard read_lock;
+		lttng_ht_add_unique_u64(the_consumer_data.relayd_ht, &relayd->node);
+	}
+
+	/* The relayd now owns the connections. */
+	free(control_sock);
+	free(data_sock);
+	control_sock = nullptr;
+	data_sock = nullptr;
+	added = true;
+
+end:
+	if (control_sock) {
+		(void) relayd_close(control_sock);
+		free(control_sock);
+	}
+
+	if (data_sock) {
+		(void) relayd_close(data_sock);
+		free(data_sock);
+	}
+
+	free(uris);
+	return added;
+}
+
+/* Create a trace chunk owning the output directory of the disk and null outputs. */
+struct lttng_trace_chunk *create_local_trace_chunk(const benchmark_config& config)
+{
+	struct lttng_trace_chunk *trace_chunk = nullptr;
+	struct lttng_directory_handle *output_directory = nullptr;
+
+	if (utils_mkdir_recursive(config.path.c_str(), S_IRWXU | S_IRWXG, -1, -1)) {
+		fprintf(stderr, "Failed to create output directory `%s`\n", config.path.c_str());
+		goto error;
+	}
+
+	output_directory = lttng_directory_handle_create(config.path.c_str());
+	trace_chunk = lttng_trace_chunk_create(0, time(nullptr), nullptr);
+	if (!output_directory || !trace_chunk ||
+	    lttng_trace_chunk_set_credentials_current_user(trace_chunk) !=
+		    LTTNG_TRACE_CHUNK_STATUS_OK ||
+	    lttng_trace_chunk_set_as_owner(trace_chunk, output_directory) !=
+		    LTTNG_TRACE_CHUNK_STATUS_OK ||
+	    lttng_trace_chunk_create_subdirectory(trace_chunk, DEFAULT_KERNEL_TRACE_DIR) !=
+		    LTTNG_TRACE_CHUNK_STATUS_OK) {
+		fprintf(stderr, "Failed to create trace chunk in `%s`\n", config.path.c_str());
+		goto error;
+	}
+
+	lttng_directory_handle_put(output_directory);
+	return trace_chunk;
+
+error:
+	lttng_directory_handle_put(output_directory);
+	lttng_trace_chunk_put(trace_chunk);
+	return nullptr;
+}
+
+/* Create a data stream of `channel` reading its sub-buffers from a stand-in ring buffer. */
+struct lttng_consumer_stream *create_stream(const benchmark_config& config,
+					    struct lttng_consumer_channel *channel,
+					    struct lttng_trace_chunk *trace_chunk,
+					    uint64_t stream_key,
+					    int null_fd)
+{
+	int alloc_ret;
+	const bool is_relayd = config.output == benchmark_output::RELAYD;
+	auto *stream = consumer_stream_create(channel,
+					      channel->key,
+					      stream_key,
+					      channel->name,
+					      is_relayd ? benchmark_relayd_id : -1ULL,
+					      benchmark_session_id,
+					      trace_chunk,
+					      stream_key,
+					      &alloc_ret,
+					      CONSUMER_CHANNEL_TYPE_DATA_PER_CPU,
+					      0);
+
+	if (!stream) {
+		return nullptr;
+	}
+
+	stream->max_sb_size = config.subbuffer_size;
+	stream->read_subbuffer_ops.get_next_subbuffer = get_next_subbuffer;
+	stream->read_subbuffer_ops.extract_subbuffer_info = extract_subbuffer_info;
+	stream->read_subbuffer_ops.put_next_subbuffer = put_next_subbuffer;
+
+	if (is_relayd) {
+		if (consumer_send_relayd_stream(stream, channel->pathname)) {
+			return nullptr;
+		}
+
+		return stream;
+	}
+
+	pthread_mutex_lock(&stream->lock);
+	const int ret = consumer_stream_create_output_files(stream, true);
+	pthread_mutex_unlock(&stream->lock);
+	if (ret) {
+		return nullptr;
+	}
+
+	if (null_fd >= 0 && dup2(null_fd, stream->out_fd) < 0) {
+		PERROR("Failed to redirect stream output to /dev/null");
+		return nullptr;
+	}
+
+	return stream;
+}
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	benchmark_config config;
+	struct lttng_consumer_local_data *ctx;
+	struct lttng_consumer_channel *channel;
+	struct lttng_trace_chunk *trace_chunk;
+	std::vector<struct lttng_consumer_stream *> streams;
+	int null_fd = -1;
+
+	if (!parse_arguments(argc, argv, config)) {
+		print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	rcu_register_thread();
+
+	ctx = lttng_consumer_create(
+		LTTNG_CONSUMER_KERNEL, lttng_consumer_read_subbuffer, nullptr, nullptr, nullptr);
+	if (!ctx || lttng_consumer_init()) {
+		fprintf(stderr, "Failed to initialize the consumer\n");
+		return EXIT_FAILURE;
+	}
+
+	if (config.output == benchmark_output::RELAYD) {
+		trace_chunk = lttng_trace_chunk_create(0, time(nullptr), nullptr);
+		if (!trace_chunk || !add_relayd(config, trace_chunk, ctx)) {
+			return EXIT_FAILURE;
+		}
+	} else {
+		trace_chunk = create_local_trace_chunk(config);
+		if (!trace_chunk) {
+			return EXIT_FAILURE;
+		}
+
+		if (config.output == benchmark_output::NUL) {
+			null_fd = open("/dev/null", O_WRONLY);
+			if (null_fd < 0) {
+				PERROR("Failed to open /dev/null");
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	channel = consumer_allocate_channel(
+		benchmark_channel_key,
+		benchmark_session_id,
+		nullptr,
+		DEFAULT_KERNEL_TRACE_DIR,
+		"channel0",
+		config.output == benchmark_output::RELAYD ? benchmark_relayd_id : -1ULL,
+		config.mode,
+		0,
+		0,
+		0,
+		0,
+		0,
+		0,
+		false,
+		false,
+		nonstd::nullopt,
+		nullptr,
+		nullptr,
+		LTTNG_TRACE_FORMAT_DEFAULT);
+	if (!channel) {
+		fprintf(stderr, "Failed to allocate the consumer channel\n");
+		return EXIT_FAILURE;
+	}
+
+	channel->type = CONSUMER_CHANNEL_TYPE_DATA_PER_CPU;
+
+	for (unsigned int stream_key = 0; stream_key < config.stream_count; stream_key++) {
+		ring_buffers.emplace_back(
+			new standin_ring_buffer(config.subbuffer_size, config.subbuffer_count));
+		if (!ring_buffers.back()->is_valid()) {
+			return EXIT_FAILURE;
+		}
+
+		auto *stream = create_stream(config, channel, trace_chunk, stream_key, null_fd);
+		if (!stream) {
+			fprintf(stderr, "Failed to create consumer stream %u\n", stream_key);
+			return EXIT_FAILURE;
+		}
+
+		streams.push_back(stream);
+	}
+
+	if (config.output == benchmark_output::RELAYD &&
+	    consumer_send_relayd_streams_sent(benchmark_relayd_id)) {
+		return EXIT_FAILURE;
+	}
+
+	printf("Output: %s (%s), streams: %u, sub-buffers: %u x %zu bytes\n",
+	       config.output == benchmark_output::DISK ? config.path.c_str() :
+		       config.output == benchmark_output::NUL ? "/dev/null" :
+							       config.url.c_str(),
+	       config.mode == LTTNG_EVENT_MMAP ? "mmap" : "splice",
+	       config.stream_count,
+	       config.subbuffer_count,
+	       config.subbuffer_size);
+
+	std::atomic<bool> stop{ false };
+	std::vector<std::thread> producers;
+	for (unsigned int stream_key = 0; stream_key < config.stream_count; stream_key++) {
+		producers.emplace_back([stream_key, &stop]() {
+			ring_buffers[stream_key]->produce(stream_key, stop);
+		});
+	}
+
+	/* Consume from this thread, like the data thread of lttng-consumerd. */
+	const int syscall_counter_fd = open_syscall_counter();
+	uint64_t syscall_count_begin = 0, syscall_count_end = 0;
+	std::vector<uint32_t> consume_durations_ns;
+	uint64_t subbuffer_count = 0, byte_count = 0;
+	bool succeeded = true;
+
+	if (syscall_counter_fd >= 0 &&
+	    read(syscall_counter_fd, &syscall_count_begin, sizeof(syscall_count_begin)) !=
+		    sizeof(syscall_count_begin)) {
+		syscall_count_begin = 0;
+	}
+
+	const auto start_time = std::chrono::steady_clock::now();
+	const auto end_time = start_time + config.duration;
+
+	while (succeeded && std::chrono::steady_clock::now() < end_time) {
+		bool consumed = false;
+
+		for (auto *stream : streams) {
+			const auto consume_start_time = std::chrono::steady_clock::now();
+			const auto ret = ctx->on_buffer_ready(stream, ctx, false);
+			const auto consume_duration =
+				std::chrono::steady_clock::now() - consume_start_time;
+
+			if (ret < 0) {
+				fprintf(stderr,
+					"Failed to consume sub-buffer of stream %s\n",
+					stream->name);
+				succeeded = false;
+				break;
+			} else if (ret == 0) {
+				continue;
+			}
+
+			consumed = true;
+			subbuffer_count++;
+			byte_count += ret;
+			consume_durations_ns.push_back(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+					consume_duration)
+					.count());
+		}
+
+		if (!consumed) {
+			std::this_thread::yield();
+		}
+	}
+
+	const auto elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+							     start_time)
+				       .count();
+	const bool has_syscall_count = syscall_counter_fd >= 0 &&
+		read(syscall_counter_fd, &syscall_count_end, sizeof(syscall_count_end)) ==
+			sizeof(syscall_count_end);
+
+	stop.store(true);
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	std::sort(consume_durations_ns.begin(), consume_durations_ns.end());
+
+	printf("Sub-buffers: %" PRIu64 " in %.2f s\n", subbuffer_count, elapsed_s);
+	printf("Throughput: %.0f sub-buffers/s, %.2f MB/s\n",
+	       subbuffer_count / elapsed_s,
+	       byte_count / elapsed_s / 1e6);
+	if (has_syscall_count && subbuffer_count) {
+		printf("System calls per sub-buffer: %.2f\n",
+		       double(syscall_count_end - syscall_count_begin) / subbuffer_count);
+	} else {
+		printf("System calls per sub-buffer: unavailable (raw_syscalls:sys_enter tracepoint is not accessible)\n");
+	}
+
+	printf("Sub-buffer consumption time (us): p50=%.1f, p90=%.1f, p99=%.1f, p99.9=%.1f, max=%.1f\n",
+	       percentile(consume_durations_ns, 50) / 1e3,
+	       percentile(consume_durations_ns, 90) / 1e3,
+	       percentile(consume_durations_ns, 99) / 1e3,
+	       percentile(consume_durations_ns, 99.9) / 1e3,
+	       (consume_durations_ns.empty() ? 0 : consume_durations_ns.back()) / 1e3);
+
+	if (config.output == benchmark_output::RELAYD) {
+		const lttng::urcu::read_lock_guard read_lock;
+		auto *relayd = consumer_find_relayd(benchmark_relayd_id);
+
+		for (auto *stream : streams) {
+			if (relayd) {
+				consumer_stream_relayd_close(stream, relayd);
+			}
+		}
+	}
+
+	if (syscall_counter_fd >= 0) {
+		(void) close(syscall_counter_fd);
+	}
+
+	if (null_fd >= 0) {
+		(void) close(null_fd);
+	}
+
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
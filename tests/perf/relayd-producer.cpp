@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "relayd-producer.hpp"
+
+#include <common/compat/endian.hpp>
+#include <common/index/ctf-index.hpp>
+#include <common/readwrite.hpp>
+#include <common/relayd/relayd.hpp>
+#include <common/sessiond-comm/relayd.hpp>
+#include <common/sessiond-comm/sessiond-comm.hpp>
+#include <common/trace-chunk.hpp>
+#include <common/uuid.hpp>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+/* CTF packet header magic number. */
+constexpr uint32_t ctf_magic = 0xC1FC1FC1;
+constexpr const char *trace_path = "ust/uid/1000/64-bit";
+
+/* Metadata fragment describing the synthetic packets: a packet header and no events. */
+constexpr const char *synthetic_metadata =
+	"/* CTF 1.8 */\n"
+	"typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+	"typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+	"trace {\n"
+	"\tmajor = 1;\n"
+	"\tminor = 8;\n"
+	"\tbyte_order = be;\n"
+	"\tpacket.header := struct {\n"
+	"\t\tuint32_t magic;\n"
+	"\t\tuint8_t uuid[16];\n"
+	"\t};\n"
+	"};\n";
+} /* namespace */
+
+relayd_producer_session::relayd_producer_session(const struct lttng_uri& control_uri,
+						 const struct lttng_uri& data_uri)
+{
+	_control_sock = lttcomm_alloc_relayd_sock(const_cast<lttng_uri *>(&control_uri),
+						  RELAYD_VERSION_COMM_MAJOR,
+						  RELAYD_VERSION_COMM_MINOR);
+	_data_sock = lttcomm_alloc_relayd_sock(const_cast<lttng_uri *>(&data_uri),
+					       RELAYD_VERSION_COMM_MAJOR,
+					       RELAYD_VERSION_COMM_MINOR);
+}
+
+relayd_producer_session::~relayd_producer_session()
+{
+	for (std::size_t i = 0; i < _stream_ids.size(); i++) {
+		(void) relayd_send_close_stream(
+			_control_sock, _stream_ids[i], _next_net_seq_nums[i] - 1);
+	}
+
+	if (_metadata_stream_id != -1ULL) {
+		(void) relayd_send_close_stream(_control_sock, _metadata_stream_id, 0);
+	}
+
+	if (_control_sock) {
+		(void) relayd_close(_control_sock);
+		free(_control_sock);
+	}
+
+	if (_data_sock) {
+		(void) relayd_close(_data_sock);
+		free(_data_sock);
+	}
+
+	lttng_trace_chunk_put(_trace_chunk);
+}
+
+bool relayd_producer_session::create(const std::string& name,
+				     uint64_t sessiond_session_id,
+				     unsigned int stream_count,
+				     std::size_t packet_size,
+				     unsigned int live_timer_us)
+{
+	char hostname[LTTNG_HOST_NAME_MAX] = {};
+	char output_path[LTTNG_PATH_MAX];
+	uint64_t relayd_session_id;
+	lttng_uuid sessiond_uuid;
+	const uint64_t chunk_id = 0;
+	const auto creation_time = time(nullptr);
+
+	if (!_control_sock || !_data_sock) {
+		fprintf(stderr, "Failed to allocate relay daemon sockets\n");
+		return false;
+	}
+
+	if (relayd_connect(_control_sock) < 0 || relayd_connect(_data_sock) < 0) {
+		fprintf(stderr, "Failed to connect to the relay daemon\n");
+		return false;
+	}
+
+	if (relayd_version_check(_control_sock)) {
+		fprintf(stderr, "Incompatible relay daemon protocol version\n");
+		return false;
+	}
+
+	(void) gethostname(hostname, sizeof(hostname) - 1);
+	if (lttng_uuid_generate(sessiond_uuid)) {
+		return false;
+	}
+
+	if (relayd_create_session(_control_sock,
+				  &relayd_session_id,
+				  name.c_str(),
+				  hostname,
+				  nullptr,
+				  live_timer_us,
+				  0,
+				  sessiond_session_id,
+				  sessiond_uuid,
+				  nullptr,
+				  creation_time,
+				  false,
+				  LTTNG_TRACE_FORMAT_DEFAULT,
+				  output_path)) {
+		fprintf(stderr, "Failed to create session `%s`\n", name.c_str());
+		return false;
+	}
+
+	_trace_chunk = lttng_trace_chunk_create(chunk_id, creation_time, nullptr);
+	if (!_trace_chunk || relayd_create_trace_chunk(_control_sock, _trace_chunk)) {
+		fprintf(stderr, "Failed to create trace chunk of session `%s`\n", name.c_str());
+		return false;
+	}
+
+	if (relayd_add_stream(_control_sock,
+			      DEFAULT_METADATA_NAME,
+			      "ust",
+			      trace_path,
+			      &_metadata_stream_id,
+			      0,
+			      0,
+			      _trace_chunk)) {
+		fprintf(stderr, "Failed to add metadata stream of session `%s`\n", name.c_str());
+		return false;
+	}
+
+	for (unsigned int stream_index = 0; stream_index < stream_count; stream_index++) {
+		const auto channel_name = "channel0_" + std::to_string(stream_index);
+		uint64_t stream_id;
+
+		if (relayd_add_stream(_control_sock,
+				      channel_name.c_str(),
+				      "ust",
+				      trace_path,
+				      &stream_id,
+				      0,
+				      0,
+				      _trace_chunk)) {
+			fprintf(stderr, "Failed to add stream `%s`\n", channel_name.c_str());
+			return false;
+		}
+
+		_stream_ids.push_back(stream_id);
+		_next_net_seq_nums.push_back(0);
+	}
+
+	if (relayd_streams_sent(_control_sock) || !_send_metadata(synthetic_metadata)) {
+		fprintf(stderr, "Failed to publish the streams of session `%s`\n", name.c_str());
+		return false;
+	}
+
+	/* Synthetic packet: CTF packet header (magic, uuid) and zeroes. */
+	_packet.assign(packet_size, 0);
+	const auto magic = htobe32(ctf_magic);
+	memcpy(_packet.data(), &magic, sizeof(magic));
+	memcpy(_packet.data() + sizeof(magic), sessiond_uuid.data(), LTTNG_UUID_LEN);
+	return true;
+}
+
+bool relayd_producer_session::_send_metadata(const std::string& metadata)
+{
+	struct lttcomm_relayd_metadata_payload payload_header = {};
+
+	/* Metadata is sent on the control connection, like lttng-consumerd does. */
+	if (relayd_send_metadata(_control_sock, sizeof(payload_header) + metadata.size()) < 0) {
+		return false;
+	}
+
+	payload_header.stream_id = htobe64(_metadata_stream_id);
+	return lttng_write(_control_sock->sock.fd, &payload_header, sizeof(payload_header)) ==
+		sizeof(payload_header) &&
+		lttng_write(_control_sock->sock.fd, metadata.data(), metadata.size()) ==
+		static_cast<ssize_t>(metadata.size());
+}
+
+bool relayd_producer_session::send_packet(unsigned int stream_index,
+					  uint64_t timestamp_begin,
+					  uint64_t timestamp_end)
+{
+	struct lttcomm_relayd_data_hdr data_hdr = {};
+	struct ctf_packet_index index = {};
+	const auto net_seq_num = _next_net_seq_nums[stream_index]++;
+	const uint64_t packet_size_bits = _packet.size() * CHAR_BIT;
+
+	data_hdr.stream_id = htobe64(_stream_ids[stream_index]);
+	data_hdr.net_seq_num = htobe64(net_seq_num);
+	data_hdr.data_size = htobe32(_packet.size());
+
+	if (relayd_send_data_hdr(_data_sock, &data_hdr, sizeof(data_hdr)) < 0) {
+		return false;
+	}
+
+	if (lttng_write(_data_sock->sock.fd, _packet.data(), _packet.size()) !=
+	    static_cast<ssize_t>(_packet.size())) {
+		return false;
+	}
+
+	index.packet_size = htobe64(packet_size_bits);
+	index.content_size = htobe64(packet_size_bits);
+	index.timestamp_begin = htobe64(timestamp_begin);
+	index.timestamp_end = htobe64(timestamp_end);
+	index.stream_instance_id = htobe64(stream_index);
+	index.packet_seq_num = htobe64(net_seq_num);
+	index.stored_size = htobe64(_packet.size());
+
+	return relayd_send_index(*_control_sock, index, _stream_ids[stream_index], net_seq_num) ==
+		0;
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#ifndef LTTNG_TESTS_PERF_RELAYD_PRODUCER_HPP
+#define LTTNG_TESTS_PERF_RELAYD_PRODUCER_HPP
+
+#include <common/uri.hpp>
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct lttcomm_relayd_sock;
+struct lttng_trace_chunk;
+
+/*
+ * Synthetic consumer daemon streaming the trace of one recording session to a
+ * relay daemon, over its own control and data connections.
+ *
+ * The trace is made of a metadata stream, holding a fixed metadata fragment,
+ * and of data streams receiving synthetic CTF packets and their indexes.
+ *
+ * Not thread-safe: a session must be used by a single thread at a time.
+ */
+class relayd_producer_session {
+public:
+	relayd_producer_session(const struct lttng_uri& control_uri,
+				const struct lttng_uri& data_uri);
+	~relayd_producer_session();
+
+	/* Deactivate copy and assignment. */
+	relayd_producer_session(const relayd_producer_session&) = delete;
+	relayd_producer_session(relayd_producer_session&&) = delete;
+	relayd_producer_session& operator=(const relayd_producer_session&) = delete;
+	relayd_producer_session& operator=(relayd_producer_session&&) = delete;
+
+	/*
+	 * Create session `name` on the relay daemon with `stream_count` data
+	 * streams of `packet_size`-byte packets. The session is a live session
+	 * when `live_timer_us` is not 0.
+	 *
+	 * Returns false on error, after printing a message.
+	 */
+	bool create(const std::string& name,
+		    uint64_t sessiond_session_id,
+		    unsigned int stream_count,
+		    std::size_t packet_size,
+		    unsigned int live_timer_us);
+
+	/*
+	 * Send a packet, followed by its index, to data stream `stream_index`.
+	 * The timestamps are only used to populate the index.
+	 */
+	bool send_packet(unsigned int stream_index,
+			 uint64_t timestamp_begin,
+			 uint64_t timestamp_end);
+
+	unsigned int stream_count() const noexcept
+	{
+		return _stream_ids.size();
+	}
+
+private:
+	bool _send_metadata(const std::string& metadata);
+
+	struct lttcomm_relayd_sock *_control_sock = nullptr;
+	struct lttcomm_relayd_sock *_data_sock = nullptr;
+	struct lttng_trace_chunk *_trace_chunk = nullptr;
+	uint64_t _metadata_stream_id = -1ULL;
+	std::vector<uint64_t> _stream_ids;
+	std::vector<uint64_t> _next_net_seq_nums;
+	std::vector<char> _packet;
+};
+
+#endif /* LTTNG_TESTS_PERF_RELAYD_PRODUCER_HPP */
@@ -0,0 +1,294 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+/*
+ * Measure the ingest throughput of a running lttng-relayd.
+ *
+ * This program plays the role of the consumer daemons of many recording
+ * sessions: each session opens its own control and data connections, creates
+ * a session, a trace chunk, and its streams on the relay daemon, and then
+ * pushes synthetic packets, each followed by its index, at a configurable rate.
+ *
+ * It reports the sustained throughput, the distribution of the per-packet
+ * latency (from the transmission of the packet to the acknowledgement of its
+ * index), and the CPU usage of the relay daemon when its PID is provided.
+ *
+ * This is not part of the test suite; run it manually against a relay daemon:
+ *   lttng-relayd -d -o /tmp/relayd-output
+ *   ./relayd_ingest_benchmark --sessions 16 --streams 8 --relayd-pid $(pidof lttng-relayd)
+ */
+
+#include "benchmark-utils.hpp"
+#include "relayd-producer.hpp"
+
+#include <common/error.hpp>
+#include <common/uri.hpp>
+#include <common/uuid.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <getopt.h>
+#include <inttypes.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* For error.h */
+int lttng_opt_quiet = 1;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+struct benchmark_config {
+	std::string url = "net://localhost";
+	unsigned int session_count = 4;
+	unsigned int stream_count = 4;
+	std::size_t packet_size = 256 * 1024;
+	std::chrono::seconds duration{ 10 };
+	/* Packets per second, per stream; 0 means "as fast as possible". */
+	unsigned int packet_rate = 0;
+	pid_t relayd_pid = -1;
+};
+
+struct session_result {
+	bool succeeded = false;
+	uint64_t packet_count = 0;
+	/* Latency of each packet, in microseconds. */
+	std::vector<uint32_t> packet_latencies_us;
+};
+
+void print_usage(const char *program_name)
+{
+	fprintf(stderr,
+		"Usage: %s [OPTIONS]\n"
+		"\n"
+		"  -u, --url=URL           Relay daemon URL (default: net://localhost)\n"
+		"  -s, --sessions=COUNT    Number of recording sessions (default: 4)\n"
+		"  -n, --streams=COUNT     Number of streams per session (default: 4)\n"
+		"  -p, --packet-size=SIZE  Size of the packets, in bytes (default: 262144)\n"
+		"  -d, --duration=SECONDS  Duration of the measurement (default: 10)\n"
+		"  -r, --rate=RATE         Packets per second per stream, 0 for unlimited (default: 0)\n"
+		"  -P, --relayd-pid=PID    PID of the relay daemon, to measure its CPU usage\n",
+		program_name);
+}
+
+bool parse_arguments(int argc, char **argv, benchmark_config& config)
+{
+	static const struct option long_options[] = {
+		{ "url", required_argument, nullptr, 'u' },
+		{ "sessions", required_argument, nullptr, 's' },
+		{ "streams", required_argument, nullptr, 'n' },
+		{ "packet-size", required_argument, nullptr, 'p' },
+		{ "duration", required_argument, nullptr, 'd' },
+		{ "rate", required_argument, nullptr, 'r' },
+		{ "relayd-pid", required_argument, nullptr, 'P' },
+		{ "help", no_argument, nullptr, 'h' },
+		{ nullptr, 0, nullptr, 0 },
+	};
+	int option;
+
+	while ((option = getopt_long(argc, argv, "u:s:n:p:d:r:P:h", long_options, nullptr)) !=
+	       -1) {
+		switch (option) {
+		case 'u':
+			config.url = optarg;
+			break;
+		case 's':
+			config.session_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 'n':
+			config.stream_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 'p':
+			config.packet_size = strtoull(optarg, nullptr, 10);
+			break;
+		case 'd':
+			config.duration = std::chrono::seconds(strtoul(optarg, nullptr, 10));
+			break;
+		case 'r':
+			config.packet_rate = strtoul(optarg, nullptr, 10);
+			break;
+		case 'P':
+			config.relayd_pid = strtol(optarg, nullptr, 10);
+			break;
+		default:
+			return false;
+		}
+	}
+
+	/* The packet must at least hold its header. */
+	return config.session_count > 0 && config.stream_count > 0 &&
+		config.packet_size >= sizeof(uint32_t) + LTTNG_UUID_LEN + sizeof(uint32_t) &&
+		config.packet_size <= UINT32_MAX && config.duration.count() > 0;
+}
+
+class relayd_session {
+public:
+	relayd_session(const benchmark_config& config,
+		       unsigned int index,
+		       const struct lttng_uri& control_uri,
+		       const struct lttng_uri& data_uri) :
+		_config(config), _index(index), _producer(control_uri, data_uri)
+	{
+	}
+
+	/* Deactivate copy and assignment. */
+	relayd_session(const relayd_session&) = delete;
+	relayd_session(relayd_session&&) = delete;
+	relayd_session& operator=(const relayd_session&) = delete;
+	relayd_session& operator=(relayd_session&&) = delete;
+
+	bool setup()
+	{
+		return _producer.create("relayd-ingest-benchmark-" + std::to_string(_index),
+					_index,
+					_config.stream_count,
+					_config.packet_size,
+					0);
+	}
+
+	void run(std::chrono::steady_clock::time_point end_time, session_result& result);
+
+private:
+	const benchmark_config& _config;
+	const unsigned int _index;
+	relayd_producer_session _producer;
+};
+
+void relayd_session::run(std::chrono::steady_clock::time_point end_time, session_result& result)
+{
+	const auto start_time = std::chrono::steady_clock::now();
+	/* Interval between two packets of the session, spread over its streams. */
+	const auto packet_interval = _config.packet_rate ?
+		std::chrono::nanoseconds(std::chrono::seconds(1)) /
+			(_config.packet_rate * _config.stream_count) :
+		std::chrono::nanoseconds(0);
+
+	for (uint64_t packet_index = 0;; packet_index++) {
+		const auto send_time = start_time + packet_index * packet_interval;
+
+		if (send_time >= end_time) {
+			break;
+		}
+
+		std::this_thread::sleep_until(send_time);
+
+		const auto packet_start_time = std::chrono::steady_clock::now();
+		if (packet_start_time >= end_time) {
+			break;
+		}
+
+		if (!_producer.send_packet(
+			    packet_index % _config.stream_count, packet_index, packet_index + 1)) {
+			fprintf(stderr, "Failed to send packet to the relay daemon\n");
+			return;
+		}
+
+		const auto latency = std::chrono::steady_clock::now() - packet_start_time;
+		result.packet_latencies_us.push_back(
+			std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+		result.packet_count++;
+	}
+
+	result.succeeded = true;
+}
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	benchmark_config config;
+	struct lttng_uri *uris = nullptr;
+
+	if (!parse_arguments(argc, argv, config)) {
+		print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (uri_parse(config.url.c_str(), &uris) != 2) {
+		fprintf(stderr, "Invalid relay daemon URL: %s\n", config.url.c_str());
+		free(uris);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::unique_ptr<relayd_session>> sessions;
+	for (unsigned int i = 0; i < config.session_count; i++) {
+		sessions.emplace_back(new relayd_session(config, i, uris[0], uris[1]));
+		if (!sessions.back()->setup()) {
+			free(uris);
+			return EXIT_FAILURE;
+		}
+	}
+
+	free(uris);
+
+	printf("Sessions: %u, streams per session: %u, packet size: %zu bytes, rate: %s\n",
+	       config.session_count,
+	       config.stream_count,
+	       config.packet_size,
+	       config.packet_rate ?
+		       (std::to_string(config.packet_rate) + " packets/s per stream").c_str() :
+		       "unlimited");
+
+	uint64_t relayd_start_ticks = 0, relayd_end_ticks = 0;
+	const bool measure_relayd_cpu = config.relayd_pid > 0 &&
+		get_process_cpu_ticks(config.relayd_pid, relayd_start_ticks);
+
+	std::vector<session_result> results(sessions.size());
+	std::vector<std::thread> threads;
+	const auto start_time = std::chrono::steady_clock::now();
+	const auto end_time = start_time + config.duration;
+
+	for (std::size_t i = 0; i < sessions.size(); i++) {
+		threads.emplace_back([&sessions, &results, end_time, i]() {
+			sessions[i]->run(end_time, results[i]);
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	const auto elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+							     start_time)
+				       .count();
+	std::vector<uint32_t> latencies_us;
+	uint64_t packet_count = 0;
+	bool succeeded = true;
+
+	for (const auto& result : results) {
+		succeeded &= result.succeeded;
+		packet_count += result.packet_count;
+		latencies_us.insert(latencies_us.end(),
+				    result.packet_latencies_us.begin(),
+				    result.packet_latencies_us.end());
+	}
+
+	std::sort(latencies_us.begin(), latencies_us.end());
+
+	printf("Packets: %" PRIu64 " in %.2f s\n", packet_count, elapsed_s);
+	printf("Throughput: %.2f MB/s, %.0f packets/s\n",
+	       packet_count * config.packet_size / elapsed_s / 1e6,
+	       packet_count / elapsed_s);
+	printf("Packet latency (us): p50=%u, p90=%u, p99=%u, p99.9=%u, max=%u\n",
+	       percentile(latencies_us, 50),
+	       percentile(latencies_us, 90),
+	       percentile(latencies_us, 99),
+	       percentile(latencies_us, 99.9),
+	       latencies_us.empty() ? 0 : latencies_us.back());
+
+	if (measure_relayd_cpu && get_process_cpu_ticks(config.relayd_pid, relayd_end_ticks)) {
+		printf("Relay daemon CPU usage: %.1f%% of one CPU\n",
+		       100.0 * (relayd_end_ticks - relayd_start_ticks) / sysconf(_SC_CLK_TCK) /
+			       elapsed_s);
+	}
+
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
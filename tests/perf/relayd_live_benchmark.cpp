@@ -0,0 +1,738 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+/*
+ * Measure the cost of serving live viewers for a running lttng-relayd.
+ *
+ * This program feeds live sessions to the relay daemon, playing the role of
+ * their consumer daemons, while viewers attached to those sessions poll them
+ * like a live trace reader does: GET_NEXT_INDEX on each stream, GET_PACKET
+ * when an index is available, and GET_METADATA whenever the relay daemon
+ * reports new metadata. A viewer polling streams with no new data sleeps for
+ * the poll interval before its next round of requests.
+ *
+ * The producers stamp the beginning timestamp of each packet index with the
+ * time at which the packet is sent. The benchmark reports the distribution of
+ * the end-to-end latency of the packets, from their transmission by the
+ * producer to their reception by a viewer, the number of GET_NEXT_INDEX
+ * requests answered with "retry", and the CPU usage of the relay daemon per
+ * viewer when its PID is provided.
+ *
+ * As the relay daemon allows a single viewer per session, each viewer
+ * attaches to its own subset of the sessions; there must be at least as many
+ * sessions as viewers.
+ *
+ * This is not part of the test suite; run it manually against a relay daemon:
+ *   lttng-relayd -d -o /tmp/relayd-output
+ *   ./relayd_live_benchmark --sessions 16 --viewers 8 --relayd-pid $(pidof lttng-relayd)
+ */
+
+#include "benchmark-utils.hpp"
+#include "relayd-producer.hpp"
+
+#include <common/compat/endian.hpp>
+#include <common/defaults.hpp>
+#include <common/error.hpp>
+#include <common/readwrite.hpp>
+#include <common/sessiond-comm/relayd.hpp>
+#include <common/uri.hpp>
+#include <common/uuid.hpp>
+
+#include <algorithm>
+#include <bin/lttng-relayd/lttng-viewer-abi.hpp>
+#include <chrono>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <memory>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* For error.h */
+int lttng_opt_quiet = 1;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+struct benchmark_config {
+	std::string url = "net://localhost";
+	std::string viewer_host = "localhost";
+	unsigned int viewer_port = DEFAULT_NETWORK_VIEWER_PORT;
+	unsigned int session_count = 4;
+	unsigned int stream_count = 4;
+	unsigned int viewer_count = 4;
+	std::size_t packet_size = 4096;
+	std::chrono::seconds duration{ 10 };
+	/* Packets per second, per stream. */
+	unsigned int packet_rate = 10;
+	std::chrono::milliseconds poll_interval{ 100 };
+	pid_t relayd_pid = -1;
+};
+
+struct producer_result {
+	bool succeeded = false;
+	uint64_t packet_count = 0;
+};
+
+struct viewer_result {
+	bool succeeded = false;
+	uint64_t packet_count = 0;
+	uint64_t index_request_count = 0;
+	uint64_t index_retry_count = 0;
+	uint64_t metadata_request_count = 0;
+	/* End-to-end latency of each packet, in microseconds. */
+	std::vector<uint32_t> packet_latencies_us;
+};
+
+void print_usage(const char *program_name)
+{
+	fprintf(stderr,
+		"Usage: %s [OPTIONS]\n"
+		"\n"
+		"  -u, --url=URL              Relay daemon URL (default: net://localhost)\n"
+		"  -H, --viewer-host=HOST     Relay daemon live viewer host (default: localhost)\n"
+		"  -L, --viewer-port=PORT     Relay daemon live viewer port (default: %d)\n"
+		"  -s, --sessions=COUNT       Number of live sessions (default: 4)\n"
+		"  -n, --streams=COUNT        Number of streams per session (default: 4)\n"
+		"  -v, --viewers=COUNT        Number of viewers, at most one per session (default: 4)\n"
+		"  -p, --packet-size=SIZE     Size of the packets, in bytes (default: 4096)\n"
+		"  -d, --duration=SECONDS     Duration of the measurement (default: 10)\n"
+		"  -r, --rate=RATE            Packets per second per stream (default: 10)\n"
+		"  -i, --poll-interval=MS     Viewer poll interval when no data is available (default: 100)\n"
+		"  -P, --relayd-pid=PID       PID of the relay daemon, to measure its CPU usage\n",
+		program_name,
+		DEFAULT_NETWORK_VIEWER_PORT);
+}
+
+bool parse_arguments(int argc, char **argv, benchmark_config& config)
+{
+	static const struct option long_options[] = {
+		{ "url", required_argument, nullptr, 'u' },
+		{ "viewer-host", required_argument, nullptr, 'H' },
+		{ "viewer-port", required_argument, nullptr, 'L' },
+		{ "sessions", required_argument, nullptr, 's' },
+		{ "streams", required_argument, nullptr, 'n' },
+		{ "viewers", required_argument, nullptr, 'v' },
+		{ "packet-size", required_argument, nullptr, 'p' },
+		{ "duration", required_argument, nullptr, 'd' },
+		{ "rate", required_argument, nullptr, 'r' },
+		{ "poll-interval", required_argument, nullptr, 'i' },
+		{ "relayd-pid", required_argument, nullptr, 'P' },
+		{ "help", no_argument, nullptr, 'h' },
+		{ nullptr, 0, nullptr, 0 },
+	};
+	int option;
+
+	while ((option = getopt_long(
+			argc, argv, "u:H:L:s:n:v:p:d:r:i:P:h", long_options, nullptr)) != -1) {
+		switch (option) {
+		case 'u':
+			config.url = optarg;
+			break;
+		case 'H':
+			config.viewer_host = optarg;
+			break;
+		case 'L':
+			config.viewer_port = strtoul(optarg, nullptr, 10);
+			break;
+		case 's':
+			config.session_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 'n':
+			config.stream_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 'v':
+			config.viewer_count = strtoul(optarg, nullptr, 10);
+			break;
+		case 'p':
+			config.packet_size = strtoull(optarg, nullptr, 10);
+			break;
+		case 'd':
+			config.duration = std::chrono::seconds(strtoul(optarg, nullptr, 10));
+			break;
+		case 'r':
+			config.packet_rate = strtoul(optarg, nullptr, 10);
+			break;
+		case 'i':
+			config.poll_interval =
+				std::chrono::milliseconds(strtoul(optarg, nullptr, 10));
+			break;
+		case 'P':
+			config.relayd_pid = strtol(optarg, nullptr, 10);
+			break;
+		default:
+			return false;
+		}
+	}
+
+	/* The packet must at least hold its header. */
+	return config.session_count > 0 && config.stream_count > 0 && config.viewer_count > 0 &&
+		config.viewer_count <= config.session_count && config.packet_rate > 0 &&
+		config.packet_size >= sizeof(uint32_t) + LTTNG_UUID_LEN + sizeof(uint32_t) &&
+		config.packet_size <= UINT32_MAX && config.duration.count() > 0;
+}
+
+std::string session_name(unsigned int index)
+{
+	/* Include the PID to avoid attaching to the sessions of a previous run. */
+	return "relayd-live-benchmark-" + std::to_string(getpid()) + "-" + std::to_string(index);
+}
+
+uint64_t monotonic_time_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+void produce(const benchmark_config& config,
+	     relayd_producer_session& producer,
+	     std::chrono::steady_clock::time_point end_time,
+	     producer_result& result)
+{
+	const auto start_time = std::chrono::steady_clock::now();
+	/* Interval between two packets of the session, spread over its streams. */
+	const auto packet_interval = std::chrono::nanoseconds(std::chrono::seconds(1)) /
+		(config.packet_rate * config.stream_count);
+
+	for (uint64_t packet_index = 0;; packet_index++) {
+		const auto send_time = start_time + packet_index * packet_interval;
+
+		if (send_time >= end_time) {
+			break;
+		}
+
+		std::this_thread::sleep_until(send_time);
+
+		/* The index timestamps carry the transmission time of the packet. */
+		const auto timestamp = monotonic_time_ns();
+		if (!producer.send_packet(
+			    packet_index % config.stream_count, timestamp, timestamp)) {
+			fprintf(stderr, "Failed to send packet to the relay daemon\n");
+			return;
+		}
+
+		result.packet_count++;
+	}
+
+	result.succeeded = true;
+}
+
+class live_viewer {
+public:
+	live_viewer(const benchmark_config& config, unsigned int index) :
+		_config(config), _index(index)
+	{
+	}
+
+	~live_viewer()
+	{
+		if (_fd >= 0) {
+			(void) close(_fd);
+		}
+	}
+
+	/* Deactivate copy and assignment. */
+	live_viewer(const live_viewer&) = delete;
+	live_viewer(live_viewer&&) = delete;
+	live_viewer& operator=(const live_viewer&) = delete;
+	live_viewer& operator=(live_viewer&&) = delete;
+
+	/* Connect and attach to the sessions of this viewer, from the beginning. */
+	bool setup();
+	void run(std::chrono::steady_clock::time_point end_time, viewer_result& result);
+	void detach();
+
+private:
+	struct stream {
+		uint64_t id;
+		uint64_t ctf_trace_id;
+		bool is_metadata;
+		bool hung_up;
+	};
+
+	bool _connect();
+	bool _send_command(enum lttng_viewer_command command,
+			   const void *payload,
+			   std::size_t payload_size);
+	bool _recv(void *buf, std::size_t size);
+	bool _list_sessions(std::vector<uint64_t>& session_ids);
+	bool _create_viewer_session();
+	bool _attach_session(uint64_t session_id);
+	bool _get_metadata(uint64_t ctf_trace_id, viewer_result& result);
+	/* Returns 1 if a packet was received, 0 if none is available, and -1 on error. */
+	int _consume_next_packet(stream& data_stream, viewer_result& result);
+
+	const benchmark_config& _config;
+	const unsigned int _index;
+	int _fd = -1;
+	std::vector<uint64_t> _session_ids;
+	std::vector<stream> _streams;
+	std::vector<char> _packet_buffer;
+	std::vector<char> _metadata_buffer;
+};
+
+bool live_viewer::_connect()
+{
+	struct addrinfo hints = {};
+	struct addrinfo *addresses;
+	const auto port = std::to_string(_config.viewer_port);
+
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if (getaddrinfo(_config.viewer_host.c_str(), port.c_str(), &hints, &addresses)) {
+		return false;
+	}
+
+	for (auto *address = addresses; address; address = address->ai_next) {
+		_fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+		if (_fd < 0) {
+			continue;
+		}
+
+		if (connect(_fd, address->ai_addr, address->ai_addrlen) == 0) {
+			break;
+		}
+
+		(void) close(_fd);
+		_fd = -1;
+	}
+
+	freeaddrinfo(addresses);
+	if (_fd < 0) {
+		return false;
+	}
+
+	struct lttng_viewer_connect connect_msg = {};
+
+	connect_msg.major = htobe32(RELAYD_VERSION_COMM_MAJOR);
+	connect_msg.minor = htobe32(RELAYD_VERSION_COMM_MINOR);
+	connect_msg.type = htobe32(LTTNG_VIEWER_CLIENT_COMMAND);
+
+	return _send_command(LTTNG_VIEWER_CONNECT, &connect_msg, sizeof(connect_msg)) &&
+		_recv(&connect_msg, sizeof(connect_msg));
+}
+
+bool live_viewer::_send_command(enum lttng_viewer_command command,
+				const void *payload,
+				std::size_t payload_size)
+{
+	struct lttng_viewer_cmd cmd = {};
+
+	cmd.cmd = htobe32(command);
+	cmd.data_size = htobe64(payload_size);
+	cmd.cmd_version = htobe32(0);
+
+	return lttng_write(_fd, &cmd, sizeof(cmd)) == sizeof(cmd) &&
+		(payload_size == 0 ||
+		 lttng_write(_fd, payload, payload_size) == static_cast<ssize_t>(payload_size));
+}
+
+bool live_viewer::_recv(void *buf, std::size_t size)
+{
+	return lttng_read(_fd, buf, size) == static_cast<ssize_t>(size);
+}
+
+bool live_viewer::_list_sessions(std::vector<uint64_t>& session_ids)
+{
+	struct lttng_viewer_list_sessions list;
+
+	if (!_send_command(LTTNG_VIEWER_LIST_SESSIONS, nullptr, 0) || !_recv(&list, sizeof(list))) {
+		return false;
+	}
+
+	session_ids.assign(_config.session_count, -1ULL);
+	for (uint32_t i = 0; i < be32toh(list.sessions_count); i++) {
+		struct lttng_viewer_session_2_15 session;
+
+		if (!_recv(&session, sizeof(session))) {
+			return false;
+		}
+
+		std::vector<char> hostname(be32toh(session.hostname_len));
+		std::string name(be32toh(session.session_name_len), '\0');
+
+		if (!_recv(hostname.data(), hostname.size()) || !_recv(&name[0], name.size())) {
+			return false;
+		}
+
+		for (unsigned int session_index = 0; session_index < _config.session_count;
+		     session_index++) {
+			if (name == session_name(session_index)) {
+				session_ids[session_index] = be64toh(session.common.id);
+			}
+		}
+	}
+
+	return std::find(session_ids.begin(), session_ids.end(), -1ULL) == session_ids.end();
+}
+
+bool live_viewer::_create_viewer_session()
+{
+	struct lttng_viewer_create_session_response response;
+
+	return _send_command(LTTNG_VIEWER_CREATE_SESSION, nullptr, 0) &&
+		_recv(&response, sizeof(response)) &&
+		be32toh(response.status) == LTTNG_VIEWER_CREATE_SESSION_OK;
+}
+
+bool live_viewer::_attach_session(uint64_t session_id)
+{
+	struct lttng_viewer_attach_session_request request = {};
+	struct lttng_viewer_attach_session_response response;
+
+	request.session_id = htobe64(session_id);
+	request.seek = htobe32(LTTNG_VIEWER_SEEK_BEGINNING);
+
+	if (!_send_command(LTTNG_VIEWER_ATTACH_SESSION, &request, sizeof(request)) ||
+	    !_recv(&response, sizeof(response))) {
+		return false;
+	}
+
+	if (be32toh(response.status) != LTTNG_VIEWER_ATTACH_OK) {
+		fprintf(stderr,
+			"Viewer %u failed to attach to session %" PRIu64 " (status %u)\n",
+			_index,
+			session_id,
+			be32toh(response.status));
+		return false;
+	}
+
+	for (uint32_t i = 0; i < be32toh(response.streams_count); i++) {
+		struct lttng_viewer_stream viewer_stream;
+
+		if (!_recv(&viewer_stream, sizeof(viewer_stream))) {
+			return false;
+		}
+
+		_streams.push_back({ be64toh(viewer_stream.id),
+				     be64toh(viewer_stream.ctf_trace_id),
+				     be32toh(viewer_stream.metadata_flag) != 0,
+				     false });
+	}
+
+	_session_ids.push_back(session_id);
+	return true;
+}
+
+bool live_viewer::setup()
+{
+	std::vector<uint64_t> session_ids;
+
+	if (!_connect()) {
+		fprintf(stderr,
+			"Viewer %u failed to connect to the relay daemon at %s:%u\n",
+			_index,
+			_config.viewer_host.c_str(),
+			_config.viewer_port);
+		return false;
+	}
+
+	if (!_list_sessions(session_ids) || !_create_viewer_session()) {
+		fprintf(stderr, "Viewer %u failed to find the benchmark sessions\n", _index);
+		return false;
+	}
+
+	/* Each viewer attaches to every `viewer_count`-th session. */
+	for (unsigned int session_index = _index; session_index < _config.session_count;
+	     session_index += _config.viewer_count) {
+		if (!_attach_session(session_ids[session_index])) {
+			return false;
+		}
+	}
+
+	_packet_buffer.resize(_config.packet_size);
+	return true;
+}
+
+bool live_viewer::_get_metadata(uint64_t ctf_trace_id, viewer_result& result)
+{
+	const auto metadata_stream =
+		std::find_if(_streams.begin(), _streams.end(), [ctf_trace_id](const stream& s) {
+			return s.is_metadata && s.ctf_trace_id == ctf_trace_id;
+		});
+	struct lttng_viewer_get_metadata request = {};
+
+	if (metadata_stream == _streams.end()) {
+		return false;
+	}
+
+	request.stream_id = htobe64(metadata_stream->id);
+
+	/* Fetch the metadata until the relay daemon has nothing new to send. */
+	while (true) {
+		struct lttng_viewer_metadata_packet response;
+
+		result.metadata_request_count++;
+		if (!_send_command(LTTNG_VIEWER_GET_METADATA, &request, sizeof(request)) ||
+		    !_recv(&response, sizeof(response))) {
+			return false;
+		}
+
+		switch (be32toh(response.status)) {
+		case LTTNG_VIEWER_METADATA_OK:
+			_metadata_buffer.resize(be64toh(response.len));
+			if (!_recv(_metadata_buffer.data(), _metadata_buffer.size())) {
+				return false;
+			}
+
+			break;
+		case LTTNG_VIEWER_NO_NEW_METADATA:
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+int live_viewer::_consume_next_packet(stream& data_stream, viewer_result& result)
+{
+	struct lttng_viewer_get_next_index index_request = {};
+	struct lttng_viewer_index index;
+
+	index_request.stream_id = htobe64(data_stream.id);
+
+	result.index_request_count++;
+	if (!_send_command(LTTNG_VIEWER_GET_NEXT_INDEX, &index_request, sizeof(index_request)) ||
+	    !_recv(&index, sizeof(index))) {
+		return -1;
+	}
+
+	if ((be32toh(index.flags) & LTTNG_VIEWER_FLAG_NEW_METADATA) &&
+	    !_get_metadata(data_stream.ctf_trace_id, result)) {
+		return -1;
+	}
+
+	switch (be32toh(index.status)) {
+	case LTTNG_VIEWER_INDEX_OK:
+		break;
+	case LTTNG_VIEWER_INDEX_RETRY:
+		result.index_retry_count++;
+		return 0;
+	case LTTNG_VIEWER_INDEX_INACTIVE:
+		return 0;
+	case LTTNG_VIEWER_INDEX_HUP:
+		data_stream.hung_up = true;
+		return 0;
+	default:
+		return -1;
+	}
+
+	struct lttng_viewer_get_packet packet_request = {};
+	struct lttng_viewer_trace_packet packet;
+	const uint64_t packet_size = be64toh(index.packet_size) / CHAR_BIT;
+
+	if (packet_size > _packet_buffer.size()) {
+		return -1;
+	}
+
+	packet_request.stream_id = htobe64(data_stream.id);
+	/* Already in big endian. */
+	packet_request.offset = index.offset;
+	packet_request.len = htobe32(packet_size);
+
+	if (!_send_command(LTTNG_VIEWER_GET_PACKET, &packet_request, sizeof(packet_request)) ||
+	    !_recv(&packet, sizeof(packet))) {
+		return -1;
+	}
+
+	if (be32toh(packet.status) != LTTNG_VIEWER_GET_PACKET_OK ||
+	    be32toh(packet.len) > _packet_buffer.size() ||
+	    !_recv(_packet_buffer.data(), be32toh(packet.len))) {
+		return -1;
+	}
+
+	const auto latency_ns = monotonic_time_ns() - be64toh(index.timestamp_begin);
+	result.packet_latencies_us.push_back(latency_ns / 1000);
+	result.packet_count++;
+	return 1;
+}
+
+void live_viewer::run(std::chrono::steady_clock::time_point end_time, viewer_result& result)
+{
+	while (std::chrono::steady_clock::now() < end_time) {
+		bool received_packet = false;
+
+		for (auto& viewer_stream : _streams) {
+			if (viewer_stream.is_metadata || viewer_stream.hung_up) {
+				continue;
+			}
+
+			const auto ret = _consume_next_packet(viewer_stream, result);
+			if (ret < 0) {
+				fprintf(stderr, "Viewer %u failed to consume a packet\n", _index);
+				return;
+			}
+
+			received_packet |= ret > 0;
+		}
+
+		if (!received_packet) {
+			std::this_thread::sleep_for(_config.poll_interval);
+		}
+	}
+
+	result.succeeded = true;
+}
+
+void live_viewer::detach()
+{
+	for (const auto session_id : _session_ids) {
+		struct lttng_viewer_detach_session_request request = {};
+		struct lttng_viewer_detach_session_response response;
+
+		request.session_id = htobe64(session_id);
+		if (!_send_command(LTTNG_VIEWER_DETACH_SESSION, &request, sizeof(request)) ||
+		    !_recv(&response, sizeof(response))) {
+			return;
+		}
+	}
+}
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	benchmark_config config;
+	struct lttng_uri *uris = nullptr;
+
+	if (!parse_arguments(argc, argv, config)) {
+		print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (uri_parse(config.url.c_str(), &uris) != 2) {
+		fprintf(stderr, "Invalid relay daemon URL: %s\n", config.url.c_str());
+		free(uris);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::unique_ptr<relayd_producer_session>> producers;
+	for (unsigned int i = 0; i < config.session_count; i++) {
+		producers.emplace_back(new relayd_producer_session(uris[0], uris[1]));
+		if (!producers.back()->create(session_name(i),
+					      i,
+					      config.stream_count,
+					      config.packet_size,
+					      DEFAULT_LTTNG_LIVE_TIMER)) {
+			free(uris);
+			return EXIT_FAILURE;
+		}
+	}
+
+	free(uris);
+
+	std::vector<std::unique_ptr<live_viewer>> viewers;
+	for (unsigned int i = 0; i < config.viewer_count; i++) {
+		viewers.emplace_back(new live_viewer(config, i));
+		if (!viewers.back()->setup()) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("Sessions: %u, streams per session: %u, viewers: %u, packet size: %zu bytes, "
+	       "rate: %u packets/s per stream, poll interval: %lld ms\n",
+	       config.session_count,
+	       config.stream_count,
+	       config.viewer_count,
+	       config.packet_size,
+	       config.packet_rate,
+	       static_cast<long long>(config.poll_interval.count()));
+
+	uint64_t relayd_start_ticks = 0, relayd_end_ticks = 0;
+	const bool measure_relayd_cpu = config.relayd_pid > 0 &&
+		get_process_cpu_ticks(config.relayd_pid, relayd_start_ticks);
+
+	std::vector<producer_result> producer_results(producers.size());
+	std::vector<viewer_result> viewer_results(viewers.size());
+	std::vector<std::thread> threads;
+	const auto start_time = std::chrono::steady_clock::now();
+	const auto end_time = start_time + config.duration;
+
+	for (std::size_t i = 0; i < producers.size(); i++) {
+		threads.emplace_back([&config, &producers, &producer_results, end_time, i]() {
+			produce(config, *producers[i], end_time, producer_results[i]);
+		});
+	}
+
+	for (std::size_t i = 0; i < viewers.size(); i++) {
+		threads.emplace_back([&viewers, &viewer_results, end_time, i]() {
+			viewers[i]->run(end_time, viewer_results[i]);
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	const auto elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+							     start_time)
+				       .count();
+
+	for (auto& viewer : viewers) {
+		viewer->detach();
+	}
+
+	std::vector<uint32_t> latencies_us;
+	uint64_t sent_packet_count = 0, received_packet_count = 0;
+	uint64_t index_request_count = 0, index_retry_count = 0, metadata_request_count = 0;
+	bool succeeded = true;
+
+	for (const auto& result : producer_results) {
+		succeeded &= result.succeeded;
+		sent_packet_count += result.packet_count;
+	}
+
+	for (const auto& result : viewer_results) {
+		succeeded &= result.succeeded;
+		received_packet_count += result.packet_count;
+		index_request_count += result.index_request_count;
+		index_retry_count += result.index_retry_count;
+		metadata_request_count += result.metadata_request_count;
+		latencies_us.insert(latencies_us.end(),
+				    result.packet_latencies_us.begin(),
+				    result.packet_latencies_us.end());
+	}
+
+	std::sort(latencies_us.begin(), latencies_us.end());
+
+	printf("Packets: %" PRIu64 " sent, %" PRIu64 " received by the viewers in %.2f s\n",
+	       sent_packet_count,
+	       received_packet_count,
+	       elapsed_s);
+	printf("Viewer throughput: %.0f packets/s per viewer\n",
+	       received_packet_count / elapsed_s / config.viewer_count);
+	printf("Viewer requests: %" PRIu64 " GET_NEXT_INDEX (%.1f%% retry), %" PRIu64
+	       " GET_METADATA\n",
+	       index_request_count,
+	       index_request_count ? 100.0 * index_retry_count / index_request_count : 0.0,
+	       metadata_request_count);
+	printf("End-to-end packet latency (us): p50=%u, p90=%u, p99=%u, p99.9=%u, max=%u\n",
+	       percentile(latencies_us, 50),
+	       percentile(latencies_us, 90),
+	       percentile(latencies_us, 99),
+	       percentile(latencies_us, 99.9),
+	       latencies_us.empty() ? 0 : latencies_us.back());
+
+	if (measure_relayd_cpu && get_process_cpu_ticks(config.relayd_pid, relayd_end_ticks)) {
+		const auto relayd_cpu_percent = 100.0 * (relayd_end_ticks - relayd_start_ticks) /
+			sysconf(_SC_CLK_TCK) / elapsed_s;
+
+		printf("Relay daemon CPU usage: %.1f%% of one CPU, %.2f%% per viewer\n",
+		       relayd_cpu_percent,
+		       relayd_cpu_percent / config.viewer_count);
+	}
+
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+/*
+ * Test that a persistent session daemon connection remains usable after
+ * commands carrying a payload fail.
+ *
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/macros.hpp>
+
+#include <lttng/lttng.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tap/tap.h>
+
+#define TEST_COUNT 9
+
+#define TEST_SESSION_NAME	  "test_session"
+#define TEST_UNKNOWN_SESSION_NAME "unknown_session"
+#define TEST_CHANNEL_NAME	  "test_channel"
+
+namespace {
+struct lttng_handle *create_ust_handle(const char *session_name)
+{
+	struct lttng_domain domain = {};
+
+	domain.type = LTTNG_DOMAIN_UST;
+	domain.buf_type = LTTNG_BUFFER_PER_UID;
+	return lttng_create_handle(session_name, &domain);
+}
+
+bool session_exists(const char *session_name)
+{
+	struct lttng_session *sessions = nullptr;
+	bool found = false;
+	const int count = lttng_list_sessions(&sessions);
+
+	for (int i = 0; i < count; i++) {
+		found |= strcmp(sessions[i].name, session_name) == 0;
+	}
+
+	free(sessions);
+	return found;
+}
+
+void test_commands(const char *output_url)
+{
+	struct lttng_handle *handle = create_ust_handle(TEST_SESSION_NAME);
+	struct lttng_handle *unknown_handle = create_ust_handle(TEST_UNKNOWN_SESSION_NAME);
+	struct lttng_event *event = lttng_event_create();
+	struct lttng_event_context context = {};
+	struct lttng_channel channel = {};
+	int ret;
+
+	LTTNG_ASSERT(handle);
+	LTTNG_ASSERT(unknown_handle);
+	LTTNG_ASSERT(event);
+
+	strcpy(event->name, "tp:tptest");
+	event->type = LTTNG_EVENT_TRACEPOINT;
+	event->loglevel_type = LTTNG_EVENT_LOGLEVEL_ALL;
+	context.ctx = LTTNG_EVENT_CONTEXT_VPID;
+	strcpy(channel.name, TEST_CHANNEL_NAME);
+	lttng_channel_set_default_attr(&unknown_handle->domain, &channel.attr);
+
+	ret = lttng_create_session(TEST_SESSION_NAME, output_url);
+	ok(ret == LTTNG_OK, "Session created");
+
+	ret = lttng_enable_event_with_filter(
+		unknown_handle, event, TEST_CHANNEL_NAME, "intfield == 1");
+	ok(ret == -LTTNG_ERR_SESS_NOT_FOUND,
+	   "Enabling an event with a filter in an unknown session fails");
+
+	ret = lttng_enable_channel(unknown_handle, &channel);
+	ok(ret == -LTTNG_ERR_SESS_NOT_FOUND, "Enabling a channel in an unknown session fails");
+
+	ret = lttng_add_context(unknown_handle, &context, nullptr, nullptr);
+	ok(ret == -LTTNG_ERR_SESS_NOT_FOUND, "Adding a context to an unknown session fails");
+
+	ok(session_exists(TEST_SESSION_NAME), "Session is listed after the failed commands");
+
+	ret = lttng_enable_event_with_filter(handle, event, TEST_CHANNEL_NAME, "intfield == 1");
+	ok(ret == LTTNG_OK, "Event with a filter is enabled after the failed commands");
+
+	ret = lttng_enable_event_with_filter(handle, event, TEST_CHANNEL_NAME, "intfield == 1");
+	ok(ret == -LTTNG_ERR_UST_EVENT_ENABLED, "Enabling the same event again fails");
+
+	ret = lttng_add_context(handle, &context, TEST_CHANNEL_NAME, nullptr);
+	ok(ret == LTTNG_OK, "Context is added after the failed commands");
+
+	ret = lttng_destroy_session(TEST_SESSION_NAME);
+	ok(ret == LTTNG_OK && !session_exists(TEST_SESSION_NAME), "Session destroyed");
+
+	lttng_event_destroy(event);
+	lttng_destroy_handle(unknown_handle);
+	lttng_destroy_handle(handle);
+}
+} /* namespace */
+
+int main(int argc, const char **argv)
+{
+	struct lttng_session_daemon_connection *connection = nullptr;
+	char output_url[PATH_MAX];
+
+	plan_tests(TEST_COUNT);
+
+	if (argc < 2) {
+		diag("Usage: %s OUTPUT_PATH", argv[0]);
+		return exit_status();
+	}
+
+	snprintf(output_url, sizeof(output_url), "file://%s", argv[1]);
+
+	if (lttng_session_daemon_connection_create(&connection) !=
+	    LTTNG_SESSION_DAEMON_CONNECTION_STATUS_OK) {
+		diag("Failed to create a persistent session daemon connection");
+		return exit_status();
+	}
+
+	lttng_session_daemon_connection_set_current(connection);
+	test_commands(output_url);
+	lttng_session_daemon_connection_set_current(nullptr);
+	lttng_session_daemon_connection_destroy(connection);
+	return exit_status();
+}
@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+# SPDX-License-Identifier: GPL-2.0-only
+#
+"""
+Validate the document served by the metrics socket of the relay daemon: it
+must follow the Prometheus text exposition format, and the counters of a
+relay session must account for its streams, including the closed ones.
+"""
+
+import pathlib
+import re
+import socket
+import sys
+import tempfile
+import time
+
+# Import in-tree test utils
+test_utils_import_path = pathlib.Path(__file__).absolute().parents[3] / "utils"
+sys.path.append(str(test_utils_import_path))
+
+import lttngtest
+
+_SAMPLE_RE = re.compile(
+    r"^(?P<name>[a-zA-Z_:][a-zA-Z0-9_:]*)(\{(?P<labels>.*)\})? (?P<value>[0-9]+)$"
+)
+_LABEL_RE = re.compile(r'([a-zA-Z_][a-zA-Z0-9_]*)="((?:[^"\\]|\\.)*)"(,|$)')
+_METRIC_TYPES = ("counter", "gauge", "summary")
+
+
+def get_metrics_document(metrics_path, timeout=10):
+    # The metrics socket is created asynchronously to the relay daemon's ports.
+    deadline = time.monotonic() + timeout
+    while True:
+        try:
+            with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+                sock.connect(str(metrics_path))
+                chunks = []
+                while True:
+                    chunk = sock.recv(65536)
+                    if not chunk:
+                        return b"".join(chunks).decode()
+                    chunks.append(chunk)
+        except (FileNotFoundError, ConnectionRefusedError):
+            if time.monotonic() > deadline:
+                raise
+            time.sleep(0.1)
+
+
+def parse_labels(labels):
+    parsed = {}
+    position = 0
+    while position < len(labels):
+        match = _LABEL_RE.match(labels, position)
+        if not match:
+            raise ValueError("Malformed labels `{}`".format(labels))
+        parsed[match.group(1)] = match.group(2)
+        position = match.end()
+
+    return parsed
+
+
+def parse_metrics_document(document):
+    """
+    Parse a document of the Prometheus text exposition format, raising
+    ValueError if it is malformed.
+
+    Returns a dictionary of the families, indexed by name, holding their
+    type and samples as (name, labels, value) tuples.
+    """
+    if document and not document.endswith("\n"):
+        raise ValueError("Document doesn't end with a newline")
+
+    families = {}
+    current_family = None
+    for line in document.splitlines():
+        if line.startswith("# HELP "):
+            name, _, help_text = line[len("# HELP ") :].partition(" ")
+            if name in families or not help_text:
+                raise ValueError("Invalid HELP line `{}`".format(line))
+            families[name] = {"type": None, "samples": []}
+            current_family = name
+        elif line.startswith("# TYPE "):
+            name, _, metric_type = line[len("# TYPE ") :].partition(" ")
+            if name != current_family or metric_type not in _METRIC_TYPES:
+                raise ValueError("Invalid TYPE line `{}`".format(line))
+            families[name]["type"] = metric_type
+        else:
+            match = _SAMPLE_RE.match(line)
+            if not match or current_family is None:
+                raise ValueError("Invalid sample line `{}`".format(line))
+
+            family = families[current_family]
+            name = match.group("name")
+            valid_names = [current_family]
+            if family["type"] == "summary":
+                valid_names += [current_family + "_sum", current_family + "_count"]
+
+            if family["type"] is None or name not in valid_names:
+                raise ValueError(
+                    "Sample `{}` doesn't belong to family `{}`".format(
+                        line, current_family
+                    )
+                )
+
+            labels = parse_labels(match.group("labels") or "")
+            family["samples"].append((name, labels, int(match.group("value"))))
+
+    return families
+
+
+def get_session_counters(families):
+    """
+    Returns the written bytes of the single relay session, and the sum of
+    the written bytes of its open streams.
+    """
+    session_samples = families["lttng_relayd_session_written_bytes_total"]["samples"]
+    if len(session_samples) != 1:
+        raise ValueError(
+            "Expected a single relay session, got {}".format(len(session_samples))
+        )
+
+    session_id = session_samples[0][1]["session_id"]
+    streams_written_bytes = sum(
+        value
+        for _, labels, value in families["lttng_relayd_stream_written_bytes_total"][
+            "samples"
+        ]
+        if labels["session_id"] == session_id
+    )
+    return session_samples[0][2], streams_written_bytes
+
+
+def test_document_format(tap, metrics_path):
+    try:
+        families = parse_metrics_document(get_metrics_document(metrics_path))
+        object_counts = {
+            labels["type"]: value
+            for _, labels, value in families["lttng_relayd_objects"]["samples"]
+        }
+        tap.test(
+            object_counts.get("session") == 0,
+            "Metrics document follows the text exposition format: objects=`{}`".format(
+                object_counts
+            ),
+        )
+    except (ValueError, KeyError) as e:
+        tap.fail("Malformed metrics document: {}".format(e))
+
+
+def test_session_counters(tap, test_env, metrics_path):
+    client = lttngtest.LTTngClient(test_env, log=tap.diagnostic)
+    session_output = lttngtest.NetworkSessionOutputLocation(
+        "net://localhost:{}:{}/".format(
+            test_env.lttng_relayd_control_port, test_env.lttng_relayd_data_port
+        )
+    )
+    session = client.create_session(output=session_output)
+    channel = session.add_channel(
+        lttngtest.TracingDomain.User,
+        buffer_sharing_policy=lttngtest.BufferSharingPolicy.PerPID,
+    )
+    channel.add_recording_rule(lttngtest.UserTracepointEventRule("tp:tptest"))
+    session.start()
+
+    app = test_env.launch_wait_trace_test_application(1000)
+    app.trace()
+    app.wait_for_exit()
+
+    # Stopping the session flushes the sub-buffers to the relay daemon.
+    session.stop()
+
+    try:
+        written_bytes, streams_written_bytes = get_session_counters(
+            parse_metrics_document(get_metrics_document(metrics_path))
+        )
+        tap.test(
+            written_bytes > 0 and written_bytes >= streams_written_bytes,
+            "Session counters account for its streams: session=`{}`, streams=`{}`".format(
+                written_bytes, streams_written_bytes
+            ),
+        )
+
+        # The streams of the exited application are closed once the relay
+        # daemon has received all their data.
+        decreased = False
+        deadline = time.monotonic() + 10
+        while time.monotonic() < deadline:
+            current_written_bytes, streams_written_bytes = get_session_counters(
+                parse_metrics_document(get_metrics_document(metrics_path))
+            )
+            decreased |= current_written_bytes < written_bytes
+            if streams_written_bytes == 0:
+                break
+            time.sleep(0.5)
+
+        tap.diagnostic(
+            "Written bytes of the open streams: `{}`".format(streams_written_bytes)
+        )
+        tap.test(
+            not decreased,
+            "Session counters don't decrease as its streams are closed: written_bytes=`{}`".format(
+                current_written_bytes
+            ),
+        )
+    except (ValueError, KeyError) as e:
+        tap.fail("Malformed metrics document: {}".format(e))
+        tap.skip("Malformed metrics document")
+
+    session.destroy()
+
+
+if __name__ == "__main__":
+    tap = lttngtest.TapGenerator(3)
+    with tempfile.TemporaryDirectory() as metrics_dir:
+        metrics_path = pathlib.Path(metrics_dir) / "metrics"
+        with lttngtest.test_environment(
+            with_sessiond=True,
+            log=tap.diagnostic,
+            with_relayd=True,
+            extra_env_vars={"LTTNG_RELAYD_METRICS": str(metrics_path)},
+        ) as test_env:
+            test_document_format(tap, metrics_path)
+            test_session_counters(tap, test_env, metrics_path)
+
+    sys.exit(0 if tap.is_successful else 1)
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+# SPDX-License-Identifier: GPL-2.0-only
+#
+"""
+Tests lttng_channel_get_io_statistics and
+lttng_channel_get_io_latency_statistics, which report the statistics that the
+session daemon gets from the consumer daemons with the
+LTTNG_CONSUMER_GET_SESSION_STREAMS_IO_STATS command.
+"""
+
+import ctypes
+import os
+import pathlib
+import sys
+
+# Import in-tree test utils
+test_utils_import_path = pathlib.Path(__file__).absolute().parents[2] / "utils"
+sys.path.insert(0, str(test_utils_import_path))
+
+import lttngtest
+
+
+def get_io_statistics(channel):
+    values = [ctypes.c_uint64(0) for _ in range(4)]
+    ret = lttng.lttng_channel_get_io_statistics(
+        channel, *[ctypes.pointer(value) for value in values]
+    )
+    return ret, [value.value for value in values]
+
+
+def get_io_latency_statistics(channel):
+    values = [ctypes.c_uint64(0) for _ in range(4)]
+    ret = lttng.lttng_channel_get_io_latency_statistics(
+        channel, *[ctypes.pointer(value) for value in values]
+    )
+    return ret, [value.value for value in values]
+
+
+def test_get_io_statistics_no_channel(tap, test_env):
+    ret, _ = get_io_statistics(None)
+    tap.test(
+        ret == lttng.LTTNG_CHANNEL_STATUS_INVALID,
+        "'lttng_channel_get_io_statistics' rejects NULL channel",
+    )
+
+
+def test_get_io_latency_statistics_no_channel(tap, test_env):
+    ret, _ = get_io_latency_statistics(None)
+    tap.test(
+        ret == lttng.LTTNG_CHANNEL_STATUS_INVALID,
+        "'lttng_channel_get_io_latency_statistics' rejects NULL channel",
+    )
+
+
+def test_get_io_statistics_no_channel_ext(tap, test_env):
+    ret, _ = get_io_statistics(ctypes.pointer(lttng.struct_lttng_channel()))
+    tap.test(
+        ret == lttng.LTTNG_CHANNEL_STATUS_INVALID,
+        "'lttng_channel_get_io_statistics' rejects channel with NULL extended attribute",
+    )
+
+
+def test_get_io_statistics_no_value(tap, test_env):
+    channel_instance = common.get_channel_instance()
+    value = ctypes.c_uint64(0)
+    ret = lttng.lttng_channel_get_io_statistics(
+        channel_instance,
+        ctypes.pointer(value),
+        None,
+        ctypes.pointer(value),
+        ctypes.pointer(value),
+    )
+    lttng.lttng_channel_destroy(channel_instance)
+    tap.test(
+        ret == lttng.LTTNG_CHANNEL_STATUS_INVALID,
+        "'lttng_channel_get_io_statistics' rejects a NULL destination pointer",
+    )
+
+
+def test_get_io_statistics_not_listed(tap, test_env):
+    channel_instance = common.get_channel_instance()
+    ret, _ = get_io_statistics(channel_instance)
+    latency_ret, _ = get_io_latency_statistics(channel_instance)
+    lttng.lttng_channel_destroy(channel_instance)
+    tap.test(
+        ret == lttng.LTTNG_CHANNEL_STATUS_UNSET
+        and latency_ret == lttng.LTTNG_CHANNEL_STATUS_UNSET,
+        "I/O statistics are unset for a channel which wasn't listed: ret=`{}`, latency_ret=`{}`".format(
+            ret, latency_ret
+        ),
+    )
+
+
+def test_io_statistics_with_session(tap, test_env):
+    client = lttngtest.LTTngClient(test_env, log=tap.diagnostic)
+    session = client.create_session()
+    channel_obj = session.add_channel(lttngtest.TracingDomain.User)
+    channel_obj.add_recording_rule(lttngtest.UserTracepointEventRule("tp:tptest"))
+    session.start()
+
+    app = test_env.launch_wait_trace_test_application(10000)
+    app.trace()
+    app.wait_for_exit()
+
+    # Stopping the session flushes and consumes the sub-buffers.
+    session.stop()
+
+    session_name = session.name.encode()
+    domain_instance = lttng.struct_lttng_domain()
+    domain_instance.type = lttng.LTTNG_DOMAIN_UST
+    domain_instance.buf_type = lttng.LTTNG_BUFFER_PER_UID
+    handle_instance = lttng.lttng_create_handle(
+        ctypes.cast(session_name, lttng.lttng_create_handle.argtypes[0]),
+        ctypes.pointer(domain_instance),
+    )
+    channel_array_head = ctypes.cast(
+        ctypes.c_void_p(None),
+        ctypes.POINTER(lttng.struct_lttng_channel),
+    )
+    channel_count = lttng.lttng_list_channels(
+        handle_instance,
+        ctypes.pointer(channel_array_head),
+    )
+    lttng.lttng_destroy_handle(handle_instance)
+    if channel_count != 1:
+        tap.fail(
+            "Failed to list the channel: lttng_list_channels.ret=`{}`".format(
+                channel_count
+            )
+        )
+        session.destroy()
+        return
+
+    ret, (subbuffer_count, written_bytes, write_call_count, _) = get_io_statistics(
+        channel_array_head
+    )
+    latency_ret, (consumption_p99, consumption_max, write_p99, write_max) = (
+        get_io_latency_statistics(channel_array_head)
+    )
+    tap.diagnostic(
+        "I/O statistics: sub-buffers={}, bytes={}, writes={}, consumption p99/max={}/{} ns, write p99/max={}/{} ns".format(
+            subbuffer_count,
+            written_bytes,
+            write_call_count,
+            consumption_p99,
+            consumption_max,
+            write_p99,
+            write_max,
+        )
+    )
+    tap.test(
+        ret == lttng.LTTNG_CHANNEL_STATUS_OK
+        and latency_ret == lttng.LTTNG_CHANNEL_STATUS_OK
+        and subbuffer_count > 0
+        and written_bytes > 0
+        and write_call_count > 0
+        and consumption_p99 > 0
+        and consumption_max > 0
+        and write_p99 > 0
+        and write_max > 0,
+        "Listed channel reports the I/O statistics of its consumed sub-buffers",
+    )
+
+    session.destroy()
+
+
+if __name__ == "__main__":
+    tests = [
+        test_get_io_statistics_no_channel,
+        test_get_io_latency_statistics_no_channel,
+        test_get_io_statistics_no_channel_ext,
+        test_get_io_statistics_no_value,
+        test_get_io_statistics_not_listed,
+        test_io_statistics_with_session,  # simple integration test
+    ]
+    tap = lttngtest.TapGenerator(len(tests))
+
+    headers_dir = pathlib.Path(__file__).absolute().parents[0] / "lttngctl"
+    sys.path.insert(0, str(headers_dir))
+
+    import common
+    import lttng
+
+    with lttngtest.test_environment(with_sessiond=True, log=tap.diagnostic) as test_env:
+        # Set LTTNG_RUNDIR for the tests
+        rundir = (
+            test_env.lttng_rundir
+            if test_env.lttng_rundir
+            else test_env.lttng_home_location / ".lttng"
+        )
+        tap.diagnostic("Setting LTTNG_RUNDIR: {}".format(rundir))
+        os.environ["LTTNG_RUNDIR"] = str(rundir)
+        try:
+            for test in tests:
+                tap.diagnostic("Running test `{}`".format(test.__name__))
+                test(tap, test_env)
+        finally:
+            del os.environ["LTTNG_RUNDIR"]
+
+    sys.exit(0 if tap.is_successful else 1)
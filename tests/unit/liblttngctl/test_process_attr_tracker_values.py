@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+# SPDX-License-Identifier: GPL-2.0-only
+#
+"""
+Tests lttng_process_attr_virtual_process_id_tracker_handle_{add,remove}_pids,
+which add or remove a set of values to or from a tracker's inclusion set in a
+single session daemon command and report the outcome for each value.
+"""
+
+import ctypes
+import os
+import pathlib
+import sys
+
+# Import in-tree test utils
+test_utils_import_path = pathlib.Path(__file__).absolute().parents[2] / "utils"
+sys.path.insert(0, str(test_utils_import_path))
+
+import lttngtest
+
+# Matches LTTNG_PROCESS_ATTR_VALUES_MAX_LEN: every serialized value is larger
+# than one byte.
+VALUES_MAX_LEN = 1024 * 1024
+
+
+def get_vpid_tracker(session_name):
+    get_handle = lttng.lttng_session_get_tracker_handle
+    tracker = get_handle.argtypes[3]._type_()
+    ret = get_handle(
+        ctypes.cast(session_name.encode(), get_handle.argtypes[0]),
+        lttng.LTTNG_DOMAIN_UST,
+        lttng.LTTNG_PROCESS_ATTR_VIRTUAL_PROCESS_ID,
+        ctypes.byref(tracker),
+    )
+    if ret != lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK:
+        raise RuntimeError("Failed to get the VPID tracker: ret=`{}`".format(ret))
+
+    ret = lttng.lttng_process_attr_tracker_handle_set_tracking_policy(
+        tracker, lttng.LTTNG_TRACKING_POLICY_INCLUDE_SET
+    )
+    if ret != lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK:
+        lttng.lttng_process_attr_tracker_handle_destroy(tracker)
+        raise RuntimeError("Failed to set the tracking policy: ret=`{}`".format(ret))
+
+    return tracker
+
+
+def apply_pids(function, tracker, pids):
+    pid_array = (function.argtypes[1]._type_ * len(pids))(*pids)
+    statuses = (function.argtypes[3]._type_ * len(pids))()
+    ret = function(tracker, pid_array, len(pids), statuses)
+    return ret, [status for status in statuses]
+
+
+def add_pids(tracker, pids):
+    return apply_pids(
+        lttng.lttng_process_attr_virtual_process_id_tracker_handle_add_pids,
+        tracker,
+        pids,
+    )
+
+
+def remove_pids(tracker, pids):
+    return apply_pids(
+        lttng.lttng_process_attr_virtual_process_id_tracker_handle_remove_pids,
+        tracker,
+        pids,
+    )
+
+
+def get_inclusion_set(tracker):
+    get_set = lttng.lttng_process_attr_tracker_handle_get_inclusion_set
+    values = get_set.argtypes[1]._type_()
+    ret = get_set(tracker, ctypes.byref(values))
+    if ret != lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK:
+        raise RuntimeError("Failed to get the inclusion set: ret=`{}`".format(ret))
+
+    count = ctypes.c_uint(0)
+    lttng.lttng_process_attr_values_get_count(values, ctypes.byref(count))
+    pids = set()
+    for i in range(count.value):
+        pid = lttng.lttng_process_attr_values_get_pid_at_index.argtypes[2]._type_(0)
+        lttng.lttng_process_attr_values_get_pid_at_index(values, i, ctypes.byref(pid))
+        pids.add(pid.value)
+
+    return pids
+
+
+def test_add_pids(tap, tracker):
+    ret, statuses = add_pids(tracker, [100, 101, 100])
+    tap.test(
+        ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK
+        and statuses
+        == [
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK,
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK,
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS,
+        ],
+        "New values are added and a duplicate value is reported as existing: ret=`{}`, statuses=`{}`".format(
+            ret, statuses
+        ),
+    )
+
+    ret, statuses = add_pids(tracker, [101, 102])
+    tap.test(
+        ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK
+        and statuses
+        == [
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_EXISTS,
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK,
+        ],
+        "Values already in the inclusion set are reported as existing: ret=`{}`, statuses=`{}`".format(
+            ret, statuses
+        ),
+    )
+
+
+def test_remove_pids(tap, tracker):
+    ret, statuses = remove_pids(tracker, [100, 103])
+    tap.test(
+        ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK
+        and statuses
+        == [
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK,
+            lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_MISSING,
+        ],
+        "Values are removed and a missing value is reported as missing: ret=`{}`, statuses=`{}`".format(
+            ret, statuses
+        ),
+    )
+
+    inclusion_set = get_inclusion_set(tracker)
+    tap.test(
+        inclusion_set == {101, 102},
+        "Inclusion set reflects the added and removed values: `{}`".format(
+            inclusion_set
+        ),
+    )
+
+
+def test_no_values(tap, tracker):
+    add_ret = lttng.lttng_process_attr_virtual_process_id_tracker_handle_add_pids(
+        tracker, None, 0, None
+    )
+    remove_ret = (
+        lttng.lttng_process_attr_virtual_process_id_tracker_handle_remove_pids(
+            tracker, None, 0, None
+        )
+    )
+    tap.test(
+        add_ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK
+        and remove_ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_OK
+        and get_inclusion_set(tracker) == {101, 102},
+        "Empty sets of values are accepted and leave the inclusion set unchanged: add_ret=`{}`, remove_ret=`{}`".format(
+            add_ret, remove_ret
+        ),
+    )
+
+
+def test_values_too_large(tap, tracker):
+    ret, _ = add_pids(tracker, range(1000, 1000 + VALUES_MAX_LEN))
+    tap.test(
+        ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID
+        and get_inclusion_set(tracker) == {101, 102},
+        "Set of values larger than 1 MiB once serialized is rejected: ret=`{}`".format(
+            ret
+        ),
+    )
+
+
+def test_invalid_arguments(tap, tracker):
+    add_ret = lttng.lttng_process_attr_virtual_process_id_tracker_handle_add_pids(
+        None, None, 0, None
+    )
+    remove_ret = (
+        lttng.lttng_process_attr_virtual_process_id_tracker_handle_remove_pids(
+            tracker, None, 1, None
+        )
+    )
+    tap.test(
+        add_ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID
+        and remove_ret == lttng.LTTNG_PROCESS_ATTR_TRACKER_HANDLE_STATUS_INVALID,
+        "NULL tracker and NULL array of values are rejected: add_ret=`{}`, remove_ret=`{}`".format(
+            add_ret, remove_ret
+        ),
+    )
+
+
+if __name__ == "__main__":
+    tests = [
+        test_add_pids,
+        test_remove_pids,
+        test_no_values,
+        test_values_too_large,
+        test_invalid_arguments,
+    ]
+    tap = lttngtest.TapGenerator(7)
+
+    headers_dir = pathlib.Path(__file__).absolute().parents[0] / "lttngctl"
+    sys.path.insert(0, str(headers_dir))
+
+    import lttng
+
+    with lttngtest.test_environment(with_sessiond=True, log=tap.diagnostic) as test_env:
+        # Set LTTNG_RUNDIR for the tests
+        rundir = (
+            test_env.lttng_rundir
+            if test_env.lttng_rundir
+            else test_env.lttng_home_location / ".lttng"
+        )
+        tap.diagnostic("Setting LTTNG_RUNDIR: {}".format(rundir))
+        os.environ["LTTNG_RUNDIR"] = str(rundir)
+        try:
+            client = lttngtest.LTTngClient(test_env, log=tap.diagnostic)
+            session = client.create_session()
+            session.add_channel(lttngtest.TracingDomain.User)
+            tracker = get_vpid_tracker(session.name)
+            try:
+                for test in tests:
+                    tap.diagnostic("Running test `{}`".format(test.__name__))
+                    test(tap, tracker)
+            finally:
+                lttng.lttng_process_attr_tracker_handle_destroy(tracker)
+                session.destroy()
+        finally:
+            del os.environ["LTTNG_RUNDIR"]
+
+    sys.exit(0 if tap.is_successful else 1)
@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/compat/endian.hpp>
+#include <common/error.hpp>
+#include <common/macros.hpp>
+#include <common/make-unique.hpp>
+#include <common/sessiond-comm/agent.hpp>
+#include <common/sessiond-comm/sessiond-comm.hpp>
+#include <common/urcu.hpp>
+
+#include <bin/lttng-sessiond/agent.hpp>
+#include <arpa/inet.h>
+#include <atomic>
+#include <memory>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <tap/tap.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifdef HAVE_LIBLTTNG_UST_CTL
+#include <lttng/lttng-export.h>
+#include <lttng/ust-sigbus.h>
+LTTNG_EXPORT DEFINE_LTTNG_UST_SIGBUS_STATE();
+#endif
+
+namespace {
+bool recv_all(int fd, void *buf, size_t size)
+{
+	auto *pos = static_cast<char *>(buf);
+
+	while (size > 0) {
+		const auto ret = read(fd, pos, size);
+
+		if (ret <= 0) {
+			return false;
+		}
+
+		pos += ret;
+		size -= ret;
+	}
+
+	return true;
+}
+
+bool send_all(int fd, const void *buf, size_t size)
+{
+	return write(fd, buf, size) == (ssize_t) size;
+}
+
+/*
+ * Agent application answering the commands of the session daemon on its own
+ * thread until its socket is closed by the session daemon.
+ */
+class fake_agent {
+public:
+	explicit fake_agent(int fd) : _fd(fd), _thread([this]() { _run(); })
+	{
+	}
+
+	/* Deactivate copy and assignment. */
+	fake_agent(const fake_agent&) = delete;
+	fake_agent(fake_agent&&) = delete;
+	fake_agent& operator=(const fake_agent&) = delete;
+	fake_agent& operator=(fake_agent&&) = delete;
+
+	~fake_agent()
+	{
+		_thread.join();
+		close(_fd);
+	}
+
+	/* Return code of the replies to the enable event commands. */
+	std::atomic<uint32_t> enable_ret_code{ AGENT_RET_CODE_SUCCESS };
+	std::atomic<unsigned int> enable_count{ 0 };
+	std::atomic<unsigned int> rule_set_count{ 0 };
+	std::atomic<unsigned int> rule_set_rule_count{ 0 };
+
+private:
+	void _run()
+	{
+		struct lttcomm_agent_hdr hdr;
+
+		while (recv_all(_fd, &hdr, sizeof(hdr))) {
+			std::vector<char> payload(be64toh(hdr.data_size));
+
+			if (!recv_all(_fd, payload.data(), payload.size())) {
+				break;
+			}
+
+			std::vector<uint32_t> reply = { htobe32(AGENT_RET_CODE_SUCCESS) };
+
+			switch (be32toh(hdr.cmd)) {
+			case AGENT_CMD_ENABLE:
+				enable_count++;
+				reply[0] = htobe32(enable_ret_code.load());
+				break;
+			case AGENT_CMD_APPLY_RULE_SET:
+			{
+				struct lttcomm_agent_apply_rule_set msg;
+
+				memcpy(&msg, payload.data(), sizeof(msg));
+				const auto rule_count =
+					be32toh(msg.event_count) + be32toh(msg.app_ctx_count);
+
+				rule_set_count++;
+				rule_set_rule_count += rule_count;
+				reply.resize(1 + rule_count, htobe32(AGENT_RET_CODE_SUCCESS));
+				break;
+			}
+			default:
+				break;
+			}
+
+			if (!send_all(_fd, reply.data(), reply.size() * sizeof(reply[0]))) {
+				break;
+			}
+		}
+	}
+
+	const int _fd;
+	std::thread _thread;
+};
+
+int listen_sock = -1;
+
+struct test_app {
+	struct agent_app *app;
+	std::unique_ptr<fake_agent> agent;
+};
+
+/*
+ * Connect a fake agent application to the session daemon and register it
+ * in the agent application hash table.
+ */
+test_app add_app(enum lttng_domain_type domain, uint32_t minor_version)
+{
+	struct sockaddr_in addr = {};
+	socklen_t addr_len = sizeof(addr);
+	const int agent_fd = socket(AF_INET, SOCK_STREAM, 0);
+	int ret;
+
+	LTTNG_ASSERT(agent_fd >= 0);
+	ret = getsockname(listen_sock, (struct sockaddr *) &addr, &addr_len);
+	LTTNG_ASSERT(ret == 0);
+	ret = connect(agent_fd, (struct sockaddr *) &addr, addr_len);
+	LTTNG_ASSERT(ret == 0);
+
+	const int app_fd = accept(listen_sock, nullptr, nullptr);
+	LTTNG_ASSERT(app_fd >= 0);
+
+	auto *sock = lttcomm_alloc_sock(LTTCOMM_SOCK_TCP);
+	LTTNG_ASSERT(sock);
+	ret = lttcomm_populate_sock_from_open_socket(sock, app_fd, LTTCOMM_SOCK_TCP);
+	LTTNG_ASSERT(ret == 0);
+
+	auto *app = agent_create_app(getpid(), domain, minor_version, sock);
+	LTTNG_ASSERT(app);
+	agent_add_app(app);
+
+	return { app, lttng::make_unique<fake_agent>(agent_fd) };
+}
+
+void test_enable_event()
+{
+	std::vector<test_app> jul_apps;
+	auto *event = agent_create_event("logger", LTTNG_EVENT_LOGLEVEL_ALL, 0, nullptr, nullptr);
+	const int ret = agent_app_ht_alloc();
+
+	LTTNG_ASSERT(event);
+	LTTNG_ASSERT(ret == 0);
+	for (int i = 0; i < 3; i++) {
+		jul_apps.emplace_back(add_app(LTTNG_DOMAIN_JUL, AGENT_MINOR_VERSION));
+	}
+
+	auto log4j_app = add_app(LTTNG_DOMAIN_LOG4J, AGENT_MINOR_VERSION);
+
+	ok(agent_enable_event(event, LTTNG_DOMAIN_JUL) == LTTNG_OK && event->enabled_count == 1,
+	   "Event is enabled on the applications of the domain");
+
+	bool all_received = true;
+	for (const auto& jul_app : jul_apps) {
+		all_received &= jul_app.agent->enable_count == 1;
+	}
+
+	ok(all_received && log4j_app.agent->enable_count == 0,
+	   "Enable command is only sent to the applications of the domain");
+
+	jul_apps[1].agent->enable_ret_code = AGENT_RET_CODE_UNKNOWN_NAME;
+	ok(agent_enable_event(event, LTTNG_DOMAIN_JUL) == LTTNG_ERR_UST_EVENT_NOT_FOUND &&
+		   event->enabled_count == 1,
+	   "Failure of one application fails the enable command");
+
+	jul_apps[1].agent->enable_ret_code = AGENT_RET_CODE_SUCCESS;
+	ok(agent_enable_event(event, LTTNG_DOMAIN_JUL) == LTTNG_OK && event->enabled_count == 2,
+	   "Replies of the other applications are consumed after a failure");
+
+	/* Closing the sockets ends the fake agents. */
+	agent_app_ht_clean();
+	jul_apps.clear();
+	log4j_app.agent.reset();
+	agent_destroy_event(event);
+}
+
+void test_update()
+{
+	auto *agt = agent_create(LTTNG_DOMAIN_JUL);
+	const int ret = agent_app_ht_alloc();
+
+	LTTNG_ASSERT(agt);
+	LTTNG_ASSERT(ret == 0);
+
+	for (const char *name : { "a", "b", "c" }) {
+		auto *event = agent_create_event(name, LTTNG_EVENT_LOGLEVEL_ALL, 0, nullptr, nullptr);
+
+		LTTNG_ASSERT(event);
+		event->enabled_count = 1;
+		agent_add_event(event, agt);
+	}
+
+	auto batching_app = add_app(LTTNG_DOMAIN_JUL, 1);
+	auto legacy_app = add_app(LTTNG_DOMAIN_JUL, 0);
+
+	{
+		const lttng::urcu::read_lock_guard read_lock;
+
+		agent_update(agt, batching_app.app);
+		agent_update(agt, legacy_app.app);
+	}
+
+	ok(batching_app.agent->rule_set_count == 1 &&
+		   batching_app.agent->rule_set_rule_count == 3 &&
+		   batching_app.agent->enable_count == 0,
+	   "Application implementing the protocol 2.1 receives its rules in one command");
+	ok(legacy_app.agent->rule_set_count == 0 && legacy_app.agent->enable_count == 3,
+	   "Application implementing the protocol 2.0 receives one command per rule");
+
+	/* Disables the events on the applications before they are destroyed. */
+	agent_destroy(agt);
+	agent_app_ht_clean();
+}
+} /* namespace */
+
+int main()
+{
+	struct sockaddr_in addr = {};
+
+	plan_tests(6);
+
+	diag("Session daemon agent unit test");
+
+	rcu_register_thread();
+
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (listen_sock < 0 || bind(listen_sock, (struct sockaddr *) &addr, sizeof(addr)) ||
+	    listen(listen_sock, 16)) {
+		diag("Failed to create the agent registration socket");
+		return exit_status();
+	}
+
+	test_enable_event();
+	test_update();
+
+	close(listen_sock);
+	rcu_barrier();
+	rcu_unregister_thread();
+	return exit_status();
+}
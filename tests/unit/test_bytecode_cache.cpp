@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/macros.hpp>
+
+#include <bin/lttng-sessiond/bytecode-cache.hpp>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <tap/tap.h>
+
+#ifdef HAVE_LIBLTTNG_UST_CTL
+#include <lttng/lttng-export.h>
+#include <lttng/ust-sigbus.h>
+LTTNG_EXPORT DEFINE_LTTNG_UST_SIGBUS_STATE();
+#endif
+
+namespace {
+using bytecode_uptr = std::unique_ptr<struct lttng_bytecode, void (*)(void *)>;
+
+bytecode_uptr make_bytecode(const char *data, uint64_t seqnum = 0)
+{
+	const auto len = strlen(data) + 1;
+	bytecode_uptr bytecode(zmalloc<lttng_bytecode>(sizeof(struct lttng_bytecode) + len), free);
+
+	bytecode->len = len;
+	bytecode->reloc_table_offset = len;
+	bytecode->seqnum = seqnum;
+	memcpy(bytecode->data, data, len);
+	return bytecode;
+}
+
+void test_sharing()
+{
+	lttng::sessiond::bytecode_cache cache;
+	const auto filter = make_bytecode("filter");
+	const auto same_filter = make_bytecode("filter");
+	const auto other_filter = make_bytecode("other filter");
+	const auto other_seqnum_filter = make_bytecode("filter", 1);
+
+	const auto *shared = cache.get(*filter);
+	ok(shared != filter.get() && shared->len == filter->len &&
+		   memcmp(shared->data, filter->data, filter->len) == 0,
+	   "Cache returns a copy of the bytecode");
+	ok(cache.get(*same_filter) == shared && cache.size() == 1,
+	   "Identical bytecodes share the same copy");
+
+	const auto *other_shared = cache.get(*other_filter);
+	const auto *other_seqnum_shared = cache.get(*other_seqnum_filter);
+	ok(other_shared != shared && other_seqnum_shared != shared && cache.size() == 3,
+	   "Different bytecodes don't share a copy");
+
+	ok(cache.get_reference(shared) == shared && cache.size() == 3,
+	   "Getting a reference to a shared copy doesn't add a bytecode");
+
+	cache.put(other_shared);
+	cache.put(other_seqnum_shared);
+	cache.put(shared);
+	cache.put(shared);
+	ok(cache.size() == 1, "Shared copy is kept while it is referenced");
+
+	cache.put(shared);
+	ok(cache.size() == 0, "Shared copy is released with its last reference");
+}
+} /* namespace */
+
+int main()
+{
+	plan_tests(6);
+
+	diag("Session daemon bytecode cache unit test");
+
+	test_sharing();
+
+	return exit_status();
+}
@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ */
+
+#include <common/compression/codec.hpp>
+#include <common/exception.hpp>
+
+#include <cstring>
+#include <random>
+#include <tap/tap.h>
+#include <vector>
+
+/* For error.hpp */
+int lttng_opt_quiet;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+namespace lcomp = lttng::compression;
+
+constexpr unsigned int tests_per_codec = 4;
+
+/* Resembles a packet: repetitive event headers and payloads with some entropy. */
+std::vector<char> make_packet(std::size_t size)
+{
+	std::default_random_engine random_engine;
+	std::uniform_int_distribution<unsigned int> byte_distribution(0, 15);
+	std::vector<char> packet(size);
+
+	for (std::size_t i = 0; i < size; i++) {
+		packet[i] = i % 16 < 8 ? static_cast<char>(i % 8) :
+					 static_cast<char>(byte_distribution(random_engine));
+	}
+
+	return packet;
+}
+
+void test_codec(lcomp::codec_type type)
+{
+	const auto name = lcomp::codec_type_name(type);
+
+	if (!lcomp::is_codec_supported(type)) {
+		skip(tests_per_codec, "%s codec is not supported by this build", name);
+		return;
+	}
+
+	auto codec = lcomp::create_codec(type);
+	const auto packet = make_packet(1 << 20);
+	std::vector<char> compressed(codec->compress_bound(packet.size()));
+	std::vector<char> decompressed(packet.size());
+
+	ok(codec->type() == type, "%s codec reports its type", name);
+
+	const auto compressed_size = codec->compress(
+		packet.data(), packet.size(), compressed.data(), compressed.size());
+	ok(compressed_size > 0 && compressed_size < packet.size(),
+	   "%s codec compresses a packet (%zu bytes to %zu bytes)",
+	   name,
+	   packet.size(),
+	   compressed_size);
+
+	/* The codec is reused for the next packets of a stream. */
+	bool round_trip_ok = true;
+	for (unsigned int i = 0; i < 2; i++) {
+		const auto size = codec->decompress(
+			compressed.data(), compressed_size, decompressed.data(), decompressed.size());
+
+		round_trip_ok &= size == packet.size() &&
+			std::memcmp(decompressed.data(), packet.data(), size) == 0;
+	}
+
+	ok(round_trip_ok, "%s codec restores the original packet", name);
+
+	bool threw = false;
+	try {
+		/* Not enough room for the decompressed packet. */
+		codec->decompress(compressed.data(),
+				  compressed_size,
+				  decompressed.data(),
+				  decompressed.size() / 2);
+	} catch (const lttng::runtime_error&) {
+		threw = true;
+	}
+
+	ok(threw, "%s codec reports a too small destination buffer", name);
+}
+
+void test_unsupported_codec()
+{
+	bool threw = false;
+
+	ok(!lcomp::is_codec_supported(lcomp::codec_type::NONE),
+	   "'none' is not a supported codec");
+
+	try {
+		lcomp::create_codec(lcomp::codec_type::NONE);
+	} catch (const lttng::unsupported_error&) {
+		threw = true;
+	}
+
+	ok(threw, "Creating an unsupported codec throws");
+}
+} /* namespace */
+
+int main()
+{
+	plan_tests(2 + 2 * tests_per_codec);
+
+	test_unsupported_codec();
+	test_codec(lcomp::codec_type::ZSTD);
+	test_codec(lcomp::codec_type::LZ4);
+
+	return exit_status();
+}
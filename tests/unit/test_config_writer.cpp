@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/config/session-config.hpp>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <tap/tap.h>
+#include <unistd.h>
+
+/* For error.h */
+int lttng_opt_quiet = 1;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+const char *const document_declaration = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+
+/* Write a sample document and return the output of the writer. */
+std::string write_document(int indent)
+{
+	char path[] = "/tmp/test_config_writer.XXXXXX";
+	std::string output;
+	int ret = 0;
+
+	const auto fd = mkstemp(path);
+	if (fd < 0) {
+		diag("Failed to create temporary file");
+		return output;
+	}
+
+	auto *writer = config_writer_create(fd, indent);
+	ret |= config_writer_open_element(writer, "sessions");
+	ret |= config_writer_write_attribute(writer, "attr", "a<\"&\">\n\t");
+	ret |= config_writer_open_element(writer, "session");
+	ret |= config_writer_write_element_string(writer, "name", "<my \"session\" & co>");
+	ret |= config_writer_write_element_string(writer, "empty", "");
+	ret |= config_writer_write_element_unsigned_int(writer, "unsigned", UINT64_MAX);
+	ret |= config_writer_write_element_signed_int(writer, "signed", -42);
+	ret |= config_writer_write_element_bool(writer, "enabled", 1);
+	ret |= config_writer_write_element_double(writer, "ratio", 0.5);
+	ret |= config_writer_open_element(writer, "domains");
+	ret |= config_writer_close_element(writer);
+	ret |= config_writer_close_element(writer);
+	/* Leave the root element open: it is closed when the document ends. */
+	ret |= config_writer_destroy(writer);
+	ok(ret == 0, "Document written: indent=%d", indent);
+
+	char read_buffer[256];
+	ssize_t read_len;
+
+	lseek(fd, 0, SEEK_SET);
+	while ((read_len = read(fd, read_buffer, sizeof(read_buffer))) > 0) {
+		output.append(read_buffer, read_len);
+	}
+
+	close(fd);
+	unlink(path);
+	return output;
+}
+
+void test_output()
+{
+	const std::string expected_elements_indented =
+		"<sessions attr=\"a&lt;&quot;&amp;&quot;&gt;&#10;&#9;\">\n"
+		"\t<session>\n"
+		"\t\t<name>&lt;my &quot;session&quot; &amp; co&gt;</name>\n"
+		"\t\t<empty></empty>\n"
+		"\t\t<unsigned>18446744073709551615</unsigned>\n"
+		"\t\t<signed>-42</signed>\n"
+		"\t\t<enabled>true</enabled>\n"
+		"\t\t<ratio>0.500000</ratio>\n"
+		"\t\t<domains/>\n"
+		"\t</session>\n"
+		"</sessions>\n";
+	const std::string expected_elements =
+		"<sessions attr=\"a&lt;&quot;&amp;&quot;&gt;&#10;&#9;\">"
+		"<session>"
+		"<name>&lt;my &quot;session&quot; &amp; co&gt;</name>"
+		"<empty></empty>"
+		"<unsigned>18446744073709551615</unsigned>"
+		"<signed>-42</signed>"
+		"<enabled>true</enabled>"
+		"<ratio>0.500000</ratio>"
+		"<domains/>"
+		"</session>"
+		"</sessions>\n";
+
+	ok(write_document(1) == document_declaration + expected_elements_indented,
+	   "Indented output matches the expected document");
+	ok(write_document(0) == document_declaration + expected_elements,
+	   "Compact output matches the expected document");
+}
+
+void test_invalid_use()
+{
+	const auto fd = open("/dev/null", O_WRONLY);
+	auto *writer = config_writer_create(fd, 0);
+
+	ok(config_writer_close_element(writer) < 0, "Closing an element requires an open element");
+	ok(config_writer_open_element(writer, "") < 0, "Element names can't be empty");
+
+	config_writer_open_element(writer, "element");
+	config_writer_write_element_string(writer, "child", "value");
+	ok(config_writer_write_attribute(writer, "attr", "value") < 0,
+	   "Attributes can't be written after the content of an element");
+
+	config_writer_destroy(writer);
+	close(fd);
+}
+} /* namespace */
+
+int main()
+{
+	plan_tests(7);
+
+	diag("Configuration writer unit test");
+
+	test_output();
+	test_invalid_use();
+
+	return exit_status();
+}
@@ -0,0 +1,546 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <common/bytecode/bytecode.hpp>
+#include <common/filter/filter-ast.hpp>
+#include <common/filter/filter-ir.hpp>
+#include <common/filter/memstream.hpp>
+
+#include <cstdint>
+#include <map>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <tap/tap.h>
+#include <vector>
+
+/* For error.h */
+int lttng_opt_quiet = 1;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+struct compiled_filter {
+	bool valid = false;
+	/* Instructions followed by the relocation table. */
+	std::vector<char> data;
+	uint32_t instructions_len = 0;
+};
+
+compiled_filter compile(const char *expression, bool optimize)
+{
+	compiled_filter filter;
+	FILE *input = lttng_fmemopen((void *) expression, strlen(expression), "r");
+
+	if (!input) {
+		return filter;
+	}
+
+	struct filter_parser_ctx *ctx = filter_parser_ctx_alloc(input);
+	if (!ctx) {
+		fclose(input);
+		return filter;
+	}
+
+	if (filter_parser_ctx_append_ast(ctx) || filter_visitor_ir_generate(ctx) ||
+	    filter_visitor_ir_check_binary_op_nesting(ctx) ||
+	    filter_visitor_ir_normalize_glob_patterns(ctx) ||
+	    filter_visitor_ir_validate_string(ctx) || filter_visitor_ir_validate_globbing(ctx) ||
+	    (optimize && filter_visitor_ir_optimize(ctx)) ||
+	    filter_visitor_bytecode_generate(ctx)) {
+		goto end;
+	}
+
+	filter.valid = true;
+	filter.data.assign(ctx->bytecode->b.data, ctx->bytecode->b.data + ctx->bytecode->b.len);
+	filter.instructions_len = ctx->bytecode->b.reloc_table_offset;
+
+end:
+	filter_parser_ctx_free(ctx);
+	fclose(input);
+	return filter;
+}
+
+struct value {
+	enum class type { S64, DOUBLE, STRING } type;
+	int64_t s64;
+	double dbl;
+	std::string str;
+};
+
+using event_fields = std::map<std::string, value>;
+
+value make_s64(int64_t v)
+{
+	return { value::type::S64, v, 0, {} };
+}
+
+value make_double(double v)
+{
+	return { value::type::DOUBLE, 0, v, {} };
+}
+
+value make_string(const char *v)
+{
+	return { value::type::STRING, 0, 0, v };
+}
+
+bool to_double(const value& v, double& result)
+{
+	switch (v.type) {
+	case value::type::S64:
+		result = (double) v.s64;
+		return true;
+	case value::type::DOUBLE:
+		result = v.dbl;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Name of the field loaded by the instruction at `offset`. */
+std::string get_relocated_symbol(const compiled_filter& filter, uint32_t offset)
+{
+	const char *reloc = filter.data.data() + filter.instructions_len;
+
+	while (reloc < filter.data.data() + filter.data.size()) {
+		uint16_t reloc_offset;
+
+		memcpy(&reloc_offset, reloc, sizeof(reloc_offset));
+		reloc += sizeof(reloc_offset);
+		if (reloc_offset == offset) {
+			return reloc;
+		}
+
+		reloc += strlen(reloc) + 1;
+	}
+
+	return {};
+}
+
+/*
+ * Minimal interpreter of the instructions generated from a filter expression,
+ * following the semantics of the tracers' interpreters. Returns false if the
+ * interpretation fails, in which case the event is not recorded.
+ */
+bool interpret(const compiled_filter& filter, const event_fields& fields, bool& record)
+{
+	const char *data = filter.data.data();
+	std::vector<value> stack;
+	uint32_t pc = 0;
+
+	while (pc < filter.instructions_len) {
+		const auto op = (enum bytecode_op)(uint8_t) data[pc];
+
+		switch (op) {
+		case BYTECODE_OP_RETURN:
+			if (stack.empty() || stack.back().type != value::type::S64) {
+				return false;
+			}
+
+			record = stack.back().s64 != 0;
+			return true;
+		case BYTECODE_OP_LOAD_FIELD_REF:
+		{
+			const auto field_it = fields.find(get_relocated_symbol(filter, pc));
+
+			if (field_it == fields.end()) {
+				return false;
+			}
+
+			stack.push_back(field_it->second);
+			pc += sizeof(struct load_op) + sizeof(struct field_ref);
+			break;
+		}
+		case BYTECODE_OP_LOAD_STRING:
+		{
+			const char *str = data + pc + sizeof(struct load_op);
+
+			stack.push_back(make_string(str));
+			pc += sizeof(struct load_op) + strlen(str) + 1;
+			break;
+		}
+		case BYTECODE_OP_LOAD_S64:
+		{
+			int64_t v;
+
+			memcpy(&v, data + pc + sizeof(struct load_op), sizeof(v));
+			stack.push_back(make_s64(v));
+			pc += sizeof(struct load_op) + sizeof(struct literal_numeric);
+			break;
+		}
+		case BYTECODE_OP_LOAD_DOUBLE:
+		{
+			double v;
+
+			memcpy(&v, data + pc + sizeof(struct load_op), sizeof(v));
+			stack.push_back(make_double(v));
+			pc += sizeof(struct load_op) + sizeof(struct literal_double);
+			break;
+		}
+		case BYTECODE_OP_EQ:
+		case BYTECODE_OP_NE:
+		case BYTECODE_OP_GT:
+		case BYTECODE_OP_LT:
+		case BYTECODE_OP_GE:
+		case BYTECODE_OP_LE:
+		{
+			if (stack.size() < 2) {
+				return false;
+			}
+
+			const value right = stack.back();
+			stack.pop_back();
+			const value left = stack.back();
+			int cmp;
+
+			if (left.type == value::type::STRING && right.type == left.type) {
+				cmp = left.str.compare(right.str);
+			} else if (left.type == value::type::S64 && right.type == left.type) {
+				cmp = left.s64 < right.s64 ? -1 : left.s64 > right.s64;
+			} else {
+				double l, r;
+
+				if (!to_double(left, l) || !to_double(right, r)) {
+					return false;
+				}
+
+				/* Unordered comparisons are only true for `!=`. */
+				if (l != l || r != r) {
+					stack.back() = make_s64(op == BYTECODE_OP_NE);
+					pc += sizeof(struct binary_op);
+					break;
+				}
+
+				cmp = l < r ? -1 : l > r;
+			}
+
+			const bool result = (op == BYTECODE_OP_EQ && cmp == 0) ||
+				(op == BYTECODE_OP_NE && cmp != 0) ||
+				(op == BYTECODE_OP_GT && cmp > 0) ||
+				(op == BYTECODE_OP_LT && cmp < 0) ||
+				(op == BYTECODE_OP_GE && cmp >= 0) ||
+				(op == BYTECODE_OP_LE && cmp <= 0);
+
+			stack.back() = make_s64(result);
+			pc += sizeof(struct binary_op);
+			break;
+		}
+		case BYTECODE_OP_BIT_AND:
+		case BYTECODE_OP_BIT_OR:
+		case BYTECODE_OP_BIT_XOR:
+		{
+			if (stack.size() < 2) {
+				return false;
+			}
+
+			const value right = stack.back();
+			stack.pop_back();
+			const value left = stack.back();
+
+			if (left.type != value::type::S64 || right.type != value::type::S64) {
+				return false;
+			}
+
+			if (op == BYTECODE_OP_BIT_AND) {
+				stack.back() = make_s64(left.s64 & right.s64);
+			} else if (op == BYTECODE_OP_BIT_OR) {
+				stack.back() = make_s64(left.s64 | right.s64);
+			} else {
+				stack.back() = make_s64(left.s64 ^ right.s64);
+			}
+
+			pc += sizeof(struct binary_op);
+			break;
+		}
+		case BYTECODE_OP_UNARY_PLUS:
+		case BYTECODE_OP_UNARY_MINUS:
+		case BYTECODE_OP_UNARY_NOT:
+		case BYTECODE_OP_UNARY_BIT_NOT:
+		{
+			if (stack.empty()) {
+				return false;
+			}
+
+			value& top = stack.back();
+
+			if (top.type == value::type::S64) {
+				if (op == BYTECODE_OP_UNARY_MINUS) {
+					top.s64 = (int64_t) (0 - (uint64_t) top.s64);
+				} else if (op == BYTECODE_OP_UNARY_NOT) {
+					top.s64 = !top.s64;
+				} else if (op == BYTECODE_OP_UNARY_BIT_NOT) {
+					top.s64 = ~top.s64;
+				}
+			} else if (top.type == value::type::DOUBLE) {
+				if (op == BYTECODE_OP_UNARY_MINUS) {
+					top.dbl = -top.dbl;
+				} else if (op == BYTECODE_OP_UNARY_NOT) {
+					top = make_s64(!top.dbl);
+				} else if (op == BYTECODE_OP_UNARY_BIT_NOT) {
+					return false;
+				}
+			} else {
+				return false;
+			}
+
+			pc += sizeof(struct unary_op);
+			break;
+		}
+		case BYTECODE_OP_AND:
+		case BYTECODE_OP_OR:
+		{
+			struct logical_op insn;
+
+			memcpy(&insn, data + pc, sizeof(insn));
+			if (stack.empty() || stack.back().type != value::type::S64) {
+				return false;
+			}
+
+			if (op == BYTECODE_OP_AND && stack.back().s64 == 0) {
+				pc = insn.skip_offset;
+			} else if (op == BYTECODE_OP_OR && stack.back().s64 != 0) {
+				stack.back().s64 = 1;
+				pc = insn.skip_offset;
+			} else {
+				stack.pop_back();
+				pc += sizeof(insn);
+			}
+
+			break;
+		}
+		case BYTECODE_OP_CAST_TO_S64:
+		case BYTECODE_OP_CAST_DOUBLE_TO_S64:
+		{
+			if (stack.empty()) {
+				return false;
+			}
+
+			value& top = stack.back();
+
+			if (top.type == value::type::DOUBLE) {
+				top = make_s64((int64_t) top.dbl);
+			} else if (top.type != value::type::S64) {
+				return false;
+			}
+
+			pc += sizeof(struct cast_op);
+			break;
+		}
+		default:
+			diag("Unsupported instruction: op=%d", (int) op);
+			return false;
+		}
+	}
+
+	return false;
+}
+
+/* The event is recorded if the filter evaluates to true without errors. */
+bool is_recorded(const compiled_filter& filter, const event_fields& fields)
+{
+	bool record = false;
+
+	return interpret(filter, fields, record) && record;
+}
+
+/* Values of the `x` and `y` fields for which the filters are evaluated. */
+std::vector<event_fields> make_events()
+{
+	const value values[] = {
+		make_s64(-7),
+		make_s64(0),
+		make_s64(1),
+		make_s64(2),
+		make_s64(3),
+		make_s64(5),
+		make_s64(6),
+		make_s64(10),
+		make_s64(11),
+		make_s64(15),
+		make_s64(20),
+		make_s64(21),
+		make_s64(INT64_MAX),
+		make_double(5.0),
+		make_double(10.5),
+		make_double(-0.5),
+		make_double(NAN),
+		make_string("abc"),
+	};
+	std::vector<event_fields> events;
+
+	for (const auto& x : values) {
+		for (const auto& y : values) {
+			events.push_back(
+				{ { "x", x }, { "y", y }, { "name", make_string("abc") } });
+		}
+
+		/* Event without the `y` field. */
+		events.push_back({ { "x", x } });
+	}
+
+	return events;
+}
+
+const char *const equivalence_expressions[] = {
+	"x == 2",
+	"1 && x == 2",
+	"0 || x == 2",
+	"x == 2 && 1",
+	"x == 2 || 0",
+	"x && 1",
+	"1 && x",
+	"x || 1",
+	"0 && x",
+	"!(x == 3)",
+	"!(x != 3)",
+	"!!(x > 3)",
+	"!!x",
+	"!(x > 3)",
+	"x == -(-5)",
+	"x == +5",
+	"x == ~(-6)",
+	"x == (1 | 4)",
+	"x == (7 & 6) ^ 1",
+	"(2 < 3) && x",
+	"(2.5 > 3) || x == 5",
+	"x > 10 && x > 20",
+	"x > 10 && x >= 10",
+	"x >= 10 && x > 10",
+	"x >= 5 && x <= 5",
+	"x > 10 && x < 5",
+	"x > 5 && x < 6",
+	"x >= 5 && x < 5",
+	"x == 5 && x == 6",
+	"x == 5 && x >= 3",
+	"10 < x && x <= 20",
+	"x > 2 && y < 10 && x < 15 && y >= 3",
+	"x > 2 && name == \"abc\" && x < 15",
+	"name == \"abc\" && x == 5",
+	"(x > 2 && x < 15) || y == 5",
+	"y == 3 || (x > 2 && x > 15)",
+	"(x > 2 && x < 15) == 1",
+	"x && (y && 1)",
+	"x > 2 && (y == 1 || y == 2) && x < 15",
+	"x & 1 && x > 2",
+	"1 && 1",
+	"0 && 1",
+	"x == 10.5 && x > 10",
+	"x > 0 && y > x",
+};
+
+void test_equivalence()
+{
+	const auto events = make_events();
+
+	for (const auto *expression : equivalence_expressions) {
+		const auto original = compile(expression, false);
+		const auto optimized = compile(expression, true);
+		bool same_decisions = true;
+
+		if (!original.valid || !optimized.valid) {
+			fail("Filter `%s` compiles with and without optimization", expression);
+			continue;
+		}
+
+		for (const auto& event : events) {
+			if (is_recorded(original, event) != is_recorded(optimized, event)) {
+				same_decisions = false;
+				break;
+			}
+		}
+
+		ok(same_decisions && optimized.instructions_len <= original.instructions_len,
+		   "Optimized filter `%s` records the same events (%u -> %u bytes)",
+		   expression,
+		   original.instructions_len,
+		   optimized.instructions_len);
+	}
+}
+
+const char *const shortened_expressions[] = {
+	"x > 10 && x > 20", "1 && x == 2",     "!(x == 3)",		"x >= 5 && x <= 5",
+	"x > 10 && x < 5",  "x == -(-5)",      "x > 2 && x < 15 && x > 3",
+};
+
+void test_shortened()
+{
+	for (const auto *expression : shortened_expressions) {
+		const auto original = compile(expression, false);
+		const auto optimized = compile(expression, true);
+
+		ok(original.valid && optimized.valid &&
+			   optimized.instructions_len < original.instructions_len,
+		   "Optimized filter `%s` is shorter (%u -> %u bytes)",
+		   expression,
+		   original.instructions_len,
+		   optimized.instructions_len);
+	}
+}
+
+void test_reordering()
+{
+	/* The first field loaded is the first one in the relocation table. */
+	const auto optimized = compile("name == \"abc\" && x == 5", true);
+	const char *first_symbol =
+		optimized.data.data() + optimized.instructions_len + sizeof(uint16_t);
+
+	ok(optimized.valid && strcmp(first_symbol, "x") == 0,
+	   "Integer comparison is evaluated before the string comparison");
+}
+
+/* Check that the right operand of every `&&` node of a conjunction is on the right side. */
+bool conjunction_sides_are_valid(const struct ir_op *node)
+{
+	if (node->op != IR_OP_LOGICAL || node->u.logical.type != AST_OP_AND) {
+		return true;
+	}
+
+	return node->u.logical.left->side == IR_LEFT && node->u.logical.right->side == IR_RIGHT &&
+		conjunction_sides_are_valid(node->u.logical.left);
+}
+
+void test_rebuilt_conjunction_sides()
+{
+	const char *expression = "name == \"abc\" && x > 1 && 1 && y < 2";
+	bool sides_valid = false;
+	FILE *input = lttng_fmemopen((void *) expression, strlen(expression), "r");
+	struct filter_parser_ctx *ctx = input ? filter_parser_ctx_alloc(input) : nullptr;
+
+	if (ctx && !filter_parser_ctx_append_ast(ctx) && !filter_visitor_ir_generate(ctx) &&
+	    !filter_visitor_ir_optimize(ctx)) {
+		sides_valid = conjunction_sides_are_valid(ctx->ir_root->u.root.child);
+	}
+
+	ok(sides_valid, "Operands of a rebuilt conjunction are on the expected sides");
+
+	if (ctx) {
+		filter_parser_ctx_free(ctx);
+	}
+
+	if (input) {
+		fclose(input);
+	}
+}
+} /* namespace */
+
+int main()
+{
+	plan_tests(sizeof(equivalence_expressions) / sizeof(equivalence_expressions[0]) +
+		   sizeof(shortened_expressions) / sizeof(shortened_expressions[0]) + 2);
+
+	diag("Filter IR optimization unit test");
+
+	test_equivalence();
+	test_shortened();
+	test_reordering();
+	test_rebuilt_conjunction_sides();
+
+	return exit_status();
+}
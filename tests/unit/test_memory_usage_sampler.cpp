@@ -0,0 +1,205 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ */
+
+#include <common/macros.hpp>
+#include <common/memory-usage-sampler.hpp>
+
+#include <cstring>
+#include <random>
+#include <sys/mman.h>
+#include <tap/tap.h>
+#include <unistd.h>
+#include <vector>
+
+/* For error.hpp */
+int lttng_opt_quiet;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+using clock_type = lttng::memory_usage_sampler::clock;
+
+constexpr std::chrono::milliseconds max_sample_age(100);
+constexpr std::chrono::milliseconds full_scan_interval(1000);
+
+/* Spans three 4096-page chunks, the last one partial. */
+constexpr std::size_t area_page_count = 8200;
+
+const std::size_t page_size = sysconf(_SC_PAGESIZE);
+
+class anonymous_area {
+public:
+	anonymous_area() :
+		_address(mmap(nullptr,
+			      area_page_count * page_size,
+			      PROT_READ | PROT_WRITE,
+			      MAP_PRIVATE | MAP_ANONYMOUS,
+			      -1,
+			      0))
+	{
+		LTTNG_ASSERT(_address != MAP_FAILED);
+	}
+
+	~anonymous_area()
+	{
+		munmap(_address, area_page_count * page_size);
+	}
+
+	/* Deactivate copy and assignment. */
+	anonymous_area(const anonymous_area&) = delete;
+	anonymous_area(anonymous_area&&) = delete;
+	anonymous_area& operator=(const anonymous_area&) = delete;
+	anonymous_area& operator=(anonymous_area&&) = delete;
+
+	void *address() const noexcept
+	{
+		return _address;
+	}
+
+	void touch(std::size_t first_page, std::size_t page_count)
+	{
+		std::memset(static_cast<char *>(_address) + first_page * page_size,
+			    1,
+			    page_count * page_size);
+	}
+
+	void release(std::size_t first_page, std::size_t page_count)
+	{
+		madvise(static_cast<char *>(_address) + first_page * page_size,
+			page_count * page_size,
+			MADV_DONTNEED);
+	}
+
+private:
+	void *const _address;
+};
+
+void test_count_resident_pages()
+{
+	std::default_random_engine random_engine;
+	std::uniform_int_distribution<unsigned int> byte_distribution(0, 255);
+	/* Sizes around the 8-byte words and the lane folding period (255 words). */
+	const std::size_t sizes[] = { 0, 1, 7, 8, 9, 2039, 2040, 2041, 4096, 10000 };
+	bool all_match = true;
+
+	for (const auto size : sizes) {
+		std::vector<unsigned char> vector(size);
+		std::size_t expected_count = 0;
+
+		/* Only the least significant bit is meaningful; set the others randomly. */
+		for (auto& byte : vector) {
+			byte = byte_distribution(random_engine);
+			expected_count += byte & 1;
+		}
+
+		if (lttng::memory_usage_sampler::count_resident_pages(vector.data(), size) !=
+		    expected_count) {
+			diag("Resident page count mismatch with a %zu-page vector", size);
+			all_match = false;
+		}
+	}
+
+	ok(all_match, "Resident pages of residency vectors are counted correctly");
+
+	const std::vector<unsigned char> all_resident(4096, 0xff);
+	ok(lttng::memory_usage_sampler::count_resident_pages(all_resident.data(),
+							     all_resident.size()) == 4096,
+	   "All pages of a fully resident residency vector are counted");
+}
+
+void test_sample_tracks_writes()
+{
+	anonymous_area area;
+	lttng::memory_usage_sampler sampler(max_sample_age, full_scan_interval);
+	const auto start = clock_type::now();
+	std::uint64_t write_position = 0;
+
+	ok(!sampler.get_fresh_sample(start), "No fresh sample before the first sample");
+
+	auto sample = sampler.get_sample(
+		area.address(), area_page_count * page_size, write_position, start);
+	ok(sample.logical_size == area_page_count * page_size && sample.physical_size == 0,
+	   "Untouched area has no physical memory usage");
+
+	area.touch(0, 10);
+	area.touch(5000, 4);
+	write_position++;
+
+	ok(sampler.get_fresh_sample(start + max_sample_age / 2) &&
+		   sampler.get_fresh_sample(start + max_sample_age / 2)->physical_size == 0,
+	   "Sample younger than the maximal age is served from the cache");
+	ok(!sampler.get_fresh_sample(start + max_sample_age),
+	   "Sample older than the maximal age is not fresh");
+
+	sample = sampler.get_sample(area.address(),
+				    area_page_count * page_size,
+				    write_position,
+				    start + max_sample_age);
+	ok(sample.physical_size == 14 * page_size,
+	   "Pages written since the last sample are accounted");
+
+	area.touch(0, area_page_count);
+	sample = sampler.get_sample(area.address(),
+				    area_page_count * page_size,
+				    write_position,
+				    start + 2 * max_sample_age);
+	ok(sample.physical_size == 14 * page_size,
+	   "Area is not scanned again when the write position is unchanged");
+
+	write_position++;
+	sample = sampler.get_sample(area.address(),
+				    area_page_count * page_size,
+				    write_position,
+				    start + 3 * max_sample_age);
+	ok(sample.physical_size == area_page_count * page_size,
+	   "Area is scanned again when the write position changes");
+}
+
+void test_sample_tracks_releases()
+{
+	anonymous_area area;
+	lttng::memory_usage_sampler sampler(max_sample_age, full_scan_interval);
+	const auto start = clock_type::now();
+
+	area.touch(0, area_page_count);
+	auto sample = sampler.get_sample(area.address(), area_page_count * page_size, 0, start);
+	ok(sample.physical_size == area_page_count * page_size, "Touched area is fully resident");
+
+	/* Resident chunks are not scanned again until a full scan. */
+	area.release(0, 100);
+	sample = sampler.get_sample(
+		area.address(), area_page_count * page_size, 1, start + max_sample_age);
+	ok(sample.physical_size == area_page_count * page_size,
+	   "Released pages are not noticed by an incremental sample");
+
+	sampler.invalidate();
+	ok(!sampler.get_fresh_sample(start + max_sample_age),
+	   "Invalidated sample is not fresh");
+	sample = sampler.get_sample(
+		area.address(), area_page_count * page_size, 1, start + max_sample_age);
+	ok(sample.physical_size == (area_page_count - 100) * page_size,
+	   "Released pages are accounted after an invalidation");
+
+	area.release(8000, 200);
+	sample = sampler.get_sample(area.address(),
+				    area_page_count * page_size,
+				    1,
+				    start + max_sample_age + full_scan_interval);
+	ok(sample.physical_size == (area_page_count - 300) * page_size,
+	   "Released pages are accounted by the periodic full scan");
+}
+} /* namespace */
+
+int main()
+{
+	plan_tests(14);
+
+	test_count_resident_pages();
+	test_sample_tracks_writes();
+	test_sample_tracks_releases();
+
+	return exit_status();
+}
@@ -0,0 +1,285 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ */
+
+/*
+ * Measure the cost of producing large machine interface outputs, shaped like
+ * those of the `list` (sessions, and tracepoint fields) and `list-triggers`
+ * commands, and the peak memory usage of the process while doing so.
+ *
+ * The output is written to /dev/null, unless a path is provided.
+ *
+ * This is not part of the test suite; run it manually:
+ *   ./test_mi_writer_benchmark [OUTPUT-PATH]
+ */
+
+#include <common/mi-lttng.hpp>
+
+#include <lttng/action/notify.h>
+#include <lttng/condition/event-rule-matches.h>
+#include <lttng/event-rule/user-tracepoint.h>
+#include <lttng/trigger/trigger-internal.hpp>
+
+#include <chrono>
+#include <fcntl.h>
+#include <functional>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/resource.h>
+#include <tap/tap.h>
+#include <unistd.h>
+
+/* For error.hpp */
+int lttng_opt_quiet = 1;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+constexpr unsigned int session_count = 2000;
+constexpr unsigned int channel_count_per_session = 4;
+constexpr unsigned int event_count_per_channel = 25;
+constexpr unsigned int tracepoint_count = 5000;
+constexpr unsigned int field_count_per_tracepoint = 20;
+constexpr unsigned int trigger_count = 20000;
+
+const char *output_path = "/dev/null";
+
+long peak_rss_kib()
+{
+	struct rusage usage;
+
+	return getrusage(RUSAGE_SELF, &usage) ? -1 : usage.ru_maxrss;
+}
+
+/* Run `produce_output` on a new MI writer and report its duration. */
+void benchmark_output(const char *description,
+		      const char *command_name,
+		      const std::function<int(struct mi_writer *)>& produce_output)
+{
+	const auto fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		fail("Failed to open output file: %s", output_path);
+		return;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	auto *writer = mi_lttng_writer_create(fd, LTTNG_MI_XML);
+	int ret = writer ? 0 : -1;
+
+	ret = ret ?: mi_lttng_writer_command_open(writer, command_name);
+	ret = ret ?: mi_lttng_writer_open_element(writer, mi_lttng_element_command_output);
+	ret = ret ?: produce_output(writer);
+	ret = ret ?: mi_lttng_writer_close_element(writer);
+	ret = ret ?: mi_lttng_writer_command_close(writer);
+	if (writer && mi_lttng_writer_destroy(writer)) {
+		ret = -1;
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start);
+	const auto output_size = lseek(fd, 0, SEEK_END);
+
+	close(fd);
+	ok(ret == 0, "%s", description);
+	diag("  duration: %lld us, output size: %lld bytes, peak RSS: %ld KiB",
+	     (long long) duration.count(),
+	     (long long) output_size,
+	     peak_rss_kib());
+}
+
+int list_sessions(struct mi_writer *writer)
+{
+	struct lttng_domain domain = {};
+	struct lttng_session session = {};
+	int ret;
+
+	domain.type = LTTNG_DOMAIN_UST;
+	domain.buf_type = LTTNG_BUFFER_PER_UID;
+
+	auto *channel = lttng_channel_create(&domain);
+	auto *event = lttng_event_create();
+	if (!channel || !event) {
+		ret = -1;
+		goto end;
+	}
+
+	event->type = LTTNG_EVENT_TRACEPOINT;
+	event->loglevel_type = LTTNG_EVENT_LOGLEVEL_ALL;
+	event->loglevel = -1;
+	event->enabled = 1;
+
+	ret = mi_lttng_sessions_open(writer);
+	for (unsigned int session_index = 0; !ret && session_index < session_count;
+	     session_index++) {
+		snprintf(session.name, sizeof(session.name), "session-%u", session_index);
+		snprintf(session.path,
+			 sizeof(session.path),
+			 "/home/user/lttng-traces/session-%u-20250101-000000",
+			 session_index);
+
+		ret = ret ?: mi_lttng_session(writer, &session, 1);
+		ret = ret ?: mi_lttng_domains_open(writer);
+		ret = ret ?: mi_lttng_domain(writer, &domain, 1);
+		ret = ret ?: mi_lttng_channels_open(writer);
+		for (unsigned int channel_index = 0;
+		     !ret && channel_index < channel_count_per_session;
+		     channel_index++) {
+			snprintf(channel->name, sizeof(channel->name), "channel%u", channel_index);
+			ret = ret ?: mi_lttng_channel(writer, channel, 1);
+			ret = ret ?: mi_lttng_events_open(writer);
+			for (unsigned int event_index = 0;
+			     !ret && event_index < event_count_per_channel;
+			     event_index++) {
+				snprintf(event->name,
+					 sizeof(event->name),
+					 "provider:event_%u",
+					 event_index);
+				ret = mi_lttng_event(writer, event, 0, domain.type);
+			}
+
+			/* Close events and channel. */
+			ret = ret ?: mi_lttng_close_multi_element(writer, 2);
+		}
+
+		/* Close channels, domain, domains and session. */
+		ret = ret ?: mi_lttng_close_multi_element(writer, 4);
+	}
+
+	ret = ret ?: mi_lttng_writer_close_element(writer);
+end:
+	lttng_channel_destroy(channel);
+	lttng_event_destroy(event);
+	return ret;
+}
+
+int list_tracepoint_fields(struct mi_writer *writer)
+{
+	struct lttng_domain domain = {};
+	struct lttng_event_field field = {};
+	int ret;
+
+	domain.type = LTTNG_DOMAIN_UST;
+	field.type = LTTNG_EVENT_FIELD_INTEGER;
+	field.event.type = LTTNG_EVENT_TRACEPOINT;
+	field.event.loglevel = 13;
+
+	ret = mi_lttng_domains_open(writer);
+	ret = ret ?: mi_lttng_domain(writer, &domain, 1);
+	ret = ret ?: mi_lttng_pids_open(writer);
+	ret = ret ?: mi_lttng_pid(writer, 1234, "benchmark-app", 1);
+	ret = ret ?: mi_lttng_events_open(writer);
+	for (unsigned int tracepoint_index = 0; !ret && tracepoint_index < tracepoint_count;
+	     tracepoint_index++) {
+		snprintf(field.event.name,
+			 sizeof(field.event.name),
+			 "provider:tracepoint_%u",
+			 tracepoint_index);
+
+		ret = mi_lttng_event(writer, &field.event, 1, domain.type);
+		ret = ret ?: mi_lttng_event_fields_open(writer);
+		for (unsigned int field_index = 0; !ret && field_index < field_count_per_tracepoint;
+		     field_index++) {
+			snprintf(field.field_name,
+				 sizeof(field.field_name),
+				 "field_%u",
+				 field_index);
+			ret = mi_lttng_event_field(writer, &field);
+		}
+
+		/* Close fields and event. */
+		ret = ret ?: mi_lttng_close_multi_element(writer, 2);
+	}
+
+	/* Close events, pid, pids, domain and domains. */
+	ret = ret ?: mi_lttng_close_multi_element(writer, 5);
+	return ret;
+}
+
+struct lttng_triggers *create_triggers()
+{
+	auto *triggers = lttng_triggers_create();
+	auto *action = lttng_action_notify_create();
+
+	if (!triggers || !action) {
+		goto error;
+	}
+
+	for (unsigned int trigger_index = 0; trigger_index < trigger_count; trigger_index++) {
+		const auto name_pattern = "provider:event_" + std::to_string(trigger_index);
+		const auto trigger_name = "trigger-" + std::to_string(trigger_index);
+		auto *rule = lttng_event_rule_user_tracepoint_create();
+		auto *condition = rule ? lttng_condition_event_rule_matches_create(rule) : nullptr;
+		auto *trigger = condition ? lttng_trigger_create(condition, action) : nullptr;
+		int ret = trigger ? 0 : -1;
+
+		if (!ret &&
+		    (lttng_event_rule_user_tracepoint_set_name_pattern(
+			     rule, name_pattern.c_str()) != LTTNG_EVENT_RULE_STATUS_OK ||
+		     lttng_event_rule_user_tracepoint_set_filter(rule, "intfield > 42") !=
+			     LTTNG_EVENT_RULE_STATUS_OK ||
+		     lttng_trigger_set_name(trigger, trigger_name.c_str()) !=
+			     LTTNG_TRIGGER_STATUS_OK ||
+		     lttng_trigger_set_owner_uid(trigger, 1000) != LTTNG_TRIGGER_STATUS_OK)) {
+			ret = -1;
+		}
+
+		ret = ret ?: lttng_triggers_add(triggers, trigger);
+		lttng_trigger_put(trigger);
+		lttng_condition_destroy(condition);
+		lttng_event_rule_destroy(rule);
+		if (ret) {
+			goto error;
+		}
+	}
+
+	lttng_action_destroy(action);
+	return triggers;
+error:
+	lttng_action_destroy(action);
+	lttng_triggers_destroy(triggers);
+	return nullptr;
+}
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	if (argc > 1) {
+		output_path = argv[1];
+	}
+
+	plan_tests(3);
+
+	diag("Machine interface writer benchmark");
+	diag("Output: %s", output_path);
+
+	diag("List %u sessions of %u channels of %u events",
+	     session_count,
+	     channel_count_per_session,
+	     event_count_per_channel);
+	benchmark_output("List sessions", mi_lttng_element_command_list, list_sessions);
+
+	diag("List %u tracepoints of %u fields", tracepoint_count, field_count_per_tracepoint);
+	benchmark_output(
+		"List tracepoint fields", mi_lttng_element_command_list, list_tracepoint_fields);
+
+	diag("List %u triggers", trigger_count);
+	auto *triggers = create_triggers();
+	benchmark_output("List triggers",
+			 mi_lttng_element_command_list_trigger,
+			 [triggers](struct mi_writer *writer) {
+				 if (!triggers) {
+					 return -1;
+				 }
+
+				 return lttng_triggers_mi_serialize(triggers, writer, nullptr) ==
+						 LTTNG_OK ?
+					 0 :
+					 -1;
+			 });
+	lttng_triggers_destroy(triggers);
+
+	return exit_status();
+}
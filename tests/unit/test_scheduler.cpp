@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <memory>
 #include <random>
 #include <tap/tap.h>
@@ -365,6 +366,140 @@ void test_task_die()
 }
 } /* namespace periodic_scheduling */
 
+namespace timing_wheel_scheduling {
+
+using backend_type = lttng::scheduling::scheduler::backend_type;
+
+void test_no_task_scheduled()
+{
+	lttng::scheduling::scheduler scheduler(backend_type::TIMING_WHEEL);
+
+	const auto tick_ret = scheduler.tick(ns_to_time_point(100));
+	ok(!tick_ret.has_value(),
+	   "Timing wheel: tick with no task returned no time until next task");
+}
+
+void test_lots_of_tasks_ran_in_order()
+{
+	/* A 1 ns resolution spreads the tasks over many slots and levels of the wheel. */
+	lttng::scheduling::scheduler scheduler(backend_type::TIMING_WHEEL,
+					       lttng::scheduling::duration_ns(1));
+	std::array<bool, 16> tasks_ran = { false };
+	std::vector<std::pair<once_scheduling::task_once::sptr, lttng::scheduling::absolute_time>>
+		tasks;
+
+	/* Create tasks to be scheduled at ticks 5, 1005, 2005, 3005, etc. */
+	for (unsigned int i = 0; i < tasks_ran.size(); i++) {
+		tasks.emplace_back(std::make_shared<once_scheduling::task_once>(tasks_ran[i]),
+				   ns_to_time_point((i * 1000) + 5));
+	}
+
+	std::shuffle(std::begin(tasks), std::end(tasks), std::default_random_engine{});
+
+	for (const auto& task_pair : tasks) {
+		scheduler.schedule(task_pair.first, task_pair.second);
+	}
+
+	bool all_ticks_ran_expected_tasks = true;
+	for (unsigned int i = 0; i < tasks_ran.size() + 1; i++) {
+		scheduler.tick(ns_to_time_point(i * 1000));
+
+		unsigned int consecutive_tasks_executed = 0;
+		for (const auto& ran : tasks_ran) {
+			if (ran) {
+				consecutive_tasks_executed++;
+			} else {
+				break;
+			}
+		}
+
+		if (consecutive_tasks_executed != i) {
+			diag("Unexpected task count: tick=%u, expected=%u, executed=%u",
+			     i * 1000,
+			     i,
+			     consecutive_tasks_executed);
+			all_ticks_ran_expected_tasks = false;
+		}
+	}
+
+	ok(all_ticks_ran_expected_tasks, "Timing wheel: tasks ran in order of their deadline");
+}
+
+void test_deadline_within_resolution()
+{
+	lttng::scheduling::scheduler scheduler(backend_type::TIMING_WHEEL,
+					       std::chrono::milliseconds(1));
+	bool task_100_ran = false, task_150_ran = false;
+
+	scheduler.schedule(std::make_shared<once_scheduling::task_once>(task_150_ran),
+			   ns_to_time_point(150));
+	scheduler.schedule(std::make_shared<once_scheduling::task_once>(task_100_ran),
+			   ns_to_time_point(100));
+
+	const auto tick_ret = scheduler.tick(ns_to_time_point(120));
+	ok(task_100_ran && !task_150_ran,
+	   "Timing wheel: deadlines finer than the resolution are honored");
+	ok(tick_ret.has_value() && *tick_ret == lttng::scheduling::duration_ns(30),
+	   "Timing wheel: tick @ 120 returned exact time until task @ 150");
+}
+
+void test_far_deadline()
+{
+	lttng::scheduling::scheduler scheduler(backend_type::TIMING_WHEEL,
+					       lttng::scheduling::duration_ns(1));
+	bool task_ran = false;
+	const auto deadline = ns_to_time_point(0) + std::chrono::hours(1);
+
+	/* Beyond the range covered by the wheel's levels. */
+	scheduler.schedule(std::make_shared<once_scheduling::task_once>(task_ran), deadline);
+
+	scheduler.tick(deadline - lttng::scheduling::duration_ns(1));
+	ok(!task_ran, "Timing wheel: task scheduled beyond the wheel's range not ran early");
+
+	scheduler.tick(deadline);
+	ok(task_ran, "Timing wheel: task scheduled beyond the wheel's range ran at its deadline");
+}
+
+void test_cancel()
+{
+	lttng::scheduling::scheduler scheduler(backend_type::TIMING_WHEEL,
+					       lttng::scheduling::duration_ns(1));
+	bool task_ran = false;
+	auto my_task = std::make_shared<once_scheduling::task_once>(task_ran);
+
+	scheduler.schedule(my_task, ns_to_time_point(100));
+	scheduler.cancel(my_task);
+	ok(my_task.use_count() == 1, "Timing wheel: canceled task released by the scheduler");
+
+	const auto tick_ret = scheduler.tick(ns_to_time_point(200));
+	ok(!task_ran && !tick_ret.has_value(), "Timing wheel: canceled task didn't run");
+}
+
+void test_periodic_task_rescheduled()
+{
+	lttng::scheduling::scheduler scheduler(backend_type::TIMING_WHEEL,
+					       lttng::scheduling::duration_ns(1));
+	unsigned int task_run_count = 0;
+
+	auto my_task = std::make_shared<periodic_scheduling::periodic_task>(
+		lttng::scheduling::duration_ns(100), task_run_count);
+
+	scheduler.schedule(my_task, ns_to_time_point(0) + my_task->period());
+	const auto tick_ret = scheduler.tick(ns_to_time_point(100));
+	ok(task_run_count == 1,
+	   "Timing wheel: periodic task scheduled @ 100 ran during tick @ 100");
+	ok(tick_ret.has_value() && *tick_ret <= lttng::scheduling::duration_ns(100),
+	   "Timing wheel: tick @ 100 returned a wake-up time no later than the next run");
+
+	scheduler.tick(ns_to_time_point(150));
+	ok(task_run_count == 1, "Timing wheel: periodic task didn't run twice with tick @ 150");
+	scheduler.tick(ns_to_time_point(200));
+	scheduler.tick(ns_to_time_point(300));
+	ok(task_run_count == 3, "Timing wheel: periodic task ran during ticks @ 200 and @ 300");
+}
+
+} /* namespace timing_wheel_scheduling */
+
 namespace task_execution {
 void test_stop()
 {
@@ -395,12 +530,125 @@ void test_task_die()
 	   "Periodic task scheduled to run only three times only ran three times by task executor");
 }
 
+void test_stop_with_workers()
+{
+	lttng::scheduling::scheduler scheduler;
+	lttng::scheduling::task_executor executor(scheduler, 4);
+
+	executor.stop();
+
+	ok(executor.worker_count() == 4, "Scheduler with a pool of 4 workers stopped");
+}
+
+class blocking_task : public lttng::scheduling::task {
+public:
+	explicit blocking_task(std::atomic<bool>& release) : _release{ release }
+	{
+	}
+
+	void _run([[maybe_unused]] lttng::scheduling::absolute_time current_time) noexcept override
+	{
+		while (!_release.load()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+private:
+	std::atomic<bool>& _release;
+};
+
+class overlap_detecting_task : public lttng::scheduling::periodic_task {
+public:
+	overlap_detecting_task(lttng::scheduling::duration_ns period,
+			       std::atomic<unsigned int>& run_count,
+			       std::atomic<bool>& overlap_detected) :
+		lttng::scheduling::periodic_task(period),
+		_run_count{ run_count },
+		_overlap_detected{ overlap_detected }
+	{
+	}
+
+	void _run([[maybe_unused]] lttng::scheduling::absolute_time current_time) noexcept override
+	{
+		if (_running.exchange(true)) {
+			_overlap_detected = true;
+		}
+
+		/* Run for longer than the period. */
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		_run_count++;
+		_running = false;
+	}
+
+private:
+	std::atomic<bool> _running{ false };
+	std::atomic<unsigned int>& _run_count;
+	std::atomic<bool>& _overlap_detected;
+};
+
+void test_slow_task_does_not_delay_others()
+{
+	lttng::scheduling::scheduler scheduler;
+	lttng::scheduling::task_executor executor(scheduler, 2);
+	std::atomic<bool> release_slow_task{ false };
+	unsigned int task_run_count = 0;
+
+	auto slow_task = std::make_shared<blocking_task>(release_slow_task);
+	auto my_task = std::make_shared<periodic_scheduling::periodic_task_die_after_3>(
+		lttng::scheduling::duration_ns(std::chrono::milliseconds(10)), task_run_count);
+
+	scheduler.schedule(slow_task);
+	scheduler.schedule(my_task, std::chrono::steady_clock::now() + my_task->period());
+
+	const auto give_up_time = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (!my_task->canceled() && std::chrono::steady_clock::now() < give_up_time) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	ok(task_run_count == 3, "Periodic task ran while another task was blocked on a worker");
+
+	release_slow_task = true;
+	executor.stop();
+}
+
+void test_task_not_run_concurrently_with_itself()
+{
+	lttng::scheduling::scheduler scheduler;
+	lttng::scheduling::task_executor executor(scheduler, 4);
+	std::atomic<unsigned int> run_count{ 0 };
+	std::atomic<bool> overlap_detected{ false };
+
+	auto my_task = std::make_shared<overlap_detecting_task>(
+		lttng::scheduling::duration_ns(std::chrono::microseconds(100)),
+		run_count,
+		overlap_detected);
+
+	scheduler.schedule(my_task);
+	while (run_count.load() < 20) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	scheduler.cancel(my_task);
+	executor.stop();
+
+	ok(!overlap_detected.load(),
+	   "Task never ran concurrently with itself on a pool of workers");
+
+	const auto statistics = my_task->get_statistics();
+	ok(statistics.run_time.count() >= 20 &&
+		   statistics.run_time.count() == statistics.lateness.count(),
+	   "Run time and lateness of every run recorded in the task's statistics");
+	ok(statistics.run_time.quantile_upper_bound(0.5) >=
+		   std::uint64_t(std::chrono::nanoseconds(std::chrono::milliseconds(1)).count()),
+	   "Recorded median run time is consistent with the task's run time");
+}
+
 } /* namespace task_execution */
 } /* namespace */
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
 {
-	plan_tests(46);
+	plan_tests(63);
 
 	once_scheduling::test_task_not_ran_immediately();
 	once_scheduling::test_task_not_ran_before_deadline();
@@ -418,8 +666,18 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
 	periodic_scheduling::test_task_rescheduled();
 	periodic_scheduling::test_task_die();
 
+	timing_wheel_scheduling::test_no_task_scheduled();
+	timing_wheel_scheduling::test_lots_of_tasks_ran_in_order();
+	timing_wheel_scheduling::test_deadline_within_resolution();
+	timing_wheel_scheduling::test_far_deadline();
+	timing_wheel_scheduling::test_cancel();
+	timing_wheel_scheduling::test_periodic_task_rescheduled();
+
 	task_execution::test_stop();
 	task_execution::test_task_die();
+	task_execution::test_stop_with_workers();
+	task_execution::test_slow_task_does_not_delay_others();
+	task_execution::test_task_not_run_concurrently_with_itself();
 
 	return exit_status();
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ */
+
+/*
+ * Compare the cost of the scheduler's backends (priority heap and timing wheel)
+ * with large populations of periodic tasks.
+ *
+ * This is not part of the test suite; run it manually:
+ *   ./test_scheduler_benchmark
+ */
+
+#include <common/scheduler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <inttypes.h>
+#include <memory>
+#include <random>
+#include <tap/tap.h>
+#include <vector>
+
+/* For error.hpp */
+int lttng_opt_quiet;
+int lttng_opt_verbose;
+int lttng_opt_mi;
+
+namespace {
+using backend_type = lttng::scheduling::scheduler::backend_type;
+
+/* Simulated duration of the run, with one tick per simulated millisecond. */
+constexpr std::chrono::seconds simulated_duration(10);
+constexpr std::chrono::milliseconds tick_interval(1);
+
+class counting_task : public lttng::scheduling::periodic_task {
+public:
+	counting_task(lttng::scheduling::duration_ns period, std::uint64_t& run_count) :
+		lttng::scheduling::periodic_task(period), _run_count{ run_count }
+	{
+	}
+
+	void _run([[maybe_unused]] lttng::scheduling::absolute_time current_time) noexcept override
+	{
+		_run_count++;
+	}
+
+private:
+	std::uint64_t& _run_count;
+};
+
+struct benchmark_result {
+	std::chrono::nanoseconds schedule_duration;
+	std::chrono::nanoseconds tick_duration;
+	std::chrono::nanoseconds cancel_duration;
+	std::uint64_t run_count;
+};
+
+const char *backend_name(backend_type backend)
+{
+	switch (backend) {
+	case backend_type::PRIORITY_HEAP:
+		return "priority heap";
+	case backend_type::TIMING_WHEEL:
+		return "timing wheel";
+	}
+
+	abort();
+}
+
+benchmark_result run_benchmark(backend_type backend, unsigned int task_count)
+{
+	lttng::scheduling::scheduler scheduler(backend);
+	std::vector<std::shared_ptr<counting_task>> tasks;
+	/* Same seed for all backends: the same tasks are scheduled at the same times. */
+	std::default_random_engine random_engine;
+	std::uniform_int_distribution<unsigned int> period_ms_distribution(10, 1000);
+	std::uint64_t run_count = 0;
+	benchmark_result result = {};
+
+	tasks.reserve(task_count);
+	for (unsigned int i = 0; i < task_count; i++) {
+		tasks.emplace_back(std::make_shared<counting_task>(
+			std::chrono::milliseconds(period_ms_distribution(random_engine)),
+			run_count));
+	}
+
+	const lttng::scheduling::absolute_time start_time(std::chrono::seconds(1));
+
+	auto before = std::chrono::steady_clock::now();
+	for (const auto& task : tasks) {
+		scheduler.schedule(task, start_time + task->period());
+	}
+
+	result.schedule_duration = std::chrono::steady_clock::now() - before;
+
+	before = std::chrono::steady_clock::now();
+	for (auto current_time = start_time; current_time <= start_time + simulated_duration;
+	     current_time += tick_interval) {
+		scheduler.tick(current_time);
+	}
+
+	result.tick_duration = std::chrono::steady_clock::now() - before;
+
+	before = std::chrono::steady_clock::now();
+	for (const auto& task : tasks) {
+		scheduler.cancel(task);
+	}
+
+	result.cancel_duration = std::chrono::steady_clock::now() - before;
+	result.run_count = run_count;
+	return result;
+}
+
+void compare_backends(unsigned int task_count)
+{
+	const std::array<backend_type, 2> backends = { backend_type::PRIORITY_HEAP,
+						       backend_type::TIMING_WHEEL };
+	std::array<benchmark_result, 2> results;
+
+	for (unsigned int i = 0; i < backends.size(); i++) {
+		results[i] = run_benchmark(backends[i], task_count);
+
+		diag("%u tasks, %s: schedule=%.1f ns/task, tick=%.1f ns/run, cancel=%.1f ns/task, "
+		     "runs=%" PRIu64,
+		     task_count,
+		     backend_name(backends[i]),
+		     double(results[i].schedule_duration.count()) / task_count,
+		     double(results[i].tick_duration.count()) /
+			     std::max<std::uint64_t>(results[i].run_count, 1),
+		     double(results[i].cancel_duration.count()) / task_count,
+		     results[i].run_count);
+	}
+
+	ok(results[0].run_count == results[1].run_count,
+	   "Both backends ran the same number of tasks with %u tasks",
+	   task_count);
+}
+} /* namespace */
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+	const std::array<unsigned int, 3> task_counts = { 1000, 10000, 100000 };
+
+	plan_tests(task_counts.size());
+
+	for (const auto task_count : task_counts) {
+		compare_backends(task_count);
+	}
+
+	return exit_status();
+}
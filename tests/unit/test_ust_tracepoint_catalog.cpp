@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2025 EfficiOS Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include <lttng/ust-sigbus.h>
+
+#include <bin/lttng-sessiond/ust-tracepoint-catalog.hpp>
+#include <string.h>
+#include <tap/tap.h>
+
+LTTNG_EXPORT DEFINE_LTTNG_UST_SIGBUS_STATE();
+
+namespace {
+namespace lsu = lttng::sessiond::ust;
+
+using clock_type = lsu::tracepoint_catalog::clock;
+
+constexpr std::chrono::milliseconds max_list_age(1000);
+
+const lsu::tracepoint_catalog::provider_set_key app_key = {
+	"my-app", 1000, 64, 10, 0, 2049, 42, 1700000000, 0
+};
+const lsu::tracepoint_catalog::provider_set_key other_app_key = {
+	"other-app", 1000, 64, 10, 0, 2049, 43, 1700000000, 0
+};
+/* Same process name as `app_key`, but another executable. */
+const lsu::tracepoint_catalog::provider_set_key other_exe_key = {
+	"my-app", 1000, 64, 10, 0, 2049, 44, 1700000000, 0
+};
+/* Same process name as `app_key`, but an executable which can't be identified. */
+const lsu::tracepoint_catalog::provider_set_key unknown_exe_key = {
+	"my-app", 1000, 64, 10, 0, 0, 0, 0, 1234
+};
+const lsu::tracepoint_catalog::provider_set_key other_unknown_exe_key = {
+	"my-app", 1000, 64, 10, 0, 0, 0, 0, 1235
+};
+
+std::shared_ptr<const lsu::tracepoint_catalog::tracepoint_list>
+make_tracepoint_list(const char *name)
+{
+	auto tracepoints = std::make_shared<lsu::tracepoint_catalog::tracepoint_list>(1);
+
+	strcpy(tracepoints->front().name, name);
+	return tracepoints;
+}
+
+void test_unknown_provider_set()
+{
+	lsu::tracepoint_catalog catalog(max_list_age);
+	const auto now = clock_type::now();
+
+	const auto result = catalog.lookup_tracepoints(app_key, now);
+	ok(!result.list && result.generation == 0,
+	   "Provider set without a registered application is unknown");
+
+	catalog.add_tracepoints(app_key, result.generation, make_tracepoint_list("tp"), now);
+	ok(!catalog.lookup_tracepoints(app_key, now).list,
+	   "List of an unknown provider set is not added");
+}
+
+void test_shared_list()
+{
+	lsu::tracepoint_catalog catalog(max_list_age);
+	const auto now = clock_type::now();
+
+	catalog.add_app(app_key);
+	catalog.add_app(app_key);
+	catalog.add_app(other_app_key);
+
+	auto result = catalog.lookup_tracepoints(app_key, now);
+	ok(!result.list && result.generation != 0, "New provider set must be queried");
+
+	catalog.add_tracepoints(app_key, result.generation, make_tracepoint_list("tp"), now);
+	result = catalog.lookup_tracepoints(app_key, now + max_list_age / 2);
+	ok(result.list && result.list->size() == 1 && !strcmp(result.list->front().name, "tp"),
+	   "List is shared by the applications of a provider set");
+	ok(!catalog.lookup_tracepoints(other_app_key, now).list,
+	   "List is not shared with other provider sets");
+	ok(!catalog.lookup_fields(app_key, now).list,
+	   "Tracepoint field list is cached independently");
+	ok(!catalog.lookup_tracepoints(app_key, now + max_list_age).list,
+	   "List older than the maximal age must be queried again");
+}
+
+void test_executable_identity()
+{
+	lsu::tracepoint_catalog catalog(max_list_age);
+	const auto now = clock_type::now();
+
+	catalog.add_app(app_key);
+	catalog.add_app(other_exe_key);
+	catalog.add_app(unknown_exe_key);
+	catalog.add_app(other_unknown_exe_key);
+
+	for (const auto *key : { &app_key, &unknown_exe_key }) {
+		const auto result = catalog.lookup_tracepoints(*key, now);
+
+		catalog.add_tracepoints(*key, result.generation, make_tracepoint_list("tp"), now);
+	}
+
+	ok(!catalog.lookup_tracepoints(other_exe_key, now).list,
+	   "List is not shared by applications having the same name but another executable");
+	ok(!catalog.lookup_tracepoints(other_unknown_exe_key, now).list,
+	   "List is not shared by applications having an unidentified executable");
+}
+
+void test_invalidation()
+{
+	lsu::tracepoint_catalog catalog(max_list_age);
+	const auto now = clock_type::now();
+
+	catalog.add_app(app_key);
+	auto result = catalog.lookup_tracepoints(app_key, now);
+	catalog.add_tracepoints(app_key, result.generation, make_tracepoint_list("tp"), now);
+
+	catalog.add_app(app_key);
+	ok(!catalog.lookup_tracepoints(app_key, now).list,
+	   "Application registration invalidates its provider set");
+
+	result = catalog.lookup_tracepoints(app_key, now);
+	catalog.remove_app(app_key);
+	catalog.add_tracepoints(app_key, result.generation, make_tracepoint_list("tp"), now);
+	ok(!catalog.lookup_tracepoints(app_key, now).list,
+	   "List queried before an application unregistration is not added");
+
+	result = catalog.lookup_tracepoints(app_key, now);
+	catalog.add_tracepoints(app_key, result.generation, make_tracepoint_list("tp"), now);
+	ok(catalog.lookup_tracepoints(app_key, now).list,
+	   "List queried after the last invalidation is added");
+
+	catalog.remove_app(app_key);
+	result = catalog.lookup_tracepoints(app_key, now);
+	ok(!result.list && result.generation == 0,
+	   "Provider set is forgotten when its last application unregisters");
+}
+} /* namespace */
+
+int main()
+{
+	plan_tests(13);
+
+	diag("UST tracepoint catalog unit test");
+
+	test_unknown_provider_set();
+	test_shared_list();
+	test_executable_identity();
+	test_invalidation();
+
+	return exit_status();
+}